@@ -101,24 +101,6 @@ static bool parseCommandLine(CommandLine &cmdLine, int argc, const char *const *
     return true;
 }
 
-static void parseBatchResult(xe::TestLogParser &parser, const char *filename)
-{
-    std::ifstream in(filename, std::ios_base::binary);
-    uint8_t buf[2048];
-
-    for (;;)
-    {
-        in.read((char *)&buf[0], sizeof(buf));
-        int numRead = (int)in.gcount();
-
-        if (numRead > 0)
-            parser.parse(&buf[0], numRead);
-
-        if (numRead < (int)sizeof(buf))
-            break;
-    }
-}
-
 // Export to single file
 
 struct BatchResultTotals
@@ -145,18 +127,22 @@ public:
 
     xe::TestCaseResultPtr startTestCaseResult(const char *casePath)
     {
+        m_resultParser.begin(casePath);
         return xe::TestCaseResultPtr(new xe::TestCaseResultData(casePath));
     }
 
+    void testCaseResultData(const xe::TestCaseResultPtr &, const uint8_t *bytes, size_t numBytes)
+    {
+        m_resultParser.feed(bytes, numBytes);
+    }
+
     void testCaseResultUpdated(const xe::TestCaseResultPtr &)
     {
     }
 
     void testCaseResultComplete(const xe::TestCaseResultPtr &resultData)
     {
-        xe::TestCaseResult result;
-
-        xe::parseTestCaseResultFromData(&m_resultParser, &result, *resultData.get());
+        const xe::TestCaseResult &result = m_resultParser.finish(*resultData.get());
 
         // Write result.
         xe::writeTestResult(result, m_writer);
@@ -169,7 +155,7 @@ public:
 private:
     xe::xml::Writer &m_writer;
     BatchResultTotals &m_totals;
-    xe::TestResultParser m_resultParser;
+    xe::TestCaseResultStreamParser m_resultParser;
 };
 
 static void writeTotals(xe::xml::Writer &writer, const BatchResultTotals &totals)
@@ -207,7 +193,7 @@ static void batchResultToSingleXmlFile(const char *batchResultFilename, const ch
            << xe::xml::Writer::Attribute("FileName", de::FilePath(batchResultFilename).getBaseName());
 
     // Parse and write individual cases
-    parseBatchResult(parser, batchResultFilename);
+    xe::parseTestLogFile(parser, batchResultFilename);
 
     // Write ResultTotals
     writeTotals(writer, totals);
@@ -233,18 +219,22 @@ public:
 
     xe::TestCaseResultPtr startTestCaseResult(const char *casePath)
     {
+        m_resultParser.begin(casePath);
         return xe::TestCaseResultPtr(new xe::TestCaseResultData(casePath));
     }
 
+    void testCaseResultData(const xe::TestCaseResultPtr &, const uint8_t *bytes, size_t numBytes)
+    {
+        m_resultParser.feed(bytes, numBytes);
+    }
+
     void testCaseResultUpdated(const xe::TestCaseResultPtr &)
     {
     }
 
     void testCaseResultComplete(const xe::TestCaseResultPtr &resultData)
     {
-        xe::TestCaseResult result;
-
-        xe::parseTestCaseResultFromData(&m_resultParser, &result, *resultData.get());
+        const xe::TestCaseResult &result = m_resultParser.finish(*resultData.get());
 
         // Write result.
         {
@@ -267,7 +257,7 @@ public:
 private:
     vector<xe::TestCaseResultHeader> &m_resultHeaders;
     std::string m_dstPath;
-    xe::TestResultParser m_resultParser;
+    xe::TestCaseResultStreamParser m_resultParser;
 };
 
 typedef std::map<const xe::TestCase *, const xe::TestCaseResultHeader *> ShortTestResultMap;
@@ -338,7 +328,7 @@ static void batchResultToSeparateXmlFiles(const char *batchResultFilename, const
         ResultToXmlFilesLogHandler handler(shortResults, dstPath);
         xe::TestLogParser parser(&handler);
 
-        parseBatchResult(parser, batchResultFilename);
+        xe::parseTestLogFile(parser, batchResultFilename);
     }
 
     // Build case hierarchy & short result map.
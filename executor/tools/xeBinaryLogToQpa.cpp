@@ -0,0 +1,133 @@
+/*-------------------------------------------------------------------------
+ * drawElements Quality Program Test Executor
+ * ------------------------------------------
+ *
+ * Copyright (c) 2026 The Khronos Group Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *//*!
+ * \file
+ * \brief Convert binary test log to XML based .qpa log.
+ *//*--------------------------------------------------------------------*/
+
+#include "xeBinaryLogDecoder.hpp"
+#include "deString.h"
+
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+using std::string;
+using std::vector;
+
+struct CommandLine
+{
+    CommandLine(void)
+    {
+    }
+
+    string srcFilename;
+    string dstFilename;
+};
+
+static void convertBinaryLog(const CommandLine &cmdLine)
+{
+    std::ifstream in(cmdLine.srcFilename.c_str(), std::ifstream::binary | std::ifstream::in);
+    std::ofstream out(cmdLine.dstFilename.c_str(), std::ofstream::binary | std::ofstream::out);
+    xe::BinaryLogDecoder decoder;
+    vector<uint8_t> decoded;
+    uint8_t buf[64 * 1024];
+    bool isFirst = true;
+
+    if (!in.good())
+        throw std::runtime_error(string("Failed to open '") + cmdLine.srcFilename + "'");
+
+    if (!out.good())
+        throw std::runtime_error(string("Failed to open '") + cmdLine.dstFilename + "'");
+
+    for (;;)
+    {
+        in.read((char *)&buf[0], DE_LENGTH_OF_ARRAY(buf));
+        const int numRead = (int)in.gcount();
+
+        if (numRead <= 0)
+            break;
+
+        if (isFirst && !xe::isBinaryLog(&buf[0], (size_t)numRead))
+            throw std::runtime_error(string("'") + cmdLine.srcFilename + "' is not a binary test log");
+
+        isFirst = false;
+
+        decoded.clear();
+        decoder.decode(&buf[0], (size_t)numRead, decoded);
+
+        if (!decoded.empty())
+            out.write((const char *)&decoded[0], (std::streamsize)decoded.size());
+    }
+
+    if (!out.good())
+        throw std::runtime_error(string("Failed to write '") + cmdLine.dstFilename + "'");
+}
+
+static void printHelp(const char *binName)
+{
+    printf("%s: [binary log] [output qpa]\n", binName);
+}
+
+static bool parseCommandLine(CommandLine &cmdLine, int argc, const char *const *argv)
+{
+    for (int argNdx = 1; argNdx < argc; argNdx++)
+    {
+        const char *arg = argv[argNdx];
+
+        if (!deStringBeginsWith(arg, "--"))
+        {
+            if (cmdLine.srcFilename.empty())
+                cmdLine.srcFilename = arg;
+            else if (cmdLine.dstFilename.empty())
+                cmdLine.dstFilename = arg;
+            else
+                return false;
+        }
+        else
+            return false;
+    }
+
+    return !cmdLine.srcFilename.empty() && !cmdLine.dstFilename.empty();
+}
+
+int main(int argc, const char *const *argv)
+{
+    try
+    {
+        CommandLine cmdLine;
+
+        if (!parseCommandLine(cmdLine, argc, argv))
+        {
+            printHelp(argv[0]);
+            return -1;
+        }
+
+        convertBinaryLog(cmdLine);
+    }
+    catch (const std::exception &e)
+    {
+        printf("FATAL ERROR: %s\n", e.what());
+        return -1;
+    }
+
+    return 0;
+}
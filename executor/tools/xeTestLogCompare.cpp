@@ -32,7 +32,6 @@
 #include <string>
 #include <cstdio>
 #include <cstdlib>
-#include <fstream>
 #include <iostream>
 #include <set>
 #include <map>
@@ -122,9 +121,16 @@ public:
 
     xe::TestCaseResultPtr startTestCaseResult(const char *casePath)
     {
+        m_resultParser.begin(casePath);
         return xe::TestCaseResultPtr(new xe::TestCaseResultData(casePath));
     }
 
+    void testCaseResultData(const xe::TestCaseResultPtr &, const uint8_t *bytes, size_t numBytes)
+    {
+        // Parsed as it arrives instead of storing whole case log.
+        m_resultParser.feed(bytes, numBytes);
+    }
+
     void testCaseResultUpdated(const xe::TestCaseResultPtr &)
     {
         // Ignored.
@@ -141,13 +147,7 @@ public:
         header.statusDetails = caseData->getStatusDetails();
 
         if (header.statusCode == xe::TESTSTATUSCODE_LAST)
-        {
-            xe::TestCaseResult fullResult;
-
-            xe::parseTestCaseResultFromData(&m_testResultParser, &fullResult, *caseData.get());
-
-            header = xe::TestCaseResultHeader(fullResult);
-        }
+            header = xe::TestCaseResultHeader(m_resultParser.finish(*caseData.get()));
 
         // Insert into result list & map.
         m_result.resultHeaders.push_back(header);
@@ -156,29 +156,15 @@ public:
 
 private:
     ShortBatchResult &m_result;
-    xe::TestResultParser m_testResultParser;
+    xe::TestCaseResultStreamParser m_resultParser;
 };
 
 static void readLogFile(ShortBatchResult &batchResult, const char *filename)
 {
-    std::ifstream in(filename, std::ifstream::binary | std::ifstream::in);
     ShortResultHandler resultHandler(batchResult);
     xe::TestLogParser parser(&resultHandler);
-    uint8_t buf[1024];
-    int numRead = 0;
-
-    for (;;)
-    {
-        in.read((char *)&buf[0], DE_LENGTH_OF_ARRAY(buf));
-        numRead = (int)in.gcount();
-
-        if (numRead <= 0)
-            break;
 
-        parser.parse(&buf[0], numRead);
-    }
-
-    in.close();
+    xe::parseTestLogFile(parser, filename);
 }
 
 class LogFileReader : public de::Thread
@@ -192,12 +178,25 @@ public:
 
     void run(void)
     {
-        readLogFile(m_batchResult, m_filename.c_str());
+        try
+        {
+            readLogFile(m_batchResult, m_filename.c_str());
+        }
+        catch (const std::exception &e)
+        {
+            m_error = e.what();
+        }
+    }
+
+    const std::string &getError(void) const
+    {
+        return m_error;
     }
 
 private:
     ShortBatchResult &m_batchResult;
     std::string m_filename;
+    std::string m_error;
 };
 
 static void computeCaseList(vector<string> &cases, const vector<ShortBatchResult> &batchResults)
@@ -275,6 +274,9 @@ static bool runCompare(const CommandLine &cmdLine, std::ostream &dst)
             {
                 readers[ndx]->join();
 
+                if (!readers[ndx]->getError().empty())
+                    throw xe::Error(readers[ndx]->getError());
+
                 // Use file name as batch name.
                 batchNames.push_back(de::FilePath(cmdLine.filenames[ndx].c_str()).getBaseName());
             }
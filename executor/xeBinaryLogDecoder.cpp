@@ -0,0 +1,480 @@
+/*-------------------------------------------------------------------------
+ * drawElements Quality Program Test Executor
+ * ------------------------------------------
+ *
+ * Copyright (c) 2026 The Khronos Group Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *//*!
+ * \file
+ * \brief Binary test log decoder.
+ *//*--------------------------------------------------------------------*/
+
+#include "xeBinaryLogDecoder.hpp"
+#include "deInt32.h"
+#include "deMemory.h"
+#include "deString.h"
+
+#include <cstring>
+
+using std::string;
+using std::vector;
+
+namespace xe
+{
+
+// \note Must match qpXmlWriter.c.
+enum RecordType
+{
+    RECORDTYPE_RAW = 1,
+    RECORDTYPE_START_DOCUMENT,
+    RECORDTYPE_END_DOCUMENT,
+    RECORDTYPE_START_ELEMENT,
+    RECORDTYPE_END_ELEMENT,
+    RECORDTYPE_STRING,
+    RECORDTYPE_DATA,
+    RECORDTYPE_FLUSH,
+
+    RECORDTYPE_LAST
+};
+
+enum AttributeType
+{
+    ATTRIBUTETYPE_STRING = 0,
+    ATTRIBUTETYPE_INT,
+    ATTRIBUTETYPE_BOOL,
+
+    ATTRIBUTETYPE_LAST
+};
+
+enum
+{
+    FORMAT_VERSION     = 1,
+    RECORD_HEADER_SIZE = 5, //!< uint8 type, uint32 payload size.
+    MAX_INDENT         = 32
+};
+
+static const uint8_t s_magic[8] = {0x89, 'Q', 'P', 'B', '\r', '\n', 0x1a, '\n'};
+
+DE_STATIC_ASSERT(BINARY_LOG_HEADER_SIZE == sizeof(s_magic) + 4);
+
+static inline uint32_t readUint32(const uint8_t *ptr)
+{
+    return (uint32_t)ptr[0] | ((uint32_t)ptr[1] << 8) | ((uint32_t)ptr[2] << 16) | ((uint32_t)ptr[3] << 24);
+}
+
+namespace
+{
+
+//! Bounds-checked reader for record payload.
+class PayloadReader
+{
+public:
+    PayloadReader(const uint8_t *data, size_t size) : m_data(data), m_size(size), m_pos(0)
+    {
+    }
+
+    const uint8_t *getBytes(size_t numBytes)
+    {
+        if (m_size - m_pos < numBytes)
+            throw BinaryLogParseError("Truncated record in binary log");
+
+        const uint8_t *ptr = m_data + m_pos;
+        m_pos += numBytes;
+        return ptr;
+    }
+
+    uint8_t getUint8(void)
+    {
+        return *getBytes(1);
+    }
+
+    uint32_t getUint32(void)
+    {
+        return readUint32(getBytes(4));
+    }
+
+    string getString(void)
+    {
+        const size_t len = getUint32();
+        const char *str  = (const char *)getBytes(len);
+        return string(str, str + len);
+    }
+
+private:
+    const uint8_t *m_data;
+    size_t m_size;
+    size_t m_pos;
+};
+
+} // namespace
+
+static inline void append(vector<uint8_t> &dst, const char *str, size_t len)
+{
+    dst.insert(dst.end(), (const uint8_t *)str, (const uint8_t *)str + len);
+}
+
+static inline void append(vector<uint8_t> &dst, const char *str)
+{
+    append(dst, str, strlen(str));
+}
+
+static inline void append(vector<uint8_t> &dst, const string &str)
+{
+    append(dst, str.c_str(), str.size());
+}
+
+static void appendIndent(vector<uint8_t> &dst, int depth)
+{
+    dst.insert(dst.end(), (size_t)deMin32(depth, MAX_INDENT), (uint8_t)' ');
+}
+
+//! Escapes string the same way as qpXmlWriter.
+static void appendEscaped(vector<uint8_t> &dst, const char *str, size_t len)
+{
+    // Tab and line breaks are written as-is, other control characters by name.
+    static const char *const s_controlNames[32] = {DE_NULL, "SOH", "STX", "ETX", "EOT", "ENQ", "ACK", "BEL", "BS",
+                                                   DE_NULL, DE_NULL, "VT", "FF", DE_NULL, "SO", "SI", "DLE", "DC1",
+                                                   "DC2", "DC3", "DC4", "NAK", "SYN", "ETB", "CAN", "EM", "SUB", "ESC",
+                                                   "FS", "GS", "RS", "US"};
+
+    for (size_t ndx = 0; ndx < len; ndx++)
+    {
+        const char c = str[ndx];
+
+        switch (c)
+        {
+        case 0:
+            return; // qpXmlWriter stops at terminator.
+        case '<':
+            append(dst, "&lt;");
+            break;
+        case '>':
+            append(dst, "&gt;");
+            break;
+        case '&':
+            append(dst, "&amp;");
+            break;
+        case '\'':
+            append(dst, "&apos;");
+            break;
+        case '"':
+            append(dst, "&quot;");
+            break;
+
+        default:
+            if ((uint8_t)c < 32 && s_controlNames[(uint8_t)c])
+            {
+                append(dst, "&lt;");
+                append(dst, s_controlNames[(uint8_t)c]);
+                append(dst, "&gt;");
+            }
+            else
+                dst.push_back((uint8_t)c);
+            break;
+        }
+    }
+}
+
+static void appendBase64(vector<uint8_t> &dst, const uint8_t *data, size_t numBytes, int depth)
+{
+    static const char s_base64Table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    size_t lineLen = 0;
+
+    for (size_t srcNdx = 0; srcNdx < numBytes; srcNdx += 3)
+    {
+        const size_t numRead = de::min<size_t>(3, numBytes - srcNdx);
+        const uint8_t s0     = data[srcNdx];
+        const uint8_t s1     = (numRead >= 2) ? data[srcNdx + 1] : 0;
+        const uint8_t s2     = (numRead >= 3) ? data[srcNdx + 2] : 0;
+        char d[4];
+
+        if (lineLen == 0)
+            appendIndent(dst, depth);
+
+        d[0] = s_base64Table[s0 >> 2];
+        d[1] = s_base64Table[((s0 & 0x3) << 4) | (s1 >> 4)];
+        d[2] = numRead >= 2 ? s_base64Table[((s1 & 0xF) << 2) | (s2 >> 6)] : '=';
+        d[3] = numRead >= 3 ? s_base64Table[s2 & 0x3F] : '=';
+
+        append(dst, d, 4);
+        lineLen += 4;
+
+        if (lineLen >= 64)
+        {
+            dst.push_back('\n');
+            lineLen = 0;
+        }
+    }
+
+    if (lineLen > 0)
+        dst.push_back('\n');
+}
+
+bool isBinaryLogPrefix(const uint8_t *bytes, size_t numBytes)
+{
+    return deMemCmp(bytes, s_magic, de::min(numBytes, sizeof(s_magic))) == 0;
+}
+
+bool isBinaryLog(const uint8_t *bytes, size_t numBytes)
+{
+    return numBytes >= BINARY_LOG_HEADER_SIZE && deMemCmp(bytes, s_magic, sizeof(s_magic)) == 0 &&
+           readUint32(bytes + sizeof(s_magic)) == FORMAT_VERSION;
+}
+
+namespace
+{
+
+//! Concatenates all output.
+class VectorSink : public BinaryLogSink
+{
+public:
+    VectorSink(vector<uint8_t> &dst) : m_dst(dst)
+    {
+    }
+
+    void containerData(const uint8_t *bytes, size_t numBytes)
+    {
+        m_dst.insert(m_dst.end(), bytes, bytes + numBytes);
+    }
+
+    void logData(const uint8_t *bytes, size_t numBytes)
+    {
+        m_dst.insert(m_dst.end(), bytes, bytes + numBytes);
+    }
+
+private:
+    vector<uint8_t> &m_dst;
+};
+
+} // namespace
+
+BinaryLogDecoder::BinaryLogDecoder(void) : m_headerParsed(false), m_elementDepth(0), m_prevIsStartElement(false)
+{
+}
+
+BinaryLogDecoder::~BinaryLogDecoder(void)
+{
+}
+
+void BinaryLogDecoder::clear(void)
+{
+    m_pending.clear();
+    m_logData.clear();
+    m_headerParsed       = false;
+    m_elementDepth       = 0;
+    m_prevIsStartElement = false;
+}
+
+void BinaryLogDecoder::decode(const uint8_t *bytes, size_t numBytes, BinaryLogSink &sink)
+{
+    if (m_pending.empty())
+    {
+        const size_t numConsumed = decodeRecords(bytes, numBytes, sink);
+        m_pending.assign(bytes + numConsumed, bytes + numBytes);
+    }
+    else
+    {
+        m_pending.insert(m_pending.end(), bytes, bytes + numBytes);
+
+        const size_t numConsumed = decodeRecords(&m_pending[0], m_pending.size(), sink);
+        m_pending.erase(m_pending.begin(), m_pending.begin() + numConsumed);
+    }
+}
+
+void BinaryLogDecoder::decode(const uint8_t *bytes, size_t numBytes, vector<uint8_t> &dst)
+{
+    VectorSink sink(dst);
+    decode(bytes, numBytes, sink);
+}
+
+void BinaryLogDecoder::flushLogData(BinaryLogSink &sink)
+{
+    if (!m_logData.empty())
+    {
+        sink.logData(&m_logData[0], m_logData.size());
+        m_logData.clear();
+    }
+}
+
+//! Decodes all complete records, returns number of bytes consumed.
+size_t BinaryLogDecoder::decodeRecords(const uint8_t *bytes, size_t numBytes, BinaryLogSink &sink)
+{
+    size_t pos = 0;
+
+    if (!m_headerParsed)
+    {
+        if (numBytes < BINARY_LOG_HEADER_SIZE)
+            return 0;
+
+        if (deMemCmp(bytes, s_magic, sizeof(s_magic)) != 0)
+            throw BinaryLogParseError("Invalid binary log header");
+
+        if (readUint32(bytes + sizeof(s_magic)) != FORMAT_VERSION)
+            throw BinaryLogParseError("Unsupported binary log version");
+
+        m_headerParsed = true;
+        pos            = BINARY_LOG_HEADER_SIZE;
+    }
+
+    while (numBytes - pos >= RECORD_HEADER_SIZE)
+    {
+        const int type           = bytes[pos];
+        const size_t payloadSize = readUint32(bytes + pos + 1);
+
+        if (numBytes - pos - RECORD_HEADER_SIZE < payloadSize)
+            break;
+
+        decodeRecord(type, bytes + pos + RECORD_HEADER_SIZE, payloadSize, sink);
+        pos += RECORD_HEADER_SIZE + payloadSize;
+    }
+
+    flushLogData(sink);
+
+    return pos;
+}
+
+void BinaryLogDecoder::closePending(vector<uint8_t> &dst)
+{
+    if (m_prevIsStartElement)
+    {
+        append(dst, ">\n");
+        m_prevIsStartElement = false;
+    }
+}
+
+void BinaryLogDecoder::decodeRecord(int type, const uint8_t *payload, size_t payloadSize, BinaryLogSink &sink)
+{
+    PayloadReader reader(payload, payloadSize);
+    vector<uint8_t> &dst = m_logData;
+
+    switch (type)
+    {
+    case RECORDTYPE_RAW:
+        // Log data written so far must reach sink before the container data that follows it.
+        flushLogData(sink);
+        sink.containerData(payload, payloadSize);
+        break;
+
+    case RECORDTYPE_START_DOCUMENT:
+        m_elementDepth       = 0;
+        m_prevIsStartElement = false;
+
+        if (reader.getUint8() != 0)
+            append(dst, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+        break;
+
+    case RECORDTYPE_END_DOCUMENT:
+    case RECORDTYPE_FLUSH:
+        closePending(dst);
+        break;
+
+    case RECORDTYPE_START_ELEMENT:
+    {
+        const string name         = reader.getString();
+        const uint32_t numAttribs = reader.getUint32();
+
+        closePending(dst);
+
+        appendIndent(dst, m_elementDepth);
+        dst.push_back('<');
+        append(dst, name);
+
+        for (uint32_t attribNdx = 0; attribNdx < numAttribs; attribNdx++)
+        {
+            const string attribName = reader.getString();
+            const int attribType    = reader.getUint8();
+
+            dst.push_back(' ');
+            append(dst, attribName);
+            append(dst, "=\"");
+
+            switch (attribType)
+            {
+            case ATTRIBUTETYPE_STRING:
+            {
+                const string value = reader.getString();
+                appendEscaped(dst, value.c_str(), value.size());
+                break;
+            }
+
+            case ATTRIBUTETYPE_INT:
+            {
+                char buf[64];
+                deSprintf(buf, sizeof(buf), "%d", (int)reader.getUint32());
+                append(dst, buf);
+                break;
+            }
+
+            case ATTRIBUTETYPE_BOOL:
+                append(dst, reader.getUint8() != 0 ? "True" : "False");
+                break;
+
+            default:
+                throw BinaryLogParseError("Unknown attribute type in binary log");
+            }
+
+            dst.push_back('"');
+        }
+
+        m_elementDepth += 1;
+        m_prevIsStartElement = true;
+        break;
+    }
+
+    case RECORDTYPE_END_ELEMENT:
+    {
+        const string name = reader.getString();
+
+        if (m_elementDepth <= 0)
+            throw BinaryLogParseError("Unexpected end of element in binary log");
+
+        m_elementDepth -= 1;
+
+        if (m_prevIsStartElement)
+        {
+            append(dst, " />\n");
+            m_prevIsStartElement = false;
+        }
+        else
+        {
+            append(dst, "</");
+            append(dst, name);
+            append(dst, ">\n");
+        }
+        break;
+    }
+
+    case RECORDTYPE_STRING:
+        if (m_prevIsStartElement)
+        {
+            dst.push_back('>');
+            m_prevIsStartElement = false;
+        }
+
+        appendEscaped(dst, (const char *)payload, payloadSize);
+        break;
+
+    case RECORDTYPE_DATA:
+        closePending(dst);
+        appendBase64(dst, payload, payloadSize, m_elementDepth);
+        break;
+
+    default:
+        throw BinaryLogParseError("Unknown record type in binary log");
+    }
+}
+
+} // namespace xe
@@ -0,0 +1,110 @@
+#ifndef _XEBINARYLOGDECODER_HPP
+#define _XEBINARYLOGDECODER_HPP
+/*-------------------------------------------------------------------------
+ * drawElements Quality Program Test Executor
+ * ------------------------------------------
+ *
+ * Copyright (c) 2026 The Khronos Group Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *//*!
+ * \file
+ * \brief Binary test log decoder.
+ *//*--------------------------------------------------------------------*/
+
+#include "xeDefs.hpp"
+
+#include <string>
+#include <vector>
+
+namespace xe
+{
+
+class BinaryLogParseError : public ParseError
+{
+public:
+    BinaryLogParseError(const std::string &message) : ParseError(message)
+    {
+    }
+};
+
+enum
+{
+    BINARY_LOG_HEADER_SIZE = 12 //!< Magic and format version.
+};
+
+//! Returns true if data could be the beginning of a binary test log, i.e. it matches the start of the magic.
+bool isBinaryLogPrefix(const uint8_t *bytes, size_t numBytes);
+
+//! Returns true if data starts with binary test log magic and supported format version. Needs at least
+//! BINARY_LOG_HEADER_SIZE bytes.
+bool isBinaryLog(const uint8_t *bytes, size_t numBytes);
+
+//! Receives decoded binary log.
+class BinaryLogSink
+{
+public:
+    virtual ~BinaryLogSink(void)
+    {
+    }
+
+    //! Container format data (#beginSession etc.) as written by the test binary.
+    virtual void containerData(const uint8_t *bytes, size_t numBytes) = 0;
+
+    //! Test log XML decoded from records written between container data.
+    virtual void logData(const uint8_t *bytes, size_t numBytes) = 0;
+};
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Binary test log decoder
+ *
+ * Decodes binary test log written with QP_TEST_LOG_BINARY_FORMAT.
+ * Container format data is passed through as is and log records are
+ * converted to XML; concatenated output is identical to the log the test
+ * binary would have written without the flag. Data can be fed in pieces
+ * of any size; incomplete records are kept until the rest is fed.
+ *//*--------------------------------------------------------------------*/
+class BinaryLogDecoder
+{
+public:
+    BinaryLogDecoder(void);
+    ~BinaryLogDecoder(void);
+
+    void clear(void);
+
+    //! Decode bytes and pass output to sink.
+    void decode(const uint8_t *bytes, size_t numBytes, BinaryLogSink &sink);
+
+    //! Decode bytes and append container format output to dst.
+    void decode(const uint8_t *bytes, size_t numBytes, std::vector<uint8_t> &dst);
+
+private:
+    BinaryLogDecoder(const BinaryLogDecoder &other);
+    BinaryLogDecoder &operator=(const BinaryLogDecoder &other);
+
+    size_t decodeRecords(const uint8_t *bytes, size_t numBytes, BinaryLogSink &sink);
+    void decodeRecord(int type, const uint8_t *payload, size_t payloadSize, BinaryLogSink &sink);
+    void flushLogData(BinaryLogSink &sink);
+    void closePending(std::vector<uint8_t> &dst);
+
+    std::vector<uint8_t> m_pending; //!< Incomplete record.
+    std::vector<uint8_t> m_logData; //!< XML decoded since last container data.
+    bool m_headerParsed;
+    int m_elementDepth;
+    bool m_prevIsStartElement;
+};
+
+} // namespace xe
+
+#endif // _XEBINARYLOGDECODER_HPP
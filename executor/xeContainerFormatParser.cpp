@@ -22,26 +22,29 @@
  *//*--------------------------------------------------------------------*/
 
 #include "xeContainerFormatParser.hpp"
-#include "deInt32.h"
+#include "deMemory.h"
 
 namespace xe
 {
 
 enum
 {
-    CONTAINERFORMATPARSER_INITIAL_BUFFER_SIZE = 1024
+    CONTAINERFORMATPARSER_MAX_ELEMENT_SIZE = 0x7fffffff
 };
 
-static int getNextBufferSize(int curSize, int minNewSize)
+static inline bool isLineEnd(uint8_t c)
 {
-    return de::max(curSize * 2, 1 << deLog2Ceil32(minNewSize));
+    return c == '\n' || c == '\r' || c == 0;
 }
 
 ContainerFormatParser::ContainerFormatParser(void)
     : m_element(CONTAINERELEMENT_INCOMPLETE)
     , m_elementLen(0)
     , m_state(STATE_AT_LINE_START)
-    , m_buf(CONTAINERFORMATPARSER_INITIAL_BUFFER_SIZE)
+    , m_carryPos(0)
+    , m_input(DE_NULL)
+    , m_inputSize(0)
+    , m_inputPos(0)
 {
 }
 
@@ -54,7 +57,11 @@ void ContainerFormatParser::clear(void)
     m_element    = CONTAINERELEMENT_INCOMPLETE;
     m_elementLen = 0;
     m_state      = STATE_AT_LINE_START;
-    m_buf.clear();
+    m_carry.clear();
+    m_carryPos  = 0;
+    m_input     = DE_NULL;
+    m_inputSize = 0;
+    m_inputPos  = 0;
 }
 
 void ContainerFormatParser::error(const std::string &what)
@@ -64,12 +71,13 @@ void ContainerFormatParser::error(const std::string &what)
 
 void ContainerFormatParser::feed(const uint8_t *bytes, size_t numBytes)
 {
-    // Grow buffer if necessary.
-    if (m_buf.getNumFree() < (int)numBytes)
-        m_buf.resize(getNextBufferSize(m_buf.getSize(), m_buf.getNumElements() + (int)numBytes));
+    // Previous buffer may still hold a complete element that hasn't been advanced past.
+    if (m_inputPos < m_inputSize)
+        m_carry.insert(m_carry.end(), m_input + m_inputPos, m_input + m_inputSize);
 
-    // Append to front.
-    m_buf.pushFront(bytes, (int)numBytes);
+    m_input     = bytes;
+    m_inputSize = numBytes;
+    m_inputPos  = 0;
 
     // If we haven't parsed complete element, re-try after data feed.
     if (m_element == CONTAINERELEMENT_INCOMPLETE)
@@ -106,20 +114,44 @@ int ContainerFormatParser::getDataSize(void) const
     return m_elementLen;
 }
 
+const uint8_t *ContainerFormatParser::getDataPtr(void) const
+{
+    DE_ASSERT(m_element == CONTAINERELEMENT_TEST_LOG_DATA);
+    int numBytes = 0;
+    return getBuffer(numBytes);
+}
+
 void ContainerFormatParser::getData(uint8_t *dst, int numBytes, int offset)
 {
     DE_ASSERT(de::inBounds(offset, 0, m_elementLen) && numBytes > 0 && de::inRange(numBytes + offset, 0, m_elementLen));
 
-    for (int ndx = 0; ndx < numBytes; ndx++)
-        dst[ndx] = m_buf.peekBack(offset + ndx);
+    deMemcpy(dst, getDataPtr() + offset, (size_t)numBytes);
+}
+
+//! Returns unparsed bytes starting from current element. Elements never span carry and input.
+const uint8_t *ContainerFormatParser::getBuffer(int &numBytes) const
+{
+    if (!m_carry.empty())
+    {
+        numBytes = (int)de::min<size_t>(m_carry.size() - m_carryPos, CONTAINERFORMATPARSER_MAX_ELEMENT_SIZE);
+        return &m_carry[m_carryPos];
+    }
+    else
+    {
+        numBytes = (int)de::min<size_t>(m_inputSize - m_inputPos, CONTAINERFORMATPARSER_MAX_ELEMENT_SIZE);
+        return m_input + m_inputPos;
+    }
 }
 
 int ContainerFormatParser::getChar(int offset) const
 {
-    DE_ASSERT(de::inRange(offset, 0, m_buf.getNumElements()));
+    int numBytes       = 0;
+    const uint8_t *buf = getBuffer(numBytes);
 
-    if (offset < m_buf.getNumElements())
-        return m_buf.peekBack(offset);
+    DE_ASSERT(de::inRange(offset, 0, numBytes));
+
+    if (offset < numBytes)
+        return buf[offset];
     else
         return END_OF_BUFFER;
 }
@@ -130,11 +162,31 @@ const char *ContainerFormatParser::getTestRunsParams(void) const
     return m_value.c_str();
 }
 
+void ContainerFormatParser::consume(int numBytes)
+{
+    if (!m_carry.empty())
+    {
+        m_carryPos += (size_t)numBytes;
+        DE_ASSERT(m_carryPos <= m_carry.size());
+
+        if (m_carryPos == m_carry.size())
+        {
+            m_carry.clear();
+            m_carryPos = 0;
+        }
+    }
+    else
+    {
+        m_inputPos += (size_t)numBytes;
+        DE_ASSERT(m_inputPos <= m_inputSize);
+    }
+}
+
 void ContainerFormatParser::advance(void)
 {
     if (m_element != CONTAINERELEMENT_INCOMPLETE)
     {
-        m_buf.popBack(m_elementLen);
+        consume(m_elementLen);
 
         m_element    = CONTAINERELEMENT_INCOMPLETE;
         m_elementLen = 0;
@@ -144,51 +196,105 @@ void ContainerFormatParser::advance(void)
 
     for (;;)
     {
-        int curChar = getChar(m_elementLen);
+        scanElement();
 
-        if (curChar != (int)END_OF_BUFFER)
-            m_elementLen += 1;
+        if (m_element != CONTAINERELEMENT_INCOMPLETE || m_carry.empty() || m_inputPos == m_inputSize)
+            break;
 
-        if (curChar == END_OF_STRING)
+        // Element continues from carry into input. Move up to the next line end over to keep it contiguous.
         {
-            if (m_elementLen == 1)
-                m_element = CONTAINERELEMENT_END_OF_STRING;
-            else if (m_state == STATE_CONTAINER_LINE)
-                parseContainerLine();
-            else
-                m_element = CONTAINERELEMENT_TEST_LOG_DATA;
+            const uint8_t *src = m_input + m_inputPos;
+            const size_t avail = m_inputSize - m_inputPos;
+            size_t numBytes    = 0;
 
-            break;
+            while (numBytes < avail && src[numBytes] != '\n' && src[numBytes] != 0)
+                numBytes += 1;
+
+            numBytes = de::min(numBytes + 1, avail);
+
+            m_carry.insert(m_carry.end(), src, src + numBytes);
+            m_inputPos += numBytes;
         }
-        else if (curChar == (int)END_OF_BUFFER)
+    }
+
+    // Input buffer is not valid after returning incomplete; keep the tail.
+    if (m_element == CONTAINERELEMENT_INCOMPLETE && m_inputPos < m_inputSize)
+    {
+        m_carry.insert(m_carry.end(), m_input + m_inputPos, m_input + m_inputSize);
+        m_inputPos = m_inputSize;
+    }
+}
+
+void ContainerFormatParser::scanElement(void)
+{
+    int numBytes       = 0;
+    const uint8_t *buf = getBuffer(numBytes);
+    int pos            = m_elementLen;
+
+    DE_ASSERT(m_element == CONTAINERELEMENT_INCOMPLETE);
+
+    while (m_element == CONTAINERELEMENT_INCOMPLETE)
+    {
+        if (pos == numBytes)
         {
-            if (m_elementLen > 0 && m_state == STATE_DATA)
+            // Log data can be returned in pieces, container lines are kept until complete.
+            if (pos > 0 && m_state != STATE_CONTAINER_LINE)
                 m_element = CONTAINERELEMENT_TEST_LOG_DATA;
 
             break;
         }
-        else if (curChar == '\r' || curChar == '\n')
+
+        if (m_state == STATE_AT_LINE_START)
         {
-            // Check for \r\n
-            int nextChar = getChar(m_elementLen);
-            if (curChar == '\n' || (nextChar != (int)END_OF_BUFFER && nextChar != '\n'))
-            {
-                if (m_state == STATE_CONTAINER_LINE)
-                    parseContainerLine();
-                else
-                    m_element = CONTAINERELEMENT_TEST_LOG_DATA;
+            const uint8_t curChar = buf[pos];
 
-                m_state = STATE_AT_LINE_START;
-                break;
+            if (pos > 0 && (curChar == '#' || curChar == END_OF_STRING))
+                m_element = CONTAINERELEMENT_TEST_LOG_DATA; // End of data lines.
+            else if (curChar == END_OF_STRING)
+            {
+                pos += 1;
+                m_element = CONTAINERELEMENT_END_OF_STRING;
             }
-            // else handle following end or \n in next iteration.
+            else
+                m_state = (curChar == '#') ? STATE_CONTAINER_LINE : STATE_DATA;
         }
-        else if (m_state == STATE_AT_LINE_START)
+        else
         {
-            DE_ASSERT(m_elementLen == 1);
-            m_state = (curChar == '#') ? STATE_CONTAINER_LINE : STATE_DATA;
+            while (pos < numBytes && !isLineEnd(buf[pos]))
+                pos += 1;
+
+            if (pos == numBytes)
+                continue;
+
+            const bool isEndOfString = buf[pos] == END_OF_STRING;
+
+            if (buf[pos] == '\r')
+            {
+                // Check for \r\n
+                if (pos + 1 < numBytes)
+                    pos += (buf[pos + 1] == '\n') ? 2 : 1;
+                else if (m_state == STATE_DATA)
+                    pos += 1; // Following \n, if any, is returned as separate data.
+                else
+                    break; // Wait for next byte.
+            }
+            else if (buf[pos] == '\n')
+                pos += 1;
+            // else end of string is returned as a separate element.
+
+            if (m_state == STATE_CONTAINER_LINE)
+            {
+                m_elementLen = pos;
+                parseContainerLine();
+            }
+            else if (isEndOfString)
+                m_element = CONTAINERELEMENT_TEST_LOG_DATA;
+
+            m_state = STATE_AT_LINE_START;
         }
     }
+
+    m_elementLen = pos;
 }
 
 void ContainerFormatParser::parseContainerLine(void)
@@ -24,7 +24,8 @@
  *//*--------------------------------------------------------------------*/
 
 #include "xeDefs.hpp"
-#include "deRingBuffer.hpp"
+
+#include <vector>
 
 namespace xe
 {
@@ -56,6 +57,15 @@ public:
     }
 };
 
+/*--------------------------------------------------------------------*//*!
+ * \brief Test log container format parser
+ *
+ * Elements are tokenized directly from the buffer given to feed() and
+ * TEST_LOG_DATA is exposed as a pointer into it. Consecutive log data
+ * lines are returned as a single element. Only the unparsed tail of the
+ * buffer is copied when getElement() returns CONTAINERELEMENT_INCOMPLETE,
+ * so the buffer must stay valid until then.
+ *//*--------------------------------------------------------------------*/
 class ContainerFormatParser
 {
 public:
@@ -84,6 +94,7 @@ public:
 
     // TEST_LOG_DATA
     int getDataSize(void) const;
+    const uint8_t *getDataPtr(void) const;
     void getData(uint8_t *dst, int numBytes, int offset);
 
     // TEST_RUN_PARAM
@@ -110,7 +121,10 @@ private:
         END_OF_BUFFER = 0xffffffff //!< End of current data buffer.
     };
 
+    const uint8_t *getBuffer(int &numBytes) const;
     int getChar(int offset) const;
+    void scanElement(void);
+    void consume(int numBytes);
     void parseContainerLine(void);
     void parseContainerValue(std::string &dst, int &offset) const;
 
@@ -120,7 +134,11 @@ private:
     std::string m_attribute;
     std::string m_value;
 
-    de::RingBuffer<uint8_t> m_buf;
+    std::vector<uint8_t> m_carry; //!< Unparsed bytes from previous buffers, precede m_input.
+    size_t m_carryPos;
+    const uint8_t *m_input; //!< Buffer given to feed(), not owned.
+    size_t m_inputSize;
+    size_t m_inputPos;
 };
 
 } // namespace xe
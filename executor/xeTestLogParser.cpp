@@ -22,6 +22,8 @@
  *//*--------------------------------------------------------------------*/
 
 #include "xeTestLogParser.hpp"
+#include "deFile.h"
+#include "deMemory.h"
 #include "deString.h"
 
 using std::map;
@@ -31,7 +33,23 @@ using std::vector;
 namespace xe
 {
 
-TestLogParser::TestLogParser(TestLogHandler *handler) : m_handler(handler), m_inSession(false)
+enum
+{
+    TESTLOGFILE_READ_BUFFER_SIZE = 1024 * 1024
+};
+
+void TestLogHandler::testCaseResultData(const TestCaseResultPtr &resultData, const uint8_t *bytes, size_t numBytes)
+{
+    const int offset = resultData->getDataSize();
+
+    resultData->setDataSize(offset + (int)numBytes);
+    deMemcpy(resultData->getData() + offset, bytes, numBytes);
+}
+
+TestLogParser::TestLogParser(TestLogHandler *handler)
+    : m_format(FORMAT_UNKNOWN)
+    , m_handler(handler)
+    , m_inSession(false)
 {
 }
 
@@ -41,6 +59,9 @@ TestLogParser::~TestLogParser(void)
 
 void TestLogParser::reset(void)
 {
+    m_format = FORMAT_UNKNOWN;
+    m_formatData.clear();
+    m_binaryDecoder.clear();
     m_containerParser.clear();
     m_currentCaseData.clear();
     m_sessionInfo = SessionInfo();
@@ -48,9 +69,66 @@ void TestLogParser::reset(void)
 }
 
 void TestLogParser::parse(const uint8_t *bytes, size_t numBytes)
+{
+    if (m_format == FORMAT_UNKNOWN)
+    {
+        // Binary log is recognized from the full header; keep data until it can be checked.
+        m_formatData.insert(m_formatData.end(), bytes, bytes + numBytes);
+
+        if (m_formatData.empty())
+            return;
+
+        if (!isBinaryLogPrefix(&m_formatData[0], m_formatData.size()))
+            m_format = FORMAT_TEXT;
+        else if (m_formatData.size() < BINARY_LOG_HEADER_SIZE)
+            return;
+        else if (isBinaryLog(&m_formatData[0], m_formatData.size()))
+            m_format = FORMAT_BINARY;
+        else
+            throw BinaryLogParseError("Unsupported binary log version");
+
+        const vector<uint8_t> formatData(m_formatData);
+        m_formatData.clear();
+        parseFormat(&formatData[0], formatData.size());
+    }
+    else
+        parseFormat(bytes, numBytes);
+}
+
+void TestLogParser::parseFormat(const uint8_t *bytes, size_t numBytes)
+{
+    if (m_format == FORMAT_BINARY)
+        m_binaryDecoder.decode(bytes, numBytes, *static_cast<BinaryLogSink *>(this));
+    else
+    {
+        m_containerParser.feed(bytes, numBytes);
+        processContainerElements();
+    }
+}
+
+void TestLogParser::containerData(const uint8_t *bytes, size_t numBytes)
 {
     m_containerParser.feed(bytes, numBytes);
+    processContainerElements();
+}
+
+void TestLogParser::logData(const uint8_t *bytes, size_t numBytes)
+{
+    // Decoded log goes straight to the current case, it doesn't need to be tokenized as container data.
+    processLogData(bytes, numBytes);
+}
+
+void TestLogParser::processLogData(const uint8_t *bytes, size_t numBytes)
+{
+    if (m_currentCaseData)
+    {
+        m_handler->testCaseResultData(m_currentCaseData, bytes, numBytes);
+        m_handler->testCaseResultUpdated(m_currentCaseData);
+    }
+}
 
+void TestLogParser::processContainerElements(void)
+{
     for (;;)
     {
         ContainerElement element = m_containerParser.getElement();
@@ -164,16 +242,7 @@ void TestLogParser::parse(const uint8_t *bytes, size_t numBytes)
             break;
 
         case CONTAINERELEMENT_TEST_LOG_DATA:
-            if (m_currentCaseData)
-            {
-                int offset       = m_currentCaseData->getDataSize();
-                int numDataBytes = m_containerParser.getDataSize();
-
-                m_currentCaseData->setDataSize(offset + numDataBytes);
-                m_containerParser.getData(m_currentCaseData->getData() + offset, numDataBytes, 0);
-
-                m_handler->testCaseResultUpdated(m_currentCaseData);
-            }
+            processLogData(m_containerParser.getDataPtr(), (size_t)m_containerParser.getDataSize());
             break;
 
         default:
@@ -184,4 +253,28 @@ void TestLogParser::parse(const uint8_t *bytes, size_t numBytes)
     }
 }
 
+void parseTestLogFile(TestLogParser &parser, const char *filename)
+{
+    deFile *const file = deFile_create(filename, DE_FILEMODE_OPEN | DE_FILEMODE_READ);
+    vector<uint8_t> buf(TESTLOGFILE_READ_BUFFER_SIZE);
+    int64_t numRead = 0;
+
+    if (!file)
+        throw Error(string("Failed to open '") + filename + "'");
+
+    try
+    {
+        // Container parser tokenizes straight from the read buffer.
+        while (deFile_read(file, &buf[0], (int64_t)buf.size(), &numRead) == DE_FILERESULT_SUCCESS && numRead > 0)
+            parser.parse(&buf[0], (size_t)numRead);
+    }
+    catch (...)
+    {
+        deFile_destroy(file);
+        throw;
+    }
+
+    deFile_destroy(file);
+}
+
 } // namespace xe
@@ -26,6 +26,7 @@
 #include "xeDefs.hpp"
 #include "xeTestCaseResult.hpp"
 #include "xeContainerFormatParser.hpp"
+#include "xeBinaryLogDecoder.hpp"
 #include "xeTestResultParser.hpp"
 #include "xeBatchResult.hpp"
 
@@ -48,9 +49,14 @@ public:
     virtual TestCaseResultPtr startTestCaseResult(const char *casePath)      = 0;
     virtual void testCaseResultUpdated(const TestCaseResultPtr &resultData)  = 0;
     virtual void testCaseResultComplete(const TestCaseResultPtr &resultData) = 0;
+
+    //! Called with each piece of test case log data before testCaseResultUpdated(). Bytes are only valid
+    //! during the call. Default implementation appends them to resultData; handlers that parse the log
+    //! incrementally can override this to avoid storing it.
+    virtual void testCaseResultData(const TestCaseResultPtr &resultData, const uint8_t *bytes, size_t numBytes);
 };
 
-class TestLogParser
+class TestLogParser : private BinaryLogSink
 {
 public:
     TestLogParser(TestLogHandler *handler);
@@ -64,6 +70,27 @@ private:
     TestLogParser(const TestLogParser &other);
     TestLogParser &operator=(const TestLogParser &other);
 
+    void parseFormat(const uint8_t *bytes, size_t numBytes);
+    void processContainerElements(void);
+    void processLogData(const uint8_t *bytes, size_t numBytes);
+
+    // BinaryLogSink
+    void containerData(const uint8_t *bytes, size_t numBytes);
+    void logData(const uint8_t *bytes, size_t numBytes);
+
+    enum Format
+    {
+        FORMAT_UNKNOWN = 0, //!< Not known until binary log header can be ruled out or checked.
+        FORMAT_TEXT,
+        FORMAT_BINARY,
+
+        FORMAT_LAST
+    };
+
+    Format m_format;
+    std::vector<uint8_t> m_formatData; //!< Data received while format is unknown.
+    BinaryLogDecoder m_binaryDecoder;
+
     ContainerFormatParser m_containerParser;
     TestLogHandler *m_handler;
 
@@ -72,6 +99,9 @@ private:
     bool m_inSession;
 };
 
+//! Parse test log file. File is read and fed to parser in large pieces.
+void parseTestLogFile(TestLogParser &parser, const char *filename);
+
 } // namespace xe
 
 #endif // _XETESTLOGPARSER_HPP
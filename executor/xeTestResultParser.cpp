@@ -926,4 +926,88 @@ void parseTestCaseResultFromData(TestResultParser *parser, TestCaseResult *resul
     DE_ASSERT(result->statusCode != TESTSTATUSCODE_LAST);
 }
 
+// TestCaseResultStreamParser
+
+TestCaseResultStreamParser::TestCaseResultStreamParser(void)
+    : m_parseResult(TestResultParser::PARSERESULT_NOT_CHANGED)
+    , m_hasData(false)
+{
+}
+
+TestCaseResultStreamParser::~TestCaseResultStreamParser(void)
+{
+}
+
+void TestCaseResultStreamParser::begin(const char *casePath)
+{
+    m_result = de::MovePtr<TestCaseResult>(new TestCaseResult());
+
+    // Status is resolved in finish(), unless parsed from <Result>.
+    m_result->casePath   = casePath;
+    m_result->caseType   = TESTCASETYPE_SELF_VALIDATE;
+    m_result->statusCode = TESTSTATUSCODE_LAST;
+
+    m_parser.init(m_result.get());
+
+    m_parseResult = TestResultParser::PARSERESULT_NOT_CHANGED;
+    m_hasData     = false;
+}
+
+void TestCaseResultStreamParser::feed(const uint8_t *bytes, size_t numBytes)
+{
+    DE_ASSERT(m_result);
+
+    if (numBytes == 0)
+        return;
+
+    m_hasData = true;
+
+    // Parser state is undefined after an error.
+    if (m_parseResult != TestResultParser::PARSERESULT_ERROR)
+        m_parseResult = m_parser.parse(bytes, (int)numBytes);
+}
+
+const TestCaseResult &TestCaseResultStreamParser::finish(const TestCaseResultData &data)
+{
+    TestCaseResult *const result = m_result.get();
+
+    DE_ASSERT(result && data.getDataSize() == 0);
+
+    if (result->statusCode == TESTSTATUSCODE_LAST)
+    {
+        result->statusCode    = data.getStatusCode();
+        result->statusDetails = data.getStatusDetails();
+    }
+
+    if (m_hasData)
+    {
+        if (result->statusCode == TESTSTATUSCODE_LAST)
+        {
+            result->statusCode = TESTSTATUSCODE_INTERNAL_ERROR;
+
+            if (m_parseResult == TestResultParser::PARSERESULT_ERROR)
+                result->statusDetails = "Test case result parsing failed";
+            else if (m_parseResult != TestResultParser::PARSERESULT_COMPLETE)
+                result->statusDetails = "Incomplete test case result";
+            else
+                result->statusDetails = "Test case result is missing <Result> item";
+        }
+    }
+    else if (result->statusCode == TESTSTATUSCODE_LAST)
+    {
+        result->statusCode    = TESTSTATUSCODE_TERMINATED;
+        result->statusDetails = "Empty test case result";
+    }
+
+    if (result->casePath.empty())
+        throw Error("Empty test case path in result");
+
+    if (result->caseType == TESTCASETYPE_LAST)
+        throw Error("Invalid test case type in result");
+
+    DE_ASSERT(result->statusCode != TESTSTATUSCODE_LAST);
+
+    return *result;
+}
+
 } // namespace xe
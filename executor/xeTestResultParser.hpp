@@ -26,6 +26,7 @@
 #include "xeDefs.hpp"
 #include "xeXMLParser.hpp"
 #include "xeTestCaseResult.hpp"
+#include "deUniquePtr.hpp"
 
 #include <vector>
 
@@ -122,6 +123,35 @@ class TestCaseResultData;
 
 void parseTestCaseResultFromData(TestResultParser *parser, TestCaseResult *result, const TestCaseResultData &data);
 
+/*--------------------------------------------------------------------*//*!
+ * \brief Streaming test case result parser
+ *
+ * Parses log data of a single test case piece by piece as it is received
+ * from TestLogParser, without collecting it into TestCaseResultData first.
+ * Final result is the same as with parseTestCaseResultFromData().
+ *//*--------------------------------------------------------------------*/
+class TestCaseResultStreamParser
+{
+public:
+    TestCaseResultStreamParser(void);
+    ~TestCaseResultStreamParser(void);
+
+    void begin(const char *casePath);
+    void feed(const uint8_t *bytes, size_t numBytes);
+
+    //! Applies status from data (which is not expected to contain log data) and returns result.
+    const TestCaseResult &finish(const TestCaseResultData &data);
+
+private:
+    TestCaseResultStreamParser(const TestCaseResultStreamParser &other);
+    TestCaseResultStreamParser &operator=(const TestCaseResultStreamParser &other);
+
+    TestResultParser m_parser;
+    de::MovePtr<TestCaseResult> m_result;
+    TestResultParser::ParseResult m_parseResult;
+    bool m_hasData;
+};
+
 } // namespace xe
 
 #endif // _XETESTRESULTPARSER_HPP
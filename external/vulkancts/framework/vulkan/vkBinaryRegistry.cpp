@@ -32,6 +32,8 @@
 #include "deFile.h"
 #include "deMemory.h"
 
+#include <zlib.h>
+
 #include <sstream>
 #include <fstream>
 #include <stdexcept>
@@ -101,27 +103,191 @@ string getIndexPath(const std::string &dirName)
     return de::FilePath::join(dirName, "index.bin").getPath();
 }
 
-void writeBinary(const ProgramBinary &binary, const std::string &dstPath)
+string getManifestPath(const std::string &dirName)
+{
+    return de::FilePath::join(dirName, "manifest.txt").getPath();
+}
+
+string getBinaryPackPath(const std::string &dirName)
+{
+    return de::FilePath::join(dirName, "binaries.pack").getPath();
+}
+
+enum
+{
+    PACK_MAGIC       = 0x4b50564b, // "KVPK"
+    PACK_VERSION     = 1,
+    PACK_HEADER_SIZE = 16,
+    PACK_ENTRY_SIZE  = 16,
+};
+
+// Header and entries are serialized in little-endian byte order:
+//  header: magic, version, numBinaries, reserved (uint32 each)
+//  entry:  offset (uint64), size, storedSize (uint32 each)
+
+struct PackHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t numBinaries;
+};
+
+// Empty slots have size = 0. Binary is stored with deflate if storedSize != size.
+struct PackEntry
+{
+    uint64_t offset;     //!< Offset of stored data from the beginning of the file
+    uint32_t size;       //!< Size of binary
+    uint32_t storedSize; //!< Size of stored data
+};
+
+void writeUint32(uint8_t *dst, uint32_t value)
+{
+    for (int byteNdx = 0; byteNdx < 4; byteNdx++)
+        dst[byteNdx] = (uint8_t)(value >> (8 * byteNdx));
+}
+
+void writeUint64(uint8_t *dst, uint64_t value)
+{
+    writeUint32(dst, (uint32_t)value);
+    writeUint32(dst + 4, (uint32_t)(value >> 32));
+}
+
+uint32_t readUint32(const uint8_t *src)
+{
+    return (uint32_t)src[0] | ((uint32_t)src[1] << 8) | ((uint32_t)src[2] << 16) | ((uint32_t)src[3] << 24);
+}
+
+uint64_t readUint64(const uint8_t *src)
 {
-    const de::FilePath filePath(dstPath);
+    return (uint64_t)readUint32(src) | ((uint64_t)readUint32(src + 4) << 32);
+}
 
-    if (!de::FilePath(filePath.getDirName()).exists())
-        de::createDirectoryAndParents(filePath.getDirName().c_str());
+void serializePackHeader(uint8_t *dst, const PackHeader &header)
+{
+    writeUint32(dst + 0, header.magic);
+    writeUint32(dst + 4, header.version);
+    writeUint32(dst + 8, header.numBinaries);
+    writeUint32(dst + 12, 0u);
+}
+
+void serializePackEntry(uint8_t *dst, const PackEntry &entry)
+{
+    writeUint64(dst + 0, entry.offset);
+    writeUint32(dst + 8, entry.size);
+    writeUint32(dst + 12, entry.storedSize);
+}
+
+void readPackData(tcu::Resource &pack, uint64_t offset, size_t size, void *dst)
+{
+    const uint8_t *const packData = pack.getMappedData();
+
+    if (offset + size > (uint64_t)pack.getSize64())
+        throw tcu::ResourceError("Malformed binary pack", pack.getName().c_str(), __FILE__, __LINE__);
+
+    if (packData)
+        deMemcpy(dst, packData + offset, size);
+    else
+        pack.readAt((int64_t)offset, (uint8_t *)dst, (int)size);
+}
 
+uint32_t getNumPackedBinaries(tcu::Resource &pack)
+{
+    uint8_t data[PACK_HEADER_SIZE];
+
+    readPackData(pack, 0, sizeof(data), data);
+
+    if (readUint32(data + 0) != (uint32_t)PACK_MAGIC || readUint32(data + 4) != (uint32_t)PACK_VERSION)
+        throw tcu::ResourceError("Unsupported binary pack", pack.getName().c_str(), __FILE__, __LINE__);
+
+    return readUint32(data + 8);
+}
+
+// Returns entry with size = 0 if the slot is empty or out of range
+PackEntry readPackEntry(tcu::Resource &pack, uint32_t index)
+{
+    const uint32_t numBinaries = getNumPackedBinaries(pack);
+    PackEntry entry;
+
+    deMemset(&entry, 0, sizeof(entry));
+
+    if (index < numBinaries)
     {
-        std::ofstream out(dstPath.c_str(), std::ios_base::binary);
+        uint8_t data[PACK_ENTRY_SIZE];
 
-        if (!out.is_open() || !out.good())
-            throw tcu::Exception("Failed to open " + dstPath);
+        readPackData(pack, PACK_HEADER_SIZE + (uint64_t)index * PACK_ENTRY_SIZE, sizeof(data), data);
+
+        entry.offset     = readUint64(data + 0);
+        entry.size       = readUint32(data + 8);
+        entry.storedSize = readUint32(data + 12);
 
-        out.write((const char *)binary.getBinary(), binary.getSize());
-        out.close();
+        if (entry.size != 0 && entry.offset + entry.storedSize > (uint64_t)pack.getSize64())
+            throw tcu::ResourceError("Malformed binary pack", pack.getName().c_str(), __FILE__, __LINE__);
     }
+
+    return entry;
 }
 
-void writeBinary(const std::string &dstDir, uint32_t index, const ProgramBinary &binary)
+// Returns stored data of a non-empty entry. Data is read into storage if the pack is not mapped.
+const uint8_t *getPackedData(tcu::Resource &pack, const PackEntry &entry, vector<uint8_t> *storage)
 {
-    writeBinary(binary, getProgramPath(dstDir, index));
+    const uint8_t *const packData = pack.getMappedData();
+
+    DE_ASSERT(entry.size != 0);
+
+    if (packData)
+        return packData + entry.offset;
+    else
+    {
+        storage->resize(entry.storedSize);
+        readPackData(pack, entry.offset, storage->size(), &(*storage)[0]);
+
+        return &(*storage)[0];
+    }
+}
+
+ProgramBinary *decodePackedBinary(tcu::Resource &pack, const PackEntry &entry, const uint8_t *storedData)
+{
+    if (entry.storedSize == entry.size)
+        return new ProgramBinary(vk::PROGRAM_FORMAT_SPIRV, entry.size, storedData);
+    else
+    {
+        vector<uint8_t> bytes(entry.size);
+        uLongf numDecompressed = (uLongf)bytes.size();
+
+        if (uncompress(&bytes[0], &numDecompressed, storedData, (uLong)entry.storedSize) != Z_OK ||
+            numDecompressed != (uLongf)bytes.size())
+            throw tcu::ResourceError("Failed to decompress binary", pack.getName().c_str(), __FILE__, __LINE__);
+
+        return new ProgramBinary(vk::PROGRAM_FORMAT_SPIRV, bytes.size(), &bytes[0]);
+    }
+}
+
+// Returns null if the slot is empty
+ProgramBinary *readPackedBinary(tcu::Resource &pack, uint32_t index)
+{
+    const PackEntry entry = readPackEntry(pack, index);
+    vector<uint8_t> storage;
+
+    if (entry.size == 0)
+        return DE_NULL;
+
+    return decodePackedBinary(pack, entry, getPackedData(pack, entry, &storage));
+}
+
+// Files are written next to their final location and renamed over it once complete,
+// so that an interrupted write never leaves a truncated registry behind.
+string getTempPath(const string &path)
+{
+    return path + ".tmp";
+}
+
+void replaceFile(const string &tempPath, const string &path)
+{
+    if (!deRenameFile(tempPath.c_str(), path.c_str()))
+    {
+        deDeleteFile(tempPath.c_str());
+        throw tcu::InternalError(string("Failed to replace ") + path);
+    }
 }
 
 ProgramBinary *readBinary(const std::string &srcPath)
@@ -406,7 +572,9 @@ void BinaryIndexHash::insert(const ProgramBinary *binary, uint32_t index)
 
 // BinaryRegistryWriter
 
-BinaryRegistryWriter::BinaryRegistryWriter(const std::string &dstPath) : m_dstPath(dstPath)
+BinaryRegistryWriter::BinaryRegistryWriter(const std::string &dstPath, bool compressBinaries)
+    : m_dstPath(dstPath)
+    , m_compressBinaries(compressBinaries)
 {
     if (de::FilePath(dstPath).exists())
         initFromPath(dstPath);
@@ -422,6 +590,40 @@ void BinaryRegistryWriter::initFromPath(const std::string &srcPath)
 {
     DE_ASSERT(m_binaries.empty());
 
+    const string packPath = getBinaryPackPath(srcPath);
+    const bool hasPack    = de::FilePath(packPath).exists();
+
+    if (hasPack)
+    {
+        tcu::MappedFileResource pack(packPath.c_str());
+        const uint32_t numBinaries = getNumPackedBinaries(pack);
+        vector<uint8_t> storage;
+
+        for (uint32_t index = 0; index < numBinaries; ++index)
+        {
+            const PackEntry entry = readPackEntry(pack, index);
+
+            if (entry.size == 0)
+                continue;
+
+            {
+                const uint8_t *const storedData = getPackedData(pack, entry, &storage);
+                const de::UniquePtr<ProgramBinary> binary(decodePackedBinary(pack, entry, storedData));
+
+                // \note referenceCount is left to 0 and will only be incremented
+                //         if binary is reused (added via addProgram()).
+                addBinary(index, *binary);
+
+                // Compressed data is kept so that the binary doesn't need to be compressed again
+                m_binaries[index].packed = true;
+
+                if (entry.storedSize != entry.size)
+                    m_binaries[index].packedData.assign(storedData, storedData + entry.storedSize);
+            }
+        }
+    }
+
+    // Registries written by older versions store each binary in a separate file
     for (de::DirectoryIterator iter(srcPath); iter.hasItem(); iter.next())
     {
         const de::FilePath path    = iter.getItem();
@@ -429,17 +631,51 @@ void BinaryRegistryWriter::initFromPath(const std::string &srcPath)
 
         if (isProgramFileName(baseName))
         {
-            const uint32_t index = getProgramIndexFromName(baseName);
-            const de::UniquePtr<ProgramBinary> binary(readBinary(path.getPath()));
+            if (!hasPack)
+            {
+                const uint32_t index = getProgramIndexFromName(baseName);
+                const de::UniquePtr<ProgramBinary> binary(readBinary(path.getPath()));
+
+                addBinary(index, *binary);
+            }
+
+            m_legacyBinaryFiles.push_back(path.getPath());
+        }
+    }
+
+    readManifest(srcPath);
+}
+
+// Manifest is a text file with one line per program:
+// <digest>\t<binary index>\t<test case path>\t<program name>
+void BinaryRegistryWriter::readManifest(const std::string &srcPath)
+{
+    std::ifstream in(getManifestPath(srcPath).c_str());
+    string line;
+
+    // Missing manifest just means that all programs are rebuilt
+    while (in.is_open() && std::getline(in, line))
+    {
+        const vector<string> fields = de::splitString(line, '\t');
+        deSha1 digest;
+        uint32_t index = 0;
+
+        // Ignore malformed lines
+        if (fields.size() != 4 || fields[0].size() != 40 || !deSha1_parse(&digest, fields[0].c_str()))
+            continue;
+
+        {
+            std::istringstream indexStr(fields[1]);
 
-            addBinary(index, *binary);
-            // \note referenceCount is left to 0 and will only be incremented
-            //         if binary is reused (added via addProgram()).
+            if (!(indexStr >> index))
+                continue;
         }
+
+        m_prevManifest.insert(std::make_pair(ProgramIdentifier(fields[2], fields[3]), ManifestEntry(digest, index)));
     }
 }
 
-void BinaryRegistryWriter::addProgram(const ProgramIdentifier &id, const ProgramBinary &binary)
+void BinaryRegistryWriter::addProgram(const ProgramIdentifier &id, const ProgramBinary &binary, const deSha1 &digest)
 {
     const uint32_t *const indexPtr = findBinary(binary);
     uint32_t index                 = indexPtr ? *indexPtr : ~0u;
@@ -452,6 +688,29 @@ void BinaryRegistryWriter::addProgram(const ProgramIdentifier &id, const Program
 
     m_binaries[index].referenceCount += 1;
     m_binaryIndices.push_back(ProgramIdentifierIndex(id, index));
+    m_digests.push_back(digest);
+}
+
+bool BinaryRegistryWriter::addUnchangedProgram(const ProgramIdentifier &id, const deSha1 &digest)
+{
+    const Manifest::const_iterator entry = m_prevManifest.find(id);
+
+    if (entry == m_prevManifest.end() || !deSha1_equal(&entry->second.digest, &digest))
+        return false;
+
+    {
+        const uint32_t index = entry->second.index;
+
+        // Binary may have been removed from the registry since the manifest was written
+        if ((size_t)index >= m_binaries.size() || !m_binaries[index].binary)
+            return false;
+
+        m_binaries[index].referenceCount += 1;
+        m_binaryIndices.push_back(ProgramIdentifierIndex(id, index));
+        m_digests.push_back(digest);
+    }
+
+    return true;
 }
 
 uint32_t *BinaryRegistryWriter::findBinary(const ProgramBinary &binary) const
@@ -507,24 +766,11 @@ void BinaryRegistryWriter::writeToPath(const std::string &dstPath) const
         de::createDirectoryAndParents(dstPath.c_str());
 
     DE_ASSERT(m_binaries.size() <= 0xffffffffu);
-    for (size_t binaryNdx = 0; binaryNdx < m_binaries.size(); ++binaryNdx)
-    {
-        const BinarySlot &slot = m_binaries[binaryNdx];
-
-        if (slot.referenceCount > 0)
-        {
-            DE_ASSERT(slot.binary);
-            writeBinary(dstPath, (uint32_t)binaryNdx, *slot.binary);
-        }
-        else
-        {
-            // Delete stale binary if such exists
-            const std::string progPath = getProgramPath(dstPath, (uint32_t)binaryNdx);
+    writeBinaryPack(dstPath);
 
-            if (de::FilePath(progPath).exists())
-                deDeleteFile(progPath.c_str());
-        }
-    }
+    for (vector<string>::const_iterator fileIter = m_legacyBinaryFiles.begin(); fileIter != m_legacyBinaryFiles.end();
+         ++fileIter)
+        deDeleteFile(fileIter->c_str());
 
     // Write index
     {
@@ -540,14 +786,149 @@ void BinaryRegistryWriter::writeToPath(const std::string &dstPath) const
             de::createDirectoryAndParents(indexPath.getDirName().c_str());
 
         {
-            std::ofstream indexOut(indexPath.getPath(), std::ios_base::binary);
+            const string tempPath = getTempPath(indexPath.getPath());
 
-            if (!indexOut.is_open() || !indexOut.good())
-                throw tcu::InternalError(string("Failed to open program binary index file ") + indexPath.getPath());
+            {
+                std::ofstream indexOut(tempPath.c_str(), std::ios_base::binary);
 
-            indexOut.write((const char *)&index[0], index.size() * sizeof(BinaryIndexNode));
+                if (!indexOut.is_open() || !indexOut.good())
+                    throw tcu::InternalError(string("Failed to open program binary index file ") + tempPath);
+
+                indexOut.write((const char *)&index[0], index.size() * sizeof(BinaryIndexNode));
+
+                if (!indexOut.good())
+                    throw tcu::InternalError(string("Failed to write program binary index file ") + tempPath);
+            }
+
+            replaceFile(tempPath, indexPath.getPath());
         }
     }
+
+    writeManifest(dstPath);
+}
+
+void BinaryRegistryWriter::writeBinaryPack(const std::string &dstPath) const
+{
+    const string packPath = getBinaryPackPath(dstPath);
+    const string tempPath = getTempPath(packPath);
+    vector<uint8_t> table(PACK_HEADER_SIZE + m_binaries.size() * PACK_ENTRY_SIZE, 0u);
+    uint64_t curOffset = table.size();
+    vector<uint8_t> compressed;
+
+    {
+        std::ofstream out(tempPath.c_str(), std::ios_base::binary);
+
+        if (!out.is_open() || !out.good())
+            throw tcu::InternalError(string("Failed to open program binary pack ") + tempPath);
+
+        // Entry table is written after data when all offsets are known
+        out.seekp((std::streamoff)curOffset);
+
+        for (size_t binaryNdx = 0; binaryNdx < m_binaries.size(); ++binaryNdx)
+        {
+            const BinarySlot &slot = m_binaries[binaryNdx];
+            PackEntry entry;
+
+            // Unreferenced binaries are dropped
+            if (slot.referenceCount == 0)
+                continue;
+
+            DE_ASSERT(slot.binary);
+
+            {
+                const uint8_t *storedData = slot.binary->getBinary();
+                size_t storedSize         = slot.binary->getSize();
+
+                if (slot.packed)
+                {
+                    // Binaries from the existing pack are stored as they were, unless compression is now disabled
+                    if (m_compressBinaries && !slot.packedData.empty())
+                    {
+                        storedData = &slot.packedData[0];
+                        storedSize = slot.packedData.size();
+                    }
+                }
+                else if (m_compressBinaries)
+                {
+                    uLongf compressedSize = compressBound((uLong)storedSize);
+
+                    compressed.resize((size_t)compressedSize);
+
+                    // Binary is stored as is if compression doesn't help
+                    if (compress2(&compressed[0], &compressedSize, storedData, (uLong)storedSize,
+                                  Z_BEST_COMPRESSION) == Z_OK &&
+                        (size_t)compressedSize < storedSize)
+                    {
+                        storedData = &compressed[0];
+                        storedSize = (size_t)compressedSize;
+                    }
+                }
+
+                entry.offset     = curOffset;
+                entry.size       = (uint32_t)slot.binary->getSize();
+                entry.storedSize = (uint32_t)storedSize;
+
+                serializePackEntry(&table[PACK_HEADER_SIZE + binaryNdx * PACK_ENTRY_SIZE], entry);
+
+                out.write((const char *)storedData, (std::streamsize)storedSize);
+                curOffset += storedSize;
+            }
+        }
+
+        {
+            PackHeader header;
+
+            header.magic       = PACK_MAGIC;
+            header.version     = PACK_VERSION;
+            header.numBinaries = (uint32_t)m_binaries.size();
+
+            serializePackHeader(&table[0], header);
+
+            out.seekp(0);
+            out.write((const char *)&table[0], (std::streamsize)table.size());
+        }
+
+        if (!out.good())
+        {
+            out.close();
+            deDeleteFile(tempPath.c_str());
+            throw tcu::InternalError(string("Failed to write program binary pack ") + tempPath);
+        }
+    }
+
+    replaceFile(tempPath, packPath);
+}
+
+void BinaryRegistryWriter::writeManifest(const std::string &dstPath) const
+{
+    const string manifestPath = getManifestPath(dstPath);
+    const string tempPath     = getTempPath(manifestPath);
+
+    {
+        std::ofstream out(tempPath.c_str(), std::ios_base::binary);
+
+        if (!out.is_open() || !out.good())
+            throw tcu::InternalError(string("Failed to open program binary manifest file ") + tempPath);
+
+        DE_ASSERT(m_digests.size() == m_binaryIndices.size());
+
+        for (size_t progNdx = 0; progNdx < m_binaryIndices.size(); ++progNdx)
+        {
+            const ProgramIdentifierIndex &entry = m_binaryIndices[progNdx];
+            char digestStr[41];
+
+            deSha1_render(&m_digests[progNdx], digestStr);
+            digestStr[40] = 0;
+
+            out << digestStr << '\t' << entry.index << '\t' << entry.id.testCasePath << '\t' << entry.id.programName
+                << '\n';
+        }
+
+        if (!out.good())
+            throw tcu::InternalError(string("Failed to write program binary manifest file ") + tempPath);
+    }
+
+    replaceFile(tempPath, manifestPath);
 }
 
 // BinaryRegistryReader
@@ -555,6 +936,7 @@ void BinaryRegistryWriter::writeToPath(const std::string &dstPath) const
 BinaryRegistryReader::BinaryRegistryReader(const tcu::Archive &archive, const std::string &srcPath)
     : m_archive(archive)
     , m_srcPath(srcPath)
+    , m_binaryPackChecked(false)
 {
 }
 
@@ -569,7 +951,7 @@ ProgramBinary *BinaryRegistryReader::loadProgram(const ProgramIdentifier &id) co
         try
         {
             m_binaryIndex = BinaryIndexPtr(new BinaryIndexAccess(
-                de::MovePtr<tcu::Resource>(m_archive.getResource(getIndexPath(m_srcPath).c_str()))));
+                de::MovePtr<tcu::Resource>(m_archive.getMappedResource(getIndexPath(m_srcPath).c_str()))));
         }
         catch (const tcu::ResourceError &e)
         {
@@ -580,29 +962,64 @@ ProgramBinary *BinaryRegistryReader::loadProgram(const ProgramIdentifier &id) co
     {
         const uint32_t *indexPos = findBinaryIndex(m_binaryIndex.get(), id);
 
-        if (indexPos)
-        {
-            const string fullPath = getProgramPath(m_srcPath, *indexPos);
+        if (!indexPos)
+            throw ProgramNotFoundException(id, "Program not found in index");
 
-            try
+        try
+        {
+            if (!m_binaryPackChecked)
             {
-                de::UniquePtr<tcu::Resource> progRes(m_archive.getResource(fullPath.c_str()));
-                const int progSize = progRes->getSize();
-                vector<uint8_t> bytes(progSize);
+                m_binaryPackChecked = true;
+
+                // Fall back to separate binary files if the registry has no pack
+                try
+                {
+                    m_binaryPack = de::MovePtr<tcu::Resource>(
+                        m_archive.getMappedResource(getBinaryPackPath(m_srcPath).c_str()));
+                }
+                catch (const tcu::ResourceError &)
+                {
+                }
+            }
 
-                TCU_CHECK_INTERNAL(!bytes.empty());
+            if (m_binaryPack)
+            {
+                ProgramBinary *const binary = readPackedBinary(*m_binaryPack, *indexPos);
 
-                progRes->read(&bytes[0], progSize);
+                if (!binary)
+                    throw ProgramNotFoundException(id, "Binary missing from pack");
 
-                return new ProgramBinary(vk::PROGRAM_FORMAT_SPIRV, bytes.size(), &bytes[0]);
+                return binary;
             }
-            catch (const tcu::ResourceError &e)
+            else
             {
-                throw ProgramNotFoundException(id, e.what());
+                const string fullPath = getProgramPath(m_srcPath, *indexPos);
+                de::UniquePtr<tcu::Resource> progRes(m_archive.getMappedResource(fullPath.c_str()));
+                const size_t progSize         = (size_t)progRes->getSize();
+                const uint8_t *const progData = progRes->getMappedData();
+
+                TCU_CHECK_INTERNAL(progSize > 0);
+
+                if (progData)
+                    return new ProgramBinary(vk::PROGRAM_FORMAT_SPIRV, progSize, progData);
+                else
+                {
+                    vector<uint8_t> bytes(progSize);
+
+                    progRes->read(&bytes[0], (int)progSize);
+
+                    return new ProgramBinary(vk::PROGRAM_FORMAT_SPIRV, bytes.size(), &bytes[0]);
+                }
             }
         }
-        else
-            throw ProgramNotFoundException(id, "Program not found in index");
+        catch (const ProgramNotFoundException &)
+        {
+            throw;
+        }
+        catch (const tcu::ResourceError &e)
+        {
+            throw ProgramNotFoundException(id, e.what());
+        }
     }
 }
 
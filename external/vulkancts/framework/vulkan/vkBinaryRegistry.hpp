@@ -29,6 +29,8 @@
 #include "deMemPool.hpp"
 #include "dePoolHash.h"
 #include "deUniquePtr.hpp"
+#include "deSha1.h"
+#include "deInt32.h"
 
 #include <map>
 #include <vector>
@@ -65,6 +67,23 @@ public:
     }
 };
 
+// Binary Pack
+// -----------
+//
+// Program binaries are stored in a single pack file instead of a file per
+// binary, which is expensive on network filesystems and in Android asset
+// packs. The pack starts with a header and a table of { offset, size,
+// stored size } entries, one per binary slot, followed by binary data.
+// Header and table use little-endian byte order and 64-bit data offsets.
+// Binaries may optionally be compressed with deflate; stored size differs
+// from size for compressed binaries.
+//
+// When a registry is updated, binaries from the existing pack are copied as
+// they were stored and only new binaries are compressed. The new pack is
+// written to a temporary file that replaces the old pack once complete.
+//
+// Registries without a pack are still read from separate binary files.
+
 // Program Binary Index
 // --------------------
 //
@@ -98,6 +117,8 @@ struct BinaryIndexNode
     uint32_t index; //!< Binary index if word ends with 0 bytes, or index of first child node otherwise.
 };
 
+// Resource is accessed directly if it could be mapped into memory.
+// Otherwise elements are read in on demand, one page at a time.
 template <typename Element>
 class LazyResource
 {
@@ -107,7 +128,7 @@ public:
     const Element &operator[](size_t ndx);
     size_t size(void) const
     {
-        return m_elements.size();
+        return m_numElements;
     }
 
 private:
@@ -129,12 +150,17 @@ private:
 
     de::UniquePtr<tcu::Resource> m_resource;
 
+    size_t m_numElements;
+    const Element *m_mappedElements; //!< Elements in mapped resource, or null if resource is not mapped
     std::vector<Element> m_elements;
     std::vector<bool> m_isPageResident;
 };
 
 template <typename Element>
-LazyResource<Element>::LazyResource(de::MovePtr<tcu::Resource> resource) : m_resource(resource)
+LazyResource<Element>::LazyResource(de::MovePtr<tcu::Resource> resource)
+    : m_resource(resource)
+    , m_numElements(0)
+    , m_mappedElements(DE_NULL)
 {
     const size_t resSize     = m_resource->getSize();
     const size_t numElements = resSize / sizeof(Element);
@@ -143,8 +169,16 @@ LazyResource<Element>::LazyResource(de::MovePtr<tcu::Resource> resource) : m_res
 
     TCU_CHECK_INTERNAL(numElements * sizeof(Element) == resSize);
 
-    m_elements.resize(numElements);
-    m_isPageResident.resize(numPages, false);
+    m_numElements    = numElements;
+    m_mappedElements = (const Element *)m_resource->getMappedData();
+
+    if (m_mappedElements)
+        DE_ASSERT(deIsAlignedPtr(m_mappedElements, sizeof(uint32_t)));
+    else
+    {
+        m_elements.resize(numElements);
+        m_isPageResident.resize(numPages, false);
+    }
 }
 
 template <typename Element>
@@ -152,9 +186,12 @@ const Element &LazyResource<Element>::operator[](size_t ndx)
 {
     const size_t pageNdx = getPageForElement(ndx);
 
-    if (ndx >= m_elements.size())
+    if (ndx >= m_numElements)
         throw std::out_of_range("");
 
+    if (m_mappedElements)
+        return m_mappedElements[ndx];
+
     if (!isPageResident(pageNdx))
         makePageResident(pageNdx);
 
@@ -194,6 +231,8 @@ private:
     const std::string m_srcPath;
 
     mutable BinaryIndexPtr m_binaryIndex;
+    mutable de::MovePtr<tcu::Resource> m_binaryPack; //!< Null if registry stores binaries in separate files
+    mutable bool m_binaryPackChecked;
 };
 
 struct ProgramIdentifierIndex
@@ -225,18 +264,42 @@ private:
     BinaryIndexHashImpl *const m_hash;
 };
 
+// Build Manifest
+// --------------
+//
+// Alongside the index, the writer stores a manifest that maps each
+// ProgramIdentifier to the digest of its sources and build options
+// (see getProgramDigest()) and the binary slot it was built into. When a
+// registry is updated, programs whose digest matches the manifest can be
+// re-added with addUnchangedProgram() without building them again.
+
+struct ManifestEntry
+{
+    deSha1 digest;
+    uint32_t index;
+
+    ManifestEntry(const deSha1 &digest_, uint32_t index_) : digest(digest_), index(index_)
+    {
+    }
+};
+
 class BinaryRegistryWriter
 {
 public:
-    BinaryRegistryWriter(const std::string &dstPath);
+    BinaryRegistryWriter(const std::string &dstPath, bool compressBinaries = false);
     ~BinaryRegistryWriter(void);
 
-    void addProgram(const ProgramIdentifier &id, const ProgramBinary &binary);
+    void addProgram(const ProgramIdentifier &id, const ProgramBinary &binary, const deSha1 &digest);
+    //! Re-add program from the existing registry if it was built from identical sources. Returns false if not found.
+    bool addUnchangedProgram(const ProgramIdentifier &id, const deSha1 &digest);
     void write(void) const;
 
 private:
     void initFromPath(const std::string &srcPath);
+    void readManifest(const std::string &srcPath);
     void writeToPath(const std::string &dstPath) const;
+    void writeBinaryPack(const std::string &dstPath) const;
+    void writeManifest(const std::string &dstPath) const;
 
     uint32_t *findBinary(const ProgramBinary &binary) const;
     uint32_t getNextSlot(void) const;
@@ -246,24 +309,34 @@ private:
     {
         ProgramBinary *binary;
         size_t referenceCount;
+        bool packed;                     //!< Binary was read from the existing pack
+        std::vector<uint8_t> packedData; //!< Compressed data in the existing pack, empty if stored uncompressed
 
-        BinarySlot(ProgramBinary *binary_, size_t referenceCount_) : binary(binary_), referenceCount(referenceCount_)
+        BinarySlot(ProgramBinary *binary_, size_t referenceCount_)
+            : binary(binary_)
+            , referenceCount(referenceCount_)
+            , packed(false)
         {
         }
 
-        BinarySlot(void) : binary(DE_NULL), referenceCount(0)
+        BinarySlot(void) : binary(DE_NULL), referenceCount(0), packed(false)
         {
         }
     };
 
     typedef std::vector<BinarySlot> BinaryVector;
     typedef std::vector<ProgramIdentifierIndex> ProgIdIndexVector;
+    typedef std::map<ProgramIdentifier, ManifestEntry> Manifest;
 
     const std::string &m_dstPath;
+    const bool m_compressBinaries;
 
     ProgIdIndexVector m_binaryIndices; //!< ProgramIdentifier -> slot in m_binaries
+    std::vector<deSha1> m_digests;     //!< Digests of programs in m_binaryIndices
     BinaryIndexHash m_binaryHash;      //!< ProgramBinary -> slot in m_binaries
     BinaryVector m_binaries;
+    Manifest m_prevManifest;                    //!< Manifest of the existing registry
+    std::vector<std::string> m_legacyBinaryFiles; //!< Separate binary files to remove once pack is written
 };
 
 } // namespace BinaryRegistryDetail
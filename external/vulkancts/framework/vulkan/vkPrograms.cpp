@@ -29,22 +29,19 @@
 #include "vkShaderToSpirV.hpp"
 #include "vkSpirVAsm.hpp"
 #include "vkRefUtil.hpp"
+#include "vkShaderCache.hpp"
 
-#include "deMutex.hpp"
-#include "deFilePath.hpp"
 #include "deArrayUtil.hpp"
+#include "deSha1.hpp"
 #include "deMemory.h"
 #include "deInt32.h"
+#include "deSharedPtr.hpp"
 
 #include "tcuCommandLine.hpp"
 
 #include <map>
 #include <mutex>
 
-#if DE_OS == DE_OS_ANDROID
-#define DISABLE_SHADERCACHE_IPC
-#endif
-
 namespace vk
 {
 
@@ -103,6 +100,40 @@ bool isSaneSpirVBinary(const ProgramBinary &binary)
     return true;
 }
 
+//! Optimizer with the passes of the recipe registered. Optimizers are not thread-safe, so each thread keeps its own.
+const spvtools::Optimizer &getThreadOptimizer(spv_target_env targetEnv, int optimizationRecipe)
+{
+    typedef std::pair<spv_target_env, int> OptimizerKey;
+    typedef map<OptimizerKey, de::SharedPtr<spvtools::Optimizer>> OptimizerMap;
+
+    static thread_local OptimizerMap s_optimizers;
+    const OptimizerKey key(targetEnv, optimizationRecipe);
+    const OptimizerMap::const_iterator it = s_optimizers.find(key);
+
+    if (it != s_optimizers.end())
+        return *it->second;
+
+    {
+        const de::SharedPtr<spvtools::Optimizer> optimizer(new spvtools::Optimizer(targetEnv));
+
+        switch (optimizationRecipe)
+        {
+        case 1:
+            optimizer->RegisterPerformancePasses();
+            break;
+        case 2:
+            optimizer->RegisterSizePasses();
+            break;
+        default:
+            TCU_THROW(InternalError, "Unknown optimization recipe requested");
+        }
+
+        s_optimizers[key] = optimizer;
+
+        return *optimizer;
+    }
+}
+
 void optimizeCompiledBinary(vector<uint32_t> &binary, int optimizationRecipe, const SpirvVersion spirvVersion)
 {
     spv_target_env targetEnv = SPV_ENV_VULKAN_1_0;
@@ -131,19 +162,7 @@ void optimizeCompiledBinary(vector<uint32_t> &binary, int optimizationRecipe, co
         TCU_THROW(InternalError, "Unexpected SPIR-V version requested");
     }
 
-    spvtools::Optimizer optimizer(targetEnv);
-
-    switch (optimizationRecipe)
-    {
-    case 1:
-        optimizer.RegisterPerformancePasses();
-        break;
-    case 2:
-        optimizer.RegisterSizePasses();
-        break;
-    default:
-        TCU_THROW(InternalError, "Unknown optimization recipe requested");
-    }
+    const spvtools::Optimizer &optimizer = getThreadOptimizer(targetEnv, optimizationRecipe);
 
     spvtools::OptimizerOptions optimizer_options;
     optimizer_options.set_run_validator(false);
@@ -193,502 +212,111 @@ void validateCompiledBinary(const vector<uint32_t> &binary, SpirVProgramInfo *bu
     }
 }
 
-// IPC functions
-#ifndef DISABLE_SHADERCACHE_IPC
-#include "vkIPC.inl"
-#endif
-
-// Overridable wrapper for de::Mutex
-class cacheMutex
-{
-public:
-    cacheMutex()
-    {
-    }
-    virtual ~cacheMutex()
-    {
-    }
-    virtual void lock()
-    {
-        localMutex.lock();
-    }
-    virtual void unlock()
-    {
-        localMutex.unlock();
-    }
-
-private:
-    de::Mutex localMutex;
-};
-
-#ifndef DISABLE_SHADERCACHE_IPC
-// Overriden cacheMutex that uses IPC instead
-class cacheMutexIPC : public cacheMutex
-{
-public:
-    cacheMutexIPC()
-    {
-        ipc_sem_init(&guard, "cts_shadercache_ipc_guard");
-        ipc_sem_create(&guard, 1);
-    }
-    virtual ~cacheMutexIPC()
-    {
-        ipc_sem_close(&guard);
-    }
-    virtual void lock()
-    {
-        ipc_sem_decrement(&guard);
-    }
-    virtual void unlock()
-    {
-        ipc_sem_increment(&guard);
-    }
-
-private:
-    ipc_sharedsemaphore guard;
-};
-#endif
-
-// Each cache node takes 4 * 4 = 16 bytes; 1M items takes 16M memory.
-const uint32_t cacheMaxItems = 1024 * 1024;
-cacheMutex *cacheFileMutex   = nullptr;
-uint32_t *cacheMempool       = nullptr;
-#ifndef DISABLE_SHADERCACHE_IPC
-ipc_sharedmemory cacheIPCMemory;
-#endif
-
-struct cacheNode
-{
-    uint32_t key;
-    uint32_t data;
-    uint32_t right_child;
-    uint32_t left_child;
-};
-
-cacheNode *cacheSearch(uint32_t key)
-{
-    cacheNode *r   = (cacheNode *)(cacheMempool + 1);
-    int *tail      = (int *)cacheMempool;
-    unsigned int p = 0;
-
-    if (!*tail)
-    {
-        // Cache is empty.
-        return 0;
-    }
-
-    while (1)
-    {
-        if (r[p].key == key)
-            return &r[p];
-
-        if (key > r[p].key)
-            p = r[p].right_child;
-        else
-            p = r[p].left_child;
-
-        if (p == 0)
-            return 0;
-    }
-}
-
-void cacheInsert(uint32_t key, uint32_t data)
-{
-    cacheNode *r = (cacheNode *)(cacheMempool + 1);
-    int *tail    = (int *)cacheMempool;
-    int newnode  = *tail;
-
-    DE_ASSERT(newnode < cacheMaxItems);
-
-    // If we run out of cache space, reset the cache index.
-    if (newnode >= cacheMaxItems)
-    {
-        *tail   = 0;
-        newnode = 0;
-    }
-
-    r[*tail].data        = data;
-    r[*tail].key         = key;
-    r[*tail].left_child  = 0;
-    r[*tail].right_child = 0;
-
-    (*tail)++;
-
-    if (newnode == 0)
-    {
-        // first
-        return;
-    }
-
-    int p = 0;
-    while (1)
-    {
-        if (r[p].key == key)
-        {
-            // collision; use the latest data
-            r[p].data = data;
-            (*tail)--;
-            return;
-        }
-
-        if (key > r[p].key)
-        {
-            if (r[p].right_child != 0)
-            {
-                p = r[p].right_child;
-            }
-            else
-            {
-                r[p].right_child = newnode;
-                return;
-            }
-        }
-        else
-        {
-            if (r[p].left_child != 0)
-            {
-                p = r[p].left_child;
-            }
-            else
-            {
-                r[p].left_child = newnode;
-                return;
-            }
-        }
-    }
-}
+// Shader cache is shared by all threads; created on first use and destroyed at exit.
+ShaderCache *shaderCache = nullptr;
 
 // Called via atexit()
 void shaderCacheClean()
 {
-    delete cacheFileMutex;
-    delete[] cacheMempool;
+    delete shaderCache;
+    shaderCache = nullptr;
 }
 
-#ifndef DISABLE_SHADERCACHE_IPC
-// Called via atexit()
-void shaderCacheCleanIPC()
-{
-    delete cacheFileMutex;
-    ipc_mem_close(&cacheIPCMemory);
-}
-#endif
-
 void shaderCacheFirstRunCheck(const tcu::CommandLine &commandLine)
 {
-    bool first = true;
-
-    // We need to solve two problems here:
-    // 1) The cache and cache mutex only have to be initialized once by the first thread that arrives here.
-    // 2) We must prevent other threads from exiting early from this function thinking they don't have to initialize the cache and
-    //    cache mutex, only to try to lock the cache mutex while the first thread is still initializing it. To prevent this, we must
-    //    hold an initialization mutex (declared below) while initializing the cache and cache mutex, making other threads wait.
-
     // Used to check and set cacheFileFirstRun. We make it static, and C++11 guarantees it will only be initialized once.
+    // The mutex is held while initializing the cache so that other threads can't use it before it is ready.
     static std::mutex cacheFileFirstRunMutex;
     static bool cacheFileFirstRun = true;
 
-    // Is cacheFileFirstRun true for this thread?
-    bool needInit = false;
-
-    // Check cacheFileFirstRun only while holding the mutex, and hold it while initializing the cache.
     const std::lock_guard<std::mutex> lock(cacheFileFirstRunMutex);
-    if (cacheFileFirstRun)
-    {
-        needInit          = true;
-        cacheFileFirstRun = false;
-    }
 
-    if (needInit)
+    if (cacheFileFirstRun)
     {
-#ifndef DISABLE_SHADERCACHE_IPC
-        if (commandLine.isShaderCacheIPCEnabled())
-        {
-            // IPC path, allocate shared mutex and shared memory
-            cacheFileMutex = new cacheMutexIPC;
-            cacheFileMutex->lock();
-            ipc_mem_init(&cacheIPCMemory, "cts_shadercache_memory", sizeof(uint32_t) * (cacheMaxItems * 4 + 1));
-            if (ipc_mem_open_existing(&cacheIPCMemory) != 0)
-            {
-                ipc_mem_create(&cacheIPCMemory);
-                cacheMempool    = (uint32_t *)ipc_mem_access(&cacheIPCMemory);
-                cacheMempool[0] = 0;
-            }
-            else
-            {
-                cacheMempool = (uint32_t *)ipc_mem_access(&cacheIPCMemory);
-                first        = false;
-            }
-            atexit(shaderCacheCleanIPC);
-        }
-        else
-#endif
-        {
-            // Non-IPC path, allocate local mutex and memory
-            cacheFileMutex = new cacheMutex;
-            cacheFileMutex->lock();
-            cacheMempool    = new uint32_t[cacheMaxItems * 4 + 1];
-            cacheMempool[0] = 0;
+        // Cache file may be in use by other instances when shared, so it must not be truncated
+        const bool truncate = commandLine.isShaderCacheTruncateEnabled() && !commandLine.isShaderCacheIPCEnabled();
 
-            atexit(shaderCacheClean);
-        }
+        cacheFileFirstRun = false;
+        shaderCache       = new ShaderCache(commandLine.getShaderCacheFilename(), truncate);
 
-        if (first)
-        {
-            if (commandLine.isShaderCacheTruncateEnabled())
-            {
-                // Open file with "w" access to truncate it
-                FILE *f = fopen(commandLine.getShaderCacheFilename(), "wb");
-                if (f)
-                    fclose(f);
-            }
-            else
-            {
-                // Parse chunked shader cache file for hashes and offsets
-                FILE *file = fopen(commandLine.getShaderCacheFilename(), "rb");
-                int count  = 0;
-                if (file)
-                {
-                    uint32_t chunksize = 0;
-                    uint32_t hash      = 0;
-                    uint32_t offset    = 0;
-                    bool ok            = true;
-                    while (ok)
-                    {
-                        offset = (uint32_t)ftell(file);
-                        if (ok)
-                            ok = fread(&chunksize, 1, 4, file) == 4;
-                        if (ok)
-                            ok = fread(&hash, 1, 4, file) == 4;
-                        if (ok)
-                            cacheInsert(hash, offset);
-                        if (ok)
-                            ok = fseek(file, offset + chunksize, SEEK_SET) == 0;
-                        count++;
-                    }
-                    fclose(file);
-                }
-            }
-        }
-        cacheFileMutex->unlock();
+        atexit(shaderCacheClean);
     }
 }
 
-std::string intToString(uint32_t integer)
+vk::ProgramBinary *shadercacheLoad(const deSha1 &hash)
 {
-    std::stringstream temp_sstream;
+    return shaderCache->load(hash);
+}
 
-    temp_sstream << integer;
+void shadercacheSave(const vk::ProgramBinary *binary, const deSha1 &hash)
+{
+    if (binary == 0)
+        return;
 
-    return temp_sstream.str();
+    shaderCache->store(hash, *binary);
 }
 
-// 32-bit FNV-1 hash
-uint32_t shadercacheHash(const char *str)
+// Cache keys are SHA-1 digests over everything that may affect compilation. Strings and vectors
+// include their sizes in the digest, so adjacent fields can't alias each other.
+
+// Insert compiler revisions into the cache key.
+void addCompileEnvironment(de::Sha1Stream &key)
 {
-    uint32_t hash = 0x811c9dc5;
-    uint32_t c;
-    while ((c = (uint32_t)*str++) != 0)
-    {
-        hash *= 16777619;
-        hash ^= c;
-    }
-    return hash;
+    key << std::string(qpGetReleaseGlslName()) << std::string(qpGetReleaseSpirvToolsName())
+        << std::string(qpGetReleaseSpirvHeadersName());
 }
 
-vk::ProgramBinary *shadercacheLoad(const std::string &shaderstring, const char *shaderCacheFilename, uint32_t hash)
+de::Sha1Stream &operator<<(de::Sha1Stream &key, const ShaderBuildOptions &buildOptions)
 {
-    int32_t format;
-    int32_t length;
-    int32_t sourcelength;
-    uint32_t temp;
-    uint8_t *bin    = 0;
-    char *source    = 0;
-    bool ok         = true;
-    bool diff       = true;
-    cacheNode *node = 0;
-    cacheFileMutex->lock();
-
-    node = cacheSearch(hash);
-    if (node == 0)
-    {
-        cacheFileMutex->unlock();
-        return 0;
-    }
-    FILE *file = fopen(shaderCacheFilename, "rb");
-    ok         = file != 0;
-
-    if (ok)
-        ok = fseek(file, node->data, SEEK_SET) == 0;
-    if (ok)
-        ok = fread(&temp, 1, 4, file) == 4; // Chunk size (skip)
-    if (ok)
-        ok = fread(&temp, 1, 4, file) == 4; // Stored hash
-    if (ok)
-        ok = temp == hash; // Double check
-    if (ok)
-        ok = fread(&format, 1, 4, file) == 4;
-    if (ok)
-        ok = fread(&length, 1, 4, file) == 4;
-    if (ok)
-        ok = length > 0; // Quick check
-    if (ok)
-        bin = new uint8_t[length];
-    if (ok)
-        ok = fread(bin, 1, length, file) == (size_t)length;
-    if (ok)
-        ok = fread(&sourcelength, 1, 4, file) == 4;
-    if (ok && sourcelength > 0)
-    {
-        source               = new char[sourcelength + 1];
-        ok                   = fread(source, 1, sourcelength, file) == (size_t)sourcelength;
-        source[sourcelength] = 0;
-        diff                 = shaderstring != std::string(source);
-    }
-    if (!ok || diff)
-    {
-        // Mismatch
-        delete[] source;
-        delete[] bin;
-    }
-    else
-    {
-        delete[] source;
-        if (file)
-            fclose(file);
-        cacheFileMutex->unlock();
-        vk::ProgramBinary *res = new vk::ProgramBinary((vk::ProgramFormat)format, length, bin);
-        delete[] bin;
-        return res;
-    }
-    if (file)
-        fclose(file);
-    cacheFileMutex->unlock();
-    return 0;
+    return key << buildOptions.vulkanVersion << (uint32_t)buildOptions.targetVersion << buildOptions.flags
+               << buildOptions.supports_VK_KHR_spirv_1_4;
 }
 
-void shadercacheSave(const vk::ProgramBinary *binary, const std::string &shaderstring, const char *shaderCacheFilename,
-                     uint32_t hash)
+de::Sha1Stream &operator<<(de::Sha1Stream &key, const SpirVAsmBuildOptions &buildOptions)
 {
-    if (binary == 0)
-        return;
-    int32_t format  = binary->getFormat();
-    uint32_t length = (uint32_t)binary->getSize();
-    uint32_t chunksize;
-    uint32_t offset;
-    const uint8_t *bin = binary->getBinary();
-    const de::FilePath filePath(shaderCacheFilename);
-    cacheNode *node = 0;
+    return key << buildOptions.vulkanVersion << (uint32_t)buildOptions.targetVersion
+               << buildOptions.supports_VK_KHR_spirv_1_4 << buildOptions.supports_VK_KHR_maintenance4;
+}
 
-    cacheFileMutex->lock();
+template <typename ProgramSource>
+deSha1 getShaderCacheKey(const ProgramSource &program, int optimizationRecipe)
+{
+    de::Sha1Stream key;
 
-    node = cacheSearch(hash);
+    addCompileEnvironment(key);
+    key << (uint32_t)ProgramSource::shaderLanguage << program.buildOptions << (int32_t)optimizationRecipe;
 
-    if (node)
-    {
-        FILE *file = fopen(shaderCacheFilename, "rb");
-        bool ok    = (file != 0);
-        bool diff  = true;
-        int32_t sourcelength;
-        uint32_t temp;
-
-        uint32_t cachedLength = 0;
-
-        if (ok)
-            ok = fseek(file, node->data, SEEK_SET) == 0;
-        if (ok)
-            ok = fread(&temp, 1, 4, file) == 4; // Chunk size (skip)
-        if (ok)
-            ok = fread(&temp, 1, 4, file) == 4; // Stored hash
-        if (ok)
-            ok = temp == hash; // Double check
-        if (ok)
-            ok = fread(&temp, 1, 4, file) == 4;
-        if (ok)
-            ok = fread(&cachedLength, 1, 4, file) == 4;
-        if (ok)
-            ok = cachedLength > 0; // Quick check
-        if (ok)
-            fseek(file, cachedLength, SEEK_CUR); // skip binary
-        if (ok)
-            ok = fread(&sourcelength, 1, 4, file) == 4;
-
-        if (ok && sourcelength > 0)
-        {
-            char *source;
-            source               = new char[sourcelength + 1];
-            ok                   = fread(source, 1, sourcelength, file) == (size_t)sourcelength;
-            source[sourcelength] = 0;
-            diff                 = shaderstring != std::string(source);
-            delete[] source;
-        }
+    for (int shaderType = 0; shaderType < glu::SHADERTYPE_LAST; shaderType++)
+        key << program.sources[shaderType];
 
-        if (ok && !diff)
-        {
-            // Already in cache (written by another thread, probably)
-            fclose(file);
-            cacheFileMutex->unlock();
-            return;
-        }
-        fclose(file);
-    }
+    return key.finalize().getHash();
+}
 
-    if (!de::FilePath(filePath.getDirName()).exists())
-        de::createDirectoryAndParents(filePath.getDirName().c_str());
+deSha1 getShaderCacheKey(const SpirVAsmSource &program, int optimizationRecipe)
+{
+    de::Sha1Stream key;
 
-    FILE *file = fopen(shaderCacheFilename, "ab");
-    if (!file)
-    {
-        cacheFileMutex->unlock();
-        return;
-    }
-    // Append mode starts writing from the end of the file,
-    // but unless we do a seek, ftell returns 0.
-    fseek(file, 0, SEEK_END);
-    offset    = (uint32_t)ftell(file);
-    chunksize = 4 + 4 + 4 + 4 + length + 4 + (uint32_t)shaderstring.length();
-    fwrite(&chunksize, 1, 4, file);
-    fwrite(&hash, 1, 4, file);
-    fwrite(&format, 1, 4, file);
-    fwrite(&length, 1, 4, file);
-    fwrite(bin, 1, length, file);
-    length = (uint32_t)shaderstring.length();
-    fwrite(&length, 1, 4, file);
-    fwrite(shaderstring.c_str(), 1, length, file);
-    fclose(file);
-    cacheInsert(hash, offset);
-
-    cacheFileMutex->unlock();
+    addCompileEnvironment(key);
+    // Assembly has no ShaderLanguage, use a value distinct from GLSL and HLSL
+    key << (uint32_t)SHADER_LANGUAGE_LAST << program.buildOptions << (int32_t)optimizationRecipe << program.source;
+
+    return key.finalize().getHash();
 }
 
-// Insert any information that may affect compilation into the shader string.
-void getCompileEnvironment(std::string &shaderstring)
+deSha1 getProgramDigest(const GlslSource &program, const tcu::CommandLine &commandLine)
 {
-    shaderstring += "GLSL:";
-    shaderstring += qpGetReleaseGlslName();
-    shaderstring += "\nSpir-v Tools:";
-    shaderstring += qpGetReleaseSpirvToolsName();
-    shaderstring += "\nSpir-v Headers:";
-    shaderstring += qpGetReleaseSpirvHeadersName();
-    shaderstring += "\n";
+    return getShaderCacheKey(program, commandLine.getOptimizationRecipe());
 }
 
-// Insert compilation options into the shader string.
-void getBuildOptions(std::string &shaderstring, const ShaderBuildOptions &buildOptions, int optimizationRecipe)
+deSha1 getProgramDigest(const HlslSource &program, const tcu::CommandLine &commandLine)
 {
-    shaderstring += "Target Spir-V ";
-    shaderstring += getSpirvVersionName(buildOptions.targetVersion);
-    shaderstring += "\n";
-    if (buildOptions.flags & ShaderBuildOptions::FLAG_ALLOW_RELAXED_OFFSETS)
-        shaderstring += "Flag:Allow relaxed offsets\n";
-    if (buildOptions.flags & ShaderBuildOptions::FLAG_USE_STORAGE_BUFFER_STORAGE_CLASS)
-        shaderstring += "Flag:Use storage buffer storage class\n";
-    if (optimizationRecipe != 0)
-    {
-        shaderstring += "Optimization recipe ";
-        shaderstring += de::toString(optimizationRecipe);
-        shaderstring += "\n";
-    }
+    return getShaderCacheKey(program, commandLine.getOptimizationRecipe());
+}
+
+deSha1 getProgramDigest(const SpirVAsmSource &program, const tcu::CommandLine &commandLine)
+{
+    return getShaderCacheKey(program,
+                             commandLine.isSpirvOptimizationEnabled() ? commandLine.getOptimizationRecipe() : 0);
 }
 
 ProgramBinary *buildProgram(const GlslSource &program, glu::ShaderProgramInfo *buildInfo,
@@ -697,35 +325,25 @@ ProgramBinary *buildProgram(const GlslSource &program, glu::ShaderProgramInfo *b
     const SpirvVersion spirvVersion = program.buildOptions.targetVersion;
     const bool validateBinary       = VALIDATE_BINARIES;
     vector<uint32_t> binary;
-    std::string cachekey;
     std::string shaderstring;
     vk::ProgramBinary *res       = 0;
     const int optimizationRecipe = commandLine.getOptimizationRecipe();
-    uint32_t hash                = 0;
+    deSha1 hash;
 
     if (commandLine.isShadercacheEnabled())
     {
         shaderCacheFirstRunCheck(commandLine);
-        getCompileEnvironment(cachekey);
-        getBuildOptions(cachekey, program.buildOptions, optimizationRecipe);
 
         for (int i = 0; i < glu::SHADERTYPE_LAST; i++)
         {
-            if (!program.sources[i].empty())
-            {
-                cachekey += glu::getShaderTypeName((glu::ShaderType)i);
-
-                for (std::vector<std::string>::const_iterator it = program.sources[i].begin();
-                     it != program.sources[i].end(); ++it)
-                    shaderstring += *it;
-            }
+            for (std::vector<std::string>::const_iterator it = program.sources[i].begin();
+                 it != program.sources[i].end(); ++it)
+                shaderstring += *it;
         }
 
-        cachekey = cachekey + shaderstring;
-
-        hash = shadercacheHash(cachekey.c_str());
+        hash = getShaderCacheKey(program, optimizationRecipe);
 
-        res = shadercacheLoad(cachekey, commandLine.getShaderCacheFilename(), hash);
+        res = shadercacheLoad(hash);
 
         if (res)
         {
@@ -776,7 +394,7 @@ ProgramBinary *buildProgram(const GlslSource &program, glu::ShaderProgramInfo *b
 
         res = createProgramBinaryFromSpirV(binary);
         if (commandLine.isShadercacheEnabled())
-            shadercacheSave(res, cachekey, commandLine.getShaderCacheFilename(), hash);
+            shadercacheSave(res, hash);
     }
     return res;
 }
@@ -787,35 +405,25 @@ ProgramBinary *buildProgram(const HlslSource &program, glu::ShaderProgramInfo *b
     const SpirvVersion spirvVersion = program.buildOptions.targetVersion;
     const bool validateBinary       = VALIDATE_BINARIES;
     vector<uint32_t> binary;
-    std::string cachekey;
     std::string shaderstring;
     vk::ProgramBinary *res       = 0;
     const int optimizationRecipe = commandLine.getOptimizationRecipe();
-    int32_t hash                 = 0;
+    deSha1 hash;
 
     if (commandLine.isShadercacheEnabled())
     {
         shaderCacheFirstRunCheck(commandLine);
-        getCompileEnvironment(cachekey);
-        getBuildOptions(cachekey, program.buildOptions, optimizationRecipe);
 
         for (int i = 0; i < glu::SHADERTYPE_LAST; i++)
         {
-            if (!program.sources[i].empty())
-            {
-                cachekey += glu::getShaderTypeName((glu::ShaderType)i);
-
-                for (std::vector<std::string>::const_iterator it = program.sources[i].begin();
-                     it != program.sources[i].end(); ++it)
-                    shaderstring += *it;
-            }
+            for (std::vector<std::string>::const_iterator it = program.sources[i].begin();
+                 it != program.sources[i].end(); ++it)
+                shaderstring += *it;
         }
 
-        cachekey = cachekey + shaderstring;
+        hash = getShaderCacheKey(program, optimizationRecipe);
 
-        hash = shadercacheHash(cachekey.c_str());
-
-        res = shadercacheLoad(cachekey, commandLine.getShaderCacheFilename(), hash);
+        res = shadercacheLoad(hash);
 
         if (res)
         {
@@ -867,7 +475,7 @@ ProgramBinary *buildProgram(const HlslSource &program, glu::ShaderProgramInfo *b
         res = createProgramBinaryFromSpirV(binary);
         if (commandLine.isShadercacheEnabled())
         {
-            shadercacheSave(res, cachekey, commandLine.getShaderCacheFilename(), hash);
+            shadercacheSave(res, hash);
         }
     }
     return res;
@@ -880,29 +488,16 @@ ProgramBinary *assembleProgram(const SpirVAsmSource &program, SpirVProgramInfo *
     const bool validateBinary       = VALIDATE_BINARIES;
     vector<uint32_t> binary;
     vk::ProgramBinary *res = 0;
-    std::string cachekey;
     const int optimizationRecipe = commandLine.isSpirvOptimizationEnabled() ? commandLine.getOptimizationRecipe() : 0;
-    uint32_t hash                = 0;
+    deSha1 hash;
 
     if (commandLine.isShadercacheEnabled())
     {
         shaderCacheFirstRunCheck(commandLine);
-        getCompileEnvironment(cachekey);
-        cachekey += "Target Spir-V ";
-        cachekey += getSpirvVersionName(spirvVersion);
-        cachekey += "\n";
-        if (optimizationRecipe != 0)
-        {
-            cachekey += "Optimization recipe ";
-            cachekey += de::toString(optimizationRecipe);
-            cachekey += "\n";
-        }
-
-        cachekey += program.source;
 
-        hash = shadercacheHash(cachekey.c_str());
+        hash = getShaderCacheKey(program, optimizationRecipe);
 
-        res = shadercacheLoad(cachekey, commandLine.getShaderCacheFilename(), hash);
+        res = shadercacheLoad(hash);
 
         if (res)
         {
@@ -933,7 +528,7 @@ ProgramBinary *assembleProgram(const SpirVAsmSource &program, SpirVProgramInfo *
         res = createProgramBinaryFromSpirV(binary);
         if (commandLine.isShadercacheEnabled())
         {
-            shadercacheSave(res, cachekey, commandLine.getShaderCacheFilename(), hash);
+            shadercacheSave(res, hash);
         }
     }
     return res;
@@ -30,6 +30,7 @@
 
 #include "deUniquePtr.hpp"
 #include "deSTLUtil.hpp"
+#include "deSha1.h"
 
 #include <vector>
 #include <map>
@@ -263,6 +264,12 @@ ProgramBinary *buildProgram(const HlslSource &program, glu::ShaderProgramInfo *b
                             const tcu::CommandLine &commandLine);
 ProgramBinary *assembleProgram(const vk::SpirVAsmSource &program, SpirVProgramInfo *buildInfo,
                                const tcu::CommandLine &commandLine);
+
+// Digest of everything that affects the binary produced by buildProgram() or assembleProgram()
+deSha1 getProgramDigest(const GlslSource &program, const tcu::CommandLine &commandLine);
+deSha1 getProgramDigest(const HlslSource &program, const tcu::CommandLine &commandLine);
+deSha1 getProgramDigest(const vk::SpirVAsmSource &program, const tcu::CommandLine &commandLine);
+
 void disassembleProgram(const ProgramBinary &program, std::ostream *dst);
 bool validateProgram(const ProgramBinary &program, std::ostream *dst, const SpirvValidatorOptions &);
 
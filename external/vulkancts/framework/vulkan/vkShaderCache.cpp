@@ -0,0 +1,497 @@
+/*-------------------------------------------------------------------------
+ * Vulkan CTS Framework
+ * --------------------
+ *
+ * Copyright (c) 2026 The Khronos Group Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *//*!
+ * \file
+ * \brief Persistent, memory-mapped shader binary cache.
+ *//*--------------------------------------------------------------------*/
+
+#include "vkShaderCache.hpp"
+
+#include "deAtomic.h"
+#include "deFilePath.hpp"
+#include "deMemory.h"
+#include "deRandom.hpp"
+#include "deSharedPtr.hpp"
+#include "deUniquePtr.hpp"
+
+namespace vk
+{
+
+namespace
+{
+
+enum
+{
+    CACHE_MAGIC       = 0x43537664, // "dvSC"
+    CACHE_VERSION     = 2,
+    CACHE_INDEX_SIZE  = 256 * 1024, // Must be power of two
+    CACHE_MAX_PROBES  = 64,
+    CACHE_HEADER_SIZE = 64,
+    DATA_ALIGNMENT    = 16, // Data offsets are stored in units of DATA_ALIGNMENT bytes
+};
+
+// Offsets are 32-bit so that they can be updated atomically on all platforms. With
+// DATA_ALIGNMENT sized units the data section can grow up to 64GB.
+struct Header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t indexSize;
+    volatile uint32_t dataEnd; //!< End of reserved data, updated atomically
+};
+
+// Entry is empty if size is zero. Entry is claimed but not yet published if size is
+// non-zero and offset is zero.
+struct IndexEntry
+{
+    volatile uint32_t offset; //!< Offset of data record, written last
+    volatile uint32_t size;   //!< Size of binary, used for claiming entry
+    uint32_t key[5];
+    uint32_t reserved;
+};
+
+// Data record is the program format followed by the binary, padded to DATA_ALIGNMENT
+enum
+{
+    RECORD_HEADER_SIZE = sizeof(uint32_t)
+};
+
+DE_STATIC_ASSERT(sizeof(Header) <= CACHE_HEADER_SIZE);
+DE_STATIC_ASSERT(sizeof(IndexEntry) == 32);
+
+const int64_t s_dataStart = (int64_t)CACHE_HEADER_SIZE + (int64_t)CACHE_INDEX_SIZE * sizeof(IndexEntry);
+
+DE_STATIC_ASSERT((CACHE_HEADER_SIZE + CACHE_INDEX_SIZE * 32) % DATA_ALIGNMENT == 0);
+
+inline Header *getHeader(uint8_t *base)
+{
+    return (Header *)base;
+}
+
+inline IndexEntry *getIndex(uint8_t *base)
+{
+    return (IndexEntry *)(base + CACHE_HEADER_SIZE);
+}
+
+inline uint32_t getEntryNdx(const deSha1 &key, uint32_t probeNdx)
+{
+    return (key.hash[0] + probeNdx) & (CACHE_INDEX_SIZE - 1);
+}
+
+bool isHeaderValid(const uint8_t *ptr)
+{
+    uint32_t header[3];
+
+    deMemcpy(header, ptr, sizeof(header));
+
+    return header[0] == (uint32_t)CACHE_MAGIC && header[1] == (uint32_t)CACHE_VERSION &&
+           header[2] == (uint32_t)CACHE_INDEX_SIZE;
+}
+
+} // namespace
+
+ShaderCache::ShaderCache(const char *filename, bool truncate)
+    : m_file(DE_NULL)
+    , m_base(DE_NULL)
+    , m_mapping(DE_NULL)
+{
+    const de::FilePath filePath(filename);
+    const uint32_t mode = DE_FILEMODE_READ | DE_FILEMODE_WRITE | DE_FILEMODE_OPEN | DE_FILEMODE_CREATE;
+
+    if (!filePath.getDirName().empty() && !de::FilePath(filePath.getDirName()).exists())
+        de::createDirectoryAndParents(filePath.getDirName().c_str());
+
+    m_file = deFile_create(filename, mode);
+
+    if (!m_file)
+        return;
+
+    // Other processes may be opening the same file; the lock makes checking and
+    // initializing the header atomic. Truncation is done here as well, instead of
+    // when opening the file.
+    if (deFile_lock(m_file))
+    {
+        const bool initialized = initialize(truncate);
+
+        deFile_unlock(m_file);
+
+        if (initialized)
+            return;
+    }
+
+    deFile_destroy(m_file);
+    m_file = DE_NULL;
+}
+
+ShaderCache::~ShaderCache(void)
+{
+    for (size_t mappingNdx = 0; mappingNdx < m_mappings.size(); mappingNdx++)
+    {
+        deFile_unmap(m_mappings[mappingNdx]->ptr, m_mappings[mappingNdx]->size);
+        delete m_mappings[mappingNdx];
+    }
+
+    if (m_file)
+        deFile_destroy(m_file);
+}
+
+bool ShaderCache::initialize(bool truncate)
+{
+    // Initialize file if it is empty or has been written by an incompatible version
+    {
+        const int64_t size = deFile_getSize(m_file);
+        bool valid         = false;
+
+        if (!truncate && size >= s_dataStart)
+        {
+            uint8_t header[CACHE_HEADER_SIZE];
+            int64_t numRead = 0;
+
+            if (deFile_seek(m_file, DE_FILEPOSITION_BEGIN, 0) &&
+                deFile_read(m_file, header, sizeof(header), &numRead) == DE_FILERESULT_SUCCESS &&
+                numRead == (int64_t)sizeof(header))
+                valid = isHeaderValid(header);
+        }
+
+        if (!valid)
+        {
+            Header header;
+
+            deMemset(&header, 0, sizeof(header));
+            header.magic     = CACHE_MAGIC;
+            header.version   = CACHE_VERSION;
+            header.indexSize = CACHE_INDEX_SIZE;
+            header.dataEnd   = (uint32_t)(s_dataStart / DATA_ALIGNMENT);
+
+            // Index is zero-filled by growing the file
+            if (!deFile_setSize(m_file, 0) || !deFile_setSize(m_file, s_dataStart) ||
+                !writeData(0, sizeof(header), &header))
+                return false;
+        }
+    }
+
+    {
+        de::MovePtr<Mapping> mapping(new Mapping());
+
+        m_mappings.reserve(1);
+
+        mapping->size = deFile_getSize(m_file);
+        mapping->ptr  = (uint8_t *)deFile_map(m_file, mapping->size, true);
+
+        if (!mapping->ptr)
+            return false;
+
+        m_base    = mapping->ptr;
+        m_mapping = mapping.get();
+        m_mappings.push_back(mapping.release());
+    }
+
+    return true;
+}
+
+const ShaderCache::Mapping *ShaderCache::getMapping(uint64_t end)
+{
+    const Mapping *mapping = m_mapping;
+
+    if (end <= (uint64_t)mapping->size)
+        return mapping;
+
+    {
+        const de::ScopedLock lock(m_mappingLock);
+        de::MovePtr<Mapping> newMapping;
+
+        // Another thread may have grown the mapping already
+        mapping = m_mapping;
+
+        if (end <= (uint64_t)mapping->size)
+            return mapping;
+
+        m_mappings.reserve(m_mappings.size() + 1);
+        newMapping = de::MovePtr<Mapping>(new Mapping());
+
+        // Mappings grow geometrically, which bounds the total size of the mappings kept alive.
+        // Mapping past the end of the file is fine, since only published data is read.
+        newMapping->size = de::max(de::max((int64_t)end, deFile_getSize(m_file)), 2 * mapping->size);
+        newMapping->ptr  = (uint8_t *)deFile_map(m_file, newMapping->size, true);
+
+        if (!newMapping->ptr)
+        {
+            newMapping->size = (int64_t)end;
+            newMapping->ptr  = (uint8_t *)deFile_map(m_file, newMapping->size, true);
+
+            if (!newMapping->ptr)
+                return DE_NULL;
+        }
+
+        mapping = newMapping.get();
+        m_mappings.push_back(newMapping.release());
+
+        // Mapping must be complete before other threads can see it
+        deMemoryReadWriteFence();
+        m_mapping = mapping;
+
+        return mapping;
+    }
+}
+
+bool ShaderCache::readData(uint64_t offset, size_t size, void *dst)
+{
+    const Mapping *const mapping = getMapping(offset + size);
+
+    if (!mapping)
+        return false;
+
+    deMemcpy(dst, mapping->ptr + offset, size);
+
+    return true;
+}
+
+bool ShaderCache::writeData(uint64_t offset, size_t size, const void *src)
+{
+    const de::ScopedLock lock(m_fileLock);
+    int64_t numWritten = 0;
+
+    return deFile_seek(m_file, DE_FILEPOSITION_BEGIN, (int64_t)offset) &&
+           deFile_write(m_file, src, (int64_t)size, &numWritten) == DE_FILERESULT_SUCCESS &&
+           numWritten == (int64_t)size;
+}
+
+ProgramBinary *ShaderCache::load(const deSha1 &key)
+{
+    if (!isValid())
+        return DE_NULL;
+
+    IndexEntry *const index = getIndex(m_base);
+
+    for (uint32_t probeNdx = 0; probeNdx < CACHE_MAX_PROBES; probeNdx++)
+    {
+        IndexEntry &entry     = index[getEntryNdx(key, probeNdx)];
+        const uint32_t offset = entry.offset;
+
+        if (offset == 0)
+        {
+            // Empty entry terminates the probe sequence; claimed but unpublished entries are skipped
+            if (entry.size == 0)
+                break;
+            else
+                continue;
+        }
+
+        // Key and size are written before the offset is published
+        deMemoryReadWriteFence();
+
+        if (deMemCmp(entry.key, key.hash, sizeof(key.hash)) == 0)
+        {
+            const size_t binarySize = entry.size;
+            std::vector<uint8_t> record(RECORD_HEADER_SIZE + binarySize);
+            uint32_t format;
+
+            if (!readData((uint64_t)offset * DATA_ALIGNMENT, record.size(), &record[0]))
+                return DE_NULL;
+
+            deMemcpy(&format, &record[0], sizeof(format));
+
+            if (format >= PROGRAM_FORMAT_LAST)
+                return DE_NULL;
+
+            return new ProgramBinary((ProgramFormat)format, binarySize, &record[RECORD_HEADER_SIZE]);
+        }
+    }
+
+    return DE_NULL;
+}
+
+void ShaderCache::store(const deSha1 &key, const ProgramBinary &binary)
+{
+    const uint32_t binarySize = (uint32_t)binary.getSize();
+
+    if (!isValid() || binarySize == 0)
+        return;
+
+    IndexEntry *const index = getIndex(m_base);
+    IndexEntry *entry       = DE_NULL;
+
+    // Claim an empty index entry, or give up if the key is already present
+    for (uint32_t probeNdx = 0; probeNdx < CACHE_MAX_PROBES; probeNdx++)
+    {
+        IndexEntry &candidate = index[getEntryNdx(key, probeNdx)];
+
+        if (candidate.offset != 0)
+        {
+            deMemoryReadWriteFence();
+
+            if (deMemCmp(candidate.key, key.hash, sizeof(key.hash)) == 0)
+                return;
+        }
+        else if (candidate.size == 0 && deAtomicCompareExchangeUint32(&candidate.size, 0u, binarySize) == 0u)
+        {
+            entry = &candidate;
+            break;
+        }
+    }
+
+    // Index is full around this key
+    if (!entry)
+        return;
+
+    deMemcpy(entry->key, key.hash, sizeof(key.hash));
+
+    // Reserve space for the record. On failure below the entry stays claimed but is
+    // never published, and lookups skip it.
+    {
+        Header *const header    = getHeader(m_base);
+        const uint64_t numUnits = ((uint64_t)RECORD_HEADER_SIZE + binarySize + DATA_ALIGNMENT - 1) / DATA_ALIGNMENT;
+        std::vector<uint8_t> record((size_t)(numUnits * DATA_ALIGNMENT), 0u);
+        const uint32_t format = (uint32_t)binary.getFormat();
+        uint32_t offset;
+
+        for (;;)
+        {
+            offset = header->dataEnd;
+
+            // Data section is full
+            if ((uint64_t)offset + numUnits > 0xFFFFFFFFull)
+                return;
+
+            if (deAtomicCompareExchangeUint32(&header->dataEnd, offset, offset + (uint32_t)numUnits) == offset)
+                break;
+        }
+
+        deMemcpy(&record[0], &format, sizeof(format));
+        deMemcpy(&record[RECORD_HEADER_SIZE], binary.getBinary(), binarySize);
+
+        if (!writeData((uint64_t)offset * DATA_ALIGNMENT, record.size(), &record[0]))
+            return;
+
+        deMemoryReadWriteFence();
+        entry->offset = offset;
+    }
+}
+
+void shaderCacheSelfTest(void)
+{
+    const char *const filename = "vk-shader-cache-selftest.bin";
+    const int numEntries       = 64;
+    de::Random rnd(0x5ade4cac);
+    std::vector<deSha1> keys(numEntries + 1);
+    std::vector<de::SharedPtr<ProgramBinary>> binaries(numEntries + 1);
+
+    for (int entryNdx = 0; entryNdx <= numEntries; entryNdx++)
+    {
+        std::vector<uint8_t> data((size_t)rnd.getInt(1, 4096));
+
+        for (size_t byteNdx = 0; byteNdx < data.size(); byteNdx++)
+            data[byteNdx] = rnd.getUint8();
+
+        deSha1_compute(&keys[entryNdx], sizeof(entryNdx), &entryNdx);
+        binaries[entryNdx] =
+            de::SharedPtr<ProgramBinary>(new ProgramBinary(PROGRAM_FORMAT_SPIRV, data.size(), &data[0]));
+    }
+
+    try
+    {
+        // Entries written through one instance are visible through another one, including
+        // entries appended after the other instance mapped the file.
+        {
+            ShaderCache writer(filename, true);
+            ShaderCache reader(filename, false);
+
+            DE_TEST_ASSERT(writer.isValid() && reader.isValid());
+
+            for (int entryNdx = 0; entryNdx < numEntries; entryNdx++)
+            {
+                writer.store(keys[entryNdx], *binaries[entryNdx]);
+
+                for (int cacheNdx = 0; cacheNdx < 2; cacheNdx++)
+                {
+                    ShaderCache &cache = cacheNdx == 0 ? writer : reader;
+                    const ProgramBinary &expected = *binaries[entryNdx];
+                    const de::UniquePtr<ProgramBinary> loaded(cache.load(keys[entryNdx]));
+
+                    DE_TEST_ASSERT(loaded && loaded->getFormat() == expected.getFormat());
+                    DE_TEST_ASSERT(loaded->getSize() == expected.getSize());
+                    DE_TEST_ASSERT(deMemCmp(loaded->getBinary(), expected.getBinary(), expected.getSize()) == 0);
+                }
+            }
+
+            DE_TEST_ASSERT(!reader.load(keys[numEntries]));
+        }
+
+        // Entries persist when the file is reopened
+        {
+            ShaderCache cache(filename, false);
+
+            for (int entryNdx = 0; entryNdx < numEntries; entryNdx++)
+            {
+                const de::UniquePtr<ProgramBinary> loaded(cache.load(keys[entryNdx]));
+
+                DE_TEST_ASSERT(loaded && loaded->getSize() == binaries[entryNdx]->getSize());
+            }
+        }
+
+        // Entry that was claimed but never published is skipped, and the key can still be stored
+        {
+            const deSha1 &key = keys[numEntries];
+            deFile *file      = deFile_create(filename, DE_FILEMODE_READ | DE_FILEMODE_WRITE | DE_FILEMODE_OPEN);
+            IndexEntry entry;
+            int64_t numWritten = 0;
+
+            DE_TEST_ASSERT(file);
+
+            deMemset(&entry, 0, sizeof(entry));
+            entry.size = 16;
+            deMemcpy(entry.key, key.hash, sizeof(key.hash));
+
+            DE_TEST_ASSERT(deFile_seek(file, DE_FILEPOSITION_BEGIN,
+                                       CACHE_HEADER_SIZE + (int64_t)getEntryNdx(key, 0) * sizeof(IndexEntry)));
+            DE_TEST_ASSERT(deFile_write(file, &entry, sizeof(entry), &numWritten) == DE_FILERESULT_SUCCESS);
+            deFile_destroy(file);
+
+            {
+                ShaderCache cache(filename, false);
+
+                DE_TEST_ASSERT(!cache.load(key));
+
+                cache.store(key, *binaries[numEntries]);
+
+                {
+                    const de::UniquePtr<ProgramBinary> loaded(cache.load(key));
+
+                    DE_TEST_ASSERT(loaded && loaded->getSize() == binaries[numEntries]->getSize());
+                }
+            }
+        }
+
+        // Truncating removes all entries
+        {
+            ShaderCache cache(filename, true);
+
+            DE_TEST_ASSERT(cache.isValid() && !cache.load(keys[0]));
+        }
+    }
+    catch (...)
+    {
+        deDeleteFile(filename);
+        throw;
+    }
+
+    deDeleteFile(filename);
+}
+
+} // namespace vk
@@ -0,0 +1,107 @@
+#ifndef _VKSHADERCACHE_HPP
+#define _VKSHADERCACHE_HPP
+/*-------------------------------------------------------------------------
+ * Vulkan CTS Framework
+ * --------------------
+ *
+ * Copyright (c) 2026 The Khronos Group Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *//*!
+ * \file
+ * \brief Persistent, memory-mapped shader binary cache.
+ *//*--------------------------------------------------------------------*/
+
+#include "vkDefs.hpp"
+#include "vkPrograms.hpp"
+
+#include "deMutex.hpp"
+#include "deSha1.h"
+#include "deFile.h"
+
+#include <vector>
+
+namespace vk
+{
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Shader binary cache store
+ *
+ * Cache is a single file consisting of a header, a fixed size open
+ * addressing index keyed by SHA-1 digests and an append-only data section.
+ * The file is memory-mapped and shared; several threads and processes may
+ * use the same cache file concurrently.
+ *
+ * Lookups never take locks. New entries are written in two steps: binary
+ * data is appended first into a range reserved with an atomic update of
+ * the header, then the index entry is published by writing its data
+ * offset. Readers only consider entries with a non-zero offset.
+ *
+ * Entries appended after the file was mapped are read through a larger
+ * mapping of the same file. Mappings are replaced under a lock, but old
+ * mappings stay valid until the cache is destroyed, so readers never wait
+ * for each other.
+ *
+ * Index entries are claimed before the data is written. If writing fails,
+ * or the process writing the entry dies, the entry stays claimed forever:
+ * lookups and stores skip it, but it is not reused.
+ *
+ * File is initialized while holding an advisory file lock. Truncating the
+ * cache is only safe when no other process is using the same file.
+ *//*--------------------------------------------------------------------*/
+class ShaderCache
+{
+public:
+    ShaderCache(const char *filename, bool truncate);
+    ~ShaderCache(void);
+
+    bool isValid(void) const
+    {
+        return m_base != DE_NULL;
+    }
+
+    //! Returns cached binary or null if key was not found.
+    ProgramBinary *load(const deSha1 &key);
+    void store(const deSha1 &key, const ProgramBinary &binary);
+
+private:
+    ShaderCache(const ShaderCache &);            // Not allowed!
+    ShaderCache &operator=(const ShaderCache &); // Not allowed!
+
+    struct Mapping
+    {
+        uint8_t *ptr;
+        int64_t size;
+    };
+
+    bool initialize(bool truncate);
+    const Mapping *getMapping(uint64_t end);
+
+    bool readData(uint64_t offset, size_t size, void *dst);
+    bool writeData(uint64_t offset, size_t size, const void *src);
+
+    deFile *m_file;
+    uint8_t *m_base;                   //!< Header and index, from the first mapping
+    const Mapping *volatile m_mapping; //!< Largest mapping
+    std::vector<Mapping *> m_mappings; //!< All mappings, unmapped on destruction
+    de::Mutex m_mappingLock;           //!< Protects replacing m_mapping
+    de::Mutex m_fileLock;              //!< Protects file position of m_file
+};
+
+//! Exercises the cache file; throws on failure.
+void shaderCacheSelfTest(void);
+
+} // namespace vk
+
+#endif // _VKSHADERCACHE_HPP
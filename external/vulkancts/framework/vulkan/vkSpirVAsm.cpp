@@ -26,6 +26,8 @@
 #include "deClock.h"
 
 #include <algorithm>
+#include <map>
+#include <utility>
 
 #include "spirv-tools/libspirv.h"
 
@@ -94,16 +96,143 @@ static spv_target_env mapTargetSpvEnvironment(SpirvVersion spirvVersion)
     return result;
 }
 
+/*--------------------------------------------------------------------*//*!
+ * \brief SPIRV-Tools objects reused by the calls made on one thread
+ *
+ * Creating a context builds the opcode and operand tables of the target
+ * environment, which is a significant part of the cost of assembling or
+ * validating a small program. Contexts and validator options are created
+ * on first use and kept until the thread exits.
+ *//*--------------------------------------------------------------------*/
+class SpirvToolsCache
+{
+public:
+    SpirvToolsCache(void)
+    {
+    }
+
+    ~SpirvToolsCache(void)
+    {
+        for (ContextMap::const_iterator it = m_contexts.begin(); it != m_contexts.end(); ++it)
+            spvContextDestroy(it->second);
+
+        for (ValidatorOptionsMap::const_iterator it = m_validatorOptions.begin(); it != m_validatorOptions.end(); ++it)
+            spvValidatorOptionsDestroy(it->second);
+    }
+
+    spv_context getContext(spv_target_env env)
+    {
+        const ContextMap::const_iterator it = m_contexts.find(env);
+
+        if (it != m_contexts.end())
+            return it->second;
+
+        {
+            const spv_context context = spvContextCreate(env);
+
+            if (!context)
+                throw std::bad_alloc();
+
+            try
+            {
+                m_contexts[env] = context;
+            }
+            catch (...)
+            {
+                spvContextDestroy(context);
+                throw;
+            }
+
+            return context;
+        }
+    }
+
+    spv_validator_options getValidatorOptions(const SpirvValidatorOptions &valOptions)
+    {
+        const ValidatorOptionsKey key(valOptions.blockLayout, valOptions.flags);
+        const ValidatorOptionsMap::const_iterator it = m_validatorOptions.find(key);
+
+        if (it != m_validatorOptions.end())
+            return it->second;
+
+        {
+            const spv_validator_options options = createValidatorOptions(valOptions);
+
+            try
+            {
+                m_validatorOptions[key] = options;
+            }
+            catch (...)
+            {
+                spvValidatorOptionsDestroy(options);
+                throw;
+            }
+
+            return options;
+        }
+    }
+
+    static SpirvToolsCache &getThreadCache(void)
+    {
+        static thread_local SpirvToolsCache s_cache;
+        return s_cache;
+    }
+
+private:
+    SpirvToolsCache(const SpirvToolsCache &);
+    SpirvToolsCache &operator=(const SpirvToolsCache &);
+
+    static spv_validator_options createValidatorOptions(const SpirvValidatorOptions &valOptions)
+    {
+        const spv_validator_options options = spvValidatorOptionsCreate();
+
+        if (options == DE_NULL)
+            throw std::bad_alloc();
+
+        switch (valOptions.blockLayout)
+        {
+        case SpirvValidatorOptions::kDefaultBlockLayout:
+            break;
+        case SpirvValidatorOptions::kNoneBlockLayout:
+            spvValidatorOptionsSetSkipBlockLayout(options, true);
+            break;
+        case SpirvValidatorOptions::kRelaxedBlockLayout:
+            spvValidatorOptionsSetRelaxBlockLayout(options, true);
+            break;
+        case SpirvValidatorOptions::kUniformStandardLayout:
+            spvValidatorOptionsSetUniformBufferStandardLayout(options, true);
+            break;
+        case SpirvValidatorOptions::kScalarBlockLayout:
+            spvValidatorOptionsSetScalarBlockLayout(options, true);
+            break;
+        }
+
+        if (valOptions.flags & SpirvValidatorOptions::FLAG_SPIRV_VALIDATOR_WORKGROUP_SCALAR_BLOCK_LAYOUT)
+        {
+            spvValidatorOptionsSetWorkgroupScalarBlockLayout(options, true);
+        }
+
+        if (valOptions.flags & SpirvValidatorOptions::FLAG_SPIRV_VALIDATOR_ALLOW_LOCALSIZEID)
+            spvValidatorOptionsSetAllowLocalSizeId(options, true);
+
+        return options;
+    }
+
+    typedef std::map<spv_target_env, spv_context> ContextMap;
+    typedef std::pair<SpirvValidatorOptions::BlockLayoutRules, uint32_t> ValidatorOptionsKey;
+    typedef std::map<ValidatorOptionsKey, spv_validator_options> ValidatorOptionsMap;
+
+    ContextMap m_contexts;
+    ValidatorOptionsMap m_validatorOptions;
+};
+
 bool assembleSpirV(const SpirVAsmSource *program, std::vector<uint32_t> *dst, SpirVProgramInfo *buildInfo,
                    SpirvVersion spirvVersion)
 {
-    const spv_context context = spvContextCreate(mapTargetSpvEnvironment(spirvVersion));
+    const spv_context context = SpirvToolsCache::getThreadCache().getContext(mapTargetSpvEnvironment(spirvVersion));
     spv_binary binary         = DE_NULL;
     spv_diagnostic diagnostic = DE_NULL;
 
-    if (!context)
-        throw std::bad_alloc();
-
     try
     {
         const std::string &spvSource    = program->source;
@@ -126,7 +255,6 @@ bool assembleSpirV(const SpirVAsmSource *program, std::vector<uint32_t> *dst, Sp
 
         spvBinaryDestroy(binary);
         spvDiagnosticDestroy(diagnostic);
-        spvContextDestroy(context);
 
         return compileOk == SPV_SUCCESS;
     }
@@ -134,7 +262,6 @@ bool assembleSpirV(const SpirVAsmSource *program, std::vector<uint32_t> *dst, Sp
     {
         spvBinaryDestroy(binary);
         spvDiagnosticDestroy(diagnostic);
-        spvContextDestroy(context);
 
         throw;
     }
@@ -142,13 +269,10 @@ bool assembleSpirV(const SpirVAsmSource *program, std::vector<uint32_t> *dst, Sp
 
 void disassembleSpirV(size_t binarySizeInWords, const uint32_t *binary, std::ostream *dst, SpirvVersion spirvVersion)
 {
-    const spv_context context = spvContextCreate(mapTargetSpvEnvironment(spirvVersion));
+    const spv_context context = SpirvToolsCache::getThreadCache().getContext(mapTargetSpvEnvironment(spirvVersion));
     spv_text text             = DE_NULL;
     spv_diagnostic diagnostic = DE_NULL;
 
-    if (!context)
-        throw std::bad_alloc();
-
     try
     {
         const spv_result_t result = spvBinaryToText(context, binary, binarySizeInWords, 0, &text, &diagnostic);
@@ -160,13 +284,11 @@ void disassembleSpirV(size_t binarySizeInWords, const uint32_t *binary, std::ost
 
         spvTextDestroy(text);
         spvDiagnosticDestroy(diagnostic);
-        spvContextDestroy(context);
     }
     catch (...)
     {
         spvTextDestroy(text);
         spvDiagnosticDestroy(diagnostic);
-        spvContextDestroy(context);
 
         throw;
     }
@@ -175,49 +297,16 @@ void disassembleSpirV(size_t binarySizeInWords, const uint32_t *binary, std::ost
 bool validateSpirV(size_t binarySizeInWords, const uint32_t *binary, std::ostream *infoLog,
                    const SpirvValidatorOptions &val_options)
 {
-    const spv_context context     = spvContextCreate(getSpirvToolsEnvForValidatorOptions(val_options));
-    spv_diagnostic diagnostic     = DE_NULL;
-    spv_validator_options options = DE_NULL;
-    spv_text disasmText           = DE_NULL;
-
-    if (!context)
-        throw std::bad_alloc();
+    SpirvToolsCache &cache              = SpirvToolsCache::getThreadCache();
+    const spv_context context           = cache.getContext(getSpirvToolsEnvForValidatorOptions(val_options));
+    const spv_validator_options options = cache.getValidatorOptions(val_options);
+    spv_diagnostic diagnostic           = DE_NULL;
+    spv_text disasmText                 = DE_NULL;
 
     try
     {
         spv_const_binary_t cbinary = {binary, binarySizeInWords};
 
-        options = spvValidatorOptionsCreate();
-
-        if (options == DE_NULL)
-            throw std::bad_alloc();
-
-        switch (val_options.blockLayout)
-        {
-        case SpirvValidatorOptions::kDefaultBlockLayout:
-            break;
-        case SpirvValidatorOptions::kNoneBlockLayout:
-            spvValidatorOptionsSetSkipBlockLayout(options, true);
-            break;
-        case SpirvValidatorOptions::kRelaxedBlockLayout:
-            spvValidatorOptionsSetRelaxBlockLayout(options, true);
-            break;
-        case SpirvValidatorOptions::kUniformStandardLayout:
-            spvValidatorOptionsSetUniformBufferStandardLayout(options, true);
-            break;
-        case SpirvValidatorOptions::kScalarBlockLayout:
-            spvValidatorOptionsSetScalarBlockLayout(options, true);
-            break;
-        }
-
-        if (val_options.flags & SpirvValidatorOptions::FLAG_SPIRV_VALIDATOR_WORKGROUP_SCALAR_BLOCK_LAYOUT)
-        {
-            spvValidatorOptionsSetWorkgroupScalarBlockLayout(options, true);
-        }
-
-        if (val_options.flags & SpirvValidatorOptions::FLAG_SPIRV_VALIDATOR_ALLOW_LOCALSIZEID)
-            spvValidatorOptionsSetAllowLocalSizeId(options, true);
-
         const spv_result_t valid = spvValidateWithOptions(context, options, &cbinary, &diagnostic);
         const bool passed        = (valid == SPV_SUCCESS);
 
@@ -242,18 +331,14 @@ bool validateSpirV(size_t binarySizeInWords, const uint32_t *binary, std::ostrea
         }
 
         spvTextDestroy(disasmText);
-        spvValidatorOptionsDestroy(options);
         spvDiagnosticDestroy(diagnostic);
-        spvContextDestroy(context);
 
         return passed;
     }
     catch (...)
     {
         spvTextDestroy(disasmText);
-        spvValidatorOptionsDestroy(options);
         spvDiagnosticDestroy(diagnostic);
-        spvContextDestroy(context);
 
         throw;
     }
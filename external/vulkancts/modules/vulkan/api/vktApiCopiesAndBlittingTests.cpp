@@ -3855,9 +3855,9 @@ CompressedTextureForBlit::CompressedTextureForBlit(const tcu::CompressedTexForma
     m_decompressedAccess =
         tcu::PixelBufferAccess(decompressedSrcFormat, width, height, depth, m_decompressedData.getPtr());
 
-    // store decompressed data
+    // store decompressed data, decoded texels don't depend on the thread count
     m_compressedTexture.decompress(m_decompressedAccess,
-                                   tcu::TexDecompressionParams(tcu::TexDecompressionParams::ASTCMODE_LDR));
+                                   tcu::TexDecompressionParams(tcu::TexDecompressionParams::ASTCMODE_LDR, 0));
 }
 
 tcu::PixelBufferAccess CompressedTextureForBlit::getDecompressedAccess() const
@@ -4166,7 +4166,9 @@ tcu::TestStatus BlittingImages::iterate(void)
         tcu::TextureLevel decompressedLevel(getUncompressedFormat(dstCompressedFormat), dstWidth, dstHeight, dstDepth);
         tcu::PixelBufferAccess decompressedAccess(decompressedLevel.getAccess());
 
-        tcu::decompress(decompressedAccess, dstCompressedFormat, compressedDataSrc);
+        // Decoded texels don't depend on the thread count, decode on all cores.
+        tcu::decompress(decompressedAccess, dstCompressedFormat, compressedDataSrc,
+                        tcu::TexDecompressionParams(tcu::TexDecompressionParams::ASTCMODE_LAST, 0));
 
         return checkTestResult(decompressedAccess);
     }
@@ -29,6 +29,7 @@
 #include "amber/vktAmberTestCase.hpp"
 
 #include "deMath.h"
+#include "deInt32.h"
 #include "deMemory.h"
 #include "deFloat16.h"
 #include "deDefs.hpp"
@@ -48,22 +49,27 @@
 #include "tcuResultCollector.hpp"
 #include "tcuMaybe.hpp"
 #include "tcuFloat.hpp"
+#include "tcuParallelFor.hpp"
 
 #include "gluContextInfo.hpp"
 #include "gluVarType.hpp"
 #include "gluRenderContext.hpp"
 #include "glwDefs.hpp"
 
+#include <cstddef>
 #include <cstdint>
 #include <cmath>
 #include <string>
 #include <sstream>
 #include <iostream>
 #include <map>
+#include <new>
 #include <utility>
 #include <limits>
 #include <tuple>
 #include <valarray>
+#include <mutex>
+#include <atomic>
 
 // Uncomment this to get evaluation trace dumps to std::cerr
 //#define GLS_ENABLE_TRACE
@@ -94,7 +100,13 @@ enum
     // platforms where toggling floating-point rounding mode is slow (emulated arm on x86).
     // As a workaround watchdog is kept happy by touching it periodically during reference
     // interval computation.
-    TOUCH_WATCHDOG_VALUE_FREQUENCY = 512
+    TOUCH_WATCHDOG_VALUE_FREQUENCY = 512,
+
+    // Number of inputs for which reference intervals are computed at once by a compiled statement.
+    REFERENCE_BATCH_SIZE = 64,
+
+    // Number of inputs verified by one parallelFor() range.
+    VERIFY_VALUES_PER_RANGE = 4 * REFERENCE_BATCH_SIZE
 };
 
 namespace vkt
@@ -1277,11 +1289,128 @@ template <typename T>
 VariableP<T> variable(const string &name);
 StatementP compoundStatement(const vector<StatementP> &statements);
 
+/*--------------------------------------------------------------------*//*!
+ * \brief Type-independent part of a variable.
+ *
+ * Each variable has a slot in the environment frame of the scope it is used
+ * in. Slots are assigned by assignFrameSlots() after the statements of the
+ * scope have been built, so evaluation doesn't need to look up variables by
+ * name.
+ *
+ *//*--------------------------------------------------------------------*/
+class VariableBase
+{
+public:
+    VariableBase(const string &name, size_t valueSize) : m_name(name), m_valueSize(valueSize), m_offset(NO_SLOT)
+    {
+    }
+
+    string getName(void) const
+    {
+        return m_name;
+    }
+    size_t getValueSize(void) const
+    {
+        return m_valueSize;
+    }
+    size_t getOffset(void) const
+    {
+        DE_ASSERT(m_offset != NO_SLOT);
+        return m_offset;
+    }
+    void setOffset(size_t offset) const
+    {
+        // Variables must not be shared between scopes with different layouts.
+        DE_ASSERT(m_offset == NO_SLOT || m_offset == offset);
+        m_offset = offset;
+    }
+
+private:
+    static constexpr size_t NO_SLOT = ~(size_t)0;
+
+    const string m_name;
+    const size_t m_valueSize;
+    mutable size_t m_offset;
+};
+
+typedef vector<const VariableBase *> VariableList;
+
+//! Assign frame slots to variables. Variables with the same name share a slot. Returns the frame size in bytes.
+size_t assignFrameSlots(const VariableList &variables)
+{
+    map<string, size_t> slotSizes;
+    map<string, size_t> slotOffsets;
+    size_t frameSize = 0;
+
+    for (size_t ndx = 0; ndx < variables.size(); ++ndx)
+    {
+        size_t &slotSize = slotSizes[variables[ndx]->getName()];
+
+        slotSize = de::max(slotSize, variables[ndx]->getValueSize());
+    }
+
+    for (map<string, size_t>::const_iterator it = slotSizes.begin(); it != slotSizes.end(); ++it)
+    {
+        slotOffsets[it->first] = frameSize;
+        frameSize += deAlignSize(it->second, alignof(std::max_align_t));
+    }
+
+    for (size_t ndx = 0; ndx < variables.size(); ++ndx)
+        variables[ndx]->setOffset(slotOffsets[variables[ndx]->getName()]);
+
+    return frameSize;
+}
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Storage for the frames of nested environments.
+ *
+ * Frames are allocated in LIFO order, one per function call depth. Storage
+ * is kept when a frame is released, so once the deepest call has been
+ * evaluated no more memory is allocated.
+ *
+ *//*--------------------------------------------------------------------*/
+class EnvironmentArena
+{
+public:
+    EnvironmentArena(void) : m_depth(0)
+    {
+    }
+
+    uint8_t *pushFrame(size_t frameSize)
+    {
+        if (m_frames.size() <= m_depth)
+            m_frames.resize(m_depth + 1);
+
+        vector<std::max_align_t> &frame = m_frames[m_depth++];
+        const size_t numUnits           = (frameSize + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t);
+
+        if (frame.size() < numUnits)
+            frame.resize(numUnits);
+
+        return reinterpret_cast<uint8_t *>(frame.data());
+    }
+
+    void popFrame(void)
+    {
+        DE_ASSERT(m_depth > 0);
+        --m_depth;
+    }
+
+private:
+    EnvironmentArena(const EnvironmentArena &);
+    EnvironmentArena &operator=(const EnvironmentArena &);
+
+    vector<vector<std::max_align_t>> m_frames;
+    size_t m_depth;
+};
+
 /*--------------------------------------------------------------------*//*!
  * \brief A variable environment.
  *
  * An Environment object maintains the mapping between variables of the
- * abstract syntax tree and their values.
+ * abstract syntax tree and their values. Values are stored in a frame
+ * allocated from an EnvironmentArena, at the slots assigned to the variables
+ * by assignFrameSlots().
  *
  * \todo [2014-03-28 lauri] At least run-time type safety.
  *
@@ -1289,25 +1418,48 @@ StatementP compoundStatement(const vector<StatementP> &statements);
 class Environment
 {
 public:
+    Environment(EnvironmentArena &arena, size_t frameSize)
+        : m_arena(arena)
+        , m_frameSize(frameSize)
+        , m_frame(arena.pushFrame(frameSize))
+    {
+    }
+
+    ~Environment(void)
+    {
+        m_arena.popFrame();
+    }
+
+    EnvironmentArena &getArena(void) const
+    {
+        return m_arena;
+    }
+
     template <typename T>
     void bind(const Variable<T> &variable, const typename Traits<T>::IVal &value)
     {
-        uint8_t *const data = new uint8_t[sizeof(value)];
-
-        deMemcpy(data, &value, sizeof(value));
-        de::insert(m_map, variable.getName(), SharedPtr<uint8_t>(data, de::ArrayDeleter<uint8_t>()));
+        new (getSlot(variable)) typename Traits<T>::IVal(value);
     }
 
     template <typename T>
     typename Traits<T>::IVal &lookup(const Variable<T> &variable) const
     {
-        uint8_t *const data = de::lookup(m_map, variable.getName()).get();
-
-        return *reinterpret_cast<typename Traits<T>::IVal *>(data);
+        return *reinterpret_cast<typename Traits<T>::IVal *>(getSlot(variable));
     }
 
 private:
-    map<string, SharedPtr<uint8_t>> m_map;
+    Environment(const Environment &);
+    Environment &operator=(const Environment &);
+
+    uint8_t *getSlot(const VariableBase &variable) const
+    {
+        DE_ASSERT(variable.getOffset() + variable.getValueSize() <= m_frameSize);
+        return m_frame + variable.getOffset();
+    }
+
+    EnvironmentArena &m_arena;
+    const size_t m_frameSize;
+    uint8_t *const m_frame;
 };
 
 /*--------------------------------------------------------------------*//*!
@@ -1334,6 +1486,219 @@ struct EvalContext
     int callDepth;
 };
 
+/*--------------------------------------------------------------------*//*!
+ * \brief Location of a value in a batch frame.
+ *
+ * A batch frame holds the values of a compiled statement for a batch of
+ * inputs. Each slot is an array with one value per input: value ndx of a
+ * slot is at offset * batchSize + ndx * stride from the start of the frame.
+ *
+ *//*--------------------------------------------------------------------*/
+struct BatchSlot
+{
+    BatchSlot(size_t offset_ = 0, size_t stride_ = 0) : offset(offset_), stride(stride_)
+    {
+    }
+
+    size_t offset;
+    size_t stride;
+};
+
+//! Values of a slot in a batch frame.
+template <typename T>
+class BatchArray
+{
+public:
+    BatchArray(uint8_t *frame, size_t batchSize, const BatchSlot &slot)
+        : m_data(frame + slot.offset * batchSize)
+        , m_stride(slot.stride)
+    {
+    }
+
+    T &operator[](size_t ndx) const
+    {
+        return *reinterpret_cast<T *>(m_data + ndx * m_stride);
+    }
+
+private:
+    uint8_t *m_data;
+    size_t m_stride;
+};
+
+class BatchProgram;
+
+//! Batch frame allocated from an arena for the lifetime of the object.
+class BatchFrame
+{
+public:
+    BatchFrame(EnvironmentArena &arena, const BatchProgram &program, size_t batchSize);
+
+    ~BatchFrame(void)
+    {
+        m_arena.popFrame();
+    }
+
+    size_t getBatchSize(void) const
+    {
+        return m_batchSize;
+    }
+
+    template <typename T>
+    BatchArray<T> getArray(const BatchSlot &slot) const
+    {
+        return BatchArray<T>(m_data, m_batchSize, slot);
+    }
+
+private:
+    BatchFrame(const BatchFrame &);
+    BatchFrame &operator=(const BatchFrame &);
+
+    EnvironmentArena &m_arena;
+    const size_t m_batchSize;
+    uint8_t *const m_data;
+};
+
+//! One operation of a compiled statement, executed for all inputs of a batch at once.
+class BatchOp
+{
+public:
+    virtual ~BatchOp(void)
+    {
+    }
+    virtual void execute(const EvalContext &ctx, const BatchFrame &frame) const = 0;
+};
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Statements compiled to a linear list of operations.
+ *
+ * Compiling flattens the expression trees of the statements into operations
+ * that read their arguments from slots and write their result to a new slot.
+ * Executing the program runs each operation for the whole batch before
+ * moving to the next one, so the expression tree is walked only once when
+ * compiling instead of once per input.
+ *
+ *//*--------------------------------------------------------------------*/
+class BatchProgram
+{
+public:
+    BatchProgram(void) : m_inputFrameSize(0)
+    {
+    }
+
+    //! Add slots for variables. Variables with the same name share a slot. Must be called before compiling.
+    void addVariables(const VariableList &variables)
+    {
+        map<string, size_t> slotSizes;
+
+        for (size_t ndx = 0; ndx < variables.size(); ++ndx)
+        {
+            size_t &slotSize = slotSizes[variables[ndx]->getName()];
+
+            slotSize = de::max(slotSize, variables[ndx]->getValueSize());
+        }
+
+        for (map<string, size_t>::const_iterator it = slotSizes.begin(); it != slotSizes.end(); ++it)
+        {
+            if (!de::contains(m_variableSlots, it->first))
+                m_variableSlots[it->first] = addSlot(it->second);
+
+            DE_ASSERT(m_variableSlots[it->first].stride >= it->second);
+        }
+    }
+
+    BatchSlot getVariableSlot(const VariableBase &variable) const
+    {
+        return de::lookup(m_variableSlots, variable.getName());
+    }
+
+    //! Add a slot for a temporary value.
+    BatchSlot addSlot(size_t valueSize)
+    {
+        const BatchSlot slot(m_inputFrameSize, deAlignSize(valueSize, alignof(std::max_align_t)));
+
+        m_inputFrameSize += slot.stride;
+        return slot;
+    }
+
+    //! Append an operation. The program takes ownership of `op`.
+    void addOp(const BatchOp *op)
+    {
+        m_ops.push_back(SharedPtr<const BatchOp>(op));
+    }
+
+    //! Size of the values of one input in bytes.
+    size_t getInputFrameSize(void) const
+    {
+        return m_inputFrameSize;
+    }
+
+    void execute(const EvalContext &ctx, const BatchFrame &frame) const
+    {
+        for (size_t ndx = 0; ndx < m_ops.size(); ++ndx)
+            m_ops[ndx]->execute(ctx, frame);
+    }
+
+private:
+    map<string, BatchSlot> m_variableSlots;
+    vector<SharedPtr<const BatchOp>> m_ops;
+    size_t m_inputFrameSize;
+};
+
+BatchFrame::BatchFrame(EnvironmentArena &arena, const BatchProgram &program, size_t batchSize)
+    : m_arena(arena)
+    , m_batchSize(batchSize)
+    , m_data(arena.pushFrame(program.getInputFrameSize() * batchSize))
+{
+}
+
+//! Copy a value to another slot, e.g. the value of an expression to the variable it is assigned to.
+template <typename T>
+class BatchCopyOp : public BatchOp
+{
+public:
+    BatchCopyOp(const BatchSlot &src, const BatchSlot &dst) : m_src(src), m_dst(dst)
+    {
+    }
+
+    void execute(const EvalContext &, const BatchFrame &frame) const
+    {
+        const BatchArray<T> src = frame.getArray<T>(m_src);
+        const BatchArray<T> dst = frame.getArray<T>(m_dst);
+
+        for (size_t ndx = 0; ndx < frame.getBatchSize(); ++ndx)
+            new (&dst[ndx]) T(src[ndx]);
+    }
+
+private:
+    const BatchSlot m_src;
+    const BatchSlot m_dst;
+};
+
+//! Copy element I of a tuple value to another slot.
+template <typename Tuple, std::size_t I>
+class BatchTupleElementOp : public BatchOp
+{
+public:
+    typedef std::tuple_element_t<I, Tuple> Element;
+
+    BatchTupleElementOp(const BatchSlot &src, const BatchSlot &dst) : m_src(src), m_dst(dst)
+    {
+    }
+
+    void execute(const EvalContext &, const BatchFrame &frame) const
+    {
+        const BatchArray<Tuple> src   = frame.getArray<Tuple>(m_src);
+        const BatchArray<Element> dst = frame.getArray<Element>(m_dst);
+
+        for (size_t ndx = 0; ndx < frame.getBatchSize(); ++ndx)
+            new (&dst[ndx]) Element(std::get<I>(src[ndx]));
+    }
+
+private:
+    const BatchSlot m_src;
+    const BatchSlot m_dst;
+};
+
 /*--------------------------------------------------------------------*//*!
  * \brief Simple incremental counter.
  *
@@ -1419,15 +1784,27 @@ public:
     {
         this->doGetUsedFuncs(dst);
     }
+    //! Add the variables used in this statement to `dst`.
+    void getUsedVars(VariableList &dst) const
+    {
+        this->doGetUsedVars(dst);
+    }
+    //! Append the operations of this statement to `program`.
+    void compile(BatchProgram &program) const
+    {
+        this->doCompile(program);
+    }
     void failed(EvalContext &ctx) const
     {
         this->doFail(ctx);
     }
 
 protected:
-    virtual void doPrint(ostream &os) const         = 0;
-    virtual void doExecute(EvalContext &ctx) const  = 0;
-    virtual void doGetUsedFuncs(FuncSet &dst) const = 0;
+    virtual void doPrint(ostream &os) const             = 0;
+    virtual void doExecute(EvalContext &ctx) const      = 0;
+    virtual void doGetUsedFuncs(FuncSet &dst) const     = 0;
+    virtual void doGetUsedVars(VariableList &dst) const = 0;
+    virtual void doCompile(BatchProgram &program) const = 0;
     virtual void doFail(EvalContext &ctx) const
     {
         DE_UNREF(ctx);
@@ -1502,6 +1879,21 @@ protected:
         m_value->getUsedFuncs(dst);
     }
 
+    void doGetUsedVars(VariableList &dst) const
+    {
+        dst.push_back(m_variable.get());
+        m_value->getUsedVars(dst);
+    }
+
+    void doCompile(BatchProgram &program) const
+    {
+        const BatchSlot value    = m_value->compile(program);
+        const BatchSlot variable = program.getVariableSlot(*m_variable);
+
+        if (value.offset != variable.offset)
+            program.addOp(new BatchCopyOp<typename Traits<T>::IVal>(value, variable));
+    }
+
     virtual void doFail(EvalContext &ctx) const
     {
         if (m_isDeclaration)
@@ -1555,6 +1947,17 @@ protected:
         m_value->getUsedFuncs(dst);
     }
 
+    void doGetUsedVars(VariableList &dst) const
+    {
+        std::apply([&dst](const auto &...variables) { (dst.push_back(variables.get()), ...); }, m_variables);
+        m_value->getUsedVars(dst);
+    }
+
+    void doCompile(BatchProgram &program) const
+    {
+        compileResult(program, m_value->compile(program), std::make_index_sequence<std::tuple_size_v<Z>>());
+    }
+
     void doExecute(EvalContext &ctx) const
     {
         IVal result = m_value->evaluate(ctx);
@@ -1586,6 +1989,13 @@ protected:
         else
             ctx.env.lookup(*std::get<0>(m_variables)) = std::get<0>(result);
     }
+    template <std::size_t... I>
+    void compileResult(BatchProgram &program, const BatchSlot &result, std::index_sequence<I...>) const
+    {
+        (program.addOp(
+             new BatchTupleElementOp<IVal, I>(result, program.getVariableSlot(*std::get<I>(m_variables)))),
+         ...);
+    }
 
     VariableP<X> m_variable;
     Vars m_variables;
@@ -1648,6 +2058,18 @@ protected:
             m_statements[ndx]->getUsedFuncs(dst);
     }
 
+    void doGetUsedVars(VariableList &dst) const
+    {
+        for (size_t ndx = 0; ndx < m_statements.size(); ++ndx)
+            m_statements[ndx]->getUsedVars(dst);
+    }
+
+    void doCompile(BatchProgram &program) const
+    {
+        for (size_t ndx = 0; ndx < m_statements.size(); ++ndx)
+            m_statements[ndx]->compile(program);
+    }
+
     vector<StatementP> m_statements;
 };
 
@@ -1678,6 +2100,12 @@ public:
         this->doGetUsedFuncs(dst);
     }
 
+    //! Output the variables that this expression refers to. Variables inside called functions are not included.
+    void getUsedVars(VariableList &dst) const
+    {
+        this->doGetUsedVars(dst);
+    }
+
 protected:
     virtual void doPrintExpr(ostream &) const
     {
@@ -1689,6 +2117,9 @@ protected:
     virtual void doGetUsedFuncs(FuncSet &) const
     {
     }
+    virtual void doGetUsedVars(VariableList &) const
+    {
+    }
 };
 
 //! Type-specific operations for an expression representing type T.
@@ -1704,6 +2135,11 @@ public:
     {
         return this->doFails(ctx);
     }
+    //! Append the operations computing this expression to `program`. Returns the slot of the result.
+    BatchSlot compile(BatchProgram &program) const
+    {
+        return this->doCompile(program);
+    }
 
 protected:
     virtual IVal doEvaluate(const EvalContext &ctx) const = 0;
@@ -1711,6 +2147,7 @@ protected:
     {
         return doEvaluate(ctx);
     }
+    virtual BatchSlot doCompile(BatchProgram &program) const;
 };
 
 template <class X, class... Y>
@@ -1724,6 +2161,11 @@ public:
     {
         return this->doFails(ctx);
     }
+    //! Append the operations computing this expression to `program`. Returns the slot of the result.
+    BatchSlot compile(BatchProgram &program) const
+    {
+        return this->doCompile(program);
+    }
 
 protected:
     virtual IVal doEvaluate(const EvalContext &ctx) const = 0;
@@ -1731,6 +2173,7 @@ protected:
     {
         return doEvaluate(ctx);
     }
+    virtual BatchSlot doCompile(BatchProgram &program) const;
 };
 
 //! Evaluate an expression with the given context, optionally tracing the calls to stderr.
@@ -1794,6 +2237,62 @@ typename Expr<std::tuple<X, Y...>>::IVal Expr<std::tuple<X, Y...>>::evaluate(con
 #endif
 }
 
+//! Compute an expression that does not read any variables, e.g. a constant, once per batch.
+template <typename E>
+class BatchConstantOp : public BatchOp
+{
+public:
+    typedef typename E::IVal IVal;
+
+    BatchConstantOp(const E &expr, const BatchSlot &dst) : m_expr(expr), m_dst(dst)
+    {
+    }
+
+    void execute(const EvalContext &ctx, const BatchFrame &frame) const
+    {
+        const IVal value           = m_expr.evaluate(ctx);
+        const BatchArray<IVal> dst = frame.getArray<IVal>(m_dst);
+
+        for (size_t ndx = 0; ndx < frame.getBatchSize(); ++ndx)
+            new (&dst[ndx]) IVal(value);
+    }
+
+private:
+    const E &m_expr;
+    const BatchSlot m_dst;
+};
+
+//! Expressions that read variables must override this.
+template <typename T>
+BatchSlot Expr<T>::doCompile(BatchProgram &program) const
+{
+    const BatchSlot dst = program.addSlot(sizeof(IVal));
+
+#ifdef DE_DEBUG
+    VariableList usedVars;
+    this->getUsedVars(usedVars);
+    DE_ASSERT(usedVars.empty());
+#endif
+
+    program.addOp(new BatchConstantOp<Expr<T>>(*this, dst));
+    return dst;
+}
+
+template <class X, class... Y>
+BatchSlot Expr<std::tuple<X, Y...>>::doCompile(BatchProgram &program) const
+{
+    const BatchSlot dst = program.addSlot(sizeof(IVal));
+
+#ifdef DE_DEBUG
+    VariableList usedVars;
+    this->getUsedVars(usedVars);
+    DE_ASSERT(usedVars.empty());
+#endif
+
+    program.addOp(new BatchConstantOp<Expr<std::tuple<X, Y...>>>(*this, dst));
+    return dst;
+}
+
 template <typename T>
 class ExprPBase : public SharedPtr<const Expr<T>>
 {
@@ -1951,31 +2450,32 @@ ExprP<Matrix<T, Rows, Cols>> operator-(const ExprP<Matrix<T, Rows, Cols>> &mat);
  * environment.
  *//*--------------------------------------------------------------------*/
 template <typename T>
-class Variable : public Expr<T>
+class Variable : public Expr<T>, public VariableBase
 {
 public:
     typedef typename Expr<T>::IVal IVal;
 
-    Variable(const string &name) : m_name(name)
+    Variable(const string &name) : VariableBase(name, sizeof(IVal))
     {
     }
-    string getName(void) const
-    {
-        return m_name;
-    }
 
 protected:
     void doPrintExpr(ostream &os) const
     {
-        os << m_name;
+        os << getName();
+    }
+    void doGetUsedVars(VariableList &dst) const
+    {
+        dst.push_back(this);
     }
     IVal doEvaluate(const EvalContext &ctx) const
     {
         return ctx.env.lookup<T>(*this);
     }
-
-private:
-    string m_name;
+    BatchSlot doCompile(BatchProgram &program) const
+    {
+        return program.getVariableSlot(*this);
+    }
 };
 
 template <typename T>
@@ -2277,6 +2777,15 @@ public:
     {
         return this->doApply(ctx, args);
     }
+
+    //! Apply to `batchSize` sets of arguments, constructing the results in `ret`.
+    void applyBatch(const EvalContext &ctx, const BatchArray<IArg0> &arg0, const BatchArray<IArg1> &arg1,
+                    const BatchArray<IArg2> &arg2, const BatchArray<IArg3> &arg3, const BatchArray<ApplyResult> &ret,
+                    size_t batchSize) const
+    {
+        this->doApplyBatch(ctx, arg0, arg1, arg2, arg3, ret, batchSize);
+    }
+
     ExprP<Ret> operator()(const ExprP<Arg0> &arg0 = voidP(), const ExprP<Arg1> &arg1 = voidP(),
                           const ExprP<Arg2> &arg2 = voidP(), const ExprP<Arg3> &arg3 = voidP()) const;
 
@@ -2291,6 +2800,13 @@ protected:
     {
         return this->doApply(ctx, args);
     }
+    virtual void doApplyBatch(const EvalContext &ctx, const BatchArray<IArg0> &arg0, const BatchArray<IArg1> &arg1,
+                              const BatchArray<IArg2> &arg2, const BatchArray<IArg3> &arg3,
+                              const BatchArray<ApplyResult> &ret, size_t batchSize) const
+    {
+        for (size_t ndx = 0; ndx < batchSize; ++ndx)
+            new (&ret[ndx]) ApplyResult(this->applyArgs(ctx, IArgs(arg0[ndx], arg1[ndx], arg2[ndx], arg3[ndx])));
+    }
 
     virtual void doPrint(ostream &os, const BaseArgExprs &args) const
     {
@@ -2324,6 +2840,42 @@ protected:
     }
 };
 
+//! Apply a function to the argument slots of a batch.
+template <typename Sig>
+class BatchApplyOp : public BatchOp
+{
+public:
+    typedef Func<Sig> ApplyFunc;
+
+    BatchApplyOp(const ApplyFunc &func, const BatchSlot &arg0, const BatchSlot &arg1, const BatchSlot &arg2,
+                 const BatchSlot &arg3, const BatchSlot &ret)
+        : m_func(func)
+        , m_arg0(arg0)
+        , m_arg1(arg1)
+        , m_arg2(arg2)
+        , m_arg3(arg3)
+        , m_ret(ret)
+    {
+    }
+
+    void execute(const EvalContext &ctx, const BatchFrame &frame) const
+    {
+        m_func.applyBatch(ctx, frame.getArray<typename ApplyFunc::IArg0>(m_arg0),
+                          frame.getArray<typename ApplyFunc::IArg1>(m_arg1),
+                          frame.getArray<typename ApplyFunc::IArg2>(m_arg2),
+                          frame.getArray<typename ApplyFunc::IArg3>(m_arg3),
+                          frame.getArray<typename ApplyFunc::ApplyResult>(m_ret), frame.getBatchSize());
+    }
+
+private:
+    const ApplyFunc &m_func;
+    const BatchSlot m_arg0;
+    const BatchSlot m_arg1;
+    const BatchSlot m_arg2;
+    const BatchSlot m_arg3;
+    const BatchSlot m_ret;
+};
+
 template <typename Sig>
 class Apply : public Expr<typename Sig::Ret>
 {
@@ -2375,6 +2927,26 @@ protected:
         m_args.d->getUsedFuncs(dst);
     }
 
+    void doGetUsedVars(VariableList &dst) const
+    {
+        m_args.a->getUsedVars(dst);
+        m_args.b->getUsedVars(dst);
+        m_args.c->getUsedVars(dst);
+        m_args.d->getUsedVars(dst);
+    }
+
+    BatchSlot doCompile(BatchProgram &program) const
+    {
+        const BatchSlot arg0 = m_args.a->compile(program);
+        const BatchSlot arg1 = m_args.b->compile(program);
+        const BatchSlot arg2 = m_args.c->compile(program);
+        const BatchSlot arg3 = m_args.d->compile(program);
+        const BatchSlot ret  = program.addSlot(sizeof(IVal));
+
+        program.addOp(new BatchApplyOp<Sig>(m_func, arg0, arg1, arg2, arg3, ret));
+        return ret;
+    }
+
     const ApplyFunc &m_func;
     ArgExprs m_args;
 };
@@ -2553,6 +3125,26 @@ public:
         m_args.d->getUsedFuncs(dst);
     }
 
+    void doGetUsedVars(VariableList &dst) const
+    {
+        m_args.a->getUsedVars(dst);
+        m_args.b->getUsedVars(dst);
+        m_args.c->getUsedVars(dst);
+        m_args.d->getUsedVars(dst);
+    }
+
+    BatchSlot doCompile(BatchProgram &program) const
+    {
+        const BatchSlot arg0 = m_args.a->compile(program);
+        const BatchSlot arg1 = m_args.b->compile(program);
+        const BatchSlot arg2 = m_args.c->compile(program);
+        const BatchSlot arg3 = m_args.d->compile(program);
+        const BatchSlot ret  = program.addSlot(sizeof(ApplyResult));
+
+        program.addOp(new BatchApplyOp<Sig>(m_func, arg0, arg1, arg2, arg3, ret));
+        return ret;
+    }
+
     ApplyResult doEvaluate(const EvalContext &ctx) const
     {
         const Variable<P0> &var0 = static_cast<const Variable<P0> &>(*m_args.a);
@@ -2631,12 +3223,12 @@ protected:
 
     IRet doApply(const EvalContext &ctx, const IArgs &args) const
     {
-        Environment funEnv;
+        initialize();
+
+        Environment funEnv(ctx.env.getArena(), m_frameSize);
         IArgs &mutArgs = const_cast<IArgs &>(args);
         IRet ret;
 
-        initialize();
-
         funEnv.bind(*m_var0, args.a);
         funEnv.bind(*m_var1, args.b);
         funEnv.bind(*m_var2, args.c);
@@ -2660,6 +3252,41 @@ protected:
         return ret;
     }
 
+    void doApplyBatch(const EvalContext &ctx, const BatchArray<IArg0> &arg0, const BatchArray<IArg1> &arg1,
+                      const BatchArray<IArg2> &arg2, const BatchArray<IArg3> &arg3, const BatchArray<IRet> &ret,
+                      size_t batchSize) const
+    {
+        initialize();
+
+        const BatchFrame frame(ctx.env.getArena(), m_program, batchSize);
+        const BatchArray<IArg0> var0  = frame.getArray<IArg0>(m_program.getVariableSlot(*m_var0));
+        const BatchArray<IArg1> var1  = frame.getArray<IArg1>(m_program.getVariableSlot(*m_var1));
+        const BatchArray<IArg2> var2  = frame.getArray<IArg2>(m_program.getVariableSlot(*m_var2));
+        const BatchArray<IArg3> var3  = frame.getArray<IArg3>(m_program.getVariableSlot(*m_var3));
+        const BatchArray<IRet> result = frame.getArray<IRet>(m_retSlot);
+
+        for (size_t ndx = 0; ndx < batchSize; ++ndx)
+        {
+            new (&var0[ndx]) IArg0(arg0[ndx]);
+            new (&var1[ndx]) IArg1(arg1[ndx]);
+            new (&var2[ndx]) IArg2(arg2[ndx]);
+            new (&var3[ndx]) IArg3(arg3[ndx]);
+        }
+
+        m_program.execute(ctx, frame);
+
+        // Write back out and inout parameters like doApply() does.
+        for (size_t ndx = 0; ndx < batchSize; ++ndx)
+        {
+            new (&ret[ndx]) IRet(result[ndx]);
+
+            arg0[ndx] = var0[ndx];
+            arg1[ndx] = var1[ndx];
+            arg2[ndx] = var2[ndx];
+            arg3[ndx] = var3[ndx];
+        }
+    }
+
     void doGetUsedFuncs(FuncSet &dst) const
     {
         initialize();
@@ -2683,16 +3310,33 @@ protected:
     mutable VariableP<Arg3> m_var3;
     mutable vector<StatementP> m_body;
     mutable ExprP<Ret> m_ret;
+    mutable size_t m_frameSize;
+    mutable BatchProgram m_program;
+    mutable BatchSlot m_retSlot;
+    mutable std::atomic<bool> m_initialized{false};
 
 private:
+    // Functions may be first applied while references are verified on multiple threads.
+    static std::recursive_mutex &getInitializeMutex(void)
+    {
+        static std::recursive_mutex s_mutex;
+        return s_mutex;
+    }
+
     void initialize(void) const
     {
+        if (m_initialized.load(std::memory_order_acquire))
+            return;
+
+        const std::lock_guard<std::recursive_mutex> lock(getInitializeMutex());
+
         if (!m_ret)
         {
             const ParamNames &paramNames = this->getParamNames();
             Counter symCounter;
             ExpandContext ctx(symCounter);
             ArgExprs args;
+            VariableList usedVars;
 
             args.a = m_var0 = variable<Arg0>(paramNames.a);
             args.b = m_var1 = variable<Arg1>(paramNames.b);
@@ -2701,6 +3345,24 @@ private:
 
             m_ret  = this->doExpand(ctx, args);
             m_body = ctx.getStatements();
+
+            usedVars.push_back(m_var0.get());
+            usedVars.push_back(m_var1.get());
+            usedVars.push_back(m_var2.get());
+            usedVars.push_back(m_var3.get());
+
+            for (size_t ndx = 0; ndx < m_body.size(); ++ndx)
+                m_body[ndx]->getUsedVars(usedVars);
+            m_ret->getUsedVars(usedVars);
+
+            m_frameSize = assignFrameSlots(usedVars);
+
+            m_program.addVariables(usedVars);
+            for (size_t ndx = 0; ndx < m_body.size(); ++ndx)
+                m_body[ndx]->compile(m_program);
+            m_retSlot = m_ret->compile(m_program);
+
+            m_initialized.store(true, std::memory_order_release);
         }
     }
 };
@@ -7347,6 +8009,48 @@ Result makeSamplings()
     return Result();
 }
 
+//! Reference intervals of both outputs as they are compared to the shader outputs.
+template <typename Out>
+string referencesToString(const FloatFormat &highpFmt, const typename Traits<typename Out::Out0>::IVal &out0,
+                          const typename Traits<typename Out::Out1>::IVal &out1)
+{
+    typedef typename Out::Out0 Out0;
+    typedef typename Out::Out1 Out1;
+
+    return intervalToString<Out0>(highpFmt, convert<Out0>(highpFmt, out0)) + ", " +
+           intervalToString<Out1>(highpFmt, convert<Out1>(highpFmt, out1));
+}
+
+//! Reference intervals of one input that is logged after verification.
+template <typename Out>
+struct VerifiedValue
+{
+    VerifiedValue(void) : valueNdx(0), failed(false), errorNdx(0), mismatchNdx(0)
+    {
+    }
+
+    size_t valueNdx;
+    bool failed;     //!< The shader output is outside the reference intervals.
+    int errorNdx;    //!< 1-based index of the failure within its range, 0 if passed or past the logged failures.
+    int mismatchNdx; //!< 1-based index of the crosscheck mismatch within its range, 0 if none.
+    string mismatch;
+    typename Traits<typename Out::Out0>::IVal reference0;
+    typename Traits<typename Out::Out1>::IVal reference1;
+};
+
+//! Result of verifying one range of inputs. Only the first failures and mismatches of the range are kept.
+template <typename Out>
+struct VerifiedRange
+{
+    VerifiedRange(void) : numErrors(0), numMismatches(0)
+    {
+    }
+
+    int numErrors;
+    int numMismatches;
+    vector<VerifiedValue<Out>> values;
+};
+
 template <typename In, typename Out>
 class BuiltinPrecisionCaseTestInstance : public TestInstance
 {
@@ -7383,6 +8087,12 @@ tcu::TestStatus BuiltinPrecisionCaseTestInstance<In, Out>::iterate(void)
     typedef typename In::In3 In3;
     typedef typename Out::Out0 Out0;
     typedef typename Out::Out1 Out1;
+    typedef typename Traits<In0>::IVal IIn0;
+    typedef typename Traits<In1>::IVal IIn1;
+    typedef typename Traits<In2>::IVal IIn2;
+    typedef typename Traits<In3>::IVal IIn3;
+    typedef typename Traits<Out0>::IVal IOut0;
+    typedef typename Traits<Out1>::IVal IOut1;
 
     areFeaturesSupported(m_context, m_caseCtx.precisionTestFeatures);
     Inputs<In> inputs =
@@ -7396,9 +8106,9 @@ tcu::TestStatus BuiltinPrecisionCaseTestInstance<In, Out>::iterate(void)
     const FloatFormat highpFmt = m_caseCtx.highpFormat;
     const int maxMsgs          = 100;
     int numErrors              = 0;
-    Environment env; // Hoisted out of the inner loop for optimization.
-    ResultCollector status;
-    TestLog &testLog = m_context.getTestContext().getLog();
+    int numMismatches          = 0;
+    TestLog &testLog                      = m_context.getTestContext().getLog();
+    const tcu::PrecisionEvalMode evalMode = m_context.getTestContext().getCommandLine().getPrecisionEvalMode();
 
     // Module operations need exactly two inputs and have exactly one output.
     if (m_modularOp)
@@ -7452,158 +8162,300 @@ tcu::TestStatus BuiltinPrecisionCaseTestInstance<In, Out>::iterate(void)
 
     m_executor->execute(int(numValues), inputArr, outputArr);
 
-    // Initialize environment with unused values so we don't need to bind in inner loop.
-    {
-        const typename Traits<In0>::IVal in0;
-        const typename Traits<In1>::IVal in1;
-        const typename Traits<In2>::IVal in2;
-        const typename Traits<In3>::IVal in3;
-        const typename Traits<Out0>::IVal reference0;
-        const typename Traits<Out1>::IVal reference1;
+    // Assign frame slots to the variables of the statement.
+    VariableList usedVars;
 
-        env.bind(*m_variables.in0, in0);
-        env.bind(*m_variables.in1, in1);
-        env.bind(*m_variables.in2, in2);
-        env.bind(*m_variables.in3, in3);
-        env.bind(*m_variables.out0, reference0);
-        env.bind(*m_variables.out1, reference1);
-    }
+    m_stmt->getUsedVars(usedVars);
+    usedVars.push_back(m_variables.in0.get());
+    usedVars.push_back(m_variables.in1.get());
+    usedVars.push_back(m_variables.in2.get());
+    usedVars.push_back(m_variables.in3.get());
+    usedVars.push_back(m_variables.out0.get());
+    usedVars.push_back(m_variables.out1.get());
 
-    // For each input tuple, compute output reference interval and compare
-    // shader output to the reference.
-    for (size_t valueNdx = 0; valueNdx < numValues; valueNdx++)
-    {
-        bool result             = true;
-        const bool isInput16Bit = m_executor->areInputs16Bit();
-        const bool isInput64Bit = m_executor->areInputs64Bit();
+    const size_t frameSize = assignFrameSlots(usedVars);
 
-        DE_ASSERT(!(isInput16Bit && isInput64Bit));
+    // Compile the statement for computing the reference intervals of a batch of inputs at once.
+    BatchProgram program;
 
-        typename Traits<Out0>::IVal reference0;
-        typename Traits<Out1>::IVal reference1;
+    program.addVariables(usedVars);
+    m_stmt->compile(program);
 
-        if (valueNdx % (size_t)TOUCH_WATCHDOG_VALUE_FREQUENCY == 0)
-            m_context.getTestContext().touchWatchdog();
+    // For each input tuple, compute output reference interval and compare
+    // shader output to the reference. Ranges of inputs are verified on
+    // multiple threads, each with its own environment, and the inputs to
+    // log are collected so that they can be logged in input order.
+    const bool isInput16Bit = m_executor->areInputs16Bit();
+    const bool isInput64Bit = m_executor->areInputs64Bit();
+    vector<VerifiedRange<Out>> verifiedRanges(
+        (numValues + (size_t)VERIFY_VALUES_PER_RANGE - 1) / (size_t)VERIFY_VALUES_PER_RANGE);
+
+    DE_ASSERT(!(isInput16Bit && isInput64Bit));
 
-        env.lookup(*m_variables.in0) = convert<In0>(fmt, round(fmt, inputs.in0[valueNdx]));
-        env.lookup(*m_variables.in1) = convert<In1>(fmt, round(fmt, inputs.in1[valueNdx]));
-        env.lookup(*m_variables.in2) = convert<In2>(fmt, round(fmt, inputs.in2[valueNdx]));
-        env.lookup(*m_variables.in3) = convert<In3>(fmt, round(fmt, inputs.in3[valueNdx]));
+    const auto verifyValues = [&](int rangeBegin, int rangeEnd)
+    {
+        VerifiedRange<Out> &range = verifiedRanges[rangeBegin / VERIFY_VALUES_PER_RANGE];
+        EnvironmentArena envArena;
+        Environment env(envArena, frameSize);
+        ResultCollector status;
 
+        // Initialize environment with unused values so we don't need to bind in inner loop.
         {
-            EvalContext ctx(fmt, m_caseCtx.precision, env, 0);
-            m_stmt->execute(ctx);
+            const IIn0 in0;
+            const IIn1 in1;
+            const IIn2 in2;
+            const IIn3 in3;
+            const IOut0 reference0;
+            const IOut1 reference1;
+
+            env.bind(*m_variables.in0, in0);
+            env.bind(*m_variables.in1, in1);
+            env.bind(*m_variables.in2, in2);
+            env.bind(*m_variables.in3, in3);
+            env.bind(*m_variables.out0, reference0);
+            env.bind(*m_variables.out1, reference1);
+        }
 
-            switch (outCount)
+        for (size_t batchStart = (size_t)rangeBegin; batchStart < (size_t)rangeEnd;
+             batchStart += (size_t)REFERENCE_BATCH_SIZE)
+        {
+            const size_t batchSize = de::min((size_t)rangeEnd - batchStart, (size_t)REFERENCE_BATCH_SIZE);
+            const BatchFrame frame(envArena, program, batchSize);
+            const BatchArray<IIn0> batchIn0   = frame.getArray<IIn0>(program.getVariableSlot(*m_variables.in0));
+            const BatchArray<IIn1> batchIn1   = frame.getArray<IIn1>(program.getVariableSlot(*m_variables.in1));
+            const BatchArray<IIn2> batchIn2   = frame.getArray<IIn2>(program.getVariableSlot(*m_variables.in2));
+            const BatchArray<IIn3> batchIn3   = frame.getArray<IIn3>(program.getVariableSlot(*m_variables.in3));
+            const BatchArray<IOut0> batchOut0 = frame.getArray<IOut0>(program.getVariableSlot(*m_variables.out0));
+            const BatchArray<IOut1> batchOut1 = frame.getArray<IOut1>(program.getVariableSlot(*m_variables.out1));
+
+            for (size_t ndx = 0; ndx < batchSize; ndx++)
             {
-            case 2:
-                reference1 = convert<Out1>(highpFmt, env.lookup(*m_variables.out1));
-                if (!status.check(contains(reference1, outputs.out1[valueNdx], m_caseCtx.isPackFloat16b),
-                                  "Shader output 1 is outside acceptable range"))
-                    result = false;
-            // Fallthrough
-            case 1:
+                const size_t valueNdx = batchStart + ndx;
+
+                new (&batchIn0[ndx]) IIn0(convert<In0>(fmt, round(fmt, inputs.in0[valueNdx])));
+                new (&batchIn1[ndx]) IIn1(convert<In1>(fmt, round(fmt, inputs.in1[valueNdx])));
+                new (&batchIn2[ndx]) IIn2(convert<In2>(fmt, round(fmt, inputs.in2[valueNdx])));
+                new (&batchIn3[ndx]) IIn3(convert<In3>(fmt, round(fmt, inputs.in3[valueNdx])));
+                new (&batchOut0[ndx]) IOut0();
+                new (&batchOut1[ndx]) IOut1();
+            }
+
+            if (evalMode != tcu::PRECISIONEVALMODE_TREE)
             {
-                // Pass b from mod(a, b) if we are in the modulo operation.
-                const tcu::Maybe<In1> modularDivisor = (m_modularOp ? tcu::just(inputs.in1[valueNdx]) : tcu::Nothing);
+                const EvalContext batchCtx(fmt, m_caseCtx.precision, env, 0);
+
+                program.execute(batchCtx, frame);
+            }
+
+            for (size_t ndx = 0; ndx < batchSize; ndx++)
+            {
+                const size_t valueNdx = batchStart + ndx;
+                bool result           = true;
+                VerifiedValue<Out> value;
+
+                value.valueNdx = valueNdx;
+
+                env.lookup(*m_variables.in0) = batchIn0[ndx];
+                env.lookup(*m_variables.in1) = batchIn1[ndx];
+                env.lookup(*m_variables.in2) = batchIn2[ndx];
+                env.lookup(*m_variables.in3) = batchIn3[ndx];
 
-                reference0 = convert<Out0>(highpFmt, env.lookup(*m_variables.out0));
-                if (!status.check(
-                        contains(reference0, outputs.out0[valueNdx], m_caseCtx.isPackFloat16b, modularDivisor),
-                        "Shader output 0 is outside acceptable range"))
                 {
-                    m_stmt->failed(ctx);
-                    reference0 = convert<Out0>(highpFmt, env.lookup(*m_variables.out0));
-                    if (!status.check(
-                            contains(reference0, outputs.out0[valueNdx], m_caseCtx.isPackFloat16b, modularDivisor),
-                            "Shader output 0 is outside acceptable range"))
-                        result = false;
+                    EvalContext ctx(fmt, m_caseCtx.precision, env, 0);
+
+                    if (evalMode == tcu::PRECISIONEVALMODE_COMPILED)
+                    {
+                        env.lookup(*m_variables.out0) = batchOut0[ndx];
+                        env.lookup(*m_variables.out1) = batchOut1[ndx];
+                    }
+                    else
+                    {
+                        m_stmt->execute(ctx);
+
+                        if (evalMode == tcu::PRECISIONEVALMODE_CROSSCHECK)
+                        {
+                            const IOut0 &treeOut0 = env.lookup(*m_variables.out0);
+                            const IOut1 &treeOut1 = env.lookup(*m_variables.out1);
+                            const string compiled = referencesToString<Out>(highpFmt, batchOut0[ndx], batchOut1[ndx]);
+                            const string tree     = referencesToString<Out>(highpFmt, treeOut0, treeOut1);
+
+                            if (compiled != tree && ++range.numMismatches <= maxMsgs)
+                            {
+                                value.mismatchNdx = range.numMismatches;
+                                value.mismatch    = "Reference intervals differ for input " + de::toString(valueNdx) +
+                                                    ":\n\tCompiled: " + compiled + "\n\tTree: " + tree;
+                            }
+                        }
+                    }
+
+                    switch (outCount)
+                    {
+                    case 2:
+                        value.reference1 = convert<Out1>(highpFmt, env.lookup(*m_variables.out1));
+                        if (!status.check(contains(value.reference1, outputs.out1[valueNdx], m_caseCtx.isPackFloat16b),
+                                          "Shader output 1 is outside acceptable range"))
+                            result = false;
+                    // Fallthrough
+                    case 1:
+                    {
+                        // Pass b from mod(a, b) if we are in the modulo operation.
+                        const tcu::Maybe<In1> modularDivisor =
+                            (m_modularOp ? tcu::just(inputs.in1[valueNdx]) : tcu::Nothing);
+
+                        value.reference0 = convert<Out0>(highpFmt, env.lookup(*m_variables.out0));
+                        if (!status.check(contains(value.reference0, outputs.out0[valueNdx], m_caseCtx.isPackFloat16b,
+                                                   modularDivisor),
+                                          "Shader output 0 is outside acceptable range"))
+                        {
+                            m_stmt->failed(ctx);
+                            value.reference0 = convert<Out0>(highpFmt, env.lookup(*m_variables.out0));
+                            if (!status.check(contains(value.reference0, outputs.out0[valueNdx],
+                                                       m_caseCtx.isPackFloat16b, modularDivisor),
+                                              "Shader output 0 is outside acceptable range"))
+                                result = false;
+                        }
+                    }
+                    // Fallthrough
+                    default:
+                        break;
+                    }
                 }
-            }
-            // Fallthrough
-            default:
-                break;
+
+                value.failed = !result;
+
+                if (!result)
+                    ++range.numErrors;
+
+                if (!result && range.numErrors <= maxMsgs)
+                    value.errorNdx = range.numErrors;
+
+                if (value.errorNdx > 0 || value.mismatchNdx > 0 || GLS_LOG_ALL_RESULTS)
+                    range.values.push_back(value);
             }
         }
-        if (!result)
-            ++numErrors;
+    };
 
-        if ((!result && numErrors <= maxMsgs) || GLS_LOG_ALL_RESULTS)
-        {
-            MessageBuilder builder = testLog.message();
+    // The watchdog is touched on this thread between chunks of values that are verified in parallel, so that
+    // each thread verifies about TOUCH_WATCHDOG_VALUE_FREQUENCY values between touches. Chunks consist of whole
+    // ranges.
+    {
+        const size_t chunkSize =
+            (size_t)TOUCH_WATCHDOG_VALUE_FREQUENCY * (size_t)tcu::getDefaultParallelForNumThreads();
 
-            builder << (result ? "Passed" : "Failed") << " sample:\n";
+        DE_STATIC_ASSERT(TOUCH_WATCHDOG_VALUE_FREQUENCY % VERIFY_VALUES_PER_RANGE == 0);
 
-            if (inCount > 0)
+        for (size_t chunkBegin = 0; chunkBegin < numValues; chunkBegin += chunkSize)
+        {
+            const int chunkOffset        = int(chunkBegin);
+            const auto verifyChunkValues = [&](int begin, int end)
             {
-                builder << "\t" << m_variables.in0->getName() << " = "
-                        << (isInput64Bit ? value64ToString(highpFmt, inputs.in0[valueNdx]) :
-                                           (isInput16Bit ? value16ToString(highpFmt, inputs.in0[valueNdx]) :
-                                                           value32ToString(highpFmt, inputs.in0[valueNdx])))
-                        << "\n";
-            }
+                verifyValues(chunkOffset + begin, chunkOffset + end);
+            };
 
-            if (inCount > 1)
-            {
-                builder << "\t" << m_variables.in1->getName() << " = "
-                        << (isInput64Bit ? value64ToString(highpFmt, inputs.in1[valueNdx]) :
-                                           (isInput16Bit ? value16ToString(highpFmt, inputs.in1[valueNdx]) :
-                                                           value32ToString(highpFmt, inputs.in1[valueNdx])))
-                        << "\n";
-            }
+            m_context.getTestContext().touchWatchdog();
+            tcu::parallelFor(int(de::min(numValues - chunkBegin, chunkSize)), VERIFY_VALUES_PER_RANGE,
+                             verifyChunkValues);
+        }
+    }
 
-            if (inCount > 2)
-            {
-                builder << "\t" << m_variables.in2->getName() << " = "
-                        << (isInput64Bit ? value64ToString(highpFmt, inputs.in2[valueNdx]) :
-                                           (isInput16Bit ? value16ToString(highpFmt, inputs.in2[valueNdx]) :
-                                                           value32ToString(highpFmt, inputs.in2[valueNdx])))
-                        << "\n";
-            }
+    // Log the first failures in input order. Each range kept its own first maxMsgs failures and
+    // mismatches, so the first maxMsgs of the whole case are among them.
+    for (size_t rangeNdx = 0; rangeNdx < verifiedRanges.size(); rangeNdx++)
+    {
+        const VerifiedRange<Out> &range = verifiedRanges[rangeNdx];
 
-            if (inCount > 3)
-            {
-                builder << "\t" << m_variables.in3->getName() << " = "
-                        << (isInput64Bit ? value64ToString(highpFmt, inputs.in3[valueNdx]) :
-                                           (isInput16Bit ? value16ToString(highpFmt, inputs.in3[valueNdx]) :
-                                                           value32ToString(highpFmt, inputs.in3[valueNdx])))
-                        << "\n";
-            }
+        for (size_t ndx = 0; ndx < range.values.size(); ndx++)
+        {
+            const VerifiedValue<Out> &value = range.values[ndx];
+            const size_t valueNdx           = value.valueNdx;
+            const bool result               = !value.failed;
+            const IOut0 &reference0         = value.reference0;
+            const IOut1 &reference1         = value.reference1;
+
+            if (value.mismatchNdx > 0 && numMismatches + value.mismatchNdx <= maxMsgs)
+                testLog << TestLog::Message << value.mismatch << TestLog::EndMessage;
 
-            if (outCount > 0)
+            if ((value.errorNdx > 0 && numErrors + value.errorNdx <= maxMsgs) || GLS_LOG_ALL_RESULTS)
             {
-                if (m_executor->spirvCase() == SPIRV_CASETYPE_COMPARE)
+                MessageBuilder builder = testLog.message();
+
+                builder << (result ? "Passed" : "Failed") << " sample:\n";
+
+                if (inCount > 0)
                 {
-                    builder << "Output:\n"
-                            << comparisonMessage(outputs.out0[valueNdx]) << "Expected result:\n"
-                            << comparisonMessageInterval<Out0>(reference0) << "\n";
+                    builder << "\t" << m_variables.in0->getName() << " = "
+                            << (isInput64Bit ? value64ToString(highpFmt, inputs.in0[valueNdx]) :
+                                               (isInput16Bit ? value16ToString(highpFmt, inputs.in0[valueNdx]) :
+                                                               value32ToString(highpFmt, inputs.in0[valueNdx])))
+                            << "\n";
                 }
-                else
+
+                if (inCount > 1)
+                {
+                    builder << "\t" << m_variables.in1->getName() << " = "
+                            << (isInput64Bit ? value64ToString(highpFmt, inputs.in1[valueNdx]) :
+                                               (isInput16Bit ? value16ToString(highpFmt, inputs.in1[valueNdx]) :
+                                                               value32ToString(highpFmt, inputs.in1[valueNdx])))
+                            << "\n";
+                }
+
+                if (inCount > 2)
+                {
+                    builder << "\t" << m_variables.in2->getName() << " = "
+                            << (isInput64Bit ? value64ToString(highpFmt, inputs.in2[valueNdx]) :
+                                               (isInput16Bit ? value16ToString(highpFmt, inputs.in2[valueNdx]) :
+                                                               value32ToString(highpFmt, inputs.in2[valueNdx])))
+                            << "\n";
+                }
+
+                if (inCount > 3)
                 {
-                    builder << "\t" << m_variables.out0->getName() << " = "
-                            << (m_executor->isOutput64Bit(0u) ?
-                                    value64ToString(highpFmt, outputs.out0[valueNdx]) :
-                                    (m_executor->isOutput16Bit(0u) || m_caseCtx.isPackFloat16b ?
-                                         value16ToString(highpFmt, outputs.out0[valueNdx]) :
-                                         value32ToString(highpFmt, outputs.out0[valueNdx])))
+                    builder << "\t" << m_variables.in3->getName() << " = "
+                            << (isInput64Bit ? value64ToString(highpFmt, inputs.in3[valueNdx]) :
+                                               (isInput16Bit ? value16ToString(highpFmt, inputs.in3[valueNdx]) :
+                                                               value32ToString(highpFmt, inputs.in3[valueNdx])))
+                            << "\n";
+                }
+
+                if (outCount > 0)
+                {
+                    if (m_executor->spirvCase() == SPIRV_CASETYPE_COMPARE)
+                    {
+                        builder << "Output:\n"
+                                << comparisonMessage(outputs.out0[valueNdx]) << "Expected result:\n"
+                                << comparisonMessageInterval<Out0>(reference0) << "\n";
+                    }
+                    else
+                    {
+                        builder << "\t" << m_variables.out0->getName() << " = "
+                                << (m_executor->isOutput64Bit(0u) ?
+                                        value64ToString(highpFmt, outputs.out0[valueNdx]) :
+                                        (m_executor->isOutput16Bit(0u) || m_caseCtx.isPackFloat16b ?
+                                             value16ToString(highpFmt, outputs.out0[valueNdx]) :
+                                             value32ToString(highpFmt, outputs.out0[valueNdx])))
+                                << "\n"
+                                << "\tExpected range: " << intervalToString<Out0>(highpFmt, reference0) << "\n";
+                    }
+                }
+
+                if (outCount > 1)
+                {
+                    builder << "\t" << m_variables.out1->getName() << " = "
+                            << (m_executor->isOutput64Bit(1u) ?
+                                    value64ToString(highpFmt, outputs.out1[valueNdx]) :
+                                    (m_executor->isOutput16Bit(1u) || m_caseCtx.isPackFloat16b ?
+                                         value16ToString(highpFmt, outputs.out1[valueNdx]) :
+                                         value32ToString(highpFmt, outputs.out1[valueNdx])))
                             << "\n"
-                            << "\tExpected range: " << intervalToString<Out0>(highpFmt, reference0) << "\n";
+                            << "\tExpected range: " << intervalToString<Out1>(highpFmt, reference1) << "\n";
                 }
-            }
 
-            if (outCount > 1)
-            {
-                builder << "\t" << m_variables.out1->getName() << " = "
-                        << (m_executor->isOutput64Bit(1u) ? value64ToString(highpFmt, outputs.out1[valueNdx]) :
-                                                            (m_executor->isOutput16Bit(1u) || m_caseCtx.isPackFloat16b ?
-                                                                 value16ToString(highpFmt, outputs.out1[valueNdx]) :
-                                                                 value32ToString(highpFmt, outputs.out1[valueNdx])))
-                        << "\n"
-                        << "\tExpected range: " << intervalToString<Out1>(highpFmt, reference1) << "\n";
+                builder << TestLog::EndMessage;
             }
-
-            builder << TestLog::EndMessage;
         }
+
+        numErrors += range.numErrors;
+        numMismatches += range.numMismatches;
     }
 
     if (numErrors > maxMsgs)
@@ -7611,6 +8463,13 @@ tcu::TestStatus BuiltinPrecisionCaseTestInstance<In, Out>::iterate(void)
         testLog << TestLog::Message << "(Skipped " << (numErrors - maxMsgs) << " messages.)" << TestLog::EndMessage;
     }
 
+    if (numMismatches > 0)
+    {
+        testLog << TestLog::Message << numMismatches << "/" << numValues
+                << " reference intervals differ between compiled and tree-walking evaluation." << TestLog::EndMessage;
+        return tcu::TestStatus::fail("Compiled reference evaluation differs from tree-walking evaluation");
+    }
+
     if (numErrors == 0)
     {
         testLog << TestLog::Message << "All " << numValues << " inputs passed." << TestLog::EndMessage;
@@ -7670,7 +8529,6 @@ void PrecisionCase::testStatement(const Variables<In, Out> &variables, const Sta
 {
     const int inCount  = numInputs<In>();
     const int outCount = numOutputs<Out>();
-    Environment env; // Hoisted out of the inner loop for optimization.
 
     // Initialize ShaderSpec from precision, variables and statement.
     if (m_ctx.precision != glu::PRECISION_LAST)
@@ -251,6 +251,7 @@ public:
         const tcu::Texture1DArray *tex1DArray;
         const tcu::Texture2DArray *tex2DArray;
         const tcu::TextureCubeArray *texCubeArray;
+        tcu::PreparedSampler2D prepared2D; //!< tex2D with sampler, used by texture2D()
 
         inline ShaderSampler(void)
             : tex1D(DE_NULL)
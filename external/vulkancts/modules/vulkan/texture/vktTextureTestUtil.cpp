@@ -2029,8 +2029,9 @@ TestTexture2DSp loadTexture2D(const tcu::Archive &archive, const std::vector<std
                 texture =
                     TestTexture2DSp(new pipeline::TestTexture2D(commonFormat, level.getWidth(), level.getHeight()));
 
+            // Decoded texels don't depend on the thread count, decode large files on all cores.
             level.decompress(decompressedBuffer,
-                             tcu::TexDecompressionParams(tcu::TexDecompressionParams::ASTCMODE_LDR));
+                             tcu::TexDecompressionParams(tcu::TexDecompressionParams::ASTCMODE_LDR, 0));
 
             tcu::copy(commonFormatBuffer, decompressedBuffer);
             tcu::copy(texture->getLevel((int)fileIndex, 0), commonFormatBuffer);
@@ -2101,8 +2102,9 @@ TestTextureCubeSp loadTextureCube(const tcu::Archive &archive, const std::vector
             if (fileIndex == 0)
                 texture = TestTextureCubeSp(new pipeline::TestTextureCube(commonFormat, level.getWidth()));
 
+            // Decoded texels don't depend on the thread count, decode large files on all cores.
             level.decompress(decompressedBuffer,
-                             tcu::TexDecompressionParams(tcu::TexDecompressionParams::ASTCMODE_LDR));
+                             tcu::TexDecompressionParams(tcu::TexDecompressionParams::ASTCMODE_LDR, 0));
 
             tcu::copy(commonFormatBuffer, decompressedBuffer);
             tcu::copy(texture->getLevel((int)fileIndex / 6, (int)fileIndex % 6), commonFormatBuffer);
@@ -36,10 +36,13 @@
 #include "deCommandLine.hpp"
 #include "deSharedPtr.hpp"
 #include "deThread.hpp"
-#include "deThreadSafeRingBuffer.hpp"
+#include "deSemaphore.hpp"
+#include "deMutex.hpp"
+#include "deAtomic.h"
 #include "dePoolArray.hpp"
 
 #include <iostream>
+#include <deque>
 
 using de::MovePtr;
 using de::SharedPtr;
@@ -60,19 +63,73 @@ typedef de::SharedPtr<vk::ProgramBinary> ProgramBinarySp;
 class Task
 {
 public:
+    Task(void) : m_continuation(DE_NULL)
+    {
+    }
+
     virtual ~Task()
     {
     }
 
     virtual void execute(void) = 0;
+
+    // Continuation is scheduled on the executing thread right after this task completes
+    void setContinuation(Task *continuation)
+    {
+        m_continuation = continuation;
+    }
+
+    Task *getContinuation(void) const
+    {
+        return m_continuation;
+    }
+
+private:
+    Task *m_continuation;
 };
 
-typedef de::ThreadSafeRingBuffer<Task *> TaskQueue;
+class TaskExecutorThread;
+
+// Work-stealing task executor. Each thread owns a deque; the owner pushes and pops
+// at the back, and idle threads steal the oldest tasks from the front of others.
+class TaskExecutor
+{
+public:
+    TaskExecutor(uint32_t numThreads);
+    ~TaskExecutor(void);
+
+    void submit(Task *task);
+    void waitForComplete(void);
+
+private:
+    friend class TaskExecutorThread;
+
+    struct TaskDeque
+    {
+        de::Mutex lock;
+        std::deque<Task *> tasks;
+    };
+
+    typedef de::SharedPtr<TaskExecutorThread> ExecThreadSp;
+    typedef de::SharedPtr<TaskDeque> TaskDequeSp;
+
+    void push(size_t queueNdx, Task *task);
+    Task *acquire(size_t threadNdx);
+    void complete(size_t threadNdx, Task *task);
+
+    std::vector<TaskDequeSp> m_queues;
+    std::vector<ExecThreadSp> m_threads;
+
+    de::Semaphore m_numQueued;      //!< Number of tasks in all deques
+    de::Semaphore m_completeSignal; //!< Signaled when m_numPending drops to zero
+    volatile uint32_t m_numPending; //!< Number of submitted tasks not yet completed
+    volatile uint32_t m_nextQueueNdx;
+};
 
 class TaskExecutorThread : public de::Thread
 {
 public:
-    TaskExecutorThread(TaskQueue &tasks) : m_tasks(tasks)
+    TaskExecutorThread(TaskExecutor &executor, size_t threadNdx) : m_executor(executor), m_threadNdx(threadNdx)
     {
         start();
     }
@@ -81,104 +138,127 @@ public:
     {
         for (;;)
         {
-            Task *const task = m_tasks.popBack();
+            Task *const task = m_executor.acquire(m_threadNdx);
 
             if (task)
+            {
                 task->execute();
+                m_executor.complete(m_threadNdx, task);
+            }
             else
                 break; // End of tasks - time to terminate
         }
     }
 
 private:
-    TaskQueue &m_tasks;
+    TaskExecutor &m_executor;
+    const size_t m_threadNdx;
 };
 
-class TaskExecutor
+TaskExecutor::TaskExecutor(uint32_t numThreads)
+    : m_queues(numThreads)
+    , m_threads(numThreads)
+    , m_numQueued(0)
+    , m_completeSignal(0)
+    , m_numPending(0)
+    , m_nextQueueNdx(0)
 {
-public:
-    TaskExecutor(uint32_t numThreads);
-    ~TaskExecutor(void);
-
-    void submit(Task *task);
-    void waitForComplete(void);
-
-private:
-    typedef de::SharedPtr<TaskExecutorThread> ExecThreadSp;
+    for (size_t ndx = 0; ndx < m_queues.size(); ++ndx)
+        m_queues[ndx] = TaskDequeSp(new TaskDeque());
 
-    std::vector<ExecThreadSp> m_threads;
-    TaskQueue m_tasks;
-};
-
-TaskExecutor::TaskExecutor(uint32_t numThreads) : m_threads(numThreads), m_tasks(m_threads.size() * 1024u)
-{
     for (size_t ndx = 0; ndx < m_threads.size(); ++ndx)
-        m_threads[ndx] = ExecThreadSp(new TaskExecutorThread(m_tasks));
+        m_threads[ndx] = ExecThreadSp(new TaskExecutorThread(*this, ndx));
 }
 
 TaskExecutor::~TaskExecutor(void)
 {
+    // Each thread terminates after acquiring one null task
     for (size_t ndx = 0; ndx < m_threads.size(); ++ndx)
-        m_tasks.pushFront(DE_NULL);
+        push(ndx, DE_NULL);
 
     for (size_t ndx = 0; ndx < m_threads.size(); ++ndx)
         m_threads[ndx]->join();
 }
 
-void TaskExecutor::submit(Task *task)
+void TaskExecutor::push(size_t queueNdx, Task *task)
 {
-    DE_ASSERT(task);
-    m_tasks.pushFront(task);
+    {
+        TaskDeque &queue = *m_queues[queueNdx];
+        const de::ScopedLock lock(queue.lock);
+
+        queue.tasks.push_back(task);
+    }
+
+    m_numQueued.increment();
 }
 
-class SyncTask : public Task
+Task *TaskExecutor::acquire(size_t threadNdx)
 {
-public:
-    SyncTask(de::Semaphore *enterBarrier, de::Semaphore *inBarrier, de::Semaphore *leaveBarrier)
-        : m_enterBarrier(enterBarrier)
-        , m_inBarrier(inBarrier)
-        , m_leaveBarrier(leaveBarrier)
-    {
-    }
+    m_numQueued.decrement();
 
-    SyncTask(void) : m_enterBarrier(DE_NULL), m_inBarrier(DE_NULL), m_leaveBarrier(DE_NULL)
+    // A task is guaranteed to be available in some deque, but it may take
+    // several rounds to find it as other threads push and steal concurrently.
+    for (;;)
     {
-    }
+        // Newest task from own deque
+        {
+            TaskDeque &queue = *m_queues[threadNdx];
+            const de::ScopedLock lock(queue.lock);
 
-    void execute(void)
-    {
-        m_enterBarrier->increment();
-        m_inBarrier->decrement();
-        m_leaveBarrier->increment();
-    }
+            if (!queue.tasks.empty())
+            {
+                Task *const task = queue.tasks.back();
+                queue.tasks.pop_back();
+                return task;
+            }
+        }
 
-private:
-    de::Semaphore *m_enterBarrier;
-    de::Semaphore *m_inBarrier;
-    de::Semaphore *m_leaveBarrier;
-};
+        // Oldest task from other deques
+        for (size_t offset = 1; offset < m_queues.size(); ++offset)
+        {
+            TaskDeque &queue = *m_queues[(threadNdx + offset) % m_queues.size()];
+            const de::ScopedLock lock(queue.lock);
 
-void TaskExecutor::waitForComplete(void)
+            if (!queue.tasks.empty())
+            {
+                Task *const task = queue.tasks.front();
+                queue.tasks.pop_front();
+                return task;
+            }
+        }
+    }
+}
+
+void TaskExecutor::complete(size_t threadNdx, Task *task)
 {
-    de::Semaphore enterBarrier(0);
-    de::Semaphore inBarrier(0);
-    de::Semaphore leaveBarrier(0);
-    std::vector<SyncTask> syncTasks(m_threads.size());
+    Task *const continuation = task->getContinuation();
 
-    for (size_t ndx = 0; ndx < m_threads.size(); ++ndx)
+    if (continuation)
     {
-        syncTasks[ndx] = SyncTask(&enterBarrier, &inBarrier, &leaveBarrier);
-        submit(&syncTasks[ndx]);
+        deAtomicIncrementUint32(&m_numPending);
+        push(threadNdx, continuation);
     }
 
-    for (size_t ndx = 0; ndx < m_threads.size(); ++ndx)
-        enterBarrier.decrement();
+    if (deAtomicDecrementUint32(&m_numPending) == 0)
+        m_completeSignal.increment();
+}
 
-    for (size_t ndx = 0; ndx < m_threads.size(); ++ndx)
-        inBarrier.increment();
+void TaskExecutor::submit(Task *task)
+{
+    DE_ASSERT(task);
 
-    for (size_t ndx = 0; ndx < m_threads.size(); ++ndx)
-        leaveBarrier.decrement();
+    const uint32_t queueNdx = deAtomicIncrementUint32(&m_nextQueueNdx) % (uint32_t)m_queues.size();
+
+    deAtomicIncrementUint32(&m_numPending);
+    push(queueNdx, task);
+}
+
+void TaskExecutor::waitForComplete(void)
+{
+    // Pending count may drop to zero several times while tasks are being submitted,
+    // so a signal doesn't guarantee completion by itself.
+    while (m_numPending != 0)
+        m_completeSignal.decrement();
 }
 
 struct Program
@@ -193,6 +273,7 @@ struct Program
     };
 
     vk::ProgramIdentifier id;
+    deSha1 digest;
 
     Status buildStatus;
     std::string buildLog;
@@ -203,8 +284,10 @@ struct Program
 
     vk::SpirvValidatorOptions validatorOptions;
 
-    explicit Program(const vk::ProgramIdentifier &id_, const vk::SpirvValidatorOptions &valOptions_)
+    explicit Program(const vk::ProgramIdentifier &id_, const deSha1 &digest_,
+                     const vk::SpirvValidatorOptions &valOptions_)
         : id(id_)
+        , digest(digest_)
         , buildStatus(STATUS_NOT_COMPLETED)
         , validationStatus(STATUS_NOT_COMPLETED)
         , validatorOptions(valOptions_)
@@ -212,6 +295,7 @@ struct Program
     }
     Program(void)
         : id("", "")
+        , digest()
         , buildStatus(STATUS_NOT_COMPLETED)
         , validationStatus(STATUS_NOT_COMPLETED)
         , validatorOptions()
@@ -355,9 +439,16 @@ public:
     {
     }
 
+    ValidateBinaryTask(void) : m_program(DE_NULL)
+    {
+    }
+
     void execute(void)
     {
-        DE_ASSERT(m_program->buildStatus == Program::STATUS_PASSED);
+        // Chained after build task; nothing to validate if the build failed
+        if (m_program->buildStatus != Program::STATUS_PASSED)
+            return;
+
         DE_ASSERT(m_program->binary->getFormat() == vk::PROGRAM_FORMAT_SPIRV);
 
         std::ostringstream validationLogStream;
@@ -387,15 +478,17 @@ struct BuildStats
     int numSucceeded;
     int numFailed;
     int notSupported;
+    int numUpToDate;
 
-    BuildStats(void) : numSucceeded(0), numFailed(0), notSupported(0)
+    BuildStats(void) : numSucceeded(0), numFailed(0), notSupported(0), numUpToDate(0)
     {
     }
 };
 
 BuildStats buildPrograms(tcu::TestContext &testCtx, const std::string &dstPath, const bool validateBinaries,
                          const uint32_t usedVulkanVersion, const vk::SpirvVersion baselineSpirvVersion,
-                         const vk::SpirvVersion maxSpirvVersion, const bool allowSpirV14)
+                         const vk::SpirvVersion maxSpirvVersion, const bool allowSpirV14, const bool incremental,
+                         const bool compressBinaries)
 {
     const uint32_t numThreads    = deGetNumAvailableLogicalCores();
     const size_t numNodesInChunk = 500000;
@@ -408,6 +501,9 @@ BuildStats buildPrograms(tcu::TestContext &testCtx, const std::string &dstPath,
     BuildStats stats;
     int notSupported = 0;
 
+    // Registry is shared by all chunks so that the index covers every program
+    vk::BinaryRegistryWriter registryWriter(dstPath, compressBinaries);
+
     while (iterator.getState() != tcu::TestHierarchyIterator::STATE_FINISHED)
     {
 
@@ -421,6 +517,7 @@ BuildStats buildPrograms(tcu::TestContext &testCtx, const std::string &dstPath,
         de::PoolArray<BuildHighLevelShaderTask<vk::GlslSource>> buildGlslTasks(&tmpPool);
         de::PoolArray<BuildHighLevelShaderTask<vk::HlslSource>> buildHlslTasks(&tmpPool);
         de::PoolArray<BuildSpirVAsmTask> buildSpirvAsmTasks(&tmpPool);
+        de::PoolArray<ValidateBinaryTask> validationTasks(&tmpPool);
 
         // Collect build tasks. We perform tests in chunks to reduce memory usage
         size_t numNodesAdded = 0;
@@ -460,11 +557,27 @@ BuildStats buildPrograms(tcu::TestContext &testCtx, const std::string &dstPath,
                           progIter.getProgram().buildOptions.targetVersion == vk::SPIRV_VERSION_1_4))
                         continue;
 
-                    programs.pushBack(Program(vk::ProgramIdentifier(casePath, progIter.getName()),
-                                              progIter.getProgram().buildOptions.getSpirvValidatorOptions()));
+                    const vk::ProgramIdentifier progId(casePath, progIter.getName());
+                    const deSha1 digest = vk::getProgramDigest(progIter.getProgram(), testCtx.getCommandLine());
+
+                    if (incremental && registryWriter.addUnchangedProgram(progId, digest))
+                    {
+                        stats.numUpToDate += 1;
+                        continue;
+                    }
+
+                    programs.pushBack(
+                        Program(progId, digest, progIter.getProgram().buildOptions.getSpirvValidatorOptions()));
                     buildGlslTasks.pushBack(
                         BuildHighLevelShaderTask<vk::GlslSource>(progIter.getProgram(), &programs.back()));
                     buildGlslTasks.back().setCommandline(testCtx.getCommandLine());
+
+                    if (validateBinaries)
+                    {
+                        validationTasks.pushBack(ValidateBinaryTask(&programs.back()));
+                        buildGlslTasks.back().setContinuation(&validationTasks.back());
+                    }
+
                     executor.submit(&buildGlslTasks.back());
                 }
 
@@ -478,11 +591,27 @@ BuildStats buildPrograms(tcu::TestContext &testCtx, const std::string &dstPath,
                           progIter.getProgram().buildOptions.targetVersion == vk::SPIRV_VERSION_1_4))
                         continue;
 
-                    programs.pushBack(Program(vk::ProgramIdentifier(casePath, progIter.getName()),
-                                              progIter.getProgram().buildOptions.getSpirvValidatorOptions()));
+                    const vk::ProgramIdentifier progId(casePath, progIter.getName());
+                    const deSha1 digest = vk::getProgramDigest(progIter.getProgram(), testCtx.getCommandLine());
+
+                    if (incremental && registryWriter.addUnchangedProgram(progId, digest))
+                    {
+                        stats.numUpToDate += 1;
+                        continue;
+                    }
+
+                    programs.pushBack(
+                        Program(progId, digest, progIter.getProgram().buildOptions.getSpirvValidatorOptions()));
                     buildHlslTasks.pushBack(
                         BuildHighLevelShaderTask<vk::HlslSource>(progIter.getProgram(), &programs.back()));
                     buildHlslTasks.back().setCommandline(testCtx.getCommandLine());
+
+                    if (validateBinaries)
+                    {
+                        validationTasks.pushBack(ValidateBinaryTask(&programs.back()));
+                        buildHlslTasks.back().setContinuation(&validationTasks.back());
+                    }
+
                     executor.submit(&buildHlslTasks.back());
                 }
 
@@ -496,10 +625,26 @@ BuildStats buildPrograms(tcu::TestContext &testCtx, const std::string &dstPath,
                           progIter.getProgram().buildOptions.targetVersion == vk::SPIRV_VERSION_1_4))
                         continue;
 
-                    programs.pushBack(Program(vk::ProgramIdentifier(casePath, progIter.getName()),
-                                              progIter.getProgram().buildOptions.getSpirvValidatorOptions()));
+                    const vk::ProgramIdentifier progId(casePath, progIter.getName());
+                    const deSha1 digest = vk::getProgramDigest(progIter.getProgram(), testCtx.getCommandLine());
+
+                    if (incremental && registryWriter.addUnchangedProgram(progId, digest))
+                    {
+                        stats.numUpToDate += 1;
+                        continue;
+                    }
+
+                    programs.pushBack(
+                        Program(progId, digest, progIter.getProgram().buildOptions.getSpirvValidatorOptions()));
                     buildSpirvAsmTasks.pushBack(BuildSpirVAsmTask(progIter.getProgram(), &programs.back()));
                     buildSpirvAsmTasks.back().setCommandline(testCtx.getCommandLine());
+
+                    if (validateBinaries)
+                    {
+                        validationTasks.pushBack(ValidateBinaryTask(&programs.back()));
+                        buildSpirvAsmTasks.back().setContinuation(&validationTasks.back());
+                    }
+
                     executor.submit(&buildSpirvAsmTasks.back());
                 }
             }
@@ -507,37 +652,14 @@ BuildStats buildPrograms(tcu::TestContext &testCtx, const std::string &dstPath,
             iterator.next();
         }
 
-        // Need to wait until tasks completed before freeing task memory
+        // Need to wait until tasks completed before freeing task memory. Validation
+        // tasks are chained after their build tasks and complete as part of this.
         executor.waitForComplete();
 
-        if (validateBinaries)
+        for (de::PoolArray<Program>::iterator progIter = programs.begin(); progIter != programs.end(); ++progIter)
         {
-            std::vector<ValidateBinaryTask> validationTasks;
-
-            validationTasks.reserve(programs.size());
-
-            for (de::PoolArray<Program>::iterator progIter = programs.begin(); progIter != programs.end(); ++progIter)
-            {
-                if (progIter->buildStatus == Program::STATUS_PASSED)
-                {
-                    validationTasks.push_back(ValidateBinaryTask(&*progIter));
-                    executor.submit(&validationTasks.back());
-                }
-            }
-
-            executor.waitForComplete();
-        }
-
-        {
-            vk::BinaryRegistryWriter registryWriter(dstPath);
-
-            for (de::PoolArray<Program>::iterator progIter = programs.begin(); progIter != programs.end(); ++progIter)
-            {
-                if (progIter->buildStatus == Program::STATUS_PASSED)
-                    registryWriter.addProgram(progIter->id, *progIter->binary);
-            }
-
-            registryWriter.write();
+            if (progIter->buildStatus == Program::STATUS_PASSED)
+                registryWriter.addProgram(progIter->id, *progIter->binary, progIter->digest);
         }
 
         {
@@ -560,6 +682,8 @@ BuildStats buildPrograms(tcu::TestContext &testCtx, const std::string &dstPath,
         }
     }
 
+    registryWriter.write();
+
     return stats;
 }
 
@@ -578,6 +702,8 @@ DE_DECLARE_COMMAND_LINE_OPT(ShaderCacheTruncate, bool);
 DE_DECLARE_COMMAND_LINE_OPT(SpirvOptimize, bool);
 DE_DECLARE_COMMAND_LINE_OPT(SpirvOptimizationRecipe, std::string);
 DE_DECLARE_COMMAND_LINE_OPT(SpirvAllow14, bool);
+DE_DECLARE_COMMAND_LINE_OPT(Incremental, bool);
+DE_DECLARE_COMMAND_LINE_OPT(CompressBinaries, bool);
 
 static const de::cmdline::NamedValue<bool> s_enableNames[] = {{"enable", true}, {"disable", false}};
 
@@ -607,7 +733,10 @@ void registerOptions(de::cmdline::Parser &parser)
            << Option<opt::SpirvOptimize>("o", "deqp-optimize-spirv", "Enable optimization for SPIR-V", s_enableNames,
                                          "disable")
            << Option<opt::SpirvOptimizationRecipe>("p", "deqp-optimization-recipe", "Shader optimization recipe")
-           << Option<opt::SpirvAllow14>("e", "allow-spirv-14", "Allow SPIR-V 1.4 with Vulkan 1.1");
+           << Option<opt::SpirvAllow14>("e", "allow-spirv-14", "Allow SPIR-V 1.4 with Vulkan 1.1")
+           << Option<opt::Incremental>("i", "incremental",
+                                       "Only build programs that have changed since previous build in dst-path")
+           << Option<opt::CompressBinaries>("z", "compress-binaries", "Compress binaries in the binary pack");
 }
 
 } // namespace opt
@@ -698,7 +827,11 @@ int main(int argc, const char *argv[])
         const vkt::BuildStats stats =
             vkt::buildPrograms(testCtx, cmdLine.getOption<opt::DstPath>(), cmdLine.getOption<opt::Validate>(),
                                cmdLine.getOption<opt::VulkanVersion>(), baselineSpirvVersion, maxSpirvVersion,
-                               cmdLine.getOption<opt::SpirvAllow14>());
+                               cmdLine.getOption<opt::SpirvAllow14>(), cmdLine.getOption<opt::Incremental>(),
+                               cmdLine.getOption<opt::CompressBinaries>());
+
+        if (cmdLine.getOption<opt::Incremental>())
+            tcu::print("%d programs up to date\n", stats.numUpToDate);
 
         tcu::print("DONE: %d passed, %d failed, %d not supported\n", stats.numSucceeded, stats.numFailed,
                    stats.notSupported);
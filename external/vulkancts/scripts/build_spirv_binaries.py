@@ -54,7 +54,7 @@ def getBuildConfig (buildPathPtrn, targetName, buildType):
     return BuildConfig(buildPath, buildType, ["-DDEQP_TARGET=%s" % targetName])
 
 def cleanDstDir (dstPath):
-    binFiles = [f for f in os.listdir(dstPath) if os.path.isfile(os.path.join(dstPath, f)) and fnmatch.fnmatch(f, "*.spv")]
+    binFiles = [f for f in os.listdir(dstPath) if os.path.isfile(os.path.join(dstPath, f)) and (fnmatch.fnmatch(f, "*.spv") or f == "binaries.pack")]
 
     for binFile in binFiles:
         print("Removing %s" % os.path.join(dstPath, binFile))
@@ -156,6 +156,8 @@ App::App(Platform &platform, Archive &archive, TestLog &log, const CommandLine &
         if (cmdLine.isCrashHandlingEnabled())
             TCU_CHECK_INTERNAL(m_crashHandler = qpCrashHandler_create(onCrash, this));
 
+        log.setImageCompressionOptions(cmdLine.getLogImageCompressionLevel(), cmdLine.getLogImagePngFilter());
+
         // Create test context
         m_testCtx = new TestContext(m_platform, archive, log, cmdLine, m_watchDog);
 
@@ -336,11 +338,17 @@ void App::onCrash(void)
 
     if (isInCase)
     {
+        // Crash info is written directly to the file if log is written asynchronously
+        m_testCtx->getLog().flushAfterCrash();
         qpCrashHandler_writeCrashInfo(m_crashHandler, writeCrashToLog, &m_testCtx->getLog());
         m_testCtx->getLog().terminateCase(QP_TEST_RESULT_CRASH);
     }
     else
+    {
+        // Previous case may still be buffered if log is written asynchronously
+        m_testCtx->getLog().flushAfterCrash();
         qpCrashHandler_writeCrashInfo(m_crashHandler, writeCrashToConsole, DE_NULL);
+    }
 
     die("Test program crashed");
 }
@@ -25,6 +25,7 @@
 #include "tcuTexture.hpp"
 #include "tcuTextureUtil.hpp"
 #include "tcuRGBA.hpp"
+#include "tcuParallelFor.hpp"
 
 namespace tcu
 {
@@ -34,7 +35,8 @@ namespace
 
 enum
 {
-    NUM_SUBPIXEL_BITS = 8 //!< Number of subpixel bits used when doing bilinear interpolation.
+    NUM_SUBPIXEL_BITS = 8, //!< Number of subpixel bits used when doing bilinear interpolation.
+    ROWS_PER_RANGE    = 8  //!< Rows compared by one parallelSum() range.
 };
 
 // \note Algorithm assumes that colors are packed to 32-bit values as dictated by
@@ -168,7 +170,7 @@ bool comparePixelRGBA8(const ConstPixelBufferAccess &reference, const ConstPixel
 }
 
 bool bilinearCompareRGBA8(const ConstPixelBufferAccess &reference, const ConstPixelBufferAccess &result,
-                          const PixelBufferAccess &errorMask, const RGBA threshold)
+                          const PixelBufferAccess &errorMask, const RGBA threshold, int numThreads)
 {
     DE_ASSERT(reference.getFormat() == TextureFormat(TextureFormat::RGBA, TextureFormat::UNORM_INT8) &&
               result.getFormat() == TextureFormat(TextureFormat::RGBA, TextureFormat::UNORM_INT8));
@@ -176,28 +178,34 @@ bool bilinearCompareRGBA8(const ConstPixelBufferAccess &reference, const ConstPi
     // Clear error mask first to green (faster this way).
     clear(errorMask, Vec4(0.0f, 1.0f, 0.0f, 1.0f));
 
-    bool allOk = true;
-
-    for (int y = 0; y < reference.getHeight(); y++)
+    // Pixels are compared independently, so the rows can be split between threads freely.
+    const auto compareRows = [&](int rowBegin, int rowEnd)
     {
-        for (int x = 0; x < reference.getWidth(); x++)
+        int numFailed = 0;
+
+        for (int y = rowBegin; y < rowEnd; y++)
         {
-            if (!comparePixelRGBA8(reference, result, threshold, x, y) &&
-                !comparePixelRGBA8(result, reference, threshold, x, y))
+            for (int x = 0; x < reference.getWidth(); x++)
             {
-                allOk = false;
-                errorMask.setPixel(Vec4(1.0f, 0.0f, 0.0f, 1.0f), x, y);
+                if (!comparePixelRGBA8(reference, result, threshold, x, y) &&
+                    !comparePixelRGBA8(result, reference, threshold, x, y))
+                {
+                    numFailed += 1;
+                    errorMask.setPixel(Vec4(1.0f, 0.0f, 0.0f, 1.0f), x, y);
+                }
             }
         }
-    }
 
-    return allOk;
+        return numFailed;
+    };
+
+    return parallelSum(reference.getHeight(), ROWS_PER_RANGE, compareRows, numThreads) == 0;
 }
 
 } // namespace
 
 bool bilinearCompare(const ConstPixelBufferAccess &reference, const ConstPixelBufferAccess &result,
-                     const PixelBufferAccess &errorMask, const RGBA threshold)
+                     const PixelBufferAccess &errorMask, const RGBA threshold, int numThreads)
 {
     DE_ASSERT(reference.getWidth() == result.getWidth() && reference.getHeight() == result.getHeight() &&
               reference.getDepth() == result.getDepth() && reference.getFormat() == result.getFormat());
@@ -205,7 +213,7 @@ bool bilinearCompare(const ConstPixelBufferAccess &reference, const ConstPixelBu
               reference.getDepth() == errorMask.getDepth());
 
     if (reference.getFormat() == TextureFormat(TextureFormat::RGBA, TextureFormat::UNORM_INT8))
-        return bilinearCompareRGBA8(reference, result, errorMask, threshold);
+        return bilinearCompareRGBA8(reference, result, errorMask, threshold, numThreads);
     else
         throw InternalError("Unsupported format for bilinear comparison");
 }
@@ -32,8 +32,9 @@ class ConstPixelBufferAccess;
 class PixelBufferAccess;
 class RGBA;
 
+//! Compares rows on up to numThreads threads, 0 = all cores. Result doesn't depend on the number of threads.
 bool bilinearCompare(const ConstPixelBufferAccess &reference, const ConstPixelBufferAccess &result,
-                     const PixelBufferAccess &errorMask, const RGBA threshold);
+                     const PixelBufferAccess &errorMask, const RGBA threshold, int numThreads = 1);
 
 } // namespace tcu
 
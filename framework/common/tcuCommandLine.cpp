@@ -101,6 +101,10 @@ DE_DECLARE_COMMAND_LINE_OPT(VKDeviceID, int);
 DE_DECLARE_COMMAND_LINE_OPT(VKDeviceGroupID, int);
 DE_DECLARE_COMMAND_LINE_OPT(LogFlush, bool);
 DE_DECLARE_COMMAND_LINE_OPT(LogCompact, bool);
+DE_DECLARE_COMMAND_LINE_OPT(LogAsyncWrite, bool);
+DE_DECLARE_COMMAND_LINE_OPT(LogBinaryFormat, bool);
+DE_DECLARE_COMMAND_LINE_OPT(LogImageCompressionLevel, int);
+DE_DECLARE_COMMAND_LINE_OPT(LogImagePngFilter, qpPngFilter);
 DE_DECLARE_COMMAND_LINE_OPT(Validation, bool);
 DE_DECLARE_COMMAND_LINE_OPT(PrintValidationErrors, bool);
 DE_DECLARE_COMMAND_LINE_OPT(DuplicateCheck, bool);
@@ -115,6 +119,7 @@ DE_DECLARE_COMMAND_LINE_OPT(CaseFraction, std::vector<int>);
 DE_DECLARE_COMMAND_LINE_OPT(CaseFractionMandatoryTests, std::string);
 DE_DECLARE_COMMAND_LINE_OPT(WaiverFile, std::string);
 DE_DECLARE_COMMAND_LINE_OPT(RunnerType, tcu::TestRunnerType);
+DE_DECLARE_COMMAND_LINE_OPT(PrecisionEval, tcu::PrecisionEvalMode);
 DE_DECLARE_COMMAND_LINE_OPT(TerminateOnFail, bool);
 DE_DECLARE_COMMAND_LINE_OPT(TerminateOnDeviceLost, bool);
 DE_DECLARE_COMMAND_LINE_OPT(SubProcess, bool);
@@ -177,6 +182,21 @@ void registerOptions(de::cmdline::Parser &parser)
         {"none", tcu::RUNNERTYPE_NONE},
         {"amber", tcu::RUNNERTYPE_AMBER},
     };
+    static const NamedValue<qpPngFilter> s_pngFilters[]              = {
+        {"default", QP_PNG_FILTER_DEFAULT},
+        {"none", QP_PNG_FILTER_NONE},
+        {"sub", QP_PNG_FILTER_SUB},
+        {"up", QP_PNG_FILTER_UP},
+        {"avg", QP_PNG_FILTER_AVG},
+        {"paeth", QP_PNG_FILTER_PAETH},
+        {"all", QP_PNG_FILTER_ALL},
+    };
+    static const NamedValue<bool> s_logFormats[]                     = {{"xml", false}, {"binary", true}};
+    static const NamedValue<PrecisionEvalMode> s_precisionEvals[]    = {
+        {"tree", PRECISIONEVALMODE_TREE},
+        {"compiled", PRECISIONEVALMODE_COMPILED},
+        {"crosscheck", PRECISIONEVALMODE_CROSSCHECK},
+    };
 
     parser
         << Option<QuietStdout>("q", "quiet", "Suppress messages to standard output")
@@ -237,6 +257,14 @@ void registerOptions(de::cmdline::Parser &parser)
         << Option<LogFlush>(DE_NULL, "deqp-log-flush", "Enable or disable log file fflush", s_enableNames, "enable")
         << Option<LogCompact>(DE_NULL, "deqp-log-compact", "Enable or disable the compact version of the log",
                               s_enableNames, "disable")
+        << Option<LogAsyncWrite>(DE_NULL, "deqp-log-async-write",
+                                 "Enable or disable writing log file on a separate thread", s_enableNames, "disable")
+        << Option<LogBinaryFormat>(DE_NULL, "deqp-log-format", "Write log file as XML or in binary format",
+                                   s_logFormats, "xml")
+        << Option<LogImageCompressionLevel>(DE_NULL, "deqp-log-image-compression-level",
+                                            "zlib compression level (0-9) of PNG images in log, -1 for default", "-1")
+        << Option<LogImagePngFilter>(DE_NULL, "deqp-log-image-png-filter", "Row filter of PNG images in log",
+                                     s_pngFilters, "default")
         << Option<Validation>(DE_NULL, "deqp-validation", "Enable or disable test case validation", s_enableNames,
                               "disable")
         << Option<PrintValidationErrors>(DE_NULL, "deqp-print-validation-errors",
@@ -253,7 +281,8 @@ void registerOptions(de::cmdline::Parser &parser)
                                        "shadercache.bin")
         << Option<ShaderCacheTruncate>(DE_NULL, "deqp-shadercache-truncate",
                                        "Truncate shader cache before running tests", s_enableNames, "enable")
-        << Option<ShaderCacheIPC>(DE_NULL, "deqp-shadercache-ipc", "Should shader cache use inter process comms",
+        << Option<ShaderCacheIPC>(DE_NULL, "deqp-shadercache-ipc",
+                                  "Share shader cache file with other instances (disables truncation)",
                                   s_enableNames, "disable")
         << Option<RenderDoc>(DE_NULL, "deqp-renderdoc", "Enable RenderDoc frame markers", s_enableNames, "disable")
         << Option<CaseFraction>(DE_NULL, "deqp-fraction",
@@ -262,6 +291,9 @@ void registerOptions(de::cmdline::Parser &parser)
                                               "Case list file that must be run for each fraction", "")
         << Option<WaiverFile>(DE_NULL, "deqp-waiver-file", "Read waived tests from given file", "")
         << Option<RunnerType>(DE_NULL, "deqp-runner-type", "Filter test cases based on runner", s_runnerTypes, "any")
+        << Option<PrecisionEval>(DE_NULL, "deqp-precision-eval",
+                                 "Reference interval evaluation of Vulkan builtin precision tests", s_precisionEvals,
+                                 "tree")
         << Option<TerminateOnFail>(DE_NULL, "deqp-terminate-on-fail", "Terminate the run on first failure",
                                    s_enableNames, "disable")
         << Option<TerminateOnDeviceLost>(DE_NULL, "deqp-terminate-on-device-lost",
@@ -1079,9 +1111,22 @@ bool CommandLine::parse(int argc, const char *const *argv)
     if (m_cmdLine.getOption<opt::LogCompact>())
         m_logFlags |= QP_TEST_LOG_COMPACT;
 
+    if (m_cmdLine.getOption<opt::LogAsyncWrite>())
+        m_logFlags |= QP_TEST_LOG_ASYNC_WRITE;
+
+    if (m_cmdLine.getOption<opt::LogBinaryFormat>())
+        m_logFlags |= QP_TEST_LOG_BINARY_FORMAT;
+
     if (!m_cmdLine.getOption<opt::LogEmptyLoginfo>())
         m_logFlags |= QP_TEST_LOG_EXCLUDE_EMPTY_LOGINFO;
 
+    if (!de::inRange(m_cmdLine.getOption<opt::LogImageCompressionLevel>(), -1, 9))
+    {
+        debugOut << "ERROR: --deqp-log-image-compression-level must be between -1 and 9!\n" << std::endl;
+        clear();
+        return false;
+    }
+
     if (m_cmdLine.getOption<opt::SubProcess>())
         m_logFlags |= QP_TEST_LOG_NO_INITIAL_OUTPUT;
 
@@ -1149,6 +1194,14 @@ uint32_t CommandLine::getLogFlags(void) const
 {
     return m_logFlags;
 }
+int CommandLine::getLogImageCompressionLevel(void) const
+{
+    return m_cmdLine.getOption<opt::LogImageCompressionLevel>();
+}
+qpPngFilter CommandLine::getLogImagePngFilter(void) const
+{
+    return m_cmdLine.getOption<opt::LogImagePngFilter>();
+}
 RunMode CommandLine::getRunMode(void) const
 {
     return m_cmdLine.getOption<opt::RunMode>();
@@ -1281,6 +1334,10 @@ tcu::TestRunnerType CommandLine::getRunnerType(void) const
 {
     return m_cmdLine.getOption<opt::RunnerType>();
 }
+PrecisionEvalMode CommandLine::getPrecisionEvalMode(void) const
+{
+    return m_cmdLine.getOption<opt::PrecisionEval>();
+}
 bool CommandLine::isTerminateOnFailEnabled(void) const
 {
     return m_cmdLine.getOption<opt::TerminateOnFail>();
@@ -27,6 +27,7 @@
 #include "deCommandLine.hpp"
 #include "tcuTestCase.hpp"
 #include "deUniquePtr.hpp"
+#include "qpTestLog.h"
 
 #include <string>
 #include <vector>
@@ -89,6 +90,18 @@ enum ScreenRotation
     SCREENROTATION_LAST
 };
 
+/*--------------------------------------------------------------------*//*!
+ * \brief How builtin precision tests compute reference intervals.
+ *//*--------------------------------------------------------------------*/
+enum PrecisionEvalMode
+{
+    PRECISIONEVALMODE_TREE = 0,   //!< Evaluate each input by walking the expression tree.
+    PRECISIONEVALMODE_COMPILED,   //!< Evaluate batches of inputs with statements compiled to operation lists.
+    PRECISIONEVALMODE_CROSSCHECK, //!< Evaluate both ways and fail if the reference intervals differ.
+
+    PRECISIONEVALMODE_LAST
+};
+
 class CaseTreeNode;
 class CasePaths;
 class Archive;
@@ -159,6 +172,12 @@ public:
     //! Get logging flags
     uint32_t getLogFlags(void) const;
 
+    //! Get zlib compression level of logged PNG images (--deqp-log-image-compression-level)
+    int getLogImageCompressionLevel(void) const;
+
+    //! Get row filter of logged PNG images (--deqp-log-image-png-filter)
+    qpPngFilter getLogImagePngFilter(void) const;
+
     //! Get run mode (--deqp-runmode)
     RunMode getRunMode(void) const;
 
@@ -256,7 +275,7 @@ public:
     //! Should the shader cache be truncated before run (--deqp-shadercache-truncate)
     bool isShaderCacheTruncateEnabled(void) const;
 
-    //! Should the shader cache use inter process communication (IPC) (--deqp-shadercache-ipc)
+    //! Is the shader cache file shared with other instances (--deqp-shadercache-ipc)
     bool isShaderCacheIPCEnabled(void) const;
 
     //! Get shader optimization recipe (--deqp-optimization-recipe)
@@ -283,6 +302,9 @@ public:
     //! Get runner type (--deqp-runner-type)
     tcu::TestRunnerType getRunnerType(void) const;
 
+    //! Get reference evaluation mode of builtin precision tests (--deqp-precision-eval)
+    PrecisionEvalMode getPrecisionEvalMode(void) const;
+
     //! Should the run be terminated on first failure (--deqp-terminate-on-fail)
     bool isTerminateOnFailEnabled(void) const;
 
@@ -24,8 +24,10 @@
 #include "tcuCompressedTexture.hpp"
 #include "tcuTextureUtil.hpp"
 #include "tcuAstcUtil.hpp"
+#include "tcuParallelFor.hpp"
 
 #include "deStringUtil.hpp"
+#include "deRandom.hpp"
 #include "deFloat16.h"
 
 #include <algorithm>
@@ -2549,6 +2551,11 @@ int componentSum(const IVec3 &vec)
     return vec.x() + vec.y() + vec.z();
 }
 
+enum
+{
+    DECOMPRESS_MIN_BLOCKS_PER_RANGE = 1024 //!< Minimum number of blocks decoded by one parallel work item.
+};
+
 } // namespace
 
 void decompress(const PixelBufferAccess &dst, CompressedTexFormat fmt, const uint8_t *src,
@@ -2560,16 +2567,24 @@ void decompress(const PixelBufferAccess &dst, CompressedTexFormat fmt, const uin
                            deDivRoundUp32(dst.getHeight(), blockPixelSize.y()),
                            deDivRoundUp32(dst.getDepth(), blockPixelSize.z()));
     const IVec3 blockPitches(blockSize, blockSize * blockCount.x(), blockSize * blockCount.x() * blockCount.y());
-
-    std::vector<uint8_t> uncompressedBlock(dst.getFormat().getPixelSize() * blockPixelSize.x() * blockPixelSize.y() *
-                                           blockPixelSize.z());
-    const PixelBufferAccess blockAccess(getUncompressedFormat(fmt), blockPixelSize.x(), blockPixelSize.y(),
-                                        blockPixelSize.z(), &uncompressedBlock[0]);
+    const int numBlockRows = blockCount.y() * blockCount.z();
+    const int rowsPerRange = de::max(1, DECOMPRESS_MIN_BLOCKS_PER_RANGE / de::max(1, blockCount.x()));
 
     DE_ASSERT(dst.getFormat() == getUncompressedFormat(fmt));
 
-    for (int blockZ = 0; blockZ < blockCount.z(); blockZ++)
-        for (int blockY = 0; blockY < blockCount.y(); blockY++)
+    // Rows of blocks are decoded independently, each range of rows uses its own temporary block
+    const auto decompressRows = [&](int begin, int end)
+    {
+        std::vector<uint8_t> uncompressedBlock(dst.getFormat().getPixelSize() * blockPixelSize.x() *
+                                               blockPixelSize.y() * blockPixelSize.z());
+        const PixelBufferAccess blockAccess(getUncompressedFormat(fmt), blockPixelSize.x(), blockPixelSize.y(),
+                                            blockPixelSize.z(), &uncompressedBlock[0]);
+
+        for (int rowNdx = begin; rowNdx < end; rowNdx++)
+        {
+            const int blockY = rowNdx % blockCount.y();
+            const int blockZ = rowNdx / blockCount.y();
+
             for (int blockX = 0; blockX < blockCount.x(); blockX++)
             {
                 const IVec3 blockPos(blockX, blockY, blockZ);
@@ -2581,10 +2596,14 @@ void decompress(const PixelBufferAccess &dst, CompressedTexFormat fmt, const uin
 
                 decompressBlock(fmt, blockAccess, blockPtr, params);
 
-                copy(getSubregion(dst, dstPixelPos.x(), dstPixelPos.y(), dstPixelPos.z(), copySize.x(), copySize.y(),
-                                  copySize.z()),
+                copy(getSubregion(dst, dstPixelPos.x(), dstPixelPos.y(), dstPixelPos.z(), copySize.x(),
+                                  copySize.y(), copySize.z()),
                      getSubregion(blockAccess, 0, 0, 0, copySize.x(), copySize.y(), copySize.z()));
             }
+        }
+    };
+
+    parallelFor(numBlockRows, rowsPerRange, decompressRows, params.numThreads);
 }
 
 CompressedTexture::CompressedTexture(void) : m_format(COMPRESSEDTEXFORMAT_LAST), m_width(0), m_height(0), m_depth(0)
@@ -2639,4 +2658,59 @@ void CompressedTexture::decompress(const PixelBufferAccess &dst, const TexDecomp
     tcu::decompress(dst, m_format, &m_data[0], params);
 }
 
+void CompressedTexture_selfTest(void)
+{
+    const CompressedTexFormat formats[] = {
+        COMPRESSEDTEXFORMAT_ETC2_RGB8,       COMPRESSEDTEXFORMAT_EAC_R11,
+        COMPRESSEDTEXFORMAT_EAC_SIGNED_RG11, COMPRESSEDTEXFORMAT_ETC2_RGB8_PUNCHTHROUGH_ALPHA1,
+        COMPRESSEDTEXFORMAT_ETC2_EAC_RGBA8,  COMPRESSEDTEXFORMAT_ASTC_4x4_RGBA,
+        COMPRESSEDTEXFORMAT_ASTC_6x5_RGBA,   COMPRESSEDTEXFORMAT_ASTC_12x12_RGBA,
+    };
+    const int numThreadsCases[] = {2, 7};
+
+    // Large enough for several ranges of rows with every block size
+    const int width  = 1021;
+    const int height = 301;
+
+    for (int formatNdx = 0; formatNdx < DE_LENGTH_OF_ARRAY(formats); formatNdx++)
+    {
+        const CompressedTexFormat format = formats[formatNdx];
+        const bool isAstc                = isAstcFormat(format);
+        const uint32_t seed              = deInt32Hash(formatNdx);
+        CompressedTexture compressed(format, width, height);
+        uint8_t *const data = (uint8_t *)compressed.getData();
+
+        if (isAstc)
+            astc::generateRandomValidBlocks(data, (size_t)compressed.getDataSize() / astc::BLOCK_SIZE_BYTES, format,
+                                            TexDecompressionParams::ASTCMODE_LDR, seed);
+        else
+        {
+            de::Random rnd(seed);
+
+            for (int ndx = 0; ndx < compressed.getDataSize(); ndx++)
+                data[ndx] = (uint8_t)rnd.getUint32();
+        }
+
+        for (int modeNdx = 0; modeNdx < (isAstc ? (int)TexDecompressionParams::ASTCMODE_LAST : 1); modeNdx++)
+        {
+            const TexDecompressionParams::AstcMode mode =
+                isAstc ? (TexDecompressionParams::AstcMode)modeNdx : TexDecompressionParams::ASTCMODE_LAST;
+            TextureLevel reference(getUncompressedFormat(format), width, height);
+
+            compressed.decompress(reference.getAccess(), TexDecompressionParams(mode, 1));
+
+            // Output must not depend on the number of threads
+            for (int threadCaseNdx = 0; threadCaseNdx < DE_LENGTH_OF_ARRAY(numThreadsCases); threadCaseNdx++)
+            {
+                TextureLevel result(getUncompressedFormat(format), width, height);
+
+                compressed.decompress(result.getAccess(), TexDecompressionParams(mode, numThreadsCases[threadCaseNdx]));
+
+                TCU_CHECK(deMemCmp(reference.getAccess().getDataPtr(), result.getAccess().getDataPtr(),
+                                   (size_t)(reference.getFormat().getPixelSize() * width * height)) == 0);
+            }
+        }
+    }
+}
+
 } // namespace tcu
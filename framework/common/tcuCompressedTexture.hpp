@@ -120,11 +120,14 @@ struct TexDecompressionParams
         ASTCMODE_LAST
     };
 
-    TexDecompressionParams(AstcMode astcMode_ = ASTCMODE_LAST) : astcMode(astcMode_)
+    TexDecompressionParams(AstcMode astcMode_ = ASTCMODE_LAST, int numThreads_ = 1)
+        : astcMode(astcMode_)
+        , numThreads(numThreads_)
     {
     }
 
     AstcMode astcMode;
+    int numThreads; //!< Threads used for decoding blocks of large textures, 0 = all cores. Output doesn't depend on it.
 };
 
 /*--------------------------------------------------------------------*//*!
@@ -185,6 +188,8 @@ private:
 void decompress(const PixelBufferAccess &dst, CompressedTexFormat fmt, const uint8_t *src,
                 const TexDecompressionParams &params = TexDecompressionParams());
 
+void CompressedTexture_selfTest(void);
+
 } // namespace tcu
 
 #endif // _TCUCOMPRESSEDTEXTURE_HPP
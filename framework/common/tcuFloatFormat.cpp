@@ -117,9 +117,13 @@ double FloatFormat::ulp(double x, double count) const
 
     {
         const double oneULP = deLdExp(1.0, exp - m_fractionBits);
+#if TCU_INTERVAL_ROUNDING_MODE_FREE
+        return mulDirected(oneULP, count, true);
+#else
         ScopedRoundingMode ctx(DE_ROUNDINGMODE_TO_POSITIVE_INF);
 
         return oneULP * count;
+#endif
     }
 }
 
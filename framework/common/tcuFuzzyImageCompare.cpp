@@ -24,21 +24,36 @@
 #include "tcuFuzzyImageCompare.hpp"
 #include "tcuTexture.hpp"
 #include "tcuTextureUtil.hpp"
+#include "tcuParallelFor.hpp"
 #include "deMath.h"
 #include "deRandom.hpp"
 
 #include <vector>
+#include <algorithm>
 
 namespace tcu
 {
 
 enum
 {
-    MIN_ERR_THRESHOLD = 4 // Magic to make small differences go away
+    MIN_ERR_THRESHOLD = 4, // Magic to make small differences go away
+    ROWS_PER_RANGE    = 8  //!< Rows processed by one parallelFor() range
 };
 
 using std::vector;
 
+//! Distance of one sampled pixel to the other image
+struct SampleDist
+{
+    SampleDist(int x_, int y_, uint32_t dist2_) : x(x_), y(y_), dist2(dist2_)
+    {
+    }
+
+    int x;
+    int y;
+    uint32_t dist2;
+};
+
 template <int Channel>
 static inline uint8_t getChannel(uint32_t color)
 {
@@ -160,7 +175,7 @@ inline uint32_t bilinearSample(const ConstPixelBufferAccess &src, float u, float
 
 template <int DstChannels, int SrcChannels>
 static void separableConvolve(const PixelBufferAccess &dst, const ConstPixelBufferAccess &src, int shiftX, int shiftY,
-                              const std::vector<float> &kernelX, const std::vector<float> &kernelY)
+                              const std::vector<float> &kernelX, const std::vector<float> &kernelY, int numThreads)
 {
     DE_ASSERT(dst.getWidth() == src.getWidth() && dst.getHeight() == src.getHeight());
 
@@ -172,47 +187,56 @@ static void separableConvolve(const PixelBufferAccess &dst, const ConstPixelBuff
 
     // Horizontal pass
     // \note Temporary surface is written in column-wise order
-    for (int j = 0; j < src.getHeight(); j++)
+    const auto convolveRowsX = [&](int rowBegin, int rowEnd)
     {
-        for (int i = 0; i < src.getWidth(); i++)
+        for (int j = rowBegin; j < rowEnd; j++)
         {
-            Vec4 sum(0);
-
-            for (int kx = 0; kx < kw; kx++)
+            for (int i = 0; i < src.getWidth(); i++)
             {
-                float f    = kernelX[kw - kx - 1];
-                uint32_t p = readUnorm8<SrcChannels>(src, de::clamp(i + kx - shiftX, 0, src.getWidth() - 1), j);
+                Vec4 sum(0);
 
-                sum += toFloatVec(p) * f;
-            }
+                for (int kx = 0; kx < kw; kx++)
+                {
+                    float f    = kernelX[kw - kx - 1];
+                    uint32_t p = readUnorm8<SrcChannels>(src, de::clamp(i + kx - shiftX, 0, src.getWidth() - 1), j);
+
+                    sum += toFloatVec(p) * f;
+                }
 
-            writeUnorm8<DstChannels>(tmpAccess, j, i, toColor(sum));
+                writeUnorm8<DstChannels>(tmpAccess, j, i, toColor(sum));
+            }
         }
-    }
+    };
 
     // Vertical pass
-    for (int j = 0; j < src.getHeight(); j++)
+    const auto convolveRowsY = [&](int rowBegin, int rowEnd)
     {
-        for (int i = 0; i < src.getWidth(); i++)
+        for (int j = rowBegin; j < rowEnd; j++)
         {
-            Vec4 sum(0.0f);
-
-            for (int ky = 0; ky < kh; ky++)
+            for (int i = 0; i < src.getWidth(); i++)
             {
-                float f    = kernelY[kh - ky - 1];
-                uint32_t p = readUnorm8<DstChannels>(tmpAccess, de::clamp(j + ky - shiftY, 0, tmp.getWidth() - 1), i);
+                Vec4 sum(0.0f);
 
-                sum += toFloatVec(p) * f;
-            }
+                for (int ky = 0; ky < kh; ky++)
+                {
+                    float f = kernelY[kh - ky - 1];
+                    uint32_t p =
+                        readUnorm8<DstChannels>(tmpAccess, de::clamp(j + ky - shiftY, 0, tmp.getWidth() - 1), i);
+
+                    sum += toFloatVec(p) * f;
+                }
 
-            writeUnorm8<DstChannels>(dst, i, j, toColor(sum));
+                writeUnorm8<DstChannels>(dst, i, j, toColor(sum));
+            }
         }
-    }
+    };
+
+    parallelFor(src.getHeight(), ROWS_PER_RANGE, convolveRowsX, numThreads);
+    parallelFor(src.getHeight(), ROWS_PER_RANGE, convolveRowsY, numThreads);
 }
 
 template <int NumChannels>
-static uint32_t distSquaredToNeighbor(de::Random &rnd, uint32_t pixel, const ConstPixelBufferAccess &surface, int x,
-                                      int y)
+static uint32_t distSquaredToNeighborPixels(uint32_t pixel, const ConstPixelBufferAccess &surface, int x, int y)
 {
     // (x, y) + (0, 0)
     uint32_t minDist = colorDistSquared(pixel, readUnorm8<NumChannels>(surface, x, y));
@@ -236,6 +260,18 @@ static uint32_t distSquaredToNeighbor(de::Random &rnd, uint32_t pixel, const Con
             return minDist;
     }
 
+    return minDist;
+}
+
+//! Refine minDist, the distance to the neighbouring pixels, with random samples. Consumes random numbers only if
+//! minDist is not zero.
+template <int NumChannels>
+static uint32_t distSquaredToRandomSamples(de::Random &rnd, uint32_t pixel, const ConstPixelBufferAccess &surface,
+                                           int x, int y, uint32_t minDist)
+{
+    if (minDist == 0)
+        return minDist;
+
     // Random bilinear-interpolated samples around (x, y)
     for (int s = 0; s < 32; s++)
     {
@@ -274,7 +310,6 @@ float fuzzyCompare(const FuzzyCompareParams &params, const ConstPixelBufferAcces
 
     int width  = ref.getWidth();
     int height = ref.getHeight();
-    de::Random rnd(667);
 
     // Filtered
     TextureLevel refFiltered(TextureFormat(TextureFormat::RGBA, TextureFormat::UNORM_INT8), width, height);
@@ -289,10 +324,10 @@ float fuzzyCompare(const FuzzyCompareParams &params, const ConstPixelBufferAcces
     switch (ref.getFormat().order)
     {
     case TextureFormat::RGBA:
-        separableConvolve<4, 4>(refFiltered, ref, shift, shift, kernel, kernel);
+        separableConvolve<4, 4>(refFiltered, ref, shift, shift, kernel, kernel, params.numThreads);
         break;
     case TextureFormat::RGB:
-        separableConvolve<4, 3>(refFiltered, ref, shift, shift, kernel, kernel);
+        separableConvolve<4, 3>(refFiltered, ref, shift, shift, kernel, kernel, params.numThreads);
         break;
     default:
         DE_ASSERT(false);
@@ -301,10 +336,10 @@ float fuzzyCompare(const FuzzyCompareParams &params, const ConstPixelBufferAcces
     switch (cmp.getFormat().order)
     {
     case TextureFormat::RGBA:
-        separableConvolve<4, 4>(cmpFiltered, cmp, shift, shift, kernel, kernel);
+        separableConvolve<4, 4>(cmpFiltered, cmp, shift, shift, kernel, kernel, params.numThreads);
         break;
     case TextureFormat::RGB:
-        separableConvolve<4, 3>(cmpFiltered, cmp, shift, shift, kernel, kernel);
+        separableConvolve<4, 3>(cmpFiltered, cmp, shift, shift, kernel, kernel, params.numThreads);
         break;
     default:
         DE_ASSERT(false);
@@ -320,35 +355,94 @@ float fuzzyCompare(const FuzzyCompareParams &params, const ConstPixelBufferAcces
     ConstPixelBufferAccess refAccess = refFiltered.getAccess();
     ConstPixelBufferAccess cmpAccess = cmpFiltered.getAccess();
 
-    for (int y = 1; y < height - 1; y++)
+    // Pixels compared are rows and columns [1, size-1)
+    const int numRows = de::max(height - 2, 0);
+    vector<SampleDist> samples;
+
+    // Distances to the pixel and its neighbours don't use random numbers. With more than one thread they are
+    // computed for all pixels of a block of rows in parallel, as the sampled pixels aren't known yet. Sample
+    // skipping and the random samples for pixels without a neighbour match consume a single random sequence in
+    // pixel order and are walked on one thread. Samples are stored in pixel order.
     {
-        for (int x = 1; x<width - 1; x += params.maxSampleSkip> 0 ? (int)rnd.getInt(1, params.maxSampleSkip) : 1)
+        const int numThreads = params.numThreads > 0 ? params.numThreads : getDefaultParallelForNumThreads();
+        const int blockRows  = numThreads > 1 ? de::min(numThreads * ROWS_PER_RANGE, numRows) : 0;
+        vector<uint32_t> blockDists((size_t)blockRows * width * 2);
+        int blockBegin = 1;
+        de::Random rnd(667);
+
+        // blockDists[2 * (row * width + x)] is from ref to cmp and [... + 1] from cmp to ref.
+        const auto computeNeighborDists = [&](int rowBegin, int rowEnd)
+        {
+            for (int row = rowBegin; row < rowEnd; row++)
+            {
+                const int y = blockBegin + row;
+
+                for (int x = 1; x < width - 1; x++)
+                {
+                    uint32_t *dst = &blockDists[2 * ((size_t)row * width + x)];
+
+                    dst[0] = distSquaredToNeighborPixels<4>(readUnorm8<4>(refAccess, x, y), cmpAccess, x, y);
+                    dst[1] = distSquaredToNeighborPixels<4>(readUnorm8<4>(cmpAccess, x, y), refAccess, x, y);
+                }
+            }
+        };
+
+        for (int y = 1; y < height - 1; y++)
         {
-            const uint32_t minDist2RefToCmp =
-                distSquaredToNeighbor<4>(rnd, readUnorm8<4>(refAccess, x, y), cmpAccess, x, y);
-            const uint32_t minDist2CmpToRef =
-                distSquaredToNeighbor<4>(rnd, readUnorm8<4>(cmpAccess, x, y), refAccess, x, y);
-            const uint32_t minDist2 = de::min(minDist2RefToCmp, minDist2CmpToRef);
-            const uint64_t newSum4  = distSum4 + minDist2 * minDist2;
-
-            distSum4 = (newSum4 >= distSum4) ? newSum4 : ~0ull; // In case of overflow
-            distMax2 = de::max(distMax2, minDist2);
-            numSamples += 1;
-
-            // Build error image.
+            if (blockRows > 0 && (y - 1) % blockRows == 0)
             {
-                const int scale  = 255 - MIN_ERR_THRESHOLD;
-                const float err2 = float(minDist2) / float(scale * scale);
-                const float err4 = err2 * err2;
-                const float red  = err4 * 500.0f;
-                const float luma = toGrayscale(cmp.getPixel(x, y));
-                const float rF   = 0.7f + 0.3f * luma;
-
-                errorMask.setPixel(Vec4(red * rF, (1.0f - red) * rF, 0.0f, 1.0f), x, y);
+                blockBegin = y;
+                parallelFor(de::min(blockRows, height - 1 - y), ROWS_PER_RANGE, computeNeighborDists, numThreads);
+            }
+
+            for (int x = 1; x<width - 1; x += params.maxSampleSkip> 0 ? (int)rnd.getInt(1, params.maxSampleSkip) : 1)
+            {
+                const uint32_t refPixel = readUnorm8<4>(refAccess, x, y);
+                const uint32_t cmpPixel = readUnorm8<4>(cmpAccess, x, y);
+                const uint32_t *dists   =
+                    blockRows > 0 ? &blockDists[2 * ((size_t)(y - blockBegin) * width + x)] : DE_NULL;
+                const uint32_t neighborDist2RefToCmp =
+                    dists ? dists[0] : distSquaredToNeighborPixels<4>(refPixel, cmpAccess, x, y);
+                const uint32_t minDist2RefToCmp =
+                    distSquaredToRandomSamples<4>(rnd, refPixel, cmpAccess, x, y, neighborDist2RefToCmp);
+                const uint32_t neighborDist2CmpToRef =
+                    dists ? dists[1] : distSquaredToNeighborPixels<4>(cmpPixel, refAccess, x, y);
+                const uint32_t minDist2CmpToRef =
+                    distSquaredToRandomSamples<4>(rnd, cmpPixel, refAccess, x, y, neighborDist2CmpToRef);
+                const uint32_t minDist2 = de::min(minDist2RefToCmp, minDist2CmpToRef);
+                const uint64_t newSum4  = distSum4 + minDist2 * minDist2;
+
+                distSum4 = (newSum4 >= distSum4) ? newSum4 : ~0ull; // In case of overflow
+                distMax2 = de::max(distMax2, minDist2);
+                numSamples += 1;
+
+                samples.push_back(SampleDist(x, y, minDist2));
             }
         }
     }
 
+    // Build error image.
+    const auto buildErrorMaskRows = [&](int rowBegin, int rowEnd)
+    {
+        const auto isAboveRow = [](const SampleDist &sample, int y) { return sample.y < y; };
+
+        for (vector<SampleDist>::const_iterator sample =
+                 std::lower_bound(samples.begin(), samples.end(), rowBegin + 1, isAboveRow);
+             sample != samples.end() && sample->y < rowEnd + 1; ++sample)
+        {
+            const int scale  = 255 - MIN_ERR_THRESHOLD;
+            const float err2 = float(sample->dist2) / float(scale * scale);
+            const float err4 = err2 * err2;
+            const float red  = err4 * 500.0f;
+            const float luma = toGrayscale(cmp.getPixel(sample->x, sample->y));
+            const float rF   = 0.7f + 0.3f * luma;
+
+            errorMask.setPixel(Vec4(red * rF, (1.0f - red) * rF, 0.0f, 1.0f), sample->x, sample->y);
+        }
+    };
+
+    parallelFor(numRows, ROWS_PER_RANGE, buildErrorMaskRows, params.numThreads);
+
     if (params.returnMaxError)
     {
         return sqrtf(float(distMax2)) / 255.0f;
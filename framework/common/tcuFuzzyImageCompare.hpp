@@ -36,11 +36,13 @@ struct FuzzyCompareParams
     FuzzyCompareParams(int maxSampleSkip_ = 8, bool returnMaxError_ = false)
         : maxSampleSkip(maxSampleSkip_)
         , returnMaxError(returnMaxError_)
+        , numThreads(1)
     {
     }
 
     int maxSampleSkip;
     bool returnMaxError;
+    int numThreads; //!< Threads used for filtering and neighbour distances, 0 = all cores. Result doesn't depend on it.
 };
 
 float fuzzyCompare(const FuzzyCompareParams &params, const ConstPixelBufferAccess &ref,
@@ -22,16 +22,56 @@
  *//*--------------------------------------------------------------------*/
 
 #include "tcuInterval.hpp"
+#include "deRandom.hpp"
 
 #include "deMath.h"
+#include "deMemory.h"
 
 #include <cmath>
+#include <sstream>
 
 namespace tcu
 {
 
 using std::ldexp;
 
+double addDirectedFenv(double a, double b, bool upward)
+{
+    DE_FENV_ACCESS_ON
+    const ScopedRoundingMode ctx(upward ? DE_ROUNDINGMODE_TO_POSITIVE_INF : DE_ROUNDINGMODE_TO_NEGATIVE_INF);
+
+    return a + b;
+}
+
+double mulDirectedFenv(double a, double b, bool upward)
+{
+    DE_FENV_ACCESS_ON
+    const ScopedRoundingMode ctx(upward ? DE_ROUNDINGMODE_TO_POSITIVE_INF : DE_ROUNDINGMODE_TO_NEGATIVE_INF);
+
+    return a * b;
+}
+
+double divDirectedFenv(double a, double b, bool upward)
+{
+    DE_FENV_ACCESS_ON
+    const ScopedRoundingMode ctx(upward ? DE_ROUNDINGMODE_TO_POSITIVE_INF : DE_ROUNDINGMODE_TO_NEGATIVE_INF);
+
+    return a / b;
+}
+
+#if TCU_INTERVAL_ROUNDING_MODE_FREE
+//! Smallest interval containing the exact result of op(a, b).
+static Interval directedBounds(double (*op)(double, double, bool), double a, double b)
+{
+    return Interval(op(a, b, false)) | Interval(op(a, b, true));
+}
+
+static double subDirected(double a, double b, bool upward)
+{
+    return addDirected(a, -b, upward);
+}
+#endif
+
 Interval applyMonotone(DoubleFunc1 &func, const Interval &arg0)
 {
     Interval ret;
@@ -64,7 +104,13 @@ Interval operator+(const Interval &x, const Interval &y)
     Interval ret;
 
     if (!x.empty() && !y.empty())
+    {
+#if TCU_INTERVAL_ROUNDING_MODE_FREE
+        ret = Interval(addDirected(x.lo(), y.lo(), false)) | Interval(addDirected(x.hi(), y.hi(), true));
+#else
         TCU_SET_INTERVAL_BOUNDS(ret, p, p = x.lo() + y.lo(), p = x.hi() + y.hi());
+#endif
+    }
     if (x.hasNaN() || y.hasNaN())
         ret |= TCU_NAN;
 
@@ -75,7 +121,11 @@ Interval operator-(const Interval &x, const Interval &y)
 {
     Interval ret;
 
+#if TCU_INTERVAL_ROUNDING_MODE_FREE
+    TCU_INTERVAL_APPLY_MONOTONE2(ret, xp, x, yp, y, val, val = directedBounds(subDirected, xp, yp));
+#else
     TCU_INTERVAL_APPLY_MONOTONE2(ret, xp, x, yp, y, val, TCU_SET_INTERVAL(val, point, point = xp - yp));
+#endif
     return ret;
 }
 
@@ -83,7 +133,11 @@ Interval operator*(const Interval &x, const Interval &y)
 {
     Interval ret;
 
+#if TCU_INTERVAL_ROUNDING_MODE_FREE
+    TCU_INTERVAL_APPLY_MONOTONE2(ret, xp, x, yp, y, val, val = directedBounds(mulDirected, xp, yp));
+#else
     TCU_INTERVAL_APPLY_MONOTONE2(ret, xp, x, yp, y, val, TCU_SET_INTERVAL(val, point, point = xp * yp));
+#endif
     return ret;
 }
 
@@ -99,7 +153,11 @@ Interval operator/(const Interval &nom, const Interval &den)
     {
         Interval ret;
 
+#if TCU_INTERVAL_ROUNDING_MODE_FREE
+        TCU_INTERVAL_APPLY_MONOTONE2(ret, nomp, nom, denp, den, val, val = directedBounds(divDirected, nomp, denp));
+#else
         TCU_INTERVAL_APPLY_MONOTONE2(ret, nomp, nom, denp, den, val, TCU_SET_INTERVAL(val, point, point = nomp / denp));
+#endif
         return ret;
     }
 }
@@ -156,4 +214,98 @@ std::ostream &operator<<(std::ostream &os, const Interval &interval)
     return os;
 }
 
+namespace
+{
+
+typedef double (*DirectedOp)(double, double, bool);
+
+double randomDouble(de::Random &rnd)
+{
+    static const double specials[] = {0.0,
+                                      -0.0,
+                                      1.0,
+                                      std::numeric_limits<double>::denorm_min(),
+                                      std::numeric_limits<double>::min(),
+                                      std::numeric_limits<double>::max(),
+                                      std::numeric_limits<double>::infinity(),
+                                      std::numeric_limits<double>::quiet_NaN()};
+    const int kind = rnd.getInt(0, 9);
+
+    if (kind == 0)
+        return (rnd.getBool() ? -1.0 : 1.0) * specials[rnd.getInt(0, DE_LENGTH_OF_ARRAY(specials) - 1)];
+    else if (kind <= 3)
+    {
+        // Any bit pattern, including subnormals and large exponent differences.
+        const uint64_t bits = rnd.getUint64();
+        double value;
+
+        deMemcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+    else
+    {
+        // Nearby exponents, so that sums and differences are often inexact or cancel.
+        const double mantissa = (double)(rnd.getUint64() >> 11);
+
+        return (rnd.getBool() ? -1.0 : 1.0) * deLdExp(mantissa, rnd.getInt(-60, 10));
+    }
+}
+
+void checkDirectedOp(const char *name, DirectedOp errorFree, DirectedOp fenv, double a, double b, bool upward)
+{
+    const double result   = errorFree(a, b, upward);
+    const double expected = fenv(a, b, upward);
+
+    if (result == expected || (std::isnan(result) && std::isnan(expected)))
+        return;
+
+    // Rounding error is not representable near underflow; rounding outwards by one more ulp is allowed.
+    if (std::abs(expected) < detail::MIN_EXACT_ERROR_MAGNITUDE && result == detail::nextOutward(expected, upward))
+        return;
+
+    {
+        std::ostringstream msg;
+
+        msg << std::hexfloat << name << "(" << a << ", " << b << ", " << (upward ? "up" : "down") << ") returned "
+            << result << ", expected " << expected;
+        TCU_FAIL(msg.str().c_str());
+    }
+}
+
+} // namespace
+
+void Interval_selfTest(void)
+{
+    de::Random rnd(0x1a2b3c);
+
+    for (int ndx = 0; ndx < 100000; ndx++)
+    {
+        const double a    = randomDouble(rnd);
+        const double b    = randomDouble(rnd);
+        const bool upward = rnd.getBool();
+
+        checkDirectedOp("addDirected", addDirectedErrorFree, addDirectedFenv, a, b, upward);
+        checkDirectedOp("mulDirected", mulDirectedErrorFree, mulDirectedFenv, a, b, upward);
+        checkDirectedOp("divDirected", divDirectedErrorFree, divDirectedFenv, a, b, upward);
+    }
+
+    // Exact results are not widened.
+    TCU_CHECK(addDirectedErrorFree(1.0, 0x1p-52, false) == 1.0 + 0x1p-52);
+    TCU_CHECK(mulDirectedErrorFree(3.0, 0x1p-900, true) == 3.0 * 0x1p-900);
+    TCU_CHECK(divDirectedErrorFree(1.0, 4.0, true) == 0.25);
+
+    // Inexact results bracket the exact value.
+    TCU_CHECK(addDirectedErrorFree(1.0, 0x1p-60, false) == 1.0);
+    TCU_CHECK(addDirectedErrorFree(1.0, 0x1p-60, true) == 1.0 + 0x1p-52);
+    TCU_CHECK(divDirectedErrorFree(1.0, 3.0, false) < divDirectedErrorFree(1.0, 3.0, true));
+    TCU_CHECK(mulDirectedErrorFree(0x1p1000, 0x1p1000, false) == std::numeric_limits<double>::max());
+
+    {
+        const Interval widened = widenByUlp(Interval(1.0, 2.0));
+
+        TCU_CHECK(widened.lo() == 1.0 - 0x1p-53 && widened.hi() == 2.0 + 0x1p-51);
+        TCU_CHECK(widenByUlp(Interval()).empty());
+    }
+}
+
 } // namespace tcu
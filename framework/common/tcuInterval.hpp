@@ -34,6 +34,14 @@
 #define TCU_INFINITY (::std::numeric_limits<float>::infinity())
 #define TCU_NAN (::std::numeric_limits<float>::quiet_NaN())
 
+// Interval bounds are rounded outwards. By default this is done by switching the FPU rounding mode while
+// computing each bound. If TCU_INTERVAL_ROUNDING_MODE_FREE is 1, bounds are computed in round-to-nearest
+// mode and rounded outwards afterwards. Interval +, -, * and / then give the same bounds as with rounding
+// modes, and other bodies of TCU_SET_INTERVAL* are widened by one ulp of double.
+#if !defined(TCU_INTERVAL_ROUNDING_MODE_FREE)
+#define TCU_INTERVAL_ROUNDING_MODE_FREE 0
+#endif
+
 namespace tcu
 {
 
@@ -258,6 +266,135 @@ inline Interval operator+(const Interval &x)
 {
     return x;
 }
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Sum, product and quotient with directed rounding
+ *
+ * The result is rounded towards positive infinity if upward is true and
+ * towards negative infinity otherwise. The Fenv variants switch the FPU
+ * rounding mode. The ErrorFree variants compute the rounding error of the
+ * round-to-nearest result exactly with TwoSum and FMA, and must be called
+ * in round-to-nearest mode. Both give the same result, except that the
+ * ErrorFree variants may round outwards by one more ulp when the error is
+ * not representable due to underflow.
+ *//*--------------------------------------------------------------------*/
+double addDirectedFenv(double a, double b, bool upward);
+double mulDirectedFenv(double a, double b, bool upward);
+double divDirectedFenv(double a, double b, bool upward);
+
+namespace detail
+{
+
+// Products and quotients at least this large have a representable rounding error.
+constexpr double MIN_EXACT_ERROR_MAGNITUDE = 0x1p-968;
+
+inline double nextOutward(double x, bool upward)
+{
+    return std::nextafter(x, upward ? (double)TCU_INFINITY : -(double)TCU_INFINITY);
+}
+
+//! Round `nearest` in the given direction, given the exact error (exact result - nearest) of rounding to nearest.
+inline double roundDirected(double nearest, double error, bool upward)
+{
+    if (!std::isfinite(error))
+        return nextOutward(nearest, upward);
+    else if (upward ? error > 0.0 : error < 0.0)
+        return nextOutward(nearest, upward);
+    else
+        return nearest;
+}
+
+} // namespace detail
+
+inline double addDirectedErrorFree(double a, double b, bool upward)
+{
+    const double sum = a + b;
+
+    // Infinite operands give exact results, infinite sum of finite operands is overflow.
+    if (!std::isfinite(sum))
+        return std::isfinite(a) && std::isfinite(b) ? detail::nextOutward(sum, upward) : sum;
+
+    {
+        const double bVirtual = sum - a;
+        const double aVirtual = sum - bVirtual;
+        const double error    = (a - aVirtual) + (b - bVirtual);
+
+        return detail::roundDirected(sum, error, upward);
+    }
+}
+
+inline double mulDirectedErrorFree(double a, double b, bool upward)
+{
+    const double product = a * b;
+
+    if (!std::isfinite(product))
+        return std::isfinite(a) && std::isfinite(b) ? detail::nextOutward(product, upward) : product;
+
+    if (std::abs(product) < detail::MIN_EXACT_ERROR_MAGNITUDE)
+        return (a == 0.0 || b == 0.0) ? product : detail::nextOutward(product, upward);
+
+    return detail::roundDirected(product, std::fma(a, b, -product), upward);
+}
+
+inline double divDirectedErrorFree(double a, double b, bool upward)
+{
+    const double quotient = a / b;
+
+    // Division by zero and infinite dividend give exact results.
+    if (!std::isfinite(quotient))
+        return std::isfinite(a) && b != 0.0 ? detail::nextOutward(quotient, upward) : quotient;
+
+    if (std::abs(quotient) < detail::MIN_EXACT_ERROR_MAGNITUDE)
+        return (a == 0.0 || std::isinf(b)) ? quotient : detail::nextOutward(quotient, upward);
+
+    {
+        // The exact quotient is quotient + remainder / b. Tiny operands are scaled so that the remainder
+        // does not underflow; this is exact since then |b| < 1.
+        const double scale     = std::abs(a) < detail::MIN_EXACT_ERROR_MAGNITUDE ? 0x1p600 : 1.0;
+        const double remainder = std::fma(-quotient, b * scale, a * scale);
+
+        return detail::roundDirected(quotient, b < 0.0 ? -remainder : remainder, upward);
+    }
+}
+
+//! Directed rounding with the implementation selected by TCU_INTERVAL_ROUNDING_MODE_FREE.
+inline double addDirected(double a, double b, bool upward)
+{
+#if TCU_INTERVAL_ROUNDING_MODE_FREE
+    return addDirectedErrorFree(a, b, upward);
+#else
+    return addDirectedFenv(a, b, upward);
+#endif
+}
+
+inline double mulDirected(double a, double b, bool upward)
+{
+#if TCU_INTERVAL_ROUNDING_MODE_FREE
+    return mulDirectedErrorFree(a, b, upward);
+#else
+    return mulDirectedFenv(a, b, upward);
+#endif
+}
+
+inline double divDirected(double a, double b, bool upward)
+{
+#if TCU_INTERVAL_ROUNDING_MODE_FREE
+    return divDirectedErrorFree(a, b, upward);
+#else
+    return divDirectedFenv(a, b, upward);
+#endif
+}
+
+//! Interval with both bounds moved outwards to the next double. Warning bounds are unchanged.
+inline Interval widenByUlp(const Interval &x)
+{
+    if (x.empty())
+        return x;
+
+    return Interval(x.hasNaN(), detail::nextOutward(x.lo(), false), detail::nextOutward(x.hi(), true), x.warningLo(),
+                    x.warningHi());
+}
+
 Interval exp2(const Interval &x);
 Interval exp(const Interval &x);
 int sign(const Interval &x);
@@ -288,6 +425,44 @@ inline Interval &operator/=(Interval &x, const Interval &y)
 
 std::ostream &operator<<(std::ostream &os, const Interval &interval);
 
+#if TCU_INTERVAL_ROUNDING_MODE_FREE
+
+#define TCU_SET_INTERVAL_BOUNDS(DST, VAR, SETLOW, SETHIGH)     \
+    do                                                         \
+    {                                                          \
+        ::tcu::Interval &VAR##_dst_ = (DST);                   \
+        ::tcu::Interval VAR##_lo_;                             \
+        ::tcu::Interval VAR##_hi_;                             \
+                                                               \
+        {                                                      \
+            ::tcu::Interval &VAR = VAR##_lo_;                  \
+            SETLOW;                                            \
+        }                                                      \
+        {                                                      \
+            ::tcu::Interval &VAR = VAR##_hi_;                  \
+            SETHIGH;                                           \
+        }                                                      \
+                                                               \
+        VAR##_dst_ = ::tcu::widenByUlp(VAR##_lo_ | VAR##_hi_); \
+    } while (false)
+
+// Both bounds come from the same round-to-nearest value, so BODY is evaluated only once.
+#define TCU_SET_INTERVAL(DST, VAR, BODY)            \
+    do                                              \
+    {                                               \
+        ::tcu::Interval &VAR##_dst_ = (DST);        \
+        ::tcu::Interval VAR##_val_;                 \
+                                                    \
+        {                                           \
+            ::tcu::Interval &VAR = VAR##_val_;      \
+            BODY;                                   \
+        }                                           \
+                                                    \
+        VAR##_dst_ = ::tcu::widenByUlp(VAR##_val_); \
+    } while (false)
+
+#else
+
 #define TCU_SET_INTERVAL_BOUNDS(DST, VAR, SETLOW, SETHIGH)        \
     do                                                            \
     {                                                             \
@@ -313,6 +488,8 @@ std::ostream &operator<<(std::ostream &os, const Interval &interval);
 
 #define TCU_SET_INTERVAL(DST, VAR, BODY) TCU_SET_INTERVAL_BOUNDS(DST, VAR, BODY, BODY)
 
+#endif // TCU_INTERVAL_ROUNDING_MODE_FREE
+
 //! Set the interval DST to the image of BODY on ARG, assuming that BODY on
 //! ARG is a monotone function. In practice, BODY is evaluated on both the
 //! upper and lower bound of ARG, and DST is set to the union of these
@@ -363,6 +540,8 @@ Interval applyMonotone(DoubleFunc2 &func, const Interval &arg0, const Interval &
 Interval applyMonotone(DoubleIntervalFunc1 &func, const Interval &arg0);
 Interval applyMonotone(DoubleIntervalFunc2 &func, const Interval &arg0, const Interval &arg1);
 
+void Interval_selfTest(void);
+
 } // namespace tcu
 
 #endif // _TCUINTERVAL_HPP
@@ -0,0 +1,251 @@
+/*-------------------------------------------------------------------------
+ * drawElements Quality Program Tester Core
+ * ----------------------------------------
+ *
+ * Copyright (c) 2026 The Khronos Group Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *//*!
+ * \file
+ * \brief Parallel for over index ranges.
+ *//*--------------------------------------------------------------------*/
+
+#include "tcuParallelFor.hpp"
+#include "deAtomic.h"
+#include "deMutex.hpp"
+#include "deThread.hpp"
+#include "deSharedPtr.hpp"
+#include "deStringUtil.hpp"
+
+#include <exception>
+
+namespace tcu
+{
+namespace detail
+{
+namespace
+{
+
+//! Ranges shared by all threads of one parallelFor() call.
+class RangeQueue
+{
+public:
+    RangeQueue(int numItems, int grainSize, const ParallelForTask &task)
+        : m_numItems(numItems)
+        , m_grainSize(grainSize)
+        , m_numRanges((numItems + grainSize - 1) / grainSize)
+        , m_task(task)
+        , m_nextRange(0)
+        , m_errorRange(-1)
+    {
+    }
+
+    void process(void)
+    {
+        for (;;)
+        {
+            const int rangeNdx = (int)deAtomicIncrement32(&m_nextRange) - 1;
+
+            // Ranges below a failed range still run so that the exception from the lowest range is kept.
+            if (rangeNdx >= m_numRanges || isAfterError(rangeNdx))
+                break;
+
+            try
+            {
+                const int begin = rangeNdx * m_grainSize;
+                const int end   = de::min(begin + m_grainSize, m_numItems);
+
+                m_task.run(rangeNdx, begin, end);
+            }
+            catch (...)
+            {
+                const de::ScopedLock lock(m_errorLock);
+
+                if (m_errorRange < 0 || rangeNdx < m_errorRange)
+                {
+                    m_error      = std::current_exception();
+                    m_errorRange = rangeNdx;
+                }
+            }
+        }
+    }
+
+    bool isAfterError(int rangeNdx)
+    {
+        const de::ScopedLock lock(m_errorLock);
+        return m_errorRange >= 0 && rangeNdx > m_errorRange;
+    }
+
+    void rethrowError(void) const
+    {
+        if (m_error)
+            std::rethrow_exception(m_error);
+    }
+
+private:
+    const int m_numItems;
+    const int m_grainSize;
+    const int m_numRanges;
+    const ParallelForTask &m_task;
+
+    volatile int32_t m_nextRange;
+
+    de::Mutex m_errorLock;
+    int m_errorRange; //!< Protected by m_errorLock.
+    std::exception_ptr m_error;
+};
+
+class RangeThread : public de::Thread
+{
+public:
+    RangeThread(RangeQueue &queue) : m_queue(queue)
+    {
+    }
+
+    void run(void)
+    {
+        m_queue.process();
+    }
+
+private:
+    RangeQueue &m_queue;
+};
+
+} // namespace
+
+void executeParallelFor(int numItems, int grainSize, int numThreads, const ParallelForTask &task)
+{
+    DE_ASSERT(grainSize > 0);
+
+    if (numItems <= 0)
+        return;
+
+    const int numRanges = (numItems + grainSize - 1) / grainSize;
+    RangeQueue queue(numItems, grainSize, task);
+    std::vector<de::SharedPtr<RangeThread>> threads;
+
+    if (numThreads <= 0)
+        numThreads = getDefaultParallelForNumThreads();
+
+    numThreads = de::min(numThreads, numRanges);
+    threads.reserve((size_t)numThreads);
+
+    // Calling thread processes ranges as well. If a thread can't be created, remaining ranges are
+    // processed by the threads that are already running.
+    for (int threadNdx = 1; threadNdx < numThreads; threadNdx++)
+    {
+        try
+        {
+            const de::SharedPtr<RangeThread> thread(new RangeThread(queue));
+
+            thread->start();
+            threads.push_back(thread);
+        }
+        catch (const std::exception &)
+        {
+            break;
+        }
+    }
+
+    queue.process();
+
+    for (size_t threadNdx = 0; threadNdx < threads.size(); threadNdx++)
+        threads[threadNdx]->join();
+
+    queue.rethrowError();
+}
+
+} // namespace detail
+
+int getDefaultParallelForNumThreads(void)
+{
+    return de::max(1, (int)deGetNumAvailableLogicalCores());
+}
+
+void ParallelFor_selfTest(void)
+{
+    const int numThreadsCases[] = {1, 2, 3, 8, 0};
+
+    for (int threadCaseNdx = 0; threadCaseNdx < DE_LENGTH_OF_ARRAY(numThreadsCases); threadCaseNdx++)
+    {
+        const int numThreads = numThreadsCases[threadCaseNdx];
+
+        // Each item is visited exactly once
+        for (int numItems = 0; numItems < 70; numItems += 3)
+        {
+            for (int grainSize = 1; grainSize < 10; grainSize += 4)
+            {
+                std::vector<int> visitCount((size_t)numItems, 0);
+                const auto visit = [&](int begin, int end)
+                {
+                    TCU_CHECK(0 <= begin && begin < end && end <= numItems);
+                    TCU_CHECK(end - begin <= grainSize);
+
+                    for (int ndx = begin; ndx < end; ndx++)
+                        visitCount[ndx] += 1;
+                };
+
+                parallelFor(numItems, grainSize, visit, numThreads);
+
+                for (int ndx = 0; ndx < numItems; ndx++)
+                    TCU_CHECK(visitCount[ndx] == 1);
+            }
+        }
+
+        // Sum
+        {
+            const auto countOdd = [](int begin, int end)
+            {
+                int numOdd = 0;
+
+                for (int ndx = begin; ndx < end; ndx++)
+                    numOdd += ndx % 2;
+
+                return numOdd;
+            };
+
+            TCU_CHECK(parallelSum(0, 4, countOdd, numThreads) == 0);
+            TCU_CHECK(parallelSum(1001, 7, countOdd, numThreads) == 500);
+        }
+
+        // Exception from the lowest failing range is rethrown and ranges below it are processed
+        {
+            volatile int32_t numVisitedBelow10 = 0;
+            const auto throwFrom10             = [&](int begin, int end)
+            {
+                for (int ndx = begin; ndx < end; ndx++)
+                {
+                    if (ndx >= 10)
+                        throw TestError(de::toString(ndx));
+
+                    deAtomicIncrementInt32(&numVisitedBelow10);
+                }
+            };
+
+            try
+            {
+                parallelFor(100, 1, throwFrom10, numThreads);
+                TCU_FAIL("Expected exception");
+            }
+            catch (const TestError &e)
+            {
+                TCU_CHECK(std::string(e.getMessage()) == "10");
+            }
+
+            TCU_CHECK(numVisitedBelow10 == 10);
+        }
+    }
+}
+
+} // namespace tcu
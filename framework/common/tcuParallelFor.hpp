@@ -0,0 +1,133 @@
+#ifndef _TCUPARALLELFOR_HPP
+#define _TCUPARALLELFOR_HPP
+/*-------------------------------------------------------------------------
+ * drawElements Quality Program Tester Core
+ * ----------------------------------------
+ *
+ * Copyright (c) 2026 The Khronos Group Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *//*!
+ * \file
+ * \brief Parallel for over index ranges.
+ *//*--------------------------------------------------------------------*/
+
+#include "tcuDefs.hpp"
+
+#include <vector>
+
+namespace tcu
+{
+namespace detail
+{
+
+class ParallelForTask
+{
+public:
+    virtual ~ParallelForTask(void)
+    {
+    }
+
+    //! Process items [begin, end) of range rangeNdx. Called concurrently for different ranges.
+    virtual void run(int rangeNdx, int begin, int end) const = 0;
+};
+
+void executeParallelFor(int numItems, int grainSize, int numThreads, const ParallelForTask &task);
+
+template <typename Func>
+class ParallelForFunc : public ParallelForTask
+{
+public:
+    ParallelForFunc(const Func &func) : m_func(func)
+    {
+    }
+
+    void run(int rangeNdx, int begin, int end) const
+    {
+        DE_UNREF(rangeNdx);
+        m_func(begin, end);
+    }
+
+private:
+    const Func &m_func;
+};
+
+template <typename Func>
+class ParallelSumFunc : public ParallelForTask
+{
+public:
+    ParallelSumFunc(const Func &func, std::vector<int> &rangeSums) : m_func(func), m_rangeSums(rangeSums)
+    {
+    }
+
+    void run(int rangeNdx, int begin, int end) const
+    {
+        m_rangeSums[rangeNdx] = m_func(begin, end);
+    }
+
+private:
+    const Func &m_func;
+    std::vector<int> &m_rangeSums;
+};
+
+} // namespace detail
+
+//! Number of threads used by parallelFor() when numThreads is not given.
+int getDefaultParallelForNumThreads(void);
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Call func(begin, end) for consecutive ranges covering [0, numItems)
+ *
+ * Items are split into ranges of grainSize items; range boundaries depend
+ * only on numItems and grainSize. Ranges are processed by up to numThreads
+ * threads, including the calling thread, and func must be safe to call
+ * concurrently for different ranges. If numThreads is 0 the number of
+ * available cores is used.
+ *
+ * Returns after all ranges have been processed. If func throws, ranges
+ * above the failed range that have not started yet are skipped and the
+ * exception thrown by the lowest range is rethrown on the calling thread.
+ *//*--------------------------------------------------------------------*/
+template <typename Func>
+void parallelFor(int numItems, int grainSize, const Func &func, int numThreads = 0)
+{
+    detail::executeParallelFor(numItems, grainSize, numThreads, detail::ParallelForFunc<Func>(func));
+}
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Sum of func(begin, end) over ranges covering [0, numItems)
+ *
+ * Same as parallelFor() but func returns a count, for example the number
+ * of failed pixels in the range. The result does not depend on the number
+ * of threads.
+ *//*--------------------------------------------------------------------*/
+template <typename Func>
+int parallelSum(int numItems, int grainSize, const Func &func, int numThreads = 0)
+{
+    std::vector<int> rangeSums(numItems > 0 ? (size_t)((numItems + grainSize - 1) / grainSize) : 0, 0);
+    int sum = 0;
+
+    detail::executeParallelFor(numItems, grainSize, numThreads, detail::ParallelSumFunc<Func>(func, rangeSums));
+
+    for (size_t rangeNdx = 0; rangeNdx < rangeSums.size(); rangeNdx++)
+        sum += rangeSums[rangeNdx];
+
+    return sum;
+}
+
+void ParallelFor_selfTest(void);
+
+} // namespace tcu
+
+#endif // _TCUPARALLELFOR_HPP
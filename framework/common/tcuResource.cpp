@@ -22,8 +22,10 @@
  *//*--------------------------------------------------------------------*/
 
 #include "tcuResource.hpp"
+#include "deMemory.h"
 
 #include <stdio.h>
+#include <limits>
 
 namespace tcu
 {
@@ -44,6 +46,11 @@ Resource *DirArchive::getResource(const char *name) const
     return static_cast<Resource *>(new FileResource((m_path + name).c_str()));
 }
 
+Resource *DirArchive::getMappedResource(const char *name) const
+{
+    return static_cast<Resource *>(new MappedFileResource((m_path + name).c_str()));
+}
+
 FileResource::FileResource(const char *filename) : Resource(std::string(filename))
 {
     m_file = fopen(filename, "rb");
@@ -81,6 +88,79 @@ void FileResource::setPosition(int position)
     fseek(m_file, (size_t)position, SEEK_SET);
 }
 
+void Resource::readAt(int64_t offset, uint8_t *dst, int numBytes)
+{
+    TCU_CHECK_INTERNAL(de::inRange<int64_t>(offset, 0, std::numeric_limits<int>::max()));
+
+    setPosition((int)offset);
+    read(dst, numBytes);
+}
+
+MappedFileResource::MappedFileResource(const char *filename)
+    : Resource(std::string(filename))
+    , m_file(DE_NULL)
+    , m_mapping(DE_NULL)
+    , m_size(0)
+    , m_position(0)
+{
+    m_file = deFile_create(filename, DE_FILEMODE_OPEN | DE_FILEMODE_READ);
+    if (!m_file)
+        throw ResourceError("Failed to open file", filename, __FILE__, __LINE__);
+
+    m_size    = deFile_getSize(m_file);
+    m_mapping = (const uint8_t *)deFile_map(m_file, m_size, false);
+}
+
+MappedFileResource::~MappedFileResource(void)
+{
+    deFile_unmap((void *)m_mapping, m_size);
+    deFile_destroy(m_file);
+}
+
+void MappedFileResource::read(uint8_t *dst, int numBytes)
+{
+    TCU_CHECK(numBytes >= 0 && numBytes <= m_size - m_position);
+
+    if (m_mapping)
+        deMemcpy(dst, m_mapping + m_position, numBytes);
+    else
+    {
+        int64_t numRead = 0;
+
+        TCU_CHECK(deFile_seek(m_file, DE_FILEPOSITION_BEGIN, m_position) &&
+                  deFile_read(m_file, dst, numBytes, &numRead) == DE_FILERESULT_SUCCESS && numRead == numBytes);
+    }
+
+    m_position += numBytes;
+}
+
+void MappedFileResource::readAt(int64_t offset, uint8_t *dst, int numBytes)
+{
+    TCU_CHECK(de::inRange<int64_t>(offset, 0, m_size));
+
+    m_position = offset;
+    read(dst, numBytes);
+}
+
+int MappedFileResource::getSize(void) const
+{
+    TCU_CHECK_INTERNAL(m_size <= std::numeric_limits<int>::max());
+
+    return (int)m_size;
+}
+
+int MappedFileResource::getPosition(void) const
+{
+    TCU_CHECK_INTERNAL(m_position <= std::numeric_limits<int>::max());
+
+    return (int)m_position;
+}
+
+void MappedFileResource::setPosition(int position)
+{
+    m_position = de::clamp<int64_t>(position, 0, m_size);
+}
+
 ResourcePrefix::ResourcePrefix(const Archive &archive, const char *prefix) : m_archive(archive), m_prefix(prefix)
 {
 }
@@ -90,4 +170,9 @@ Resource *ResourcePrefix::getResource(const char *name) const
     return m_archive.getResource((m_prefix + name).c_str());
 }
 
+Resource *ResourcePrefix::getMappedResource(const char *name) const
+{
+    return m_archive.getMappedResource((m_prefix + name).c_str());
+}
+
 } // namespace tcu
@@ -24,6 +24,7 @@
  *//*--------------------------------------------------------------------*/
 
 #include "tcuDefs.hpp"
+#include "deFile.h"
 
 #include <string>
 
@@ -54,6 +55,21 @@ public:
     virtual int getPosition(void) const           = 0;
     virtual void setPosition(int position)        = 0;
 
+    //! Pointer to whole resource contents if resource is mapped into memory, null otherwise.
+    virtual const uint8_t *getMappedData(void) const
+    {
+        return DE_NULL;
+    }
+
+    //! Size in bytes. Unlike getSize(), not limited to 2GB.
+    virtual int64_t getSize64(void) const
+    {
+        return getSize();
+    }
+
+    //! Read numBytes starting at offset. Unlike setPosition(), offset is not limited to 2GB.
+    virtual void readAt(int64_t offset, uint8_t *dst, int numBytes);
+
     const std::string &getName(void) const
     {
         return m_name;
@@ -90,6 +106,21 @@ public:
      *//*--------------------------------------------------------------------*/
     virtual Resource *getResource(const char *name) const = 0;
 
+    /*--------------------------------------------------------------------*//*!
+     * \brief Open resource for read-only mapped access
+     *
+     * Archives that support it return a resource whose contents are
+     * accessible through Resource::getMappedData(). Otherwise a normal
+     * resource is returned, and getMappedData() returns null.
+     *
+     * \param name Resource path
+     * \return Resource object
+     *//*--------------------------------------------------------------------*/
+    virtual Resource *getMappedResource(const char *name) const
+    {
+        return getResource(name);
+    }
+
 protected:
     Archive()
     {
@@ -106,6 +137,7 @@ public:
     ~DirArchive(void);
 
     Resource *getResource(const char *name) const;
+    Resource *getMappedResource(const char *name) const;
 
     // \note Assignment and copy allowed
     DirArchive(const DirArchive &other) : Archive(), m_path(other.m_path)
@@ -139,6 +171,45 @@ private:
     FILE *m_file;
 };
 
+/*--------------------------------------------------------------------*//*!
+ * \brief File resource mapped into memory
+ *
+ * If the file can't be mapped, data is read from the file instead and
+ * getMappedData() returns null.
+ *//*--------------------------------------------------------------------*/
+class MappedFileResource : public Resource
+{
+public:
+    MappedFileResource(const char *filename);
+    ~MappedFileResource(void);
+
+    void read(uint8_t *dst, int numBytes);
+    int getSize(void) const;
+    int getPosition(void) const;
+    void setPosition(int position);
+
+    const uint8_t *getMappedData(void) const
+    {
+        return m_mapping;
+    }
+
+    int64_t getSize64(void) const
+    {
+        return m_size;
+    }
+
+    void readAt(int64_t offset, uint8_t *dst, int numBytes);
+
+private:
+    MappedFileResource(const MappedFileResource &other);
+    MappedFileResource &operator=(const MappedFileResource &other);
+
+    deFile *m_file;
+    const uint8_t *m_mapping;
+    int64_t m_size;
+    int64_t m_position;
+};
+
 class ResourcePrefix : public Archive
 {
 public:
@@ -148,6 +219,7 @@ public:
     }
 
     virtual Resource *getResource(const char *name) const;
+    virtual Resource *getMappedResource(const char *name) const;
 
 private:
     const Archive &m_archive;
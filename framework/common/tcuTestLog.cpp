@@ -565,6 +565,21 @@ void TestLog::terminateCase(qpTestResult result)
         throw LogWriteFailedError();
 }
 
+void TestLog::flush(void)
+{
+    qpTestLog_flush(m_log);
+}
+
+void TestLog::flushAfterCrash(void)
+{
+    qpTestLog_flushAfterCrash(m_log);
+}
+
+void TestLog::setImageCompressionOptions(int pngCompressionLevel, qpPngFilter pngFilter)
+{
+    qpTestLog_setImageCompressionOptions(m_log, pngCompressionLevel, pngFilter);
+}
+
 void TestLog::startTestsCasesTime(void)
 {
     if (m_logSupressed)
@@ -185,6 +185,10 @@ public:
     void startCase(const char *testCasePath, qpTestCaseType testCaseType);
     void endCase(qpTestResult result, const char *description);
     void terminateCase(qpTestResult result);
+    void flush(void);
+    void flushAfterCrash(void);
+
+    void setImageCompressionOptions(int pngCompressionLevel, qpPngFilter pngFilter);
 
     void startTestsCasesTime(void);
     void endTestsCasesTime(void);
@@ -491,6 +491,54 @@ public:
     void setPixStencil(int stencil, int x, int y, int z = 0) const;
 } DE_WARN_UNUSED_TYPE;
 
+/*--------------------------------------------------------------------*//*!
+ * \brief Pixel row format converter
+ *
+ * Converts runs of pixels between two color formats. Unpack and pack
+ * kernels specialized for the channel types are selected once at
+ * construction, and pixels are converted in chunks through an
+ * intermediate buffer one channel at a time.
+ *
+ * The result is bit-exact with converting each pixel with getPixel() and
+ * setPixel(), or with getPixelInt() and setPixel() if both formats are
+ * integer formats. Only formats with one 8, 16 or 32-bit value per channel
+ * are supported; isSupported() returns false for packed, 24 and 64-bit
+ * types and for depth and stencil formats.
+ *//*--------------------------------------------------------------------*/
+class PixelRowConverter
+{
+public:
+    PixelRowConverter(const TextureFormat &dstFormat, const TextureFormat &srcFormat);
+
+    bool isSupported(void) const
+    {
+        return m_isSupported;
+    }
+
+    //! Convert numPixels pixels. Pitches are in bytes and may be negative.
+    void convert(void *dst, int dstPixelPitch, const void *src, int srcPixelPitch, int numPixels) const;
+
+    typedef void (*UnpackFloatFunc)(Vec4 *dst, const uint8_t *src, int srcPixelPitch, int numPixels,
+                                    const int *channelOffsets);
+    typedef void (*PackFloatFunc)(uint8_t *dst, int dstPixelPitch, const Vec4 *src, int numPixels,
+                                  const int *channelMap, int numChannels);
+    typedef void (*UnpackIntFunc)(IVec4 *dst, const uint8_t *src, int srcPixelPitch, int numPixels,
+                                  const int *channelOffsets);
+    typedef void (*PackIntFunc)(uint8_t *dst, int dstPixelPitch, const IVec4 *src, int numPixels,
+                                const int *channelMap, int numChannels);
+
+private:
+    bool m_isSupported;
+    bool m_isInteger;
+    UnpackFloatFunc m_unpackFloat;
+    PackFloatFunc m_packFloat;
+    UnpackIntFunc m_unpackInt;
+    PackIntFunc m_packInt;
+    int m_srcChannelOffsets[4]; //!< Byte offset of each source channel, or negative for constant zero or one.
+    int m_dstChannelMap[4];     //!< Intermediate component written to each destination channel.
+    int m_dstNumChannels;
+};
+
 /*--------------------------------------------------------------------*//*!
  * \brief Generic pixel data container
  *
@@ -747,6 +795,59 @@ inline Vec4 Texture2DView::gatherOffsetsCompare(const Sampler &sampler, float re
     return gatherArray2DOffsetsCompare(m_levels[0], sampler, ref, s, t, 0, offsets);
 }
 
+/*--------------------------------------------------------------------*//*!
+ * \brief 2D texture view and sampler prepared for repeated sampling
+ *
+ * Resolves the texel fetch function for the view format, the per-level
+ * filters and the border color once at construction instead of on every
+ * lookup. sample() returns exactly the same values as
+ * Texture2DView::sample() with the same sampler.
+ *
+ * Views with image view min lod parameters and combined depth-stencil
+ * formats are not specialized; sample() forwards them to the view. The
+ * object is not modified after construction and can be used from several
+ * threads at once. The view levels must outlive the object.
+ *//*--------------------------------------------------------------------*/
+class PreparedSampler2D
+{
+public:
+    PreparedSampler2D(void);
+    PreparedSampler2D(const Texture2DView &view, const Sampler &sampler);
+
+    const Texture2DView &getView(void) const
+    {
+        return m_view;
+    }
+    const Sampler &getSampler(void) const
+    {
+        return m_sampler;
+    }
+
+    Vec4 sample(float s, float t, float lod) const;
+
+private:
+    typedef Vec4 (*LevelSampleFunc)(const ConstPixelBufferAccess &level, const Sampler &sampler, const Vec4 &border,
+                                    float s, float t);
+
+    enum MipmapMode
+    {
+        MIPMAPMODE_NONE = 0,
+        MIPMAPMODE_NEAREST,
+        MIPMAPMODE_LINEAR
+    };
+
+    Texture2DView m_view;
+    Sampler m_sampler;
+    Vec4 m_border;
+    float m_magnifyThreshold;
+    bool m_magBlendLevels; //!< Magnified lookups blend levels 0 and 1 with zero weight, as sampleLevelArray2D() does
+    MipmapMode m_minMipmapMode;
+    LevelSampleFunc m_magSample; //!< Null if view is not specialized
+    LevelSampleFunc m_minSample;
+} DE_WARN_UNUSED_TYPE;
+
+void PreparedSampler2D_selfTest(void);
+
 /*--------------------------------------------------------------------*//*!
  * \brief Base class for textures that have single mip-map pyramid
  *//*--------------------------------------------------------------------*/
@@ -1320,6 +1320,7 @@ void copy(const PixelBufferAccess &dst, const ConstPixelBufferAccess &src, const
         (dst.getFormat().order == tcu::TextureFormat::DS || dst.getFormat().order == tcu::TextureFormat::D);
     const bool dstHasStencil =
         (dst.getFormat().order == tcu::TextureFormat::DS || dst.getFormat().order == tcu::TextureFormat::S);
+    const PixelRowConverter rowConverter(dst.getFormat(), src.getFormat());
 
     if (src.getFormat() == dst.getFormat() && srcTightlyPacked && dstTightlyPacked)
     {
@@ -1367,6 +1368,14 @@ void copy(const PixelBufferAccess &dst, const ConstPixelBufferAccess &src, const
             tcu::clearStencil(dst, 0u);
         }
     }
+    else if (rowConverter.isSupported())
+    {
+        // Format-specialized conversion one row at a time.
+        for (int z = 0; z < depth; z++)
+            for (int y = 0; y < height; y++)
+                rowConverter.convert(dst.getPixelPtr(0, y, z), dstPixelPitch, src.getPixelPtr(0, y, z),
+                                     srcPixelPitch, width);
+    }
     else
     {
         TextureChannelClass srcClass = getTextureChannelClass(src.getFormat().type);
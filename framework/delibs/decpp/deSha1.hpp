@@ -52,6 +52,11 @@ public:
         return !(*this == other);
     }
 
+    const deSha1 &getHash(void) const
+    {
+        return m_hash;
+    }
+
 private:
     deSha1 m_hash;
 };
@@ -32,6 +32,8 @@
 #include <fcntl.h>
 #include <unistd.h>
 #include <errno.h>
+#include <sys/mman.h>
+#include <stdio.h>
 
 struct deFile_s
 {
@@ -50,6 +52,11 @@ bool deDeleteFile(const char *filename)
     return unlink(filename) == 0;
 }
 
+bool deRenameFile(const char *srcFilename, const char *dstFilename)
+{
+    return rename(srcFilename, dstFilename) == 0;
+}
+
 deFile *deFile_createFromHandle(uintptr_t handle)
 {
     int fd       = (int)handle;
@@ -80,10 +87,11 @@ static int mapOpenMode(deFileMode mode)
     /* Require write and open when using truncate */
     DE_ASSERT(!(mode & DE_FILEMODE_TRUNCATE) || ((mode & DE_FILEMODE_WRITE) && (mode & DE_FILEMODE_OPEN)));
 
-    if (mode & DE_FILEMODE_READ)
+    if ((mode & DE_FILEMODE_READ) && (mode & DE_FILEMODE_WRITE))
+        flag |= O_RDWR;
+    else if (mode & DE_FILEMODE_READ)
         flag |= O_RDONLY;
-
-    if (mode & DE_FILEMODE_WRITE)
+    else if (mode & DE_FILEMODE_WRITE)
         flag |= O_WRONLY;
 
     if (mode & DE_FILEMODE_TRUNCATE)
@@ -178,6 +186,11 @@ int64_t deFile_getSize(const deFile *file)
     return size;
 }
 
+bool deFile_setSize(deFile *file, int64_t size)
+{
+    return ftruncate(file->fd, (off_t)size) == 0;
+}
+
 static deFileResult mapReadWriteResult(int64_t numBytes)
 {
     if (numBytes > 0)
@@ -208,6 +221,54 @@ deFileResult deFile_write(deFile *file, const void *buf, int64_t bufSize, int64_
     return mapReadWriteResult(numWritten);
 }
 
+static bool setFileLock(deFile *file, short type)
+{
+    struct flock lock;
+
+    deMemset(&lock, 0, sizeof(lock));
+    lock.l_type   = type;
+    lock.l_whence = SEEK_SET;
+    lock.l_start  = 0;
+    lock.l_len    = 0; /* Whole file */
+
+    for (;;)
+    {
+        if (fcntl(file->fd, F_SETLKW, &lock) == 0)
+            return true;
+        else if (errno != EINTR)
+            return false;
+    }
+}
+
+bool deFile_lock(deFile *file)
+{
+    return setFileLock(file, F_WRLCK);
+}
+
+void deFile_unlock(deFile *file)
+{
+    setFileLock(file, F_UNLCK);
+}
+
+void *deFile_map(deFile *file, int64_t size, bool writable)
+{
+    const int prot = writable ? (PROT_READ | PROT_WRITE) : PROT_READ;
+    void *ptr      = NULL;
+
+    if (size <= 0)
+        return NULL;
+
+    ptr = mmap(NULL, (size_t)size, prot, MAP_SHARED, file->fd, 0);
+
+    return ptr != MAP_FAILED ? ptr : NULL;
+}
+
+void deFile_unmap(void *ptr, int64_t size)
+{
+    if (ptr)
+        munmap(ptr, (size_t)size);
+}
+
 #elif (DE_OS == DE_OS_WIN32)
 
 #define VC_EXTRALEAN
@@ -229,6 +290,11 @@ bool deDeleteFile(const char *filename)
     return DeleteFile(filename) == TRUE;
 }
 
+bool deRenameFile(const char *srcFilename, const char *dstFilename)
+{
+    return MoveFileEx(srcFilename, dstFilename, MOVEFILE_REPLACE_EXISTING) == TRUE;
+}
+
 deFile *deFile_createFromHandle(uintptr_t handle)
 {
     deFile *file = (deFile *)deCalloc(sizeof(deFile));
@@ -356,6 +422,20 @@ int64_t deFile_getSize(const deFile *file)
     return (int64_t)(((uint64_t)highBits << 32) | (uint64_t)lowBits);
 }
 
+bool deFile_setSize(deFile *file, int64_t size)
+{
+    LONG curHighBits = 0;
+    LONG curLowBits  = SetFilePointer(file->handle, 0, &curHighBits, FILE_CURRENT);
+    bool result      = false;
+
+    if (deFile_seek(file, DE_FILEPOSITION_BEGIN, size))
+        result = SetEndOfFile(file->handle) == TRUE;
+
+    SetFilePointer(file->handle, curLowBits, &curHighBits, FILE_BEGIN);
+
+    return result;
+}
+
 static deFileResult mapReadWriteResult(BOOL retVal, DWORD numBytes)
 {
     if (retVal && numBytes > 0)
@@ -407,6 +487,62 @@ deFileResult deFile_write(deFile *file, const void *buf, int64_t bufSize, int64_
     return mapReadWriteResult(result, numWritten32);
 }
 
+/* Lock a byte far past the end of any file, so that the lock doesn't block reads and writes. */
+static void getLockRange(OVERLAPPED *overlapped)
+{
+    deMemset(overlapped, 0, sizeof(OVERLAPPED));
+    overlapped->Offset     = 0xFFFFFFFFu;
+    overlapped->OffsetHigh = 0x7FFFFFFFu;
+}
+
+bool deFile_lock(deFile *file)
+{
+    OVERLAPPED overlapped;
+
+    getLockRange(&overlapped);
+
+    return LockFileEx(file->handle, LOCKFILE_EXCLUSIVE_LOCK, 0, 1, 0, &overlapped) == TRUE;
+}
+
+void deFile_unlock(deFile *file)
+{
+    OVERLAPPED overlapped;
+
+    getLockRange(&overlapped);
+    UnlockFileEx(file->handle, 0, 1, 0, &overlapped);
+}
+
+void *deFile_map(deFile *file, int64_t size, bool writable)
+{
+    const DWORD protect = writable ? PAGE_READWRITE : PAGE_READONLY;
+    const DWORD access  = writable ? (FILE_MAP_READ | FILE_MAP_WRITE) : FILE_MAP_READ;
+    HANDLE mapping      = NULL;
+    void *ptr           = NULL;
+
+    if (size <= 0)
+        return NULL;
+
+    mapping = CreateFileMapping(file->handle, NULL, protect, (DWORD)((uint64_t)size >> 32),
+                                (DWORD)((uint64_t)size & 0xFFFFFFFFull), NULL);
+    if (!mapping)
+        return NULL;
+
+    ptr = MapViewOfFile(mapping, access, 0, 0, (SIZE_T)size);
+
+    /* View keeps the mapping object alive. */
+    CloseHandle(mapping);
+
+    return ptr;
+}
+
+void deFile_unmap(void *ptr, int64_t size)
+{
+    DE_UNREF(size);
+
+    if (ptr)
+        UnmapViewOfFile(ptr);
+}
+
 #else
 #error Implement deFile for your OS.
 #endif
@@ -68,6 +68,8 @@ typedef enum deFilePosition_e
 
 bool deFileExists(const char *filename);
 bool deDeleteFile(const char *filename);
+/* Renames file, replacing existing file at dstFilename. */
+bool deRenameFile(const char *srcFilename, const char *dstFilename);
 
 deFile *deFile_create(const char *filename, uint32_t mode);
 deFile *deFile_createFromHandle(uintptr_t handle);
@@ -79,9 +81,22 @@ int64_t deFile_getPosition(const deFile *file);
 bool deFile_seek(deFile *file, deFilePosition base, int64_t offset);
 int64_t deFile_getSize(const deFile *file);
 
+bool deFile_setSize(deFile *file, int64_t size);
+
 deFileResult deFile_read(deFile *file, void *buf, int64_t bufSize, int64_t *numRead);
 deFileResult deFile_write(deFile *file, const void *buf, int64_t bufSize, int64_t *numWritten);
 
+/* Advisory lock for coordinating processes that share a file. Blocks until
+ * the lock is acquired. The lock doesn't prevent reading or writing the file. */
+bool deFile_lock(deFile *file);
+void deFile_unlock(deFile *file);
+
+/* Memory mapping. Maps the first size bytes of the file. Writable mappings
+ * are shared with other processes mapping the same file and require the
+ * file to be opened with both read and write access. */
+void *deFile_map(deFile *file, int64_t size, bool writable);
+void deFile_unmap(void *ptr, int64_t size);
+
 DE_END_EXTERN_C
 
 #endif /* _DEFILE_H */
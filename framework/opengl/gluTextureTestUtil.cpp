@@ -27,6 +27,7 @@
 
 #include "tcuFloat.hpp"
 #include "tcuImageCompare.hpp"
+#include "tcuParallelFor.hpp"
 #include "tcuTestLog.hpp"
 #include "tcuVectorUtil.hpp"
 
@@ -45,7 +46,8 @@ namespace TextureTestUtil
 
 enum
 {
-    MIN_SUBPIXEL_BITS = 4
+    MIN_SUBPIXEL_BITS     = 4,
+    VERIFY_ROWS_PER_RANGE = 4 //!< Rows verified by one parallelSum() range
 };
 
 SamplerType getSamplerType(tcu::TextureFormat format)
@@ -376,6 +378,15 @@ static inline tcu::Vec4 execSample(const tcu::Texture2DView &src, const Referenc
         return src.sample(params.sampler, s, t, lod);
 }
 
+static inline tcu::Vec4 execSample(const tcu::PreparedSampler2D &src, const ReferenceParams &params, float s, float t,
+                                   float lod)
+{
+    if (params.samplerType == SAMPLERTYPE_SHADOW)
+        return tcu::Vec4(src.getView().sampleCompare(params.sampler, params.ref, s, t, lod), 0.0, 0.0, 1.0f);
+    else
+        return src.sample(s, t, lod);
+}
+
 static inline tcu::Vec4 execSample(const tcu::TextureCubeView &src, const ReferenceParams &params, float s, float t,
                                    float r, float lod)
 {
@@ -457,6 +468,7 @@ static void sampleTextureNonProjected(const PixelAccess &dst, const tcu::Texture
     // Separate combined DS formats
     std::vector<tcu::ConstPixelBufferAccess> srcLevelStorage;
     tcu::Texture2DView src = getEffectiveTextureView(rawSrc, srcLevelStorage, params.sampler);
+    const tcu::PreparedSampler2D preparedSrc(src, params.sampler);
 
     float lodBias = (params.flags & ReferenceParams::USE_BIAS) ? params.bias : 0.0f;
 
@@ -496,7 +508,7 @@ static void sampleTextureNonProjected(const PixelAccess &dst, const tcu::Texture
                 t = tcu::Float16(t, tcu::ROUND_TO_ZERO).asFloat();
             }
 
-            dst.setPixel(execSample(src, params, s, t, lod) * params.colorScale + params.colorBias, x, y);
+            dst.setPixel(execSample(preparedSrc, params, s, t, lod) * params.colorScale + params.colorBias, x, y);
         }
     }
 }
@@ -550,6 +562,7 @@ static void sampleTextureProjected(const PixelAccess &dst, const tcu::Texture2DV
     // Separate combined DS formats
     std::vector<tcu::ConstPixelBufferAccess> srcLevelStorage;
     const tcu::Texture2DView src = getEffectiveTextureView(rawSrc, srcLevelStorage, params.sampler);
+    const tcu::PreparedSampler2D preparedSrc(src, params.sampler);
 
     float lodBias = (params.flags & ReferenceParams::USE_BIAS) ? params.bias : 0.0f;
     float dstW    = (float)dst.getWidth();
@@ -585,7 +598,7 @@ static void sampleTextureProjected(const PixelAccess &dst, const tcu::Texture2DV
                                                (float)dst.getWidth(), (float)dst.getHeight()) +
                         lodBias;
 
-            dst.setPixel(execSample(src, params, s, t, lod) * params.colorScale + params.colorBias, px, py);
+            dst.setPixel(execSample(preparedSrc, params, s, t, lod) * params.colorScale + params.colorBias, px, py);
         }
     }
 }
@@ -1443,6 +1456,10 @@ void computeQuadTexCoordCubeArray(std::vector<float> &dst, tcu::CubeFace face, c
 }
 
 // Texture result verification
+//
+// Pixels are verified independently, so rows are split into ranges that are verified
+// in parallel. Error mask writes don't overlap and failure counts are summed per range,
+// so results don't depend on the number of threads.
 
 //! Verifies texture lookup results and returns number of failed pixels.
 int computeTextureLookupDiff(const tcu::ConstPixelBufferAccess &result, const tcu::ConstPixelBufferAccess &reference,
@@ -1472,8 +1489,6 @@ int computeTextureLookupDiff(const tcu::ConstPixelBufferAccess &result, const tc
 
     const tcu::Vec2 lodBias((sampleParams.flags & ReferenceParams::USE_BIAS) ? sampleParams.bias : 0.0f);
 
-    int numFailed = 0;
-
     const tcu::Vec2 lodOffsets[] = {
         tcu::Vec2(-1, 0),
         tcu::Vec2(+1, 0),
@@ -1483,68 +1498,78 @@ int computeTextureLookupDiff(const tcu::ConstPixelBufferAccess &result, const tc
 
     tcu::clear(errorMask, tcu::RGBA::green().toVec());
 
-    for (int py = 0; py < result.getHeight(); py++)
+    const auto verifyRows = [&](int rowBegin, int rowEnd)
     {
-        // Ugly hack, validation can take way too long at the moment.
-        if (watchDog)
-            qpWatchDog_touch(watchDog);
+        int numFailed = 0;
 
-        for (int px = 0; px < result.getWidth(); px++)
+        for (int py = rowBegin; py < rowEnd; py++)
         {
-            const tcu::Vec4 resPix = (result.getPixel(px, py) - sampleParams.colorBias) / sampleParams.colorScale;
-            const tcu::Vec4 refPix = (reference.getPixel(px, py) - sampleParams.colorBias) / sampleParams.colorScale;
+            // Ugly hack, validation can take way too long at the moment.
+            if (watchDog)
+                qpWatchDog_touch(watchDog);
 
-            // Try comparison to ideal reference first, and if that fails use slower verificator.
-            if (!tcu::boolAll(tcu::lessThanEqual(tcu::abs(resPix - refPix), lookupPrec.colorThreshold)))
+            for (int px = 0; px < result.getWidth(); px++)
             {
-                const float wx = (float)px + 0.5f;
-                const float wy = (float)py + 0.5f;
-                const float nx = wx / dstW;
-                const float ny = wy / dstH;
+                const tcu::Vec4 resPix = (result.getPixel(px, py) - sampleParams.colorBias) / sampleParams.colorScale;
+                const tcu::Vec4 refPix =
+                    (reference.getPixel(px, py) - sampleParams.colorBias) / sampleParams.colorScale;
 
-                const int triNdx  = nx + ny >= 1.0f ? 1 : 0;
-                const float triWx = triNdx ? dstW - wx : wx;
-                const float triWy = triNdx ? dstH - wy : wy;
-                const float triNx = triNdx ? 1.0f - nx : nx;
-                const float triNy = triNdx ? 1.0f - ny : ny;
+                // Try comparison to ideal reference first, and if that fails use slower verificator.
+                if (!tcu::boolAll(tcu::lessThanEqual(tcu::abs(resPix - refPix), lookupPrec.colorThreshold)))
+                {
+                    const float wx = (float)px + 0.5f;
+                    const float wy = (float)py + 0.5f;
+                    const float nx = wx / dstW;
+                    const float ny = wy / dstH;
 
-                const float coord   = projectedTriInterpolate(triS[triNdx], triW[triNdx], triNx, triNy);
-                const float coordDx = triDerivateX(triS[triNdx], triW[triNdx], wx, dstW, triNy) * float(srcSize);
-                const float coordDy = triDerivateY(triS[triNdx], triW[triNdx], wy, dstH, triNx) * float(srcSize);
+                    const int triNdx  = nx + ny >= 1.0f ? 1 : 0;
+                    const float triWx = triNdx ? dstW - wx : wx;
+                    const float triWy = triNdx ? dstH - wy : wy;
+                    const float triNx = triNdx ? 1.0f - nx : nx;
+                    const float triNy = triNdx ? 1.0f - ny : ny;
 
-                tcu::Vec2 lodBounds = tcu::computeLodBoundsFromDerivates(coordDx, coordDy, lodPrec);
+                    const float coord   = projectedTriInterpolate(triS[triNdx], triW[triNdx], triNx, triNy);
+                    const float coordDx = triDerivateX(triS[triNdx], triW[triNdx], wx, dstW, triNy) * float(srcSize);
+                    const float coordDy = triDerivateY(triS[triNdx], triW[triNdx], wy, dstH, triNx) * float(srcSize);
 
-                // Compute lod bounds across lodOffsets range.
-                for (int lodOffsNdx = 0; lodOffsNdx < DE_LENGTH_OF_ARRAY(lodOffsets); lodOffsNdx++)
-                {
-                    const float wxo = triWx + lodOffsets[lodOffsNdx].x();
-                    const float wyo = triWy + lodOffsets[lodOffsNdx].y();
-                    const float nxo = wxo / dstW;
-                    const float nyo = wyo / dstH;
+                    tcu::Vec2 lodBounds = tcu::computeLodBoundsFromDerivates(coordDx, coordDy, lodPrec);
 
-                    const float coordDxo = triDerivateX(triS[triNdx], triW[triNdx], wxo, dstW, nyo) * float(srcSize);
-                    const float coordDyo = triDerivateY(triS[triNdx], triW[triNdx], wyo, dstH, nxo) * float(srcSize);
-                    const tcu::Vec2 lodO = tcu::computeLodBoundsFromDerivates(coordDxo, coordDyo, lodPrec);
+                    // Compute lod bounds across lodOffsets range.
+                    for (int lodOffsNdx = 0; lodOffsNdx < DE_LENGTH_OF_ARRAY(lodOffsets); lodOffsNdx++)
+                    {
+                        const float wxo = triWx + lodOffsets[lodOffsNdx].x();
+                        const float wyo = triWy + lodOffsets[lodOffsNdx].y();
+                        const float nxo = wxo / dstW;
+                        const float nyo = wyo / dstH;
 
-                    lodBounds.x() = de::min(lodBounds.x(), lodO.x());
-                    lodBounds.y() = de::max(lodBounds.y(), lodO.y());
-                }
+                        const float coordDxo =
+                            triDerivateX(triS[triNdx], triW[triNdx], wxo, dstW, nyo) * float(srcSize);
+                        const float coordDyo =
+                            triDerivateY(triS[triNdx], triW[triNdx], wyo, dstH, nxo) * float(srcSize);
+                        const tcu::Vec2 lodO = tcu::computeLodBoundsFromDerivates(coordDxo, coordDyo, lodPrec);
 
-                const tcu::Vec2 clampedLod = tcu::clampLodBounds(
-                    lodBounds + lodBias, tcu::Vec2(sampleParams.minLod, sampleParams.maxLod), lodPrec);
-                const bool isOk =
-                    tcu::isLookupResultValid(src, sampleParams.sampler, lookupPrec, coord, clampedLod, resPix);
+                        lodBounds.x() = de::min(lodBounds.x(), lodO.x());
+                        lodBounds.y() = de::max(lodBounds.y(), lodO.y());
+                    }
 
-                if (!isOk)
-                {
-                    errorMask.setPixel(tcu::RGBA::red().toVec(), px, py);
-                    numFailed += 1;
+                    const tcu::Vec2 clampedLod = tcu::clampLodBounds(
+                        lodBounds + lodBias, tcu::Vec2(sampleParams.minLod, sampleParams.maxLod), lodPrec);
+                    const bool isOk =
+                        tcu::isLookupResultValid(src, sampleParams.sampler, lookupPrec, coord, clampedLod, resPix);
+
+                    if (!isOk)
+                    {
+                        errorMask.setPixel(tcu::RGBA::red().toVec(), px, py);
+                        numFailed += 1;
+                    }
                 }
             }
         }
-    }
 
-    return numFailed;
+        return numFailed;
+    };
+
+    return tcu::parallelSum(result.getHeight(), VERIFY_ROWS_PER_RANGE, verifyRows, sampleParams.numThreads);
 }
 
 int computeTextureLookupDiff(const tcu::ConstPixelBufferAccess &result, const tcu::ConstPixelBufferAccess &reference,
@@ -1599,8 +1624,6 @@ int computeTextureLookupDiff(const tcu::ConstPixelBufferAccess &result, const tc
 
     const float posEps = 1.0f / float(1 << MIN_SUBPIXEL_BITS);
 
-    int numFailed = 0;
-
     const tcu::Vec2 lodOffsets[] = {
         tcu::Vec2(-1, 0),
         tcu::Vec2(+1, 0),
@@ -1610,92 +1633,103 @@ int computeTextureLookupDiff(const tcu::ConstPixelBufferAccess &result, const tc
 
     tcu::clear(errorMask, tcu::RGBA::green().toVec());
 
-    for (int py = 0; py < result.getHeight(); py++)
+    const auto verifyRows = [&](int rowBegin, int rowEnd)
     {
-        // Ugly hack, validation can take way too long at the moment.
-        if (watchDog)
-            qpWatchDog_touch(watchDog);
+        int numFailed = 0;
 
-        for (int px = 0; px < result.getWidth(); px++)
+        for (int py = rowBegin; py < rowEnd; py++)
         {
-            const tcu::Vec4 resPix = (result.getPixel(px, py) - sampleParams.colorBias) / sampleParams.colorScale;
-            const tcu::Vec4 refPix = (reference.getPixel(px, py) - sampleParams.colorBias) / sampleParams.colorScale;
+            // Ugly hack, validation can take way too long at the moment.
+            if (watchDog)
+                qpWatchDog_touch(watchDog);
 
-            // Try comparison to ideal reference first, and if that fails use slower verificator.
-            if (!tcu::boolAll(tcu::lessThanEqual(tcu::abs(resPix - refPix), lookupPrec.colorThreshold)))
+            for (int px = 0; px < result.getWidth(); px++)
             {
-                const float wx = (float)px + 0.5f;
-                const float wy = (float)py + 0.5f;
-                const float nx = wx / dstW;
-                const float ny = wy / dstH;
-
-                const bool tri0 = (wx - posEps) / dstW + (wy - posEps) / dstH <= 1.0f;
-                const bool tri1 = (wx + posEps) / dstW + (wy + posEps) / dstH >= 1.0f;
+                const tcu::Vec4 resPix = (result.getPixel(px, py) - sampleParams.colorBias) / sampleParams.colorScale;
+                const tcu::Vec4 refPix =
+                    (reference.getPixel(px, py) - sampleParams.colorBias) / sampleParams.colorScale;
 
-                bool isOk = false;
-
-                DE_ASSERT(tri0 || tri1);
-
-                // Pixel can belong to either of the triangles if it lies close enough to the edge.
-                for (int triNdx = (tri0 ? 0 : 1); triNdx <= (tri1 ? 1 : 0); triNdx++)
+                // Try comparison to ideal reference first, and if that fails use slower verificator.
+                if (!tcu::boolAll(tcu::lessThanEqual(tcu::abs(resPix - refPix), lookupPrec.colorThreshold)))
                 {
-                    const float triWx = triNdx ? dstW - wx : wx;
-                    const float triWy = triNdx ? dstH - wy : wy;
-                    const float triNx = triNdx ? 1.0f - nx : nx;
-                    const float triNy = triNdx ? 1.0f - ny : ny;
-
-                    const tcu::Vec2 coord(projectedTriInterpolate(triS[triNdx], triW[triNdx], triNx, triNy),
-                                          projectedTriInterpolate(triT[triNdx], triW[triNdx], triNx, triNy));
-                    const tcu::Vec2 coordDx = tcu::Vec2(triDerivateX(triS[triNdx], triW[triNdx], wx, dstW, triNy),
-                                                        triDerivateX(triT[triNdx], triW[triNdx], wx, dstW, triNy)) *
-                                              srcSize.asFloat();
-                    const tcu::Vec2 coordDy = tcu::Vec2(triDerivateY(triS[triNdx], triW[triNdx], wy, dstH, triNx),
-                                                        triDerivateY(triT[triNdx], triW[triNdx], wy, dstH, triNx)) *
-                                              srcSize.asFloat();
+                    const float wx = (float)px + 0.5f;
+                    const float wy = (float)py + 0.5f;
+                    const float nx = wx / dstW;
+                    const float ny = wy / dstH;
 
-                    tcu::Vec2 lodBounds =
-                        tcu::computeLodBoundsFromDerivates(coordDx.x(), coordDx.y(), coordDy.x(), coordDy.y(), lodPrec);
+                    const bool tri0 = (wx - posEps) / dstW + (wy - posEps) / dstH <= 1.0f;
+                    const bool tri1 = (wx + posEps) / dstW + (wy + posEps) / dstH >= 1.0f;
 
-                    // Compute lod bounds across lodOffsets range.
-                    for (int lodOffsNdx = 0; lodOffsNdx < DE_LENGTH_OF_ARRAY(lodOffsets); lodOffsNdx++)
-                    {
-                        const float wxo = triWx + lodOffsets[lodOffsNdx].x();
-                        const float wyo = triWy + lodOffsets[lodOffsNdx].y();
-                        const float nxo = wxo / dstW;
-                        const float nyo = wyo / dstH;
+                    bool isOk = false;
 
-                        const tcu::Vec2 coordDxo = tcu::Vec2(triDerivateX(triS[triNdx], triW[triNdx], wxo, dstW, nyo),
-                                                             triDerivateX(triT[triNdx], triW[triNdx], wxo, dstW, nyo)) *
-                                                   srcSize.asFloat();
-                        const tcu::Vec2 coordDyo = tcu::Vec2(triDerivateY(triS[triNdx], triW[triNdx], wyo, dstH, nxo),
-                                                             triDerivateY(triT[triNdx], triW[triNdx], wyo, dstH, nxo)) *
-                                                   srcSize.asFloat();
-                        const tcu::Vec2 lodO = tcu::computeLodBoundsFromDerivates(coordDxo.x(), coordDxo.y(),
-                                                                                  coordDyo.x(), coordDyo.y(), lodPrec);
+                    DE_ASSERT(tri0 || tri1);
 
-                        lodBounds.x() = de::min(lodBounds.x(), lodO.x());
-                        lodBounds.y() = de::max(lodBounds.y(), lodO.y());
+                    // Pixel can belong to either of the triangles if it lies close enough to the edge.
+                    for (int triNdx = (tri0 ? 0 : 1); triNdx <= (tri1 ? 1 : 0); triNdx++)
+                    {
+                        const float triWx = triNdx ? dstW - wx : wx;
+                        const float triWy = triNdx ? dstH - wy : wy;
+                        const float triNx = triNdx ? 1.0f - nx : nx;
+                        const float triNy = triNdx ? 1.0f - ny : ny;
+
+                        const tcu::Vec2 coord(projectedTriInterpolate(triS[triNdx], triW[triNdx], triNx, triNy),
+                                              projectedTriInterpolate(triT[triNdx], triW[triNdx], triNx, triNy));
+                        const tcu::Vec2 coordDx = tcu::Vec2(triDerivateX(triS[triNdx], triW[triNdx], wx, dstW, triNy),
+                                                            triDerivateX(triT[triNdx], triW[triNdx], wx, dstW, triNy)) *
+                                                  srcSize.asFloat();
+                        const tcu::Vec2 coordDy = tcu::Vec2(triDerivateY(triS[triNdx], triW[triNdx], wy, dstH, triNx),
+                                                            triDerivateY(triT[triNdx], triW[triNdx], wy, dstH, triNx)) *
+                                                  srcSize.asFloat();
+
+                        tcu::Vec2 lodBounds = tcu::computeLodBoundsFromDerivates(coordDx.x(), coordDx.y(), coordDy.x(),
+                                                                                         coordDy.y(), lodPrec);
+
+                        // Compute lod bounds across lodOffsets range.
+                        for (int lodOffsNdx = 0; lodOffsNdx < DE_LENGTH_OF_ARRAY(lodOffsets); lodOffsNdx++)
+                        {
+                            const float wxo = triWx + lodOffsets[lodOffsNdx].x();
+                            const float wyo = triWy + lodOffsets[lodOffsNdx].y();
+                            const float nxo = wxo / dstW;
+                            const float nyo = wyo / dstH;
+
+                            const tcu::Vec2 coordDxo =
+                                tcu::Vec2(triDerivateX(triS[triNdx], triW[triNdx], wxo, dstW, nyo),
+                                          triDerivateX(triT[triNdx], triW[triNdx], wxo, dstW, nyo)) *
+                                srcSize.asFloat();
+                            const tcu::Vec2 coordDyo =
+                                tcu::Vec2(triDerivateY(triS[triNdx], triW[triNdx], wyo, dstH, nxo),
+                                          triDerivateY(triT[triNdx], triW[triNdx], wyo, dstH, nxo)) *
+                                srcSize.asFloat();
+                            const tcu::Vec2 lodO =
+                                tcu::computeLodBoundsFromDerivates(coordDxo.x(), coordDxo.y(), coordDyo.x(),
+                                                                   coordDyo.y(), lodPrec);
+
+                            lodBounds.x() = de::min(lodBounds.x(), lodO.x());
+                            lodBounds.y() = de::max(lodBounds.y(), lodO.y());
+                        }
+
+                        const tcu::Vec2 clampedLod =
+                            tcu::clampLodBounds(lodBounds + lodBias, tcu::Vec2(minLod, sampleParams.maxLod), lodPrec);
+                        if (tcu::isLookupResultValid(src, sampleParams.sampler, lookupPrec, coord, clampedLod, resPix))
+                        {
+                            isOk = true;
+                            break;
+                        }
                     }
 
-                    const tcu::Vec2 clampedLod =
-                        tcu::clampLodBounds(lodBounds + lodBias, tcu::Vec2(minLod, sampleParams.maxLod), lodPrec);
-                    if (tcu::isLookupResultValid(src, sampleParams.sampler, lookupPrec, coord, clampedLod, resPix))
+                    if (!isOk)
                     {
-                        isOk = true;
-                        break;
+                        errorMask.setPixel(tcu::RGBA::red().toVec(), px, py);
+                        numFailed += 1;
                     }
                 }
-
-                if (!isOk)
-                {
-                    errorMask.setPixel(tcu::RGBA::red().toVec(), px, py);
-                    numFailed += 1;
-                }
             }
         }
-    }
 
-    return numFailed;
+        return numFailed;
+    };
+
+    return tcu::parallelSum(result.getHeight(), VERIFY_ROWS_PER_RANGE, verifyRows, sampleParams.numThreads);
 }
 
 bool verifyTextureResult(tcu::TestContext &testCtx, const tcu::ConstPixelBufferAccess &result,
@@ -1821,8 +1855,6 @@ int computeTextureLookupDiff(const tcu::ConstPixelBufferAccess &result, const tc
     const float minLod = (sampleParams.imageViewMinLod != 0.0f) ? de::max(imageViewMinLodRelMode, sampleParams.minLod) :
                                                                   sampleParams.minLod;
 
-    int numFailed = 0;
-
     const tcu::Vec2 lodOffsets[] = {
         tcu::Vec2(-1, 0),
         tcu::Vec2(+1, 0),
@@ -1838,97 +1870,105 @@ int computeTextureLookupDiff(const tcu::ConstPixelBufferAccess &result, const tc
 
     tcu::clear(errorMask, tcu::RGBA::green().toVec());
 
-    for (int py = 0; py < result.getHeight(); py++)
+    const auto verifyRows = [&](int rowBegin, int rowEnd)
     {
-        // Ugly hack, validation can take way too long at the moment.
-        if (watchDog)
-            qpWatchDog_touch(watchDog);
+        int numFailed = 0;
 
-        for (int px = 0; px < result.getWidth(); px++)
+        for (int py = rowBegin; py < rowEnd; py++)
         {
-            const tcu::Vec4 resPix = (result.getPixel(px, py) - sampleParams.colorBias) / sampleParams.colorScale;
-            const tcu::Vec4 refPix = (reference.getPixel(px, py) - sampleParams.colorBias) / sampleParams.colorScale;
+            // Ugly hack, validation can take way too long at the moment.
+            if (watchDog)
+                qpWatchDog_touch(watchDog);
 
-            // Try comparison to ideal reference first, and if that fails use slower verificator.
-            if (!tcu::boolAll(tcu::lessThanEqual(tcu::abs(resPix - refPix), lookupPrec.colorThreshold)))
+            for (int px = 0; px < result.getWidth(); px++)
             {
-                const float wx = (float)px + 0.5f;
-                const float wy = (float)py + 0.5f;
-                const float nx = wx / dstW;
-                const float ny = wy / dstH;
+                const tcu::Vec4 resPix = (result.getPixel(px, py) - sampleParams.colorBias) / sampleParams.colorScale;
+                const tcu::Vec4 refPix =
+                    (reference.getPixel(px, py) - sampleParams.colorBias) / sampleParams.colorScale;
 
-                const bool tri0 = (wx - posEps) / dstW + (wy - posEps) / dstH <= 1.0f;
-                const bool tri1 = (wx + posEps) / dstW + (wy + posEps) / dstH >= 1.0f;
-
-                bool isOk = false;
-
-                DE_ASSERT(tri0 || tri1);
-
-                // Pixel can belong to either of the triangles if it lies close enough to the edge.
-                for (int triNdx = (tri0 ? 0 : 1); triNdx <= (tri1 ? 1 : 0); triNdx++)
+                // Try comparison to ideal reference first, and if that fails use slower verificator.
+                if (!tcu::boolAll(tcu::lessThanEqual(tcu::abs(resPix - refPix), lookupPrec.colorThreshold)))
                 {
-                    const float triWx = triNdx ? dstW - wx : wx;
-                    const float triWy = triNdx ? dstH - wy : wy;
-                    const float triNx = triNdx ? 1.0f - nx : nx;
-                    const float triNy = triNdx ? 1.0f - ny : ny;
-
-                    const tcu::Vec3 coord(projectedTriInterpolate(triS[triNdx], triW[triNdx], triNx, triNy),
-                                          projectedTriInterpolate(triT[triNdx], triW[triNdx], triNx, triNy),
-                                          projectedTriInterpolate(triR[triNdx], triW[triNdx], triNx, triNy));
-                    const tcu::Vec3 coordDx(triDerivateX(triS[triNdx], triW[triNdx], wx, dstW, triNy),
-                                            triDerivateX(triT[triNdx], triW[triNdx], wx, dstW, triNy),
-                                            triDerivateX(triR[triNdx], triW[triNdx], wx, dstW, triNy));
-                    const tcu::Vec3 coordDy(triDerivateY(triS[triNdx], triW[triNdx], wy, dstH, triNx),
-                                            triDerivateY(triT[triNdx], triW[triNdx], wy, dstH, triNx),
-                                            triDerivateY(triR[triNdx], triW[triNdx], wy, dstH, triNx));
+                    const float wx = (float)px + 0.5f;
+                    const float wy = (float)py + 0.5f;
+                    const float nx = wx / dstW;
+                    const float ny = wy / dstH;
 
-                    tcu::Vec2 lodBounds =
-                        tcu::computeCubeLodBoundsFromDerivates(coord, coordDx, coordDy, srcSize, lodPrec);
+                    const bool tri0 = (wx - posEps) / dstW + (wy - posEps) / dstH <= 1.0f;
+                    const bool tri1 = (wx + posEps) / dstW + (wy + posEps) / dstH >= 1.0f;
 
-                    // Compute lod bounds across lodOffsets range.
-                    for (int lodOffsNdx = 0; lodOffsNdx < DE_LENGTH_OF_ARRAY(lodOffsets); lodOffsNdx++)
-                    {
-                        const float wxo = triWx + lodOffsets[lodOffsNdx].x();
-                        const float wyo = triWy + lodOffsets[lodOffsNdx].y();
-                        const float nxo = wxo / dstW;
-                        const float nyo = wyo / dstH;
+                    bool isOk = false;
 
-                        const tcu::Vec3 coordO(projectedTriInterpolate(triS[triNdx], triW[triNdx], nxo, nyo),
-                                               projectedTriInterpolate(triT[triNdx], triW[triNdx], nxo, nyo),
-                                               projectedTriInterpolate(triR[triNdx], triW[triNdx], nxo, nyo));
-                        const tcu::Vec3 coordDxo(triDerivateX(triS[triNdx], triW[triNdx], wxo, dstW, nyo),
-                                                 triDerivateX(triT[triNdx], triW[triNdx], wxo, dstW, nyo),
-                                                 triDerivateX(triR[triNdx], triW[triNdx], wxo, dstW, nyo));
-                        const tcu::Vec3 coordDyo(triDerivateY(triS[triNdx], triW[triNdx], wyo, dstH, nxo),
-                                                 triDerivateY(triT[triNdx], triW[triNdx], wyo, dstH, nxo),
-                                                 triDerivateY(triR[triNdx], triW[triNdx], wyo, dstH, nxo));
-                        const tcu::Vec2 lodO =
-                            tcu::computeCubeLodBoundsFromDerivates(coordO, coordDxo, coordDyo, srcSize, lodPrec);
+                    DE_ASSERT(tri0 || tri1);
 
-                        lodBounds.x() = de::min(lodBounds.x(), lodO.x());
-                        lodBounds.y() = de::max(lodBounds.y(), lodO.y());
+                    // Pixel can belong to either of the triangles if it lies close enough to the edge.
+                    for (int triNdx = (tri0 ? 0 : 1); triNdx <= (tri1 ? 1 : 0); triNdx++)
+                    {
+                        const float triWx = triNdx ? dstW - wx : wx;
+                        const float triWy = triNdx ? dstH - wy : wy;
+                        const float triNx = triNdx ? 1.0f - nx : nx;
+                        const float triNy = triNdx ? 1.0f - ny : ny;
+
+                        const tcu::Vec3 coord(projectedTriInterpolate(triS[triNdx], triW[triNdx], triNx, triNy),
+                                              projectedTriInterpolate(triT[triNdx], triW[triNdx], triNx, triNy),
+                                              projectedTriInterpolate(triR[triNdx], triW[triNdx], triNx, triNy));
+                        const tcu::Vec3 coordDx(triDerivateX(triS[triNdx], triW[triNdx], wx, dstW, triNy),
+                                                triDerivateX(triT[triNdx], triW[triNdx], wx, dstW, triNy),
+                                                triDerivateX(triR[triNdx], triW[triNdx], wx, dstW, triNy));
+                        const tcu::Vec3 coordDy(triDerivateY(triS[triNdx], triW[triNdx], wy, dstH, triNx),
+                                                triDerivateY(triT[triNdx], triW[triNdx], wy, dstH, triNx),
+                                                triDerivateY(triR[triNdx], triW[triNdx], wy, dstH, triNx));
+
+                        tcu::Vec2 lodBounds =
+                            tcu::computeCubeLodBoundsFromDerivates(coord, coordDx, coordDy, srcSize, lodPrec);
+
+                        // Compute lod bounds across lodOffsets range.
+                        for (int lodOffsNdx = 0; lodOffsNdx < DE_LENGTH_OF_ARRAY(lodOffsets); lodOffsNdx++)
+                        {
+                            const float wxo = triWx + lodOffsets[lodOffsNdx].x();
+                            const float wyo = triWy + lodOffsets[lodOffsNdx].y();
+                            const float nxo = wxo / dstW;
+                            const float nyo = wyo / dstH;
+
+                            const tcu::Vec3 coordO(projectedTriInterpolate(triS[triNdx], triW[triNdx], nxo, nyo),
+                                                   projectedTriInterpolate(triT[triNdx], triW[triNdx], nxo, nyo),
+                                                   projectedTriInterpolate(triR[triNdx], triW[triNdx], nxo, nyo));
+                            const tcu::Vec3 coordDxo(triDerivateX(triS[triNdx], triW[triNdx], wxo, dstW, nyo),
+                                                     triDerivateX(triT[triNdx], triW[triNdx], wxo, dstW, nyo),
+                                                     triDerivateX(triR[triNdx], triW[triNdx], wxo, dstW, nyo));
+                            const tcu::Vec3 coordDyo(triDerivateY(triS[triNdx], triW[triNdx], wyo, dstH, nxo),
+                                                     triDerivateY(triT[triNdx], triW[triNdx], wyo, dstH, nxo),
+                                                     triDerivateY(triR[triNdx], triW[triNdx], wyo, dstH, nxo));
+                            const tcu::Vec2 lodO =
+                                tcu::computeCubeLodBoundsFromDerivates(coordO, coordDxo, coordDyo, srcSize, lodPrec);
+
+                            lodBounds.x() = de::min(lodBounds.x(), lodO.x());
+                            lodBounds.y() = de::max(lodBounds.y(), lodO.y());
+                        }
+
+                        const tcu::Vec2 clampedLod =
+                            tcu::clampLodBounds(lodBounds + lodBias, tcu::Vec2(minLod, sampleParams.maxLod), lodPrec);
+
+                        if (tcu::isLookupResultValid(src, sampleParams.sampler, lookupPrec, coord, clampedLod, resPix))
+                        {
+                            isOk = true;
+                            break;
+                        }
                     }
 
-                    const tcu::Vec2 clampedLod =
-                        tcu::clampLodBounds(lodBounds + lodBias, tcu::Vec2(minLod, sampleParams.maxLod), lodPrec);
-
-                    if (tcu::isLookupResultValid(src, sampleParams.sampler, lookupPrec, coord, clampedLod, resPix))
+                    if (!isOk)
                     {
-                        isOk = true;
-                        break;
+                        errorMask.setPixel(tcu::RGBA::red().toVec(), px, py);
+                        numFailed += 1;
                     }
                 }
-
-                if (!isOk)
-                {
-                    errorMask.setPixel(tcu::RGBA::red().toVec(), px, py);
-                    numFailed += 1;
-                }
             }
         }
-    }
 
-    return numFailed;
+        return numFailed;
+    };
+
+    return tcu::parallelSum(result.getHeight(), VERIFY_ROWS_PER_RANGE, verifyRows, sampleParams.numThreads);
 }
 
 bool verifyTextureResult(tcu::TestContext &testCtx, const tcu::ConstPixelBufferAccess &result,
@@ -2020,8 +2060,6 @@ int computeTextureLookupDiff(const tcu::ConstPixelBufferAccess &result, const tc
 
     const float posEps = 1.0f / float(1 << MIN_SUBPIXEL_BITS);
 
-    int numFailed = 0;
-
     const tcu::Vec2 lodOffsets[] = {
         tcu::Vec2(-1, 0),
         tcu::Vec2(+1, 0),
@@ -2031,99 +2069,109 @@ int computeTextureLookupDiff(const tcu::ConstPixelBufferAccess &result, const tc
 
     tcu::clear(errorMask, tcu::RGBA::green().toVec());
 
-    for (int py = 0; py < result.getHeight(); py++)
+    const auto verifyRows = [&](int rowBegin, int rowEnd)
     {
-        // Ugly hack, validation can take way too long at the moment.
-        if (watchDog)
-            qpWatchDog_touch(watchDog);
+        int numFailed = 0;
 
-        for (int px = 0; px < result.getWidth(); px++)
+        for (int py = rowBegin; py < rowEnd; py++)
         {
-            const tcu::Vec4 resPix = (result.getPixel(px, py) - sampleParams.colorBias) / sampleParams.colorScale;
-            const tcu::Vec4 refPix = (reference.getPixel(px, py) - sampleParams.colorBias) / sampleParams.colorScale;
+            // Ugly hack, validation can take way too long at the moment.
+            if (watchDog)
+                qpWatchDog_touch(watchDog);
 
-            // Try comparison to ideal reference first, and if that fails use slower verificator.
-            if (!tcu::boolAll(tcu::lessThanEqual(tcu::abs(resPix - refPix), lookupPrec.colorThreshold)))
+            for (int px = 0; px < result.getWidth(); px++)
             {
-                const float wx = (float)px + 0.5f;
-                const float wy = (float)py + 0.5f;
-                const float nx = wx / dstW;
-                const float ny = wy / dstH;
+                const tcu::Vec4 resPix = (result.getPixel(px, py) - sampleParams.colorBias) / sampleParams.colorScale;
+                const tcu::Vec4 refPix =
+                    (reference.getPixel(px, py) - sampleParams.colorBias) / sampleParams.colorScale;
 
-                const bool tri0 = (wx - posEps) / dstW + (wy - posEps) / dstH <= 1.0f;
-                const bool tri1 = (wx + posEps) / dstW + (wy + posEps) / dstH >= 1.0f;
-
-                bool isOk = false;
-
-                DE_ASSERT(tri0 || tri1);
-
-                // Pixel can belong to either of the triangles if it lies close enough to the edge.
-                for (int triNdx = (tri0 ? 0 : 1); triNdx <= (tri1 ? 1 : 0); triNdx++)
+                // Try comparison to ideal reference first, and if that fails use slower verificator.
+                if (!tcu::boolAll(tcu::lessThanEqual(tcu::abs(resPix - refPix), lookupPrec.colorThreshold)))
                 {
-                    const float triWx = triNdx ? dstW - wx : wx;
-                    const float triWy = triNdx ? dstH - wy : wy;
-                    const float triNx = triNdx ? 1.0f - nx : nx;
-                    const float triNy = triNdx ? 1.0f - ny : ny;
-
-                    const tcu::Vec3 coord(projectedTriInterpolate(triS[triNdx], triW[triNdx], triNx, triNy),
-                                          projectedTriInterpolate(triT[triNdx], triW[triNdx], triNx, triNy),
-                                          projectedTriInterpolate(triR[triNdx], triW[triNdx], triNx, triNy));
-                    const tcu::Vec3 coordDx = tcu::Vec3(triDerivateX(triS[triNdx], triW[triNdx], wx, dstW, triNy),
-                                                        triDerivateX(triT[triNdx], triW[triNdx], wx, dstW, triNy),
-                                                        triDerivateX(triR[triNdx], triW[triNdx], wx, dstW, triNy)) *
-                                              srcSize.asFloat();
-                    const tcu::Vec3 coordDy = tcu::Vec3(triDerivateY(triS[triNdx], triW[triNdx], wy, dstH, triNx),
-                                                        triDerivateY(triT[triNdx], triW[triNdx], wy, dstH, triNx),
-                                                        triDerivateY(triR[triNdx], triW[triNdx], wy, dstH, triNx)) *
-                                              srcSize.asFloat();
+                    const float wx = (float)px + 0.5f;
+                    const float wy = (float)py + 0.5f;
+                    const float nx = wx / dstW;
+                    const float ny = wy / dstH;
 
-                    tcu::Vec2 lodBounds = tcu::computeLodBoundsFromDerivates(
-                        coordDx.x(), coordDx.y(), coordDx.z(), coordDy.x(), coordDy.y(), coordDy.z(), lodPrec);
+                    const bool tri0 = (wx - posEps) / dstW + (wy - posEps) / dstH <= 1.0f;
+                    const bool tri1 = (wx + posEps) / dstW + (wy + posEps) / dstH >= 1.0f;
 
-                    // Compute lod bounds across lodOffsets range.
-                    for (int lodOffsNdx = 0; lodOffsNdx < DE_LENGTH_OF_ARRAY(lodOffsets); lodOffsNdx++)
-                    {
-                        const float wxo = triWx + lodOffsets[lodOffsNdx].x();
-                        const float wyo = triWy + lodOffsets[lodOffsNdx].y();
-                        const float nxo = wxo / dstW;
-                        const float nyo = wyo / dstH;
+                    bool isOk = false;
 
-                        const tcu::Vec3 coordDxo = tcu::Vec3(triDerivateX(triS[triNdx], triW[triNdx], wxo, dstW, nyo),
-                                                             triDerivateX(triT[triNdx], triW[triNdx], wxo, dstW, nyo),
-                                                             triDerivateX(triR[triNdx], triW[triNdx], wxo, dstW, nyo)) *
-                                                   srcSize.asFloat();
-                        const tcu::Vec3 coordDyo = tcu::Vec3(triDerivateY(triS[triNdx], triW[triNdx], wyo, dstH, nxo),
-                                                             triDerivateY(triT[triNdx], triW[triNdx], wyo, dstH, nxo),
-                                                             triDerivateY(triR[triNdx], triW[triNdx], wyo, dstH, nxo)) *
-                                                   srcSize.asFloat();
-                        const tcu::Vec2 lodO =
-                            tcu::computeLodBoundsFromDerivates(coordDxo.x(), coordDxo.y(), coordDxo.z(), coordDyo.x(),
-                                                               coordDyo.y(), coordDyo.z(), lodPrec);
+                    DE_ASSERT(tri0 || tri1);
 
-                        lodBounds.x() = de::min(lodBounds.x(), lodO.x());
-                        lodBounds.y() = de::max(lodBounds.y(), lodO.y());
+                    // Pixel can belong to either of the triangles if it lies close enough to the edge.
+                    for (int triNdx = (tri0 ? 0 : 1); triNdx <= (tri1 ? 1 : 0); triNdx++)
+                    {
+                        const float triWx = triNdx ? dstW - wx : wx;
+                        const float triWy = triNdx ? dstH - wy : wy;
+                        const float triNx = triNdx ? 1.0f - nx : nx;
+                        const float triNy = triNdx ? 1.0f - ny : ny;
+
+                        const tcu::Vec3 coord(projectedTriInterpolate(triS[triNdx], triW[triNdx], triNx, triNy),
+                                              projectedTriInterpolate(triT[triNdx], triW[triNdx], triNx, triNy),
+                                              projectedTriInterpolate(triR[triNdx], triW[triNdx], triNx, triNy));
+                        const tcu::Vec3 coordDx = tcu::Vec3(triDerivateX(triS[triNdx], triW[triNdx], wx, dstW, triNy),
+                                                            triDerivateX(triT[triNdx], triW[triNdx], wx, dstW, triNy),
+                                                            triDerivateX(triR[triNdx], triW[triNdx], wx, dstW, triNy)) *
+                                                  srcSize.asFloat();
+                        const tcu::Vec3 coordDy = tcu::Vec3(triDerivateY(triS[triNdx], triW[triNdx], wy, dstH, triNx),
+                                                            triDerivateY(triT[triNdx], triW[triNdx], wy, dstH, triNx),
+                                                            triDerivateY(triR[triNdx], triW[triNdx], wy, dstH, triNx)) *
+                                                  srcSize.asFloat();
+
+                        tcu::Vec2 lodBounds = tcu::computeLodBoundsFromDerivates(
+                            coordDx.x(), coordDx.y(), coordDx.z(), coordDy.x(), coordDy.y(), coordDy.z(), lodPrec);
+
+                        // Compute lod bounds across lodOffsets range.
+                        for (int lodOffsNdx = 0; lodOffsNdx < DE_LENGTH_OF_ARRAY(lodOffsets); lodOffsNdx++)
+                        {
+                            const float wxo = triWx + lodOffsets[lodOffsNdx].x();
+                            const float wyo = triWy + lodOffsets[lodOffsNdx].y();
+                            const float nxo = wxo / dstW;
+                            const float nyo = wyo / dstH;
+
+                            const tcu::Vec3 coordDxo =
+                                tcu::Vec3(triDerivateX(triS[triNdx], triW[triNdx], wxo, dstW, nyo),
+                                          triDerivateX(triT[triNdx], triW[triNdx], wxo, dstW, nyo),
+                                          triDerivateX(triR[triNdx], triW[triNdx], wxo, dstW, nyo)) *
+                                srcSize.asFloat();
+                            const tcu::Vec3 coordDyo =
+                                tcu::Vec3(triDerivateY(triS[triNdx], triW[triNdx], wyo, dstH, nxo),
+                                          triDerivateY(triT[triNdx], triW[triNdx], wyo, dstH, nxo),
+                                          triDerivateY(triR[triNdx], triW[triNdx], wyo, dstH, nxo)) *
+                                srcSize.asFloat();
+                            const tcu::Vec2 lodO =
+                                tcu::computeLodBoundsFromDerivates(coordDxo.x(), coordDxo.y(), coordDxo.z(),
+                                                                   coordDyo.x(), coordDyo.y(), coordDyo.z(), lodPrec);
+
+                            lodBounds.x() = de::min(lodBounds.x(), lodO.x());
+                            lodBounds.y() = de::max(lodBounds.y(), lodO.y());
+                        }
+
+                        const tcu::Vec2 clampedLod =
+                            tcu::clampLodBounds(lodBounds + lodBias, tcu::Vec2(minLod, sampleParams.maxLod), lodPrec);
+
+                        if (tcu::isLookupResultValid(src, sampleParams.sampler, lookupPrec, coord, clampedLod, resPix))
+                        {
+                            isOk = true;
+                            break;
+                        }
                     }
 
-                    const tcu::Vec2 clampedLod =
-                        tcu::clampLodBounds(lodBounds + lodBias, tcu::Vec2(minLod, sampleParams.maxLod), lodPrec);
-
-                    if (tcu::isLookupResultValid(src, sampleParams.sampler, lookupPrec, coord, clampedLod, resPix))
+                    if (!isOk)
                     {
-                        isOk = true;
-                        break;
+                        errorMask.setPixel(tcu::RGBA::red().toVec(), px, py);
+                        numFailed += 1;
                     }
                 }
-
-                if (!isOk)
-                {
-                    errorMask.setPixel(tcu::RGBA::red().toVec(), px, py);
-                    numFailed += 1;
-                }
             }
         }
-    }
 
-    return numFailed;
+        return numFailed;
+    };
+
+    return tcu::parallelSum(result.getHeight(), VERIFY_ROWS_PER_RANGE, verifyRows, sampleParams.numThreads);
 }
 
 bool verifyTextureResult(tcu::TestContext &testCtx, const tcu::ConstPixelBufferAccess &result,
@@ -2188,8 +2236,6 @@ int computeTextureLookupDiff(const tcu::ConstPixelBufferAccess &result, const tc
 
     const tcu::Vec2 lodBias((sampleParams.flags & ReferenceParams::USE_BIAS) ? sampleParams.bias : 0.0f);
 
-    int numFailed = 0;
-
     const tcu::Vec2 lodOffsets[] = {
         tcu::Vec2(-1, 0),
         tcu::Vec2(+1, 0),
@@ -2199,69 +2245,77 @@ int computeTextureLookupDiff(const tcu::ConstPixelBufferAccess &result, const tc
 
     tcu::clear(errorMask, tcu::RGBA::green().toVec());
 
-    for (int py = 0; py < result.getHeight(); py++)
+    const auto verifyRows = [&](int rowBegin, int rowEnd)
     {
-        // Ugly hack, validation can take way too long at the moment.
-        if (watchDog)
-            qpWatchDog_touch(watchDog);
+        int numFailed = 0;
 
-        for (int px = 0; px < result.getWidth(); px++)
+        for (int py = rowBegin; py < rowEnd; py++)
         {
-            const tcu::Vec4 resPix = (result.getPixel(px, py) - sampleParams.colorBias) / sampleParams.colorScale;
-            const tcu::Vec4 refPix = (reference.getPixel(px, py) - sampleParams.colorBias) / sampleParams.colorScale;
+            // Ugly hack, validation can take way too long at the moment.
+            if (watchDog)
+                qpWatchDog_touch(watchDog);
 
-            // Try comparison to ideal reference first, and if that fails use slower verificator.
-            if (!tcu::boolAll(tcu::lessThanEqual(tcu::abs(resPix - refPix), lookupPrec.colorThreshold)))
+            for (int px = 0; px < result.getWidth(); px++)
             {
-                const float wx = (float)px + 0.5f;
-                const float wy = (float)py + 0.5f;
-                const float nx = wx / dstW;
-                const float ny = wy / dstH;
-
-                const int triNdx  = nx + ny >= 1.0f ? 1 : 0;
-                const float triWx = triNdx ? dstW - wx : wx;
-                const float triWy = triNdx ? dstH - wy : wy;
-                const float triNx = triNdx ? 1.0f - nx : nx;
-                const float triNy = triNdx ? 1.0f - ny : ny;
+                const tcu::Vec4 resPix = (result.getPixel(px, py) - sampleParams.colorBias) / sampleParams.colorScale;
+                const tcu::Vec4 refPix =
+                    (reference.getPixel(px, py) - sampleParams.colorBias) / sampleParams.colorScale;
 
-                const tcu::Vec2 coord(projectedTriInterpolate(triS[triNdx], triW[triNdx], triNx, triNy),
-                                      projectedTriInterpolate(triT[triNdx], triW[triNdx], triNx, triNy));
-                const float coordDx = triDerivateX(triS[triNdx], triW[triNdx], wx, dstW, triNy) * srcSize;
-                const float coordDy = triDerivateY(triS[triNdx], triW[triNdx], wy, dstH, triNx) * srcSize;
-
-                tcu::Vec2 lodBounds = tcu::computeLodBoundsFromDerivates(coordDx, coordDy, lodPrec);
-
-                // Compute lod bounds across lodOffsets range.
-                for (int lodOffsNdx = 0; lodOffsNdx < DE_LENGTH_OF_ARRAY(lodOffsets); lodOffsNdx++)
+                // Try comparison to ideal reference first, and if that fails use slower verificator.
+                if (!tcu::boolAll(tcu::lessThanEqual(tcu::abs(resPix - refPix), lookupPrec.colorThreshold)))
                 {
-                    const float wxo = triWx + lodOffsets[lodOffsNdx].x();
-                    const float wyo = triWy + lodOffsets[lodOffsNdx].y();
-                    const float nxo = wxo / dstW;
-                    const float nyo = wyo / dstH;
+                    const float wx = (float)px + 0.5f;
+                    const float wy = (float)py + 0.5f;
+                    const float nx = wx / dstW;
+                    const float ny = wy / dstH;
 
-                    const float coordDxo = triDerivateX(triS[triNdx], triW[triNdx], wxo, dstW, nyo) * srcSize;
-                    const float coordDyo = triDerivateY(triS[triNdx], triW[triNdx], wyo, dstH, nxo) * srcSize;
-                    const tcu::Vec2 lodO = tcu::computeLodBoundsFromDerivates(coordDxo, coordDyo, lodPrec);
+                    const int triNdx  = nx + ny >= 1.0f ? 1 : 0;
+                    const float triWx = triNdx ? dstW - wx : wx;
+                    const float triWy = triNdx ? dstH - wy : wy;
+                    const float triNx = triNdx ? 1.0f - nx : nx;
+                    const float triNy = triNdx ? 1.0f - ny : ny;
 
-                    lodBounds.x() = de::min(lodBounds.x(), lodO.x());
-                    lodBounds.y() = de::max(lodBounds.y(), lodO.y());
-                }
+                    const tcu::Vec2 coord(projectedTriInterpolate(triS[triNdx], triW[triNdx], triNx, triNy),
+                                          projectedTriInterpolate(triT[triNdx], triW[triNdx], triNx, triNy));
+                    const float coordDx = triDerivateX(triS[triNdx], triW[triNdx], wx, dstW, triNy) * srcSize;
+                    const float coordDy = triDerivateY(triS[triNdx], triW[triNdx], wy, dstH, triNx) * srcSize;
 
-                const tcu::Vec2 clampedLod = tcu::clampLodBounds(
-                    lodBounds + lodBias, tcu::Vec2(sampleParams.minLod, sampleParams.maxLod), lodPrec);
-                const bool isOk =
-                    tcu::isLookupResultValid(src, sampleParams.sampler, lookupPrec, coord, clampedLod, resPix);
+                    tcu::Vec2 lodBounds = tcu::computeLodBoundsFromDerivates(coordDx, coordDy, lodPrec);
 
-                if (!isOk)
-                {
-                    errorMask.setPixel(tcu::RGBA::red().toVec(), px, py);
-                    numFailed += 1;
+                    // Compute lod bounds across lodOffsets range.
+                    for (int lodOffsNdx = 0; lodOffsNdx < DE_LENGTH_OF_ARRAY(lodOffsets); lodOffsNdx++)
+                    {
+                        const float wxo = triWx + lodOffsets[lodOffsNdx].x();
+                        const float wyo = triWy + lodOffsets[lodOffsNdx].y();
+                        const float nxo = wxo / dstW;
+                        const float nyo = wyo / dstH;
+
+                        const float coordDxo = triDerivateX(triS[triNdx], triW[triNdx], wxo, dstW, nyo) * srcSize;
+                        const float coordDyo = triDerivateY(triS[triNdx], triW[triNdx], wyo, dstH, nxo) * srcSize;
+                        const tcu::Vec2 lodO = tcu::computeLodBoundsFromDerivates(coordDxo, coordDyo, lodPrec);
+
+                        lodBounds.x() = de::min(lodBounds.x(), lodO.x());
+                        lodBounds.y() = de::max(lodBounds.y(), lodO.y());
+                    }
+
+                    const tcu::Vec2 clampedLod = tcu::clampLodBounds(
+                        lodBounds + lodBias, tcu::Vec2(sampleParams.minLod, sampleParams.maxLod), lodPrec);
+                    const bool isOk =
+                        tcu::isLookupResultValid(src, sampleParams.sampler, lookupPrec, coord, clampedLod, resPix);
+
+                    if (!isOk)
+                    {
+                        errorMask.setPixel(tcu::RGBA::red().toVec(), px, py);
+                        numFailed += 1;
+                    }
                 }
             }
         }
-    }
 
-    return numFailed;
+        return numFailed;
+    };
+
+    return tcu::parallelSum(result.getHeight(), VERIFY_ROWS_PER_RANGE, verifyRows, sampleParams.numThreads);
 }
 
 //! Verifies texture lookup results and returns number of failed pixels.
@@ -2295,8 +2349,6 @@ int computeTextureLookupDiff(const tcu::ConstPixelBufferAccess &result, const tc
 
     const tcu::Vec2 lodBias((sampleParams.flags & ReferenceParams::USE_BIAS) ? sampleParams.bias : 0.0f);
 
-    int numFailed = 0;
-
     const tcu::Vec2 lodOffsets[] = {
         tcu::Vec2(-1, 0),
         tcu::Vec2(+1, 0),
@@ -2306,80 +2358,89 @@ int computeTextureLookupDiff(const tcu::ConstPixelBufferAccess &result, const tc
 
     tcu::clear(errorMask, tcu::RGBA::green().toVec());
 
-    for (int py = 0; py < result.getHeight(); py++)
+    const auto verifyRows = [&](int rowBegin, int rowEnd)
     {
-        // Ugly hack, validation can take way too long at the moment.
-        if (watchDog)
-            qpWatchDog_touch(watchDog);
+        int numFailed = 0;
 
-        for (int px = 0; px < result.getWidth(); px++)
+        for (int py = rowBegin; py < rowEnd; py++)
         {
-            const tcu::Vec4 resPix = (result.getPixel(px, py) - sampleParams.colorBias) / sampleParams.colorScale;
-            const tcu::Vec4 refPix = (reference.getPixel(px, py) - sampleParams.colorBias) / sampleParams.colorScale;
+            // Ugly hack, validation can take way too long at the moment.
+            if (watchDog)
+                qpWatchDog_touch(watchDog);
 
-            // Try comparison to ideal reference first, and if that fails use slower verificator.
-            if (!tcu::boolAll(tcu::lessThanEqual(tcu::abs(resPix - refPix), lookupPrec.colorThreshold)))
+            for (int px = 0; px < result.getWidth(); px++)
             {
-                const float wx = (float)px + 0.5f;
-                const float wy = (float)py + 0.5f;
-                const float nx = wx / dstW;
-                const float ny = wy / dstH;
+                const tcu::Vec4 resPix = (result.getPixel(px, py) - sampleParams.colorBias) / sampleParams.colorScale;
+                const tcu::Vec4 refPix =
+                    (reference.getPixel(px, py) - sampleParams.colorBias) / sampleParams.colorScale;
 
-                const int triNdx  = nx + ny >= 1.0f ? 1 : 0;
-                const float triWx = triNdx ? dstW - wx : wx;
-                const float triWy = triNdx ? dstH - wy : wy;
-                const float triNx = triNdx ? 1.0f - nx : nx;
-                const float triNy = triNdx ? 1.0f - ny : ny;
+                // Try comparison to ideal reference first, and if that fails use slower verificator.
+                if (!tcu::boolAll(tcu::lessThanEqual(tcu::abs(resPix - refPix), lookupPrec.colorThreshold)))
+                {
+                    const float wx = (float)px + 0.5f;
+                    const float wy = (float)py + 0.5f;
+                    const float nx = wx / dstW;
+                    const float ny = wy / dstH;
 
-                const tcu::Vec3 coord(projectedTriInterpolate(triS[triNdx], triW[triNdx], triNx, triNy),
-                                      projectedTriInterpolate(triT[triNdx], triW[triNdx], triNx, triNy),
-                                      projectedTriInterpolate(triR[triNdx], triW[triNdx], triNx, triNy));
-                const tcu::Vec2 coordDx = tcu::Vec2(triDerivateX(triS[triNdx], triW[triNdx], wx, dstW, triNy),
-                                                    triDerivateX(triT[triNdx], triW[triNdx], wx, dstW, triNy)) *
-                                          srcSize;
-                const tcu::Vec2 coordDy = tcu::Vec2(triDerivateY(triS[triNdx], triW[triNdx], wy, dstH, triNx),
-                                                    triDerivateY(triT[triNdx], triW[triNdx], wy, dstH, triNx)) *
-                                          srcSize;
+                    const int triNdx  = nx + ny >= 1.0f ? 1 : 0;
+                    const float triWx = triNdx ? dstW - wx : wx;
+                    const float triWy = triNdx ? dstH - wy : wy;
+                    const float triNx = triNdx ? 1.0f - nx : nx;
+                    const float triNy = triNdx ? 1.0f - ny : ny;
+
+                    const tcu::Vec3 coord(projectedTriInterpolate(triS[triNdx], triW[triNdx], triNx, triNy),
+                                          projectedTriInterpolate(triT[triNdx], triW[triNdx], triNx, triNy),
+                                          projectedTriInterpolate(triR[triNdx], triW[triNdx], triNx, triNy));
+                    const tcu::Vec2 coordDx = tcu::Vec2(triDerivateX(triS[triNdx], triW[triNdx], wx, dstW, triNy),
+                                                        triDerivateX(triT[triNdx], triW[triNdx], wx, dstW, triNy)) *
+                                              srcSize;
+                    const tcu::Vec2 coordDy = tcu::Vec2(triDerivateY(triS[triNdx], triW[triNdx], wy, dstH, triNx),
+                                                        triDerivateY(triT[triNdx], triW[triNdx], wy, dstH, triNx)) *
+                                              srcSize;
 
-                tcu::Vec2 lodBounds =
-                    tcu::computeLodBoundsFromDerivates(coordDx.x(), coordDx.y(), coordDy.x(), coordDy.y(), lodPrec);
+                    tcu::Vec2 lodBounds =
+                        tcu::computeLodBoundsFromDerivates(coordDx.x(), coordDx.y(), coordDy.x(), coordDy.y(), lodPrec);
 
-                // Compute lod bounds across lodOffsets range.
-                for (int lodOffsNdx = 0; lodOffsNdx < DE_LENGTH_OF_ARRAY(lodOffsets); lodOffsNdx++)
-                {
-                    const float wxo = triWx + lodOffsets[lodOffsNdx].x();
-                    const float wyo = triWy + lodOffsets[lodOffsNdx].y();
-                    const float nxo = wxo / dstW;
-                    const float nyo = wyo / dstH;
+                    // Compute lod bounds across lodOffsets range.
+                    for (int lodOffsNdx = 0; lodOffsNdx < DE_LENGTH_OF_ARRAY(lodOffsets); lodOffsNdx++)
+                    {
+                        const float wxo = triWx + lodOffsets[lodOffsNdx].x();
+                        const float wyo = triWy + lodOffsets[lodOffsNdx].y();
+                        const float nxo = wxo / dstW;
+                        const float nyo = wyo / dstH;
 
-                    const tcu::Vec2 coordDxo = tcu::Vec2(triDerivateX(triS[triNdx], triW[triNdx], wxo, dstW, nyo),
-                                                         triDerivateX(triT[triNdx], triW[triNdx], wxo, dstW, nyo)) *
-                                               srcSize;
-                    const tcu::Vec2 coordDyo = tcu::Vec2(triDerivateY(triS[triNdx], triW[triNdx], wyo, dstH, nxo),
-                                                         triDerivateY(triT[triNdx], triW[triNdx], wyo, dstH, nxo)) *
-                                               srcSize;
-                    const tcu::Vec2 lodO = tcu::computeLodBoundsFromDerivates(coordDxo.x(), coordDxo.y(), coordDyo.x(),
-                                                                              coordDyo.y(), lodPrec);
+                        const tcu::Vec2 coordDxo = tcu::Vec2(triDerivateX(triS[triNdx], triW[triNdx], wxo, dstW, nyo),
+                                                             triDerivateX(triT[triNdx], triW[triNdx], wxo, dstW, nyo)) *
+                                                   srcSize;
+                        const tcu::Vec2 coordDyo = tcu::Vec2(triDerivateY(triS[triNdx], triW[triNdx], wyo, dstH, nxo),
+                                                             triDerivateY(triT[triNdx], triW[triNdx], wyo, dstH, nxo)) *
+                                                   srcSize;
+                        const tcu::Vec2 lodO =
+                            tcu::computeLodBoundsFromDerivates(coordDxo.x(), coordDxo.y(), coordDyo.x(),
+                                                               coordDyo.y(), lodPrec);
 
-                    lodBounds.x() = de::min(lodBounds.x(), lodO.x());
-                    lodBounds.y() = de::max(lodBounds.y(), lodO.y());
-                }
+                        lodBounds.x() = de::min(lodBounds.x(), lodO.x());
+                        lodBounds.y() = de::max(lodBounds.y(), lodO.y());
+                    }
 
-                const tcu::Vec2 clampedLod = tcu::clampLodBounds(
-                    lodBounds + lodBias, tcu::Vec2(sampleParams.minLod, sampleParams.maxLod), lodPrec);
-                const bool isOk =
-                    tcu::isLookupResultValid(src, sampleParams.sampler, lookupPrec, coord, clampedLod, resPix);
+                    const tcu::Vec2 clampedLod = tcu::clampLodBounds(
+                        lodBounds + lodBias, tcu::Vec2(sampleParams.minLod, sampleParams.maxLod), lodPrec);
+                    const bool isOk =
+                        tcu::isLookupResultValid(src, sampleParams.sampler, lookupPrec, coord, clampedLod, resPix);
 
-                if (!isOk)
-                {
-                    errorMask.setPixel(tcu::RGBA::red().toVec(), px, py);
-                    numFailed += 1;
+                    if (!isOk)
+                    {
+                        errorMask.setPixel(tcu::RGBA::red().toVec(), px, py);
+                        numFailed += 1;
+                    }
                 }
             }
         }
-    }
 
-    return numFailed;
+        return numFailed;
+    };
+
+    return tcu::parallelSum(result.getHeight(), VERIFY_ROWS_PER_RANGE, verifyRows, sampleParams.numThreads);
 }
 
 bool verifyTextureResult(tcu::TestContext &testCtx, const tcu::ConstPixelBufferAccess &result,
@@ -2496,8 +2557,6 @@ int computeTextureLookupDiff(const tcu::ConstPixelBufferAccess &result, const tc
 
     const float posEps = 1.0f / float((1 << 4) + 1); // ES3 requires at least 4 subpixel bits.
 
-    int numFailed = 0;
-
     const tcu::Vec2 lodOffsets[] = {
         tcu::Vec2(-1, 0),
         tcu::Vec2(+1, 0),
@@ -2513,99 +2572,107 @@ int computeTextureLookupDiff(const tcu::ConstPixelBufferAccess &result, const tc
 
     tcu::clear(errorMask, tcu::RGBA::green().toVec());
 
-    for (int py = 0; py < result.getHeight(); py++)
+    const auto verifyRows = [&](int rowBegin, int rowEnd)
     {
-        // Ugly hack, validation can take way too long at the moment.
-        if (watchDog)
-            qpWatchDog_touch(watchDog);
+        int numFailed = 0;
 
-        for (int px = 0; px < result.getWidth(); px++)
+        for (int py = rowBegin; py < rowEnd; py++)
         {
-            const tcu::Vec4 resPix = (result.getPixel(px, py) - sampleParams.colorBias) / sampleParams.colorScale;
-            const tcu::Vec4 refPix = (reference.getPixel(px, py) - sampleParams.colorBias) / sampleParams.colorScale;
+            // Ugly hack, validation can take way too long at the moment.
+            if (watchDog)
+                qpWatchDog_touch(watchDog);
 
-            // Try comparison to ideal reference first, and if that fails use slower verificator.
-            if (!tcu::boolAll(tcu::lessThanEqual(tcu::abs(resPix - refPix), lookupPrec.colorThreshold)))
+            for (int px = 0; px < result.getWidth(); px++)
             {
-                const float wx = (float)px + 0.5f;
-                const float wy = (float)py + 0.5f;
-                const float nx = wx / dstW;
-                const float ny = wy / dstH;
+                const tcu::Vec4 resPix = (result.getPixel(px, py) - sampleParams.colorBias) / sampleParams.colorScale;
+                const tcu::Vec4 refPix =
+                    (reference.getPixel(px, py) - sampleParams.colorBias) / sampleParams.colorScale;
 
-                const bool tri0 = nx + ny - posEps <= 1.0f;
-                const bool tri1 = nx + ny + posEps >= 1.0f;
-
-                bool isOk = false;
-
-                DE_ASSERT(tri0 || tri1);
-
-                // Pixel can belong to either of the triangles if it lies close enough to the edge.
-                for (int triNdx = (tri0 ? 0 : 1); triNdx <= (tri1 ? 1 : 0); triNdx++)
+                // Try comparison to ideal reference first, and if that fails use slower verificator.
+                if (!tcu::boolAll(tcu::lessThanEqual(tcu::abs(resPix - refPix), lookupPrec.colorThreshold)))
                 {
-                    const float triWx = triNdx ? dstW - wx : wx;
-                    const float triWy = triNdx ? dstH - wy : wy;
-                    const float triNx = triNdx ? 1.0f - nx : nx;
-                    const float triNy = triNdx ? 1.0f - ny : ny;
-
-                    const tcu::Vec4 coord(projectedTriInterpolate(triS[triNdx], triW[triNdx], triNx, triNy),
-                                          projectedTriInterpolate(triT[triNdx], triW[triNdx], triNx, triNy),
-                                          projectedTriInterpolate(triR[triNdx], triW[triNdx], triNx, triNy),
-                                          projectedTriInterpolate(triQ[triNdx], triW[triNdx], triNx, triNy));
-                    const tcu::Vec3 coordDx(triDerivateX(triS[triNdx], triW[triNdx], wx, dstW, triNy),
-                                            triDerivateX(triT[triNdx], triW[triNdx], wx, dstW, triNy),
-                                            triDerivateX(triR[triNdx], triW[triNdx], wx, dstW, triNy));
-                    const tcu::Vec3 coordDy(triDerivateY(triS[triNdx], triW[triNdx], wy, dstH, triNx),
-                                            triDerivateY(triT[triNdx], triW[triNdx], wy, dstH, triNx),
-                                            triDerivateY(triR[triNdx], triW[triNdx], wy, dstH, triNx));
+                    const float wx = (float)px + 0.5f;
+                    const float wy = (float)py + 0.5f;
+                    const float nx = wx / dstW;
+                    const float ny = wy / dstH;
 
-                    tcu::Vec2 lodBounds =
-                        tcu::computeCubeLodBoundsFromDerivates(coord.toWidth<3>(), coordDx, coordDy, srcSize, lodPrec);
+                    const bool tri0 = nx + ny - posEps <= 1.0f;
+                    const bool tri1 = nx + ny + posEps >= 1.0f;
 
-                    // Compute lod bounds across lodOffsets range.
-                    for (int lodOffsNdx = 0; lodOffsNdx < DE_LENGTH_OF_ARRAY(lodOffsets); lodOffsNdx++)
-                    {
-                        const float wxo = triWx + lodOffsets[lodOffsNdx].x();
-                        const float wyo = triWy + lodOffsets[lodOffsNdx].y();
-                        const float nxo = wxo / dstW;
-                        const float nyo = wyo / dstH;
+                    bool isOk = false;
 
-                        const tcu::Vec3 coordO(projectedTriInterpolate(triS[triNdx], triW[triNdx], nxo, nyo),
-                                               projectedTriInterpolate(triT[triNdx], triW[triNdx], nxo, nyo),
-                                               projectedTriInterpolate(triR[triNdx], triW[triNdx], nxo, nyo));
-                        const tcu::Vec3 coordDxo(triDerivateX(triS[triNdx], triW[triNdx], wxo, dstW, nyo),
-                                                 triDerivateX(triT[triNdx], triW[triNdx], wxo, dstW, nyo),
-                                                 triDerivateX(triR[triNdx], triW[triNdx], wxo, dstW, nyo));
-                        const tcu::Vec3 coordDyo(triDerivateY(triS[triNdx], triW[triNdx], wyo, dstH, nxo),
-                                                 triDerivateY(triT[triNdx], triW[triNdx], wyo, dstH, nxo),
-                                                 triDerivateY(triR[triNdx], triW[triNdx], wyo, dstH, nxo));
-                        const tcu::Vec2 lodO =
-                            tcu::computeCubeLodBoundsFromDerivates(coordO, coordDxo, coordDyo, srcSize, lodPrec);
+                    DE_ASSERT(tri0 || tri1);
 
-                        lodBounds.x() = de::min(lodBounds.x(), lodO.x());
-                        lodBounds.y() = de::max(lodBounds.y(), lodO.y());
+                    // Pixel can belong to either of the triangles if it lies close enough to the edge.
+                    for (int triNdx = (tri0 ? 0 : 1); triNdx <= (tri1 ? 1 : 0); triNdx++)
+                    {
+                        const float triWx = triNdx ? dstW - wx : wx;
+                        const float triWy = triNdx ? dstH - wy : wy;
+                        const float triNx = triNdx ? 1.0f - nx : nx;
+                        const float triNy = triNdx ? 1.0f - ny : ny;
+
+                        const tcu::Vec4 coord(projectedTriInterpolate(triS[triNdx], triW[triNdx], triNx, triNy),
+                                              projectedTriInterpolate(triT[triNdx], triW[triNdx], triNx, triNy),
+                                              projectedTriInterpolate(triR[triNdx], triW[triNdx], triNx, triNy),
+                                              projectedTriInterpolate(triQ[triNdx], triW[triNdx], triNx, triNy));
+                        const tcu::Vec3 coordDx(triDerivateX(triS[triNdx], triW[triNdx], wx, dstW, triNy),
+                                                triDerivateX(triT[triNdx], triW[triNdx], wx, dstW, triNy),
+                                                triDerivateX(triR[triNdx], triW[triNdx], wx, dstW, triNy));
+                        const tcu::Vec3 coordDy(triDerivateY(triS[triNdx], triW[triNdx], wy, dstH, triNx),
+                                                triDerivateY(triT[triNdx], triW[triNdx], wy, dstH, triNx),
+                                                triDerivateY(triR[triNdx], triW[triNdx], wy, dstH, triNx));
+
+                        tcu::Vec2 lodBounds = tcu::computeCubeLodBoundsFromDerivates(coord.toWidth<3>(), coordDx,
+                                                                                     coordDy, srcSize, lodPrec);
+
+                        // Compute lod bounds across lodOffsets range.
+                        for (int lodOffsNdx = 0; lodOffsNdx < DE_LENGTH_OF_ARRAY(lodOffsets); lodOffsNdx++)
+                        {
+                            const float wxo = triWx + lodOffsets[lodOffsNdx].x();
+                            const float wyo = triWy + lodOffsets[lodOffsNdx].y();
+                            const float nxo = wxo / dstW;
+                            const float nyo = wyo / dstH;
+
+                            const tcu::Vec3 coordO(projectedTriInterpolate(triS[triNdx], triW[triNdx], nxo, nyo),
+                                                   projectedTriInterpolate(triT[triNdx], triW[triNdx], nxo, nyo),
+                                                   projectedTriInterpolate(triR[triNdx], triW[triNdx], nxo, nyo));
+                            const tcu::Vec3 coordDxo(triDerivateX(triS[triNdx], triW[triNdx], wxo, dstW, nyo),
+                                                     triDerivateX(triT[triNdx], triW[triNdx], wxo, dstW, nyo),
+                                                     triDerivateX(triR[triNdx], triW[triNdx], wxo, dstW, nyo));
+                            const tcu::Vec3 coordDyo(triDerivateY(triS[triNdx], triW[triNdx], wyo, dstH, nxo),
+                                                     triDerivateY(triT[triNdx], triW[triNdx], wyo, dstH, nxo),
+                                                     triDerivateY(triR[triNdx], triW[triNdx], wyo, dstH, nxo));
+                            const tcu::Vec2 lodO =
+                                tcu::computeCubeLodBoundsFromDerivates(coordO, coordDxo, coordDyo, srcSize, lodPrec);
+
+                            lodBounds.x() = de::min(lodBounds.x(), lodO.x());
+                            lodBounds.y() = de::max(lodBounds.y(), lodO.y());
+                        }
+
+                        const tcu::Vec2 clampedLod = tcu::clampLodBounds(
+                            lodBounds + lodBias, tcu::Vec2(sampleParams.minLod, sampleParams.maxLod), lodPrec);
+
+                        if (tcu::isLookupResultValid(src, sampleParams.sampler, lookupPrec, coordBits, coord,
+                                                     clampedLod, resPix))
+                        {
+                            isOk = true;
+                            break;
+                        }
                     }
 
-                    const tcu::Vec2 clampedLod = tcu::clampLodBounds(
-                        lodBounds + lodBias, tcu::Vec2(sampleParams.minLod, sampleParams.maxLod), lodPrec);
-
-                    if (tcu::isLookupResultValid(src, sampleParams.sampler, lookupPrec, coordBits, coord, clampedLod,
-                                                 resPix))
+                    if (!isOk)
                     {
-                        isOk = true;
-                        break;
+                        errorMask.setPixel(tcu::RGBA::red().toVec(), px, py);
+                        numFailed += 1;
                     }
                 }
-
-                if (!isOk)
-                {
-                    errorMask.setPixel(tcu::RGBA::red().toVec(), px, py);
-                    numFailed += 1;
-                }
             }
         }
-    }
 
-    return numFailed;
+        return numFailed;
+    };
+
+    return tcu::parallelSum(result.getHeight(), VERIFY_ROWS_PER_RANGE, verifyRows, sampleParams.numThreads);
 }
 
 bool verifyTextureResult(tcu::TestContext &testCtx, const tcu::ConstPixelBufferAccess &result,
@@ -2673,8 +2740,6 @@ int computeTextureCompareDiff(const tcu::ConstPixelBufferAccess &result, const t
                              de::max(deFloatFloor(sampleParams.imageViewMinLod), sampleParams.minLod) :
                              sampleParams.minLod;
 
-    int numFailed = 0;
-
     const tcu::Vec2 lodOffsets[] = {
         tcu::Vec2(-1, 0),
         tcu::Vec2(+1, 0),
@@ -2684,85 +2749,93 @@ int computeTextureCompareDiff(const tcu::ConstPixelBufferAccess &result, const t
 
     tcu::clear(errorMask, tcu::RGBA::green().toVec());
 
-    for (int py = 0; py < result.getHeight(); py++)
+    const auto verifyRows = [&](int rowBegin, int rowEnd)
     {
-        for (int px = 0; px < result.getWidth(); px++)
-        {
-            const tcu::Vec4 resPix = result.getPixel(px, py);
-            const tcu::Vec4 refPix = reference.getPixel(px, py);
+        int numFailed = 0;
 
-            // Other channels should trivially match to reference.
-            if (!tcu::boolAll(tcu::lessThanEqual(tcu::abs(refPix.swizzle(1, 2, 3) - resPix.swizzle(1, 2, 3)),
-                                                 nonShadowThreshold)))
+        for (int py = rowBegin; py < rowEnd; py++)
+        {
+            for (int px = 0; px < result.getWidth(); px++)
             {
-                errorMask.setPixel(tcu::RGBA::red().toVec(), px, py);
-                numFailed += 1;
-                continue;
-            }
+                const tcu::Vec4 resPix = result.getPixel(px, py);
+                const tcu::Vec4 refPix = reference.getPixel(px, py);
 
-            // Reference result is known to be a valid result, we can
-            // skip verification if thes results are equal
-            if (resPix.x() != refPix.x())
-            {
-                const float wx = (float)px + 0.5f;
-                const float wy = (float)py + 0.5f;
-                const float nx = wx / dstW;
-                const float ny = wy / dstH;
+                // Other channels should trivially match to reference.
+                if (!tcu::boolAll(tcu::lessThanEqual(tcu::abs(refPix.swizzle(1, 2, 3) - resPix.swizzle(1, 2, 3)),
+                                                     nonShadowThreshold)))
+                {
+                    errorMask.setPixel(tcu::RGBA::red().toVec(), px, py);
+                    numFailed += 1;
+                    continue;
+                }
 
-                const int triNdx  = nx + ny >= 1.0f ? 1 : 0;
-                const float triWx = triNdx ? dstW - wx : wx;
-                const float triWy = triNdx ? dstH - wy : wy;
-                const float triNx = triNdx ? 1.0f - nx : nx;
-                const float triNy = triNdx ? 1.0f - ny : ny;
+                // Reference result is known to be a valid result, we can
+                // skip verification if thes results are equal
+                if (resPix.x() != refPix.x())
+                {
+                    const float wx = (float)px + 0.5f;
+                    const float wy = (float)py + 0.5f;
+                    const float nx = wx / dstW;
+                    const float ny = wy / dstH;
 
-                const tcu::Vec2 coord(projectedTriInterpolate(triS[triNdx], triW[triNdx], triNx, triNy),
-                                      projectedTriInterpolate(triT[triNdx], triW[triNdx], triNx, triNy));
-                const tcu::Vec2 coordDx = tcu::Vec2(triDerivateX(triS[triNdx], triW[triNdx], wx, dstW, triNy),
-                                                    triDerivateX(triT[triNdx], triW[triNdx], wx, dstW, triNy)) *
-                                          srcSize.asFloat();
-                const tcu::Vec2 coordDy = tcu::Vec2(triDerivateY(triS[triNdx], triW[triNdx], wy, dstH, triNx),
-                                                    triDerivateY(triT[triNdx], triW[triNdx], wy, dstH, triNx)) *
-                                          srcSize.asFloat();
+                    const int triNdx  = nx + ny >= 1.0f ? 1 : 0;
+                    const float triWx = triNdx ? dstW - wx : wx;
+                    const float triWy = triNdx ? dstH - wy : wy;
+                    const float triNx = triNdx ? 1.0f - nx : nx;
+                    const float triNy = triNdx ? 1.0f - ny : ny;
+
+                    const tcu::Vec2 coord(projectedTriInterpolate(triS[triNdx], triW[triNdx], triNx, triNy),
+                                          projectedTriInterpolate(triT[triNdx], triW[triNdx], triNx, triNy));
+                    const tcu::Vec2 coordDx = tcu::Vec2(triDerivateX(triS[triNdx], triW[triNdx], wx, dstW, triNy),
+                                                        triDerivateX(triT[triNdx], triW[triNdx], wx, dstW, triNy)) *
+                                              srcSize.asFloat();
+                    const tcu::Vec2 coordDy = tcu::Vec2(triDerivateY(triS[triNdx], triW[triNdx], wy, dstH, triNx),
+                                                        triDerivateY(triT[triNdx], triW[triNdx], wy, dstH, triNx)) *
+                                              srcSize.asFloat();
 
-                tcu::Vec2 lodBounds =
-                    tcu::computeLodBoundsFromDerivates(coordDx.x(), coordDx.y(), coordDy.x(), coordDy.y(), lodPrec);
+                    tcu::Vec2 lodBounds =
+                        tcu::computeLodBoundsFromDerivates(coordDx.x(), coordDx.y(), coordDy.x(), coordDy.y(), lodPrec);
 
-                // Compute lod bounds across lodOffsets range.
-                for (int lodOffsNdx = 0; lodOffsNdx < DE_LENGTH_OF_ARRAY(lodOffsets); lodOffsNdx++)
-                {
-                    const float wxo = triWx + lodOffsets[lodOffsNdx].x();
-                    const float wyo = triWy + lodOffsets[lodOffsNdx].y();
-                    const float nxo = wxo / dstW;
-                    const float nyo = wyo / dstH;
+                    // Compute lod bounds across lodOffsets range.
+                    for (int lodOffsNdx = 0; lodOffsNdx < DE_LENGTH_OF_ARRAY(lodOffsets); lodOffsNdx++)
+                    {
+                        const float wxo = triWx + lodOffsets[lodOffsNdx].x();
+                        const float wyo = triWy + lodOffsets[lodOffsNdx].y();
+                        const float nxo = wxo / dstW;
+                        const float nyo = wyo / dstH;
 
-                    const tcu::Vec2 coordDxo = tcu::Vec2(triDerivateX(triS[triNdx], triW[triNdx], wxo, dstW, nyo),
-                                                         triDerivateX(triT[triNdx], triW[triNdx], wxo, dstW, nyo)) *
-                                               srcSize.asFloat();
-                    const tcu::Vec2 coordDyo = tcu::Vec2(triDerivateY(triS[triNdx], triW[triNdx], wyo, dstH, nxo),
-                                                         triDerivateY(triT[triNdx], triW[triNdx], wyo, dstH, nxo)) *
-                                               srcSize.asFloat();
-                    const tcu::Vec2 lodO = tcu::computeLodBoundsFromDerivates(coordDxo.x(), coordDxo.y(), coordDyo.x(),
-                                                                              coordDyo.y(), lodPrec);
+                        const tcu::Vec2 coordDxo = tcu::Vec2(triDerivateX(triS[triNdx], triW[triNdx], wxo, dstW, nyo),
+                                                             triDerivateX(triT[triNdx], triW[triNdx], wxo, dstW, nyo)) *
+                                                   srcSize.asFloat();
+                        const tcu::Vec2 coordDyo = tcu::Vec2(triDerivateY(triS[triNdx], triW[triNdx], wyo, dstH, nxo),
+                                                             triDerivateY(triT[triNdx], triW[triNdx], wyo, dstH, nxo)) *
+                                                   srcSize.asFloat();
+                        const tcu::Vec2 lodO =
+                            tcu::computeLodBoundsFromDerivates(coordDxo.x(), coordDxo.y(), coordDyo.x(),
+                                                               coordDyo.y(), lodPrec);
 
-                    lodBounds.x() = de::min(lodBounds.x(), lodO.x());
-                    lodBounds.y() = de::max(lodBounds.y(), lodO.y());
-                }
+                        lodBounds.x() = de::min(lodBounds.x(), lodO.x());
+                        lodBounds.y() = de::max(lodBounds.y(), lodO.y());
+                    }
 
-                const tcu::Vec2 clampedLod =
-                    tcu::clampLodBounds(lodBounds + lodBias, tcu::Vec2(minLod, sampleParams.maxLod), lodPrec);
-                const bool isOk = tcu::isTexCompareResultValid(src, sampleParams.sampler, comparePrec, coord,
-                                                               clampedLod, sampleParams.ref, resPix.x());
+                    const tcu::Vec2 clampedLod =
+                        tcu::clampLodBounds(lodBounds + lodBias, tcu::Vec2(minLod, sampleParams.maxLod), lodPrec);
+                    const bool isOk = tcu::isTexCompareResultValid(src, sampleParams.sampler, comparePrec, coord,
+                                                                   clampedLod, sampleParams.ref, resPix.x());
 
-                if (!isOk)
-                {
-                    errorMask.setPixel(tcu::RGBA::red().toVec(), px, py);
-                    numFailed += 1;
+                    if (!isOk)
+                    {
+                        errorMask.setPixel(tcu::RGBA::red().toVec(), px, py);
+                        numFailed += 1;
+                    }
                 }
             }
         }
-    }
 
-    return numFailed;
+        return numFailed;
+    };
+
+    return tcu::parallelSum(result.getHeight(), VERIFY_ROWS_PER_RANGE, verifyRows, sampleParams.numThreads);
 }
 
 int computeTextureCompareDiff(const tcu::ConstPixelBufferAccess &result, const tcu::ConstPixelBufferAccess &reference,
@@ -2795,8 +2868,6 @@ int computeTextureCompareDiff(const tcu::ConstPixelBufferAccess &result, const t
                              de::max(deFloatFloor(sampleParams.imageViewMinLod), sampleParams.minLod) :
                              sampleParams.minLod;
 
-    int numFailed = 0;
-
     const tcu::Vec2 lodOffsets[] = {
         tcu::Vec2(-1, 0),
         tcu::Vec2(+1, 0),
@@ -2806,88 +2877,96 @@ int computeTextureCompareDiff(const tcu::ConstPixelBufferAccess &result, const t
 
     tcu::clear(errorMask, tcu::RGBA::green().toVec());
 
-    for (int py = 0; py < result.getHeight(); py++)
+    const auto verifyRows = [&](int rowBegin, int rowEnd)
     {
-        for (int px = 0; px < result.getWidth(); px++)
-        {
-            const tcu::Vec4 resPix = result.getPixel(px, py);
-            const tcu::Vec4 refPix = reference.getPixel(px, py);
+        int numFailed = 0;
 
-            // Other channels should trivially match to reference.
-            if (!tcu::boolAll(tcu::lessThanEqual(tcu::abs(refPix.swizzle(1, 2, 3) - resPix.swizzle(1, 2, 3)),
-                                                 nonShadowThreshold)))
+        for (int py = rowBegin; py < rowEnd; py++)
+        {
+            for (int px = 0; px < result.getWidth(); px++)
             {
-                errorMask.setPixel(tcu::RGBA::red().toVec(), px, py);
-                numFailed += 1;
-                continue;
-            }
+                const tcu::Vec4 resPix = result.getPixel(px, py);
+                const tcu::Vec4 refPix = reference.getPixel(px, py);
 
-            // Reference result is known to be a valid result, we can
-            // skip verification if thes results are equal
-            if (resPix.x() != refPix.x())
-            {
-                const float wx = (float)px + 0.5f;
-                const float wy = (float)py + 0.5f;
-                const float nx = wx / dstW;
-                const float ny = wy / dstH;
+                // Other channels should trivially match to reference.
+                if (!tcu::boolAll(tcu::lessThanEqual(tcu::abs(refPix.swizzle(1, 2, 3) - resPix.swizzle(1, 2, 3)),
+                                                     nonShadowThreshold)))
+                {
+                    errorMask.setPixel(tcu::RGBA::red().toVec(), px, py);
+                    numFailed += 1;
+                    continue;
+                }
 
-                const int triNdx  = nx + ny >= 1.0f ? 1 : 0;
-                const float triWx = triNdx ? dstW - wx : wx;
-                const float triWy = triNdx ? dstH - wy : wy;
-                const float triNx = triNdx ? 1.0f - nx : nx;
-                const float triNy = triNdx ? 1.0f - ny : ny;
+                // Reference result is known to be a valid result, we can
+                // skip verification if thes results are equal
+                if (resPix.x() != refPix.x())
+                {
+                    const float wx = (float)px + 0.5f;
+                    const float wy = (float)py + 0.5f;
+                    const float nx = wx / dstW;
+                    const float ny = wy / dstH;
 
-                const tcu::Vec3 coord(projectedTriInterpolate(triS[triNdx], triW[triNdx], triNx, triNy),
-                                      projectedTriInterpolate(triT[triNdx], triW[triNdx], triNx, triNy),
-                                      projectedTriInterpolate(triR[triNdx], triW[triNdx], triNx, triNy));
-                const tcu::Vec3 coordDx(triDerivateX(triS[triNdx], triW[triNdx], wx, dstW, triNy),
-                                        triDerivateX(triT[triNdx], triW[triNdx], wx, dstW, triNy),
-                                        triDerivateX(triR[triNdx], triW[triNdx], wx, dstW, triNy));
-                const tcu::Vec3 coordDy(triDerivateY(triS[triNdx], triW[triNdx], wy, dstH, triNx),
-                                        triDerivateY(triT[triNdx], triW[triNdx], wy, dstH, triNx),
-                                        triDerivateY(triR[triNdx], triW[triNdx], wy, dstH, triNx));
+                    const int triNdx  = nx + ny >= 1.0f ? 1 : 0;
+                    const float triWx = triNdx ? dstW - wx : wx;
+                    const float triWy = triNdx ? dstH - wy : wy;
+                    const float triNx = triNdx ? 1.0f - nx : nx;
+                    const float triNy = triNdx ? 1.0f - ny : ny;
 
-                tcu::Vec2 lodBounds = tcu::computeCubeLodBoundsFromDerivates(coord, coordDx, coordDy, srcSize, lodPrec);
+                    const tcu::Vec3 coord(projectedTriInterpolate(triS[triNdx], triW[triNdx], triNx, triNy),
+                                          projectedTriInterpolate(triT[triNdx], triW[triNdx], triNx, triNy),
+                                          projectedTriInterpolate(triR[triNdx], triW[triNdx], triNx, triNy));
+                    const tcu::Vec3 coordDx(triDerivateX(triS[triNdx], triW[triNdx], wx, dstW, triNy),
+                                            triDerivateX(triT[triNdx], triW[triNdx], wx, dstW, triNy),
+                                            triDerivateX(triR[triNdx], triW[triNdx], wx, dstW, triNy));
+                    const tcu::Vec3 coordDy(triDerivateY(triS[triNdx], triW[triNdx], wy, dstH, triNx),
+                                            triDerivateY(triT[triNdx], triW[triNdx], wy, dstH, triNx),
+                                            triDerivateY(triR[triNdx], triW[triNdx], wy, dstH, triNx));
 
-                // Compute lod bounds across lodOffsets range.
-                for (int lodOffsNdx = 0; lodOffsNdx < DE_LENGTH_OF_ARRAY(lodOffsets); lodOffsNdx++)
-                {
-                    const float wxo = triWx + lodOffsets[lodOffsNdx].x();
-                    const float wyo = triWy + lodOffsets[lodOffsNdx].y();
-                    const float nxo = wxo / dstW;
-                    const float nyo = wyo / dstH;
+                    tcu::Vec2 lodBounds =
+                        tcu::computeCubeLodBoundsFromDerivates(coord, coordDx, coordDy, srcSize, lodPrec);
 
-                    const tcu::Vec3 coordO(projectedTriInterpolate(triS[triNdx], triW[triNdx], nxo, nyo),
-                                           projectedTriInterpolate(triT[triNdx], triW[triNdx], nxo, nyo),
-                                           projectedTriInterpolate(triR[triNdx], triW[triNdx], nxo, nyo));
-                    const tcu::Vec3 coordDxo(triDerivateX(triS[triNdx], triW[triNdx], wxo, dstW, nyo),
-                                             triDerivateX(triT[triNdx], triW[triNdx], wxo, dstW, nyo),
-                                             triDerivateX(triR[triNdx], triW[triNdx], wxo, dstW, nyo));
-                    const tcu::Vec3 coordDyo(triDerivateY(triS[triNdx], triW[triNdx], wyo, dstH, nxo),
-                                             triDerivateY(triT[triNdx], triW[triNdx], wyo, dstH, nxo),
-                                             triDerivateY(triR[triNdx], triW[triNdx], wyo, dstH, nxo));
-                    const tcu::Vec2 lodO =
-                        tcu::computeCubeLodBoundsFromDerivates(coordO, coordDxo, coordDyo, srcSize, lodPrec);
+                    // Compute lod bounds across lodOffsets range.
+                    for (int lodOffsNdx = 0; lodOffsNdx < DE_LENGTH_OF_ARRAY(lodOffsets); lodOffsNdx++)
+                    {
+                        const float wxo = triWx + lodOffsets[lodOffsNdx].x();
+                        const float wyo = triWy + lodOffsets[lodOffsNdx].y();
+                        const float nxo = wxo / dstW;
+                        const float nyo = wyo / dstH;
 
-                    lodBounds.x() = de::min(lodBounds.x(), lodO.x());
-                    lodBounds.y() = de::max(lodBounds.y(), lodO.y());
-                }
+                        const tcu::Vec3 coordO(projectedTriInterpolate(triS[triNdx], triW[triNdx], nxo, nyo),
+                                               projectedTriInterpolate(triT[triNdx], triW[triNdx], nxo, nyo),
+                                               projectedTriInterpolate(triR[triNdx], triW[triNdx], nxo, nyo));
+                        const tcu::Vec3 coordDxo(triDerivateX(triS[triNdx], triW[triNdx], wxo, dstW, nyo),
+                                                 triDerivateX(triT[triNdx], triW[triNdx], wxo, dstW, nyo),
+                                                 triDerivateX(triR[triNdx], triW[triNdx], wxo, dstW, nyo));
+                        const tcu::Vec3 coordDyo(triDerivateY(triS[triNdx], triW[triNdx], wyo, dstH, nxo),
+                                                 triDerivateY(triT[triNdx], triW[triNdx], wyo, dstH, nxo),
+                                                 triDerivateY(triR[triNdx], triW[triNdx], wyo, dstH, nxo));
+                        const tcu::Vec2 lodO =
+                            tcu::computeCubeLodBoundsFromDerivates(coordO, coordDxo, coordDyo, srcSize, lodPrec);
 
-                const tcu::Vec2 clampedLod =
-                    tcu::clampLodBounds(lodBounds + lodBias, tcu::Vec2(minLod, sampleParams.maxLod), lodPrec);
-                const bool isOk = tcu::isTexCompareResultValid(src, sampleParams.sampler, comparePrec, coord,
-                                                               clampedLod, sampleParams.ref, resPix.x());
+                        lodBounds.x() = de::min(lodBounds.x(), lodO.x());
+                        lodBounds.y() = de::max(lodBounds.y(), lodO.y());
+                    }
 
-                if (!isOk)
-                {
-                    errorMask.setPixel(tcu::RGBA::red().toVec(), px, py);
-                    numFailed += 1;
+                    const tcu::Vec2 clampedLod =
+                        tcu::clampLodBounds(lodBounds + lodBias, tcu::Vec2(minLod, sampleParams.maxLod), lodPrec);
+                    const bool isOk = tcu::isTexCompareResultValid(src, sampleParams.sampler, comparePrec, coord,
+                                                                   clampedLod, sampleParams.ref, resPix.x());
+
+                    if (!isOk)
+                    {
+                        errorMask.setPixel(tcu::RGBA::red().toVec(), px, py);
+                        numFailed += 1;
+                    }
                 }
             }
         }
-    }
 
-    return numFailed;
+        return numFailed;
+    };
+
+    return tcu::parallelSum(result.getHeight(), VERIFY_ROWS_PER_RANGE, verifyRows, sampleParams.numThreads);
 }
 
 int computeTextureCompareDiff(const tcu::ConstPixelBufferAccess &result, const tcu::ConstPixelBufferAccess &reference,
@@ -2916,8 +2995,6 @@ int computeTextureCompareDiff(const tcu::ConstPixelBufferAccess &result, const t
 
     const tcu::Vec2 lodBias((sampleParams.flags & ReferenceParams::USE_BIAS) ? sampleParams.bias : 0.0f);
 
-    int numFailed = 0;
-
     const tcu::Vec2 lodOffsets[] = {
         tcu::Vec2(-1, 0),
         tcu::Vec2(+1, 0),
@@ -2927,86 +3004,94 @@ int computeTextureCompareDiff(const tcu::ConstPixelBufferAccess &result, const t
 
     tcu::clear(errorMask, tcu::RGBA::green().toVec());
 
-    for (int py = 0; py < result.getHeight(); py++)
+    const auto verifyRows = [&](int rowBegin, int rowEnd)
     {
-        for (int px = 0; px < result.getWidth(); px++)
-        {
-            const tcu::Vec4 resPix = result.getPixel(px, py);
-            const tcu::Vec4 refPix = reference.getPixel(px, py);
+        int numFailed = 0;
 
-            // Other channels should trivially match to reference.
-            if (!tcu::boolAll(tcu::lessThanEqual(tcu::abs(refPix.swizzle(1, 2, 3) - resPix.swizzle(1, 2, 3)),
-                                                 nonShadowThreshold)))
+        for (int py = rowBegin; py < rowEnd; py++)
+        {
+            for (int px = 0; px < result.getWidth(); px++)
             {
-                errorMask.setPixel(tcu::RGBA::red().toVec(), px, py);
-                numFailed += 1;
-                continue;
-            }
+                const tcu::Vec4 resPix = result.getPixel(px, py);
+                const tcu::Vec4 refPix = reference.getPixel(px, py);
 
-            // Reference result is known to be a valid result, we can
-            // skip verification if thes results are equal
-            if (resPix.x() != refPix.x())
-            {
-                const float wx = (float)px + 0.5f;
-                const float wy = (float)py + 0.5f;
-                const float nx = wx / dstW;
-                const float ny = wy / dstH;
+                // Other channels should trivially match to reference.
+                if (!tcu::boolAll(tcu::lessThanEqual(tcu::abs(refPix.swizzle(1, 2, 3) - resPix.swizzle(1, 2, 3)),
+                                                     nonShadowThreshold)))
+                {
+                    errorMask.setPixel(tcu::RGBA::red().toVec(), px, py);
+                    numFailed += 1;
+                    continue;
+                }
 
-                const int triNdx  = nx + ny >= 1.0f ? 1 : 0;
-                const float triWx = triNdx ? dstW - wx : wx;
-                const float triWy = triNdx ? dstH - wy : wy;
-                const float triNx = triNdx ? 1.0f - nx : nx;
-                const float triNy = triNdx ? 1.0f - ny : ny;
+                // Reference result is known to be a valid result, we can
+                // skip verification if thes results are equal
+                if (resPix.x() != refPix.x())
+                {
+                    const float wx = (float)px + 0.5f;
+                    const float wy = (float)py + 0.5f;
+                    const float nx = wx / dstW;
+                    const float ny = wy / dstH;
 
-                const tcu::Vec3 coord(projectedTriInterpolate(triS[triNdx], triW[triNdx], triNx, triNy),
-                                      projectedTriInterpolate(triT[triNdx], triW[triNdx], triNx, triNy),
-                                      projectedTriInterpolate(triR[triNdx], triW[triNdx], triNx, triNy));
-                const tcu::Vec2 coordDx = tcu::Vec2(triDerivateX(triS[triNdx], triW[triNdx], wx, dstW, triNy),
-                                                    triDerivateX(triT[triNdx], triW[triNdx], wx, dstW, triNy)) *
-                                          srcSize.asFloat();
-                const tcu::Vec2 coordDy = tcu::Vec2(triDerivateY(triS[triNdx], triW[triNdx], wy, dstH, triNx),
-                                                    triDerivateY(triT[triNdx], triW[triNdx], wy, dstH, triNx)) *
-                                          srcSize.asFloat();
+                    const int triNdx  = nx + ny >= 1.0f ? 1 : 0;
+                    const float triWx = triNdx ? dstW - wx : wx;
+                    const float triWy = triNdx ? dstH - wy : wy;
+                    const float triNx = triNdx ? 1.0f - nx : nx;
+                    const float triNy = triNdx ? 1.0f - ny : ny;
 
-                tcu::Vec2 lodBounds =
-                    tcu::computeLodBoundsFromDerivates(coordDx.x(), coordDx.y(), coordDy.x(), coordDy.y(), lodPrec);
+                    const tcu::Vec3 coord(projectedTriInterpolate(triS[triNdx], triW[triNdx], triNx, triNy),
+                                          projectedTriInterpolate(triT[triNdx], triW[triNdx], triNx, triNy),
+                                          projectedTriInterpolate(triR[triNdx], triW[triNdx], triNx, triNy));
+                    const tcu::Vec2 coordDx = tcu::Vec2(triDerivateX(triS[triNdx], triW[triNdx], wx, dstW, triNy),
+                                                        triDerivateX(triT[triNdx], triW[triNdx], wx, dstW, triNy)) *
+                                              srcSize.asFloat();
+                    const tcu::Vec2 coordDy = tcu::Vec2(triDerivateY(triS[triNdx], triW[triNdx], wy, dstH, triNx),
+                                                        triDerivateY(triT[triNdx], triW[triNdx], wy, dstH, triNx)) *
+                                              srcSize.asFloat();
 
-                // Compute lod bounds across lodOffsets range.
-                for (int lodOffsNdx = 0; lodOffsNdx < DE_LENGTH_OF_ARRAY(lodOffsets); lodOffsNdx++)
-                {
-                    const float wxo = triWx + lodOffsets[lodOffsNdx].x();
-                    const float wyo = triWy + lodOffsets[lodOffsNdx].y();
-                    const float nxo = wxo / dstW;
-                    const float nyo = wyo / dstH;
+                    tcu::Vec2 lodBounds =
+                        tcu::computeLodBoundsFromDerivates(coordDx.x(), coordDx.y(), coordDy.x(), coordDy.y(), lodPrec);
 
-                    const tcu::Vec2 coordDxo = tcu::Vec2(triDerivateX(triS[triNdx], triW[triNdx], wxo, dstW, nyo),
-                                                         triDerivateX(triT[triNdx], triW[triNdx], wxo, dstW, nyo)) *
-                                               srcSize.asFloat();
-                    const tcu::Vec2 coordDyo = tcu::Vec2(triDerivateY(triS[triNdx], triW[triNdx], wyo, dstH, nxo),
-                                                         triDerivateY(triT[triNdx], triW[triNdx], wyo, dstH, nxo)) *
-                                               srcSize.asFloat();
-                    const tcu::Vec2 lodO = tcu::computeLodBoundsFromDerivates(coordDxo.x(), coordDxo.y(), coordDyo.x(),
-                                                                              coordDyo.y(), lodPrec);
+                    // Compute lod bounds across lodOffsets range.
+                    for (int lodOffsNdx = 0; lodOffsNdx < DE_LENGTH_OF_ARRAY(lodOffsets); lodOffsNdx++)
+                    {
+                        const float wxo = triWx + lodOffsets[lodOffsNdx].x();
+                        const float wyo = triWy + lodOffsets[lodOffsNdx].y();
+                        const float nxo = wxo / dstW;
+                        const float nyo = wyo / dstH;
 
-                    lodBounds.x() = de::min(lodBounds.x(), lodO.x());
-                    lodBounds.y() = de::max(lodBounds.y(), lodO.y());
-                }
+                        const tcu::Vec2 coordDxo = tcu::Vec2(triDerivateX(triS[triNdx], triW[triNdx], wxo, dstW, nyo),
+                                                             triDerivateX(triT[triNdx], triW[triNdx], wxo, dstW, nyo)) *
+                                                   srcSize.asFloat();
+                        const tcu::Vec2 coordDyo = tcu::Vec2(triDerivateY(triS[triNdx], triW[triNdx], wyo, dstH, nxo),
+                                                             triDerivateY(triT[triNdx], triW[triNdx], wyo, dstH, nxo)) *
+                                                   srcSize.asFloat();
+                        const tcu::Vec2 lodO =
+                            tcu::computeLodBoundsFromDerivates(coordDxo.x(), coordDxo.y(), coordDyo.x(),
+                                                               coordDyo.y(), lodPrec);
 
-                const tcu::Vec2 clampedLod = tcu::clampLodBounds(
-                    lodBounds + lodBias, tcu::Vec2(sampleParams.minLod, sampleParams.maxLod), lodPrec);
-                const bool isOk = tcu::isTexCompareResultValid(src, sampleParams.sampler, comparePrec, coord,
-                                                               clampedLod, sampleParams.ref, resPix.x());
+                        lodBounds.x() = de::min(lodBounds.x(), lodO.x());
+                        lodBounds.y() = de::max(lodBounds.y(), lodO.y());
+                    }
 
-                if (!isOk)
-                {
-                    errorMask.setPixel(tcu::RGBA::red().toVec(), px, py);
-                    numFailed += 1;
+                    const tcu::Vec2 clampedLod = tcu::clampLodBounds(
+                        lodBounds + lodBias, tcu::Vec2(sampleParams.minLod, sampleParams.maxLod), lodPrec);
+                    const bool isOk = tcu::isTexCompareResultValid(src, sampleParams.sampler, comparePrec, coord,
+                                                                   clampedLod, sampleParams.ref, resPix.x());
+
+                    if (!isOk)
+                    {
+                        errorMask.setPixel(tcu::RGBA::red().toVec(), px, py);
+                        numFailed += 1;
+                    }
                 }
             }
         }
-    }
 
-    return numFailed;
+        return numFailed;
+    };
+
+    return tcu::parallelSum(result.getHeight(), VERIFY_ROWS_PER_RANGE, verifyRows, sampleParams.numThreads);
 }
 
 int computeTextureCompareDiff(const tcu::ConstPixelBufferAccess &result, const tcu::ConstPixelBufferAccess &reference,
@@ -3246,8 +3331,6 @@ int computeTextureCompareDiff(const tcu::ConstPixelBufferAccess &result, const t
 
     const tcu::Vec2 lodBias((sampleParams.flags & ReferenceParams::USE_BIAS) ? sampleParams.bias : 0.0f);
 
-    int numFailed = 0;
-
     const tcu::Vec2 lodOffsets[] = {
         tcu::Vec2(-1, 0),
         tcu::Vec2(+1, 0),
@@ -3257,90 +3340,97 @@ int computeTextureCompareDiff(const tcu::ConstPixelBufferAccess &result, const t
 
     tcu::clear(errorMask, tcu::RGBA::green().toVec());
 
-    for (int py = 0; py < result.getHeight(); py++)
+    const auto verifyRows = [&](int rowBegin, int rowEnd)
     {
-        for (int px = 0; px < result.getWidth(); px++)
-        {
-            const tcu::Vec4 resPix = result.getPixel(px, py);
-            const tcu::Vec4 refPix = reference.getPixel(px, py);
+        int numFailed = 0;
 
-            // Other channels should trivially match to reference.
-            if (!tcu::boolAll(tcu::lessThanEqual(tcu::abs(refPix.swizzle(1, 2, 3) - resPix.swizzle(1, 2, 3)),
-                                                 nonShadowThreshold)))
+        for (int py = rowBegin; py < rowEnd; py++)
+        {
+            for (int px = 0; px < result.getWidth(); px++)
             {
-                errorMask.setPixel(tcu::RGBA::red().toVec(), px, py);
-                numFailed += 1;
-                continue;
-            }
+                const tcu::Vec4 resPix = result.getPixel(px, py);
+                const tcu::Vec4 refPix = reference.getPixel(px, py);
 
-            // Reference result is known to be a valid result, we can
-            // skip verification if thes results are equal
-            if (resPix.x() != refPix.x())
-            {
-                const float wx = (float)px + 0.5f;
-                const float wy = (float)py + 0.5f;
-                const float nx = wx / dstW;
-                const float ny = wy / dstH;
+                // Other channels should trivially match to reference.
+                if (!tcu::boolAll(tcu::lessThanEqual(tcu::abs(refPix.swizzle(1, 2, 3) - resPix.swizzle(1, 2, 3)),
+                                                     nonShadowThreshold)))
+                {
+                    errorMask.setPixel(tcu::RGBA::red().toVec(), px, py);
+                    numFailed += 1;
+                    continue;
+                }
 
-                const int triNdx  = nx + ny >= 1.0f ? 1 : 0;
-                const float triWx = triNdx ? dstW - wx : wx;
-                const float triWy = triNdx ? dstH - wy : wy;
-                const float triNx = triNdx ? 1.0f - nx : nx;
-                const float triNy = triNdx ? 1.0f - ny : ny;
+                // Reference result is known to be a valid result, we can
+                // skip verification if thes results are equal
+                if (resPix.x() != refPix.x())
+                {
+                    const float wx = (float)px + 0.5f;
+                    const float wy = (float)py + 0.5f;
+                    const float nx = wx / dstW;
+                    const float ny = wy / dstH;
 
-                const tcu::Vec4 coord(projectedTriInterpolate(triS[triNdx], triW[triNdx], triNx, triNy),
-                                      projectedTriInterpolate(triT[triNdx], triW[triNdx], triNx, triNy),
-                                      projectedTriInterpolate(triR[triNdx], triW[triNdx], triNx, triNy),
-                                      projectedTriInterpolate(triQ[triNdx], triW[triNdx], triNx, triNy));
-                const tcu::Vec3 coordDx(triDerivateX(triS[triNdx], triW[triNdx], wx, dstW, triNy),
-                                        triDerivateX(triT[triNdx], triW[triNdx], wx, dstW, triNy),
-                                        triDerivateX(triR[triNdx], triW[triNdx], wx, dstW, triNy));
-                const tcu::Vec3 coordDy(triDerivateY(triS[triNdx], triW[triNdx], wy, dstH, triNx),
-                                        triDerivateY(triT[triNdx], triW[triNdx], wy, dstH, triNx),
-                                        triDerivateY(triR[triNdx], triW[triNdx], wy, dstH, triNx));
+                    const int triNdx  = nx + ny >= 1.0f ? 1 : 0;
+                    const float triWx = triNdx ? dstW - wx : wx;
+                    const float triWy = triNdx ? dstH - wy : wy;
+                    const float triNx = triNdx ? 1.0f - nx : nx;
+                    const float triNy = triNdx ? 1.0f - ny : ny;
 
-                tcu::Vec2 lodBounds =
-                    tcu::computeCubeLodBoundsFromDerivates(coord.swizzle(0, 1, 2), coordDx, coordDy, srcSize, lodPrec);
+                    const tcu::Vec4 coord(projectedTriInterpolate(triS[triNdx], triW[triNdx], triNx, triNy),
+                                          projectedTriInterpolate(triT[triNdx], triW[triNdx], triNx, triNy),
+                                          projectedTriInterpolate(triR[triNdx], triW[triNdx], triNx, triNy),
+                                          projectedTriInterpolate(triQ[triNdx], triW[triNdx], triNx, triNy));
+                    const tcu::Vec3 coordDx(triDerivateX(triS[triNdx], triW[triNdx], wx, dstW, triNy),
+                                            triDerivateX(triT[triNdx], triW[triNdx], wx, dstW, triNy),
+                                            triDerivateX(triR[triNdx], triW[triNdx], wx, dstW, triNy));
+                    const tcu::Vec3 coordDy(triDerivateY(triS[triNdx], triW[triNdx], wy, dstH, triNx),
+                                            triDerivateY(triT[triNdx], triW[triNdx], wy, dstH, triNx),
+                                            triDerivateY(triR[triNdx], triW[triNdx], wy, dstH, triNx));
 
-                // Compute lod bounds across lodOffsets range.
-                for (int lodOffsNdx = 0; lodOffsNdx < DE_LENGTH_OF_ARRAY(lodOffsets); lodOffsNdx++)
-                {
-                    const float wxo = triWx + lodOffsets[lodOffsNdx].x();
-                    const float wyo = triWy + lodOffsets[lodOffsNdx].y();
-                    const float nxo = wxo / dstW;
-                    const float nyo = wyo / dstH;
+                    tcu::Vec2 lodBounds = tcu::computeCubeLodBoundsFromDerivates(coord.swizzle(0, 1, 2), coordDx,
+                                                                                 coordDy, srcSize, lodPrec);
 
-                    const tcu::Vec3 coordO(projectedTriInterpolate(triS[triNdx], triW[triNdx], nxo, nyo),
-                                           projectedTriInterpolate(triT[triNdx], triW[triNdx], nxo, nyo),
-                                           projectedTriInterpolate(triR[triNdx], triW[triNdx], nxo, nyo));
-                    const tcu::Vec3 coordDxo(triDerivateX(triS[triNdx], triW[triNdx], wxo, dstW, nyo),
-                                             triDerivateX(triT[triNdx], triW[triNdx], wxo, dstW, nyo),
-                                             triDerivateX(triR[triNdx], triW[triNdx], wxo, dstW, nyo));
-                    const tcu::Vec3 coordDyo(triDerivateY(triS[triNdx], triW[triNdx], wyo, dstH, nxo),
-                                             triDerivateY(triT[triNdx], triW[triNdx], wyo, dstH, nxo),
-                                             triDerivateY(triR[triNdx], triW[triNdx], wyo, dstH, nxo));
-                    const tcu::Vec2 lodO =
-                        tcu::computeCubeLodBoundsFromDerivates(coordO, coordDxo, coordDyo, srcSize, lodPrec);
+                    // Compute lod bounds across lodOffsets range.
+                    for (int lodOffsNdx = 0; lodOffsNdx < DE_LENGTH_OF_ARRAY(lodOffsets); lodOffsNdx++)
+                    {
+                        const float wxo = triWx + lodOffsets[lodOffsNdx].x();
+                        const float wyo = triWy + lodOffsets[lodOffsNdx].y();
+                        const float nxo = wxo / dstW;
+                        const float nyo = wyo / dstH;
 
-                    lodBounds.x() = de::min(lodBounds.x(), lodO.x());
-                    lodBounds.y() = de::max(lodBounds.y(), lodO.y());
-                }
+                        const tcu::Vec3 coordO(projectedTriInterpolate(triS[triNdx], triW[triNdx], nxo, nyo),
+                                               projectedTriInterpolate(triT[triNdx], triW[triNdx], nxo, nyo),
+                                               projectedTriInterpolate(triR[triNdx], triW[triNdx], nxo, nyo));
+                        const tcu::Vec3 coordDxo(triDerivateX(triS[triNdx], triW[triNdx], wxo, dstW, nyo),
+                                                 triDerivateX(triT[triNdx], triW[triNdx], wxo, dstW, nyo),
+                                                 triDerivateX(triR[triNdx], triW[triNdx], wxo, dstW, nyo));
+                        const tcu::Vec3 coordDyo(triDerivateY(triS[triNdx], triW[triNdx], wyo, dstH, nxo),
+                                                 triDerivateY(triT[triNdx], triW[triNdx], wyo, dstH, nxo),
+                                                 triDerivateY(triR[triNdx], triW[triNdx], wyo, dstH, nxo));
+                        const tcu::Vec2 lodO =
+                            tcu::computeCubeLodBoundsFromDerivates(coordO, coordDxo, coordDyo, srcSize, lodPrec);
 
-                const tcu::Vec2 clampedLod = tcu::clampLodBounds(
-                    lodBounds + lodBias, tcu::Vec2(sampleParams.minLod, sampleParams.maxLod), lodPrec);
-                const bool isOk = tcu::isTexCompareResultValid(src, sampleParams.sampler, comparePrec, coord,
-                                                               clampedLod, sampleParams.ref, resPix.x());
+                        lodBounds.x() = de::min(lodBounds.x(), lodO.x());
+                        lodBounds.y() = de::max(lodBounds.y(), lodO.y());
+                    }
 
-                if (!isOk)
-                {
-                    errorMask.setPixel(tcu::RGBA::red().toVec(), px, py);
-                    numFailed += 1;
+                    const tcu::Vec2 clampedLod = tcu::clampLodBounds(
+                        lodBounds + lodBias, tcu::Vec2(sampleParams.minLod, sampleParams.maxLod), lodPrec);
+                    const bool isOk = tcu::isTexCompareResultValid(src, sampleParams.sampler, comparePrec, coord,
+                                                                   clampedLod, sampleParams.ref, resPix.x());
+
+                    if (!isOk)
+                    {
+                        errorMask.setPixel(tcu::RGBA::red().toVec(), px, py);
+                        numFailed += 1;
+                    }
                 }
             }
         }
-    }
 
-    return numFailed;
+        return numFailed;
+    };
+
+    return tcu::parallelSum(result.getHeight(), VERIFY_ROWS_PER_RANGE, verifyRows, sampleParams.numThreads);
 }
 
 // Mipmap generation comparison.
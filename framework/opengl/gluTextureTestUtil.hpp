@@ -131,6 +131,7 @@ struct ReferenceParams : public RenderParams
         , imageViewMinLod(0.0f)
         , imageViewMinLodMode(tcu::IMAGEVIEWMINLODMODE_PREFERRED)
         , lodTexelFetch(0)
+        , numThreads(1)
     {
     }
 
@@ -147,6 +148,7 @@ struct ReferenceParams : public RenderParams
         , imageViewMinLod(0.0f)
         , imageViewMinLodMode(tcu::IMAGEVIEWMINLODMODE_PREFERRED)
         , lodTexelFetch(0)
+        , numThreads(1)
     {
     }
 
@@ -161,6 +163,7 @@ struct ReferenceParams : public RenderParams
     float imageViewMinLod;
     tcu::ImageViewMinLodMode imageViewMinLodMode;
     int lodTexelFetch;
+    int numThreads; //!< Threads used by computeTexture*Diff() verifiers, 0 = all cores. Result doesn't depend on it.
 };
 
 SamplerType getSamplerType(tcu::TextureFormat format);
@@ -277,6 +277,7 @@ ReferenceContextLimits::ReferenceContextLimits(const glu::RenderContext &renderC
     , maxRenderbufferSize(0)
     , maxVertexAttribs(0)
     , subpixelBits(0)
+    , numRendererThreads(1)
 {
     const glw::Functions &gl = renderCtx.getFunctions();
 
@@ -4590,7 +4591,7 @@ void ReferenceContext::drawWithReference(const rr::PrimitiveList &primitives, in
                                                              (DE_NULL));
     rr::RenderState state((rr::ViewportState)(colorBuf0), m_limits.subpixelBits);
 
-    const rr::Renderer referenceRenderer;
+    const rr::Renderer referenceRenderer(m_limits.numRendererThreads);
     std::vector<rr::VertexAttrib> vertexAttribs;
 
     // Gen state
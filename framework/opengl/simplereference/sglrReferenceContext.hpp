@@ -743,6 +743,7 @@ struct ReferenceContextLimits
         , maxRenderbufferSize(2048)
         , maxVertexAttribs(16)
         , subpixelBits(rr::RenderState::DEFAULT_SUBPIXEL_BITS)
+        , numRendererThreads(1)
     {
     }
 
@@ -760,6 +761,8 @@ struct ReferenceContextLimits
     int maxRenderbufferSize;
     int maxVertexAttribs;
     int subpixelBits;
+    int numRendererThreads; //!< Reference renderer threads, 0 = all cores. Only for shader programs that don't
+                            //!< modify any state while shading, see rr::Renderer.
 
     // Both variants are needed since there are glGetString() and glGetStringi()
     std::vector<std::string> extensionList;
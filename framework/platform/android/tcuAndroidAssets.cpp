@@ -23,6 +23,9 @@
 
 #include "tcuAndroidAssets.hpp"
 
+#include <sys/mman.h>
+#include <unistd.h>
+
 namespace tcu
 {
 namespace Android
@@ -41,19 +44,65 @@ Resource *AssetArchive::getResource(const char *name) const
     return new AssetResource(m_assetMgr, name);
 }
 
-AssetResource::AssetResource(AAssetManager *assetMgr, const char *name) : Resource(name), m_asset(DE_NULL)
+Resource *AssetArchive::getMappedResource(const char *name) const
+{
+    return new AssetResource(m_assetMgr, name, true);
+}
+
+AssetResource::AssetResource(AAssetManager *assetMgr, const char *name, bool mapped)
+    : Resource(name)
+    , m_asset(DE_NULL)
+    , m_mapping(DE_NULL)
+    , m_mappingSize(0)
+    , m_mappedData(DE_NULL)
 {
     m_asset = AAssetManager_open(assetMgr, name, AASSET_MODE_RANDOM);
 
     if (!m_asset)
         throw ResourceError("Failed to open asset resource", name, __FILE__, __LINE__);
+
+    if (mapped)
+        map();
 }
 
 AssetResource::~AssetResource(void)
 {
+    if (m_mapping)
+        munmap(m_mapping, m_mappingSize);
+
     AAsset_close(m_asset);
 }
 
+void AssetResource::map(void)
+{
+    // Only uncompressed assets have a file descriptor. Compressed assets are not mapped, since
+    // AAsset_getBuffer() would inflate the whole asset into memory; they are read on demand instead.
+    off64_t start  = 0;
+    off64_t length = 0;
+    const int fd   = AAsset_openFileDescriptor64(m_asset, &start, &length);
+
+    if (fd < 0)
+        return;
+
+    if (length > 0)
+    {
+        const off64_t pageSize     = (off64_t)sysconf(_SC_PAGESIZE);
+        const off64_t alignedStart = start - start % pageSize;
+        const size_t mappingSize   = (size_t)(start - alignedStart + length);
+        void *const mapping        = mmap64(DE_NULL, mappingSize, PROT_READ, MAP_PRIVATE, fd, alignedStart);
+
+        if (mapping != MAP_FAILED)
+        {
+            m_mapping     = mapping;
+            m_mappingSize = mappingSize;
+            m_mappedData  = (const uint8_t *)mapping + (start - alignedStart);
+        }
+    }
+
+    // Mapping stays valid after the descriptor is closed
+    close(fd);
+}
+
 void AssetResource::read(uint8_t *dst, int numBytes)
 {
     TCU_CHECK(AAsset_read(m_asset, dst, numBytes) == numBytes);
@@ -79,5 +128,21 @@ int AssetResource::getSize(void) const
     return (int)AAsset_getLength(m_asset);
 }
 
+const uint8_t *AssetResource::getMappedData(void) const
+{
+    return m_mappedData;
+}
+
+int64_t AssetResource::getSize64(void) const
+{
+    return (int64_t)AAsset_getLength64(m_asset);
+}
+
+void AssetResource::readAt(int64_t offset, uint8_t *dst, int numBytes)
+{
+    TCU_CHECK(AAsset_seek64(m_asset, (off64_t)offset, SEEK_SET) == (off64_t)offset);
+    read(dst, numBytes);
+}
+
 } // namespace Android
 } // namespace tcu
@@ -40,6 +40,7 @@ public:
     ~AssetArchive(void);
 
     Resource *getResource(const char *name) const;
+    Resource *getMappedResource(const char *name) const;
 
 private:
     AAssetManager *m_assetMgr;
@@ -48,7 +49,7 @@ private:
 class AssetResource : public Resource
 {
 public:
-    AssetResource(AAssetManager *assetMgr, const char *name);
+    AssetResource(AAssetManager *assetMgr, const char *name, bool mapped = false);
     ~AssetResource(void);
 
     void read(uint8_t *dst, int numBytes);
@@ -56,12 +57,20 @@ public:
     void setPosition(int position);
     bool isFinished(void) const;
     int getSize(void) const;
+    const uint8_t *getMappedData(void) const;
+    int64_t getSize64(void) const;
+    void readAt(int64_t offset, uint8_t *dst, int numBytes);
 
 private:
     AssetResource(const AssetResource &other);
     AssetResource operator=(const AssetResource &other);
 
+    void map(void);
+
     AAsset *m_asset;
+    void *m_mapping; //!< Page-aligned mapping of the package covering the asset, or null
+    size_t m_mappingSize;
+    const uint8_t *m_mappedData;
 };
 
 } // namespace Android
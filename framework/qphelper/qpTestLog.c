@@ -31,6 +31,9 @@
 #include "deString.h"
 
 #include "deMutex.h"
+#include "deSemaphore.h"
+#include "deThread.h"
+#include "deAtomic.h"
 
 #include "deClock.h"
 
@@ -123,6 +126,380 @@ DE_INLINE ContainerType ContainerStack_getTop(const ContainerStack *stack)
 
 #endif
 
+/* Asynchronous output (QP_TEST_LOG_ASYNC_WRITE).
+ *
+ * Log output is formatted into chunks by the logging thread, and full chunks
+ * are passed to a writer thread through a single-producer single-consumer
+ * ring. All producers hold the log lock, so pushing a chunk only has to wait
+ * for the writer thread when the ring is full. Chunks are consumed while
+ * holding writeLock, which allows another thread to drain the ring, for
+ * example when terminating a case from the crash handler.
+ *
+ * PNG images are encoded by a pool of encoder threads. The ring holds a
+ * placeholder chunk for each image, and the writer thread waits for the
+ * image when it reaches the placeholder, so output order is unchanged.
+ * Images are waited for without holding writeLock, and the crash handler
+ * leaves out images that are still being encoded instead of waiting, so a
+ * crashed or hung encoder can't block writing out the log. */
+
+enum
+{
+    ASYNC_RING_SIZE           = 256,
+    ASYNC_CHUNK_SIZE          = 64 * 1024,
+    MAX_PENDING_IMAGES        = 32,
+    MAX_IMAGE_ENCODER_THREADS = 8
+};
+
+typedef struct ImageJob_s ImageJob;
+typedef struct ImageEncoder_s ImageEncoder;
+
+typedef struct LogChunk_s
+{
+    char *data;
+    size_t size;
+    size_t capacity;
+    bool flush;      /*!< Flush file after writing the chunk.                     */
+    ImageJob *image; /*!< If set, chunk is a placeholder for output of image job. */
+} LogChunk;
+
+/* Image encoded by image encoder threads. */
+struct ImageJob_s
+{
+    char *name;
+    char *description;
+    qpImageFormat imageFormat;
+    int width;
+    int height;
+    uint8_t *pixels; /*!< Tightly packed copy of the image. */
+    int pngCompressionLevel;
+    qpPngFilter pngFilter;
+
+    qpXmlWriter *writer;  /*!< Fragment writer writing into output.                */
+    LogChunk output;      /*!< Image element, valid once done has been signaled. */
+    deSemaphore done;     /*!< Signaled once by encoder thread.                  */
+    volatile bool isDone; /*!< Set before done is signaled.                      */
+
+    ImageJob *next;
+};
+
+typedef struct AsyncWriter_s
+{
+    FILE *outputFile;
+    deThread thread;
+
+    deMutex consumeLock;       /*!< Serializes consumers other than crash handler. */
+    deMutex writeLock;         /*!< Held while consuming chunks.                  */
+    deSemaphore numFullSlots;  /*!< Signaled once for each pushed chunk.          */
+    deSemaphore numEmptySlots; /*!< Signaled once for each consumed chunk.        */
+
+    volatile uint32_t head; /*!< Number of pushed chunks, written by producer. */
+    volatile uint32_t tail; /*!< Number of consumed chunks.                    */
+    LogChunk *slots[ASYNC_RING_SIZE];
+
+    LogChunk *current; /*!< Chunk being filled by producer.               */
+
+    volatile bool isDirect; /*!< Output is written on producer thread without allocating, set after crash. */
+
+    deSemaphore numFreeImages; /*!< Limits memory used by pending image jobs.      */
+} AsyncWriter;
+
+static void ImageJob_destroy(ImageJob *job);
+static ImageEncoder *ImageEncoder_create(void);
+static void ImageEncoder_destroy(ImageEncoder *encoder);
+
+static void LogChunk_destroy(LogChunk *chunk)
+{
+    if (chunk)
+    {
+        if (chunk->image)
+            ImageJob_destroy(chunk->image);
+
+        deFree(chunk->data);
+        deFree(chunk);
+    }
+}
+
+static bool LogChunk_append(LogChunk *chunk, const char *data, size_t numBytes)
+{
+    if (chunk->size + numBytes > chunk->capacity)
+    {
+        size_t newCapacity = chunk->size + numBytes;
+        char *newData;
+
+        if (newCapacity < ASYNC_CHUNK_SIZE)
+            newCapacity = ASYNC_CHUNK_SIZE;
+
+        newData = (char *)deRealloc(chunk->data, newCapacity);
+
+        if (!newData)
+            return false;
+
+        chunk->data     = newData;
+        chunk->capacity = newCapacity;
+    }
+
+    deMemcpy(chunk->data + chunk->size, data, numBytes);
+    chunk->size += numBytes;
+
+    return true;
+}
+
+/* Writes out all chunks in the ring. Returns false if termination chunk was consumed.
+ *
+ * Other callers than crash handler must hold consumeLock. From crash handler,
+ * images that are still being encoded are left out and chunks are not freed. */
+static bool AsyncWriter_consume(AsyncWriter *writer, bool fromCrashHandler)
+{
+    bool doFlush   = false;
+    bool terminate = false;
+
+    deMutex_lock(writer->writeLock);
+
+    while (writer->tail != writer->head)
+    {
+        const uint32_t tail = writer->tail;
+        LogChunk *chunk;
+
+        /* Slot is written before head is incremented. */
+        deMemoryReadWriteFence();
+        chunk = writer->slots[tail % ASYNC_RING_SIZE];
+
+        if (chunk && chunk->image)
+        {
+            ImageJob *const job = chunk->image;
+
+            if (!fromCrashHandler)
+            {
+                deMutex_unlock(writer->writeLock);
+                deSemaphore_decrement(job->done);
+                deMutex_lock(writer->writeLock);
+
+                /* Crash handler may have consumed the chunk in the meantime. */
+                if (writer->tail != tail)
+                    continue;
+            }
+
+            /* Images are written out in submission order. */
+            if (job->isDone)
+            {
+                deMemoryReadWriteFence();
+                fwrite(job->output.data, 1, job->output.size, writer->outputFile);
+            }
+
+            deSemaphore_increment(writer->numFreeImages);
+        }
+        else if (chunk)
+        {
+            fwrite(chunk->data, 1, chunk->size, writer->outputFile);
+            doFlush = doFlush || chunk->flush;
+        }
+        else
+            terminate = true;
+
+        writer->tail += 1;
+        deSemaphore_increment(writer->numEmptySlots);
+
+        if (!fromCrashHandler)
+            LogChunk_destroy(chunk);
+
+        if (terminate)
+            break;
+    }
+
+    if (doFlush)
+        fflush(writer->outputFile);
+
+    deMutex_unlock(writer->writeLock);
+
+    return !terminate;
+}
+
+static void asyncWriterThread(void *arg)
+{
+    AsyncWriter *writer = (AsyncWriter *)arg;
+    bool keepRunning    = true;
+
+    while (keepRunning)
+    {
+        deSemaphore_decrement(writer->numFullSlots);
+
+        deMutex_lock(writer->consumeLock);
+        keepRunning = AsyncWriter_consume(writer, false);
+        deMutex_unlock(writer->consumeLock);
+    }
+}
+
+static void AsyncWriter_push(AsyncWriter *writer, LogChunk *chunk)
+{
+    deSemaphore_decrement(writer->numEmptySlots);
+
+    writer->slots[writer->head % ASYNC_RING_SIZE] = chunk;
+    deMemoryReadWriteFence();
+    deAtomicIncrementUint32(&writer->head);
+
+    deSemaphore_increment(writer->numFullSlots);
+}
+
+/* Writes out all pending output followed by data on the calling thread. */
+static void AsyncWriter_writeDirect(AsyncWriter *writer, const char *data, size_t numBytes, bool fromCrashHandler)
+{
+    /* Writer thread may be waiting for an image while holding consumeLock. */
+    if (!fromCrashHandler)
+        deMutex_lock(writer->consumeLock);
+
+    AsyncWriter_consume(writer, fromCrashHandler);
+
+    deMutex_lock(writer->writeLock);
+
+    if (writer->current)
+    {
+        fwrite(writer->current->data, 1, writer->current->size, writer->outputFile);
+        writer->current->size = 0;
+    }
+
+    if (numBytes > 0)
+        fwrite(data, 1, numBytes, writer->outputFile);
+
+    fflush(writer->outputFile);
+
+    deMutex_unlock(writer->writeLock);
+
+    if (!fromCrashHandler)
+        deMutex_unlock(writer->consumeLock);
+}
+
+/* Writes out pending output and switches to writing all further output directly on the calling thread.
+ *
+ * Used from crash handler, so nothing is allocated or freed afterwards. */
+static void AsyncWriter_beginDirectOutput(AsyncWriter *writer)
+{
+    AsyncWriter_writeDirect(writer, NULL, 0, true);
+    writer->isDirect = true;
+}
+
+/* Pushes the current chunk to the writer thread. */
+static void AsyncWriter_submit(AsyncWriter *writer, bool flush)
+{
+    if (writer->isDirect)
+    {
+        if (flush)
+        {
+            deMutex_lock(writer->writeLock);
+            fflush(writer->outputFile);
+            deMutex_unlock(writer->writeLock);
+        }
+        return;
+    }
+
+    if (!writer->current && flush)
+        writer->current = (LogChunk *)deCalloc(sizeof(LogChunk));
+
+    if (writer->current)
+    {
+        writer->current->flush = flush;
+        AsyncWriter_push(writer, writer->current);
+        writer->current = NULL;
+    }
+    else if (flush)
+        AsyncWriter_writeDirect(writer, NULL, 0, false); /* Out of memory. */
+}
+
+static void AsyncWriter_append(void *userPtr, const char *data, size_t numBytes)
+{
+    AsyncWriter *writer = (AsyncWriter *)userPtr;
+
+    if (writer->isDirect)
+    {
+        deMutex_lock(writer->writeLock);
+        fwrite(data, 1, numBytes, writer->outputFile);
+        deMutex_unlock(writer->writeLock);
+        return;
+    }
+
+    if (!writer->current)
+        writer->current = (LogChunk *)deCalloc(sizeof(LogChunk));
+
+    if (writer->current && LogChunk_append(writer->current, data, numBytes))
+    {
+        if (writer->current->size >= ASYNC_CHUNK_SIZE)
+            AsyncWriter_submit(writer, false);
+    }
+    else
+    {
+        /* Out of memory, so data is written on this thread after everything pending. */
+        AsyncWriter_writeDirect(writer, data, numBytes, false);
+    }
+}
+
+/* Pushes placeholder for image job output. Returns false on allocation failure. */
+static bool AsyncWriter_submitImage(AsyncWriter *writer, ImageJob *job)
+{
+    LogChunk *chunk = (LogChunk *)deCalloc(sizeof(LogChunk));
+    if (!chunk)
+        return false;
+
+    chunk->image = job;
+
+    AsyncWriter_submit(writer, false);
+    AsyncWriter_push(writer, chunk);
+
+    return true;
+}
+
+static void AsyncWriter_destroy(AsyncWriter *writer)
+{
+    if (writer->thread)
+    {
+        /* Null chunk terminates the writer thread after everything has been written. */
+        AsyncWriter_submit(writer, true);
+        AsyncWriter_push(writer, NULL);
+
+        deThread_join(writer->thread);
+        deThread_destroy(writer->thread);
+    }
+
+    LogChunk_destroy(writer->current);
+
+    if (writer->consumeLock)
+        deMutex_destroy(writer->consumeLock);
+    if (writer->writeLock)
+        deMutex_destroy(writer->writeLock);
+    if (writer->numFullSlots)
+        deSemaphore_destroy(writer->numFullSlots);
+    if (writer->numEmptySlots)
+        deSemaphore_destroy(writer->numEmptySlots);
+    if (writer->numFreeImages)
+        deSemaphore_destroy(writer->numFreeImages);
+
+    deFree(writer);
+}
+
+static AsyncWriter *AsyncWriter_create(FILE *outputFile)
+{
+    AsyncWriter *writer = (AsyncWriter *)deCalloc(sizeof(AsyncWriter));
+    if (!writer)
+        return NULL;
+
+    writer->outputFile    = outputFile;
+    writer->consumeLock   = deMutex_create(NULL);
+    writer->writeLock     = deMutex_create(NULL);
+    writer->numFullSlots  = deSemaphore_create(0, NULL);
+    writer->numEmptySlots = deSemaphore_create(ASYNC_RING_SIZE, NULL);
+    writer->numFreeImages = deSemaphore_create(MAX_PENDING_IMAGES, NULL);
+
+    if (writer->consumeLock && writer->writeLock && writer->numFullSlots && writer->numEmptySlots &&
+        writer->numFreeImages)
+        writer->thread = deThread_create(asyncWriterThread, writer, NULL);
+
+    if (!writer->thread)
+    {
+        AsyncWriter_destroy(writer);
+        return NULL;
+    }
+
+    return writer;
+}
+
 /* qpTestLog instance */
 struct qpTestLog_s
 {
@@ -132,7 +509,11 @@ struct qpTestLog_s
 
     /* State protected by lock. */
     FILE *outputFile;
+    AsyncWriter *asyncWriter;   /*!< Non-null if QP_TEST_LOG_ASYNC_WRITE is set. */
+    ImageEncoder *imageEncoder; /*!< Non-null if QP_TEST_LOG_ASYNC_WRITE is set. */
     qpXmlWriter *writer;
+    int pngCompressionLevel;
+    qpPngFilter pngFilter;
     bool isSessionOpen;
     bool isCaseOpen;
 
@@ -241,9 +622,26 @@ static const qpKeyStringMap s_qpShaderTypeMap[] = {{QP_SHADER_TYPE_VERTEX, "Vert
 
 DE_STATIC_ASSERT(DE_LENGTH_OF_ARRAY(s_qpShaderTypeMap) == QP_SHADER_TYPE_LAST + 1);
 
+static void qpTestLog_writeOutput(qpTestLog *log, const char *str)
+{
+    if (log->flags & QP_TEST_LOG_BINARY_FORMAT)
+        qpXmlWriter_writeRaw(log->writer, str);
+    else if (log->asyncWriter)
+        AsyncWriter_append(log->asyncWriter, str, strlen(str));
+    else
+        fputs(str, log->outputFile);
+}
+
 static void qpTestLog_flushFile(qpTestLog *log)
 {
     DE_ASSERT(log && log->outputFile);
+
+    if (log->asyncWriter)
+    {
+        AsyncWriter_submit(log->asyncWriter, true);
+        return;
+    }
+
     fflush(log->outputFile);
 #if (DE_OS == DE_OS_WIN32) && (DE_COMPILER == DE_COMPILER_MSC)
     /* \todo [petri] Is this really necessary? */
@@ -292,11 +690,13 @@ static bool endSession(qpTestLog *log)
     qpXmlWriter_flush(log->writer);
 
     uint64_t duration = deGetMicroseconds() - sessionStartTime;
+    char durationStr[64];
 
-    fprintf(log->outputFile, "\nRun took %.2f seconds\n", (float)duration / 1000000.0f);
+    deSprintf(durationStr, sizeof(durationStr), "\nRun took %.2f seconds\n", (float)duration / 1000000.0f);
+    qpTestLog_writeOutput(log, durationStr);
 
     /* Write out #endSession. */
-    fprintf(log->outputFile, "\n#endSession\n");
+    qpTestLog_writeOutput(log, "\n#endSession\n");
     qpTestLog_flushFile(log);
 
     log->isSessionOpen = false;
@@ -334,11 +734,34 @@ qpTestLog *qpTestLog_createFileLog(const char *fileName, uint32_t flags)
     }
 
     log->flags         = flags;
-    log->writer        = qpXmlWriter_createFileWriter(log->outputFile, 0, !(flags & QP_TEST_LOG_NO_FLUSH));
     log->lock          = deMutex_create(NULL);
     log->isSessionOpen = false;
     log->isCaseOpen    = false;
 
+    log->pngCompressionLevel = -1;
+    log->pngFilter           = QP_PNG_FILTER_DEFAULT;
+
+    if (flags & QP_TEST_LOG_ASYNC_WRITE)
+    {
+        log->asyncWriter = AsyncWriter_create(log->outputFile);
+        if (!log->asyncWriter)
+        {
+            qpPrintf("ERROR: Unable to create log writer thread.\n");
+            qpTestLog_destroy(log);
+            return NULL;
+        }
+
+        log->writer = qpXmlWriter_createCallbackWriter(AsyncWriter_append, log->asyncWriter);
+
+#if defined(QP_SUPPORT_PNG)
+        log->imageEncoder = ImageEncoder_create();
+        if (!log->imageEncoder)
+            qpPrintf("WARNING: Unable to create image encoder threads.\n");
+#endif
+    }
+    else
+        log->writer = qpXmlWriter_createFileWriter(log->outputFile, 0, !(flags & QP_TEST_LOG_NO_FLUSH));
+
     if (!log->writer)
     {
         qpPrintf("ERROR: Unable to create output XML writer to file '%s'.\n", fileName);
@@ -346,6 +769,9 @@ qpTestLog *qpTestLog_createFileLog(const char *fileName, uint32_t flags)
         return NULL;
     }
 
+    if (flags & QP_TEST_LOG_BINARY_FORMAT)
+        qpXmlWriter_setBinaryFormat(log->writer);
+
     if (!log->lock)
     {
         qpPrintf("ERROR: Unable to create mutex.\n");
@@ -370,21 +796,34 @@ bool qpTestLog_beginSession(qpTestLog *log, const char *additionalSessionInfo)
         return true;
 
     /* Write session info. */
-    fprintf(log->outputFile, "#sessionInfo releaseName %s\n", qpGetReleaseName());
-    fprintf(log->outputFile, "#sessionInfo releaseId 0x%08x\n", qpGetReleaseId());
-    fprintf(log->outputFile, "#sessionInfo targetName \"%s\"\n", qpGetTargetName());
+    char releaseIdStr[64];
+    deSprintf(releaseIdStr, sizeof(releaseIdStr), "#sessionInfo releaseId 0x%08x\n", qpGetReleaseId());
+
+    qpTestLog_writeOutput(log, "#sessionInfo releaseName ");
+    qpTestLog_writeOutput(log, qpGetReleaseName());
+    qpTestLog_writeOutput(log, "\n");
+    qpTestLog_writeOutput(log, releaseIdStr);
+    qpTestLog_writeOutput(log, "#sessionInfo targetName \"");
+    qpTestLog_writeOutput(log, qpGetTargetName());
+    qpTestLog_writeOutput(log, "\"\n");
     char *compactStr = "";
     if (qpTestLog_isCompact(log))
     {
         compactStr = "-compact";
     }
-    fprintf(log->outputFile, "#sessionInfo logFormatVersion \"%s%s\"\n", LOG_FORMAT_VERSION, compactStr);
+    qpTestLog_writeOutput(log, "#sessionInfo logFormatVersion \"");
+    qpTestLog_writeOutput(log, LOG_FORMAT_VERSION);
+    qpTestLog_writeOutput(log, compactStr);
+    qpTestLog_writeOutput(log, "\"\n");
 
     if (strlen(additionalSessionInfo) > 1)
-        fprintf(log->outputFile, "%s\n", additionalSessionInfo);
+    {
+        qpTestLog_writeOutput(log, additionalSessionInfo);
+        qpTestLog_writeOutput(log, "\n");
+    }
 
     /* Write out #beginSession. */
-    fprintf(log->outputFile, "#beginSession\n");
+    qpTestLog_writeOutput(log, "#beginSession\n");
     qpTestLog_flushFile(log);
     sessionStartTime = deGetMicroseconds();
 
@@ -407,6 +846,13 @@ void qpTestLog_destroy(qpTestLog *log)
     if (log->writer)
         qpXmlWriter_destroy(log->writer);
 
+    /* Writes out all remaining output. Writer thread waits for pending images. */
+    if (log->asyncWriter)
+        AsyncWriter_destroy(log->asyncWriter);
+
+    if (log->imageEncoder)
+        ImageEncoder_destroy(log->imageEncoder);
+
     if (log->outputFile)
         fclose(log->outputFile);
 
@@ -439,7 +885,9 @@ bool qpTestLog_startCase(qpTestLog *log, const char *testCasePath, qpTestCaseTyp
     qpXmlWriter_flush(log->writer);
     if (!qpTestLog_isCompact(log))
     {
-        fprintf(log->outputFile, "\n#beginTestCaseResult %s\n", testCasePath);
+        qpTestLog_writeOutput(log, "\n#beginTestCaseResult ");
+        qpTestLog_writeOutput(log, testCasePath);
+        qpTestLog_writeOutput(log, "\n");
     }
     if (!(log->flags & QP_TEST_LOG_NO_FLUSH))
         qpTestLog_flushFile(log);
@@ -500,7 +948,7 @@ bool qpTestLog_endCase(qpTestLog *log, qpTestResult result, const char *resultDe
     qpXmlWriter_flush(log->writer);
     if (!qpTestLog_isCompact(log))
     {
-        fprintf(log->outputFile, "\n#endTestCaseResult\n");
+        qpTestLog_writeOutput(log, "\n#endTestCaseResult\n");
     }
     if (!(log->flags & QP_TEST_LOG_NO_FLUSH))
         qpTestLog_flushFile(log);
@@ -518,7 +966,7 @@ bool qpTestLog_startTestsCasesTime(qpTestLog *log)
 
     /* Flush XML and write out #beginTestCaseResult. */
     qpXmlWriter_flush(log->writer);
-    fprintf(log->outputFile, "\n#beginTestsCasesTime\n");
+    qpTestLog_writeOutput(log, "\n#beginTestsCasesTime\n");
 
     log->isCaseOpen = true;
 
@@ -550,7 +998,7 @@ bool qpTestLog_endTestsCasesTime(qpTestLog *log)
 
     qpXmlWriter_flush(log->writer);
 
-    fprintf(log->outputFile, "\n#endTestsCasesTime\n");
+    qpTestLog_writeOutput(log, "\n#endTestsCasesTime\n");
 
     log->isCaseOpen = false;
 
@@ -567,6 +1015,7 @@ bool qpTestLog_endTestsCasesTime(qpTestLog *log)
 bool qpTestLog_terminateCase(qpTestLog *log, qpTestResult result)
 {
     const char *resultStr = QP_LOOKUP_STRING(s_qpTestResultMap, result);
+    const bool isCrash    = result == QP_TEST_RESULT_CRASH;
 
     DE_ASSERT(log);
     DE_ASSERT(result == QP_TEST_RESULT_CRASH || result == QP_TEST_RESULT_TIMEOUT);
@@ -579,10 +1028,21 @@ bool qpTestLog_terminateCase(qpTestLog *log, qpTestResult result)
         return false; /* Soft error. This is called from error handler. */
     }
 
+    /* Crash is terminated from crash handler, which must not allocate memory. */
+    if (log->asyncWriter && isCrash)
+        AsyncWriter_beginDirectOutput(log->asyncWriter);
+
     /* Flush XML and write #terminateTestCaseResult. */
     qpXmlWriter_flush(log->writer);
-    fprintf(log->outputFile, "\n#terminateTestCaseResult %s\n", resultStr);
-    qpTestLog_flushFile(log);
+    qpTestLog_writeOutput(log, "\n#terminateTestCaseResult ");
+    qpTestLog_writeOutput(log, resultStr);
+    qpTestLog_writeOutput(log, "\n");
+
+    /* Process is about to exit, so output is written out on this thread. */
+    if (log->asyncWriter)
+        AsyncWriter_writeDirect(log->asyncWriter, NULL, 0, isCrash);
+    else
+        qpTestLog_flushFile(log);
 
     log->isCaseOpen = false;
 
@@ -594,6 +1054,48 @@ bool qpTestLog_terminateCase(qpTestLog *log, qpTestResult result)
     return true;
 }
 
+/*--------------------------------------------------------------------*//*!
+ * \brief Write out all buffered log output.
+ *
+ * With QP_TEST_LOG_ASYNC_WRITE pending output is written on the calling
+ * thread.
+ * \param log        qpTestLog instance
+ *//*--------------------------------------------------------------------*/
+void qpTestLog_flush(qpTestLog *log)
+{
+    DE_ASSERT(log);
+    deMutex_lock(log->lock);
+
+    if (log->asyncWriter)
+        AsyncWriter_writeDirect(log->asyncWriter, NULL, 0, false);
+    else
+        fflush(log->outputFile);
+
+    deMutex_unlock(log->lock);
+}
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Write out all buffered log output from crash handler.
+ *
+ * Like qpTestLog_flush(), but doesn't allocate or free memory. With
+ * QP_TEST_LOG_ASYNC_WRITE all further output is written directly on the
+ * calling thread, so logging from the crash handler doesn't allocate
+ * either.
+ * \param log        qpTestLog instance
+ *//*--------------------------------------------------------------------*/
+void qpTestLog_flushAfterCrash(qpTestLog *log)
+{
+    DE_ASSERT(log);
+    deMutex_lock(log->lock);
+
+    if (log->asyncWriter)
+        AsyncWriter_beginDirectOutput(log->asyncWriter);
+    else
+        fflush(log->outputFile);
+
+    deMutex_unlock(log->lock);
+}
+
 static bool qpTestLog_writeKeyValuePair(qpTestLog *log, const char *elementName, const char *name,
                                         const char *description, const char *unit, qpKeyValueTag tag, const char *text)
 {
@@ -748,13 +1250,33 @@ void pngFlushData(png_structp png)
 }
 
 static bool writeCompressedPNG(png_structp png, png_infop info, png_byte **rowPointers, int width, int height,
-                               int colorFormat)
+                               int colorFormat, int compressionLevel, qpPngFilter filter)
 {
     if (setjmp(png_jmpbuf(png)) == 0)
     {
         /* Write data. */
         png_set_IHDR(png, info, (png_uint_32)width, (png_uint_32)height, 8, colorFormat, PNG_INTERLACE_NONE,
                      PNG_COMPRESSION_TYPE_BASE, PNG_FILTER_TYPE_BASE);
+
+        if (compressionLevel >= 0)
+            png_set_compression_level(png, compressionLevel);
+
+        if (filter != QP_PNG_FILTER_DEFAULT)
+        {
+            static const int s_filters[] = {
+                0, /* QP_PNG_FILTER_DEFAULT */
+                PNG_FILTER_NONE,
+                PNG_FILTER_SUB,
+                PNG_FILTER_UP,
+                PNG_FILTER_AVG,
+                PNG_FILTER_PAETH,
+                PNG_FILTER_NONE | PNG_FILTER_SUB | PNG_FILTER_UP | PNG_FILTER_AVG | PNG_FILTER_PAETH,
+            };
+            DE_STATIC_ASSERT(DE_LENGTH_OF_ARRAY(s_filters) == QP_PNG_FILTER_LAST);
+
+            png_set_filter(png, PNG_FILTER_TYPE_BASE, s_filters[filter]);
+        }
+
         png_write_info(png, info);
         png_write_image(png, rowPointers);
         png_write_end(png, NULL);
@@ -766,7 +1288,7 @@ static bool writeCompressedPNG(png_structp png, png_infop info, png_byte **rowPo
 }
 
 static bool compressImagePNG(Buffer *buffer, qpImageFormat imageFormat, int width, int height, int rowStride,
-                             const void *data)
+                             const void *data, int compressionLevel, qpPngFilter filter)
 {
     bool compressOk        = false;
     png_structp png        = NULL;
@@ -795,7 +1317,7 @@ static bool compressImagePNG(Buffer *buffer, qpImageFormat imageFormat, int widt
         png_set_write_fn(png, buffer, pngWriteData, pngFlushData);
 
         compressOk = writeCompressedPNG(png, info, rowPointers, width, height,
-                                        hasAlpha ? PNG_COLOR_TYPE_RGBA : PNG_COLOR_TYPE_RGB);
+                                        hasAlpha ? PNG_COLOR_TYPE_RGBA : PNG_COLOR_TYPE_RGB, compressionLevel, filter);
     }
 
     /* Cleanup & return. */
@@ -812,6 +1334,336 @@ static bool compressImagePNG(Buffer *buffer, qpImageFormat imageFormat, int widt
 }
 #endif /* QP_SUPPORT_PNG */
 
+/* Encodes image using given compression mode. Encoded data is either the
+ * original data or stored in buffer. Compression mode is updated if PNG
+ * compression fails. */
+static bool encodeImage(Buffer *buffer, qpImageCompressionMode *compressionMode, qpImageFormat imageFormat,
+                        int width, int height, int stride, const void *data, int pngCompressionLevel,
+                        qpPngFilter pngFilter, const void **encodedData, size_t *encodedSize)
+{
+    const void *writeDataPtr = NULL;
+    size_t writeDataBytes    = ~(size_t)0;
+
+#if defined(QP_SUPPORT_PNG)
+    /* Try storing with PNG compression. */
+    if (*compressionMode == QP_IMAGE_COMPRESSION_MODE_PNG)
+    {
+        bool compressOk =
+            compressImagePNG(buffer, imageFormat, width, height, stride, data, pngCompressionLevel, pngFilter);
+        if (compressOk)
+        {
+            writeDataPtr   = buffer->data;
+            writeDataBytes = buffer->size;
+        }
+        else
+        {
+            /* Fall-back to default compression. */
+            qpPrintf("WARNING: PNG compression failed -- storing image uncompressed.\n");
+            *compressionMode = QP_IMAGE_COMPRESSION_MODE_NONE;
+        }
+    }
+#else
+    DE_UNREF(pngCompressionLevel);
+    DE_UNREF(pngFilter);
+#endif
+
+    /* Handle image compression. */
+    switch (*compressionMode)
+    {
+    case QP_IMAGE_COMPRESSION_MODE_NONE:
+    {
+        int pixelSize    = imageFormat == QP_IMAGE_FORMAT_RGB888 ? 3 : 4;
+        int packedStride = pixelSize * width;
+
+        if (packedStride == stride)
+            writeDataPtr = data;
+        else
+        {
+            /* Need to re-pack pixels. */
+            if (Buffer_resize(buffer, (size_t)(packedStride * height)))
+            {
+                int row;
+                for (row = 0; row < height; row++)
+                    memcpy(&buffer->data[packedStride * row], &((const uint8_t *)data)[row * stride],
+                           (size_t)(pixelSize * width));
+                writeDataPtr = buffer->data;
+            }
+            else
+            {
+                qpPrintf("ERROR: Failed to pack pixels for writing.\n");
+                return false;
+            }
+        }
+
+        writeDataBytes = (size_t)(packedStride * height);
+        break;
+    }
+
+#if defined(QP_SUPPORT_PNG)
+    case QP_IMAGE_COMPRESSION_MODE_PNG:
+        DE_ASSERT(writeDataPtr); /* Already handled. */
+        break;
+#endif
+
+    default:
+        qpPrintf("qpTestLog_writeImage(): Unknown compression mode: %s\n",
+                 QP_LOOKUP_STRING(s_qpImageCompressionModeMap, *compressionMode));
+        return false;
+    }
+
+    *encodedData = writeDataPtr;
+    *encodedSize = writeDataBytes;
+    return true;
+}
+
+static bool writeImageElement(qpXmlWriter *writer, const char *name, const char *description,
+                              qpImageCompressionMode compressionMode, qpImageFormat imageFormat, int width, int height,
+                              const void *data, size_t numBytes)
+{
+    char widthStr[32];
+    char heightStr[32];
+    qpXmlAttribute attribs[8];
+    int numAttribs = 0;
+
+    /* Fill in attributes. */
+    int32ToString(width, widthStr);
+    int32ToString(height, heightStr);
+    attribs[numAttribs++] = qpSetStringAttrib("Name", name);
+    attribs[numAttribs++] = qpSetStringAttrib("Width", widthStr);
+    attribs[numAttribs++] = qpSetStringAttrib("Height", heightStr);
+    attribs[numAttribs++] = qpSetStringAttrib("Format", QP_LOOKUP_STRING(s_qpImageFormatMap, imageFormat));
+    attribs[numAttribs++] =
+        qpSetStringAttrib("CompressionMode", QP_LOOKUP_STRING(s_qpImageCompressionModeMap, compressionMode));
+    if (description)
+        attribs[numAttribs++] = qpSetStringAttrib("Description", description);
+
+    /* <Image ID="result" Name="Foobar" Width="640" Height="480" Format="RGB888" CompressionMode="None">base64 data</Image> */
+    return qpXmlWriter_startElement(writer, "Image", numAttribs, attribs) &&
+           qpXmlWriter_writeBase64(writer, (const uint8_t *)data, numBytes) &&
+           qpXmlWriter_endElement(writer, "Image");
+}
+
+/* Image encoder thread pool. */
+struct ImageEncoder_s
+{
+    deThread threads[MAX_IMAGE_ENCODER_THREADS];
+    int numThreads;
+
+    deMutex lock;          /*!< Protects queue and stop flag. */
+    deSemaphore numQueued; /*!< Signaled once for each queued job and for each thread when stopping. */
+    ImageJob *first;
+    ImageJob *last;
+    bool stop;
+};
+
+static void ImageJob_destroy(ImageJob *job)
+{
+    if (job->writer)
+        qpXmlWriter_destroy(job->writer);
+    if (job->done)
+        deSemaphore_destroy(job->done);
+
+    deFree(job->output.data);
+    deFree(job->pixels);
+    deFree(job->name);
+    deFree(job->description);
+    deFree(job);
+}
+
+static void ImageJob_appendOutput(void *userPtr, const char *data, size_t numBytes)
+{
+    ImageJob *job = (ImageJob *)userPtr;
+    LogChunk_append(&job->output, data, numBytes);
+}
+
+static char *copyString(const char *str)
+{
+    const size_t size = strlen(str) + 1;
+    char *copy        = (char *)deMalloc(size);
+
+    if (copy)
+        deMemcpy(copy, str, size);
+
+    return copy;
+}
+
+/* Creates job with copy of the image. Image element is written at the current position of parentWriter. */
+static ImageJob *ImageJob_create(const qpXmlWriter *parentWriter, const char *name, const char *description,
+                                 qpImageFormat imageFormat, int width, int height, int stride, const void *data,
+                                 int pngCompressionLevel, qpPngFilter pngFilter)
+{
+    const int pixelSize    = imageFormat == QP_IMAGE_FORMAT_RGB888 ? 3 : 4;
+    const int packedStride = pixelSize * width;
+    ImageJob *job          = (ImageJob *)deCalloc(sizeof(ImageJob));
+    int row;
+
+    if (!job)
+        return NULL;
+
+    job->name                = copyString(name);
+    job->description         = description ? copyString(description) : NULL;
+    job->imageFormat         = imageFormat;
+    job->width               = width;
+    job->height              = height;
+    job->pixels              = (uint8_t *)deMalloc((size_t)(packedStride * height));
+    job->pngCompressionLevel = pngCompressionLevel;
+    job->pngFilter           = pngFilter;
+    job->writer              = qpXmlWriter_createFragmentWriter(parentWriter, ImageJob_appendOutput, job);
+    job->done                = deSemaphore_create(0, NULL);
+
+    if (!job->name || (description && !job->description) || !job->pixels || !job->writer || !job->done)
+    {
+        ImageJob_destroy(job);
+        return NULL;
+    }
+
+    for (row = 0; row < height; row++)
+        deMemcpy(&job->pixels[packedStride * row], &((const uint8_t *)data)[row * stride], (size_t)packedStride);
+
+    return job;
+}
+
+static void ImageJob_execute(ImageJob *job)
+{
+    qpImageCompressionMode compressionMode = QP_IMAGE_COMPRESSION_MODE_PNG;
+    const int pixelSize                    = job->imageFormat == QP_IMAGE_FORMAT_RGB888 ? 3 : 4;
+    Buffer compressedBuffer;
+    const void *encodedData = NULL;
+    size_t encodedSize      = 0;
+
+    Buffer_init(&compressedBuffer);
+
+    if (encodeImage(&compressedBuffer, &compressionMode, job->imageFormat, job->width, job->height,
+                    pixelSize * job->width, job->pixels, job->pngCompressionLevel, job->pngFilter, &encodedData,
+                    &encodedSize))
+    {
+        if (!writeImageElement(job->writer, job->name, job->description, compressionMode, job->imageFormat,
+                               job->width, job->height, encodedData, encodedSize))
+            qpPrintf("qpTestLog_writeImage(): Writing XML failed\n");
+    }
+
+    Buffer_deinit(&compressedBuffer);
+
+    /* Pixels are no longer needed. */
+    deFree(job->pixels);
+    job->pixels = NULL;
+
+    /* Output must be complete before crash handler can see the flag. */
+    deMemoryReadWriteFence();
+    job->isDone = true;
+
+    deSemaphore_increment(job->done);
+}
+
+static void imageEncoderThread(void *arg)
+{
+    ImageEncoder *encoder = (ImageEncoder *)arg;
+
+    for (;;)
+    {
+        ImageJob *job = NULL;
+
+        deSemaphore_decrement(encoder->numQueued);
+
+        deMutex_lock(encoder->lock);
+        job = encoder->first;
+        if (job)
+        {
+            encoder->first = job->next;
+            if (!encoder->first)
+                encoder->last = NULL;
+        }
+        deMutex_unlock(encoder->lock);
+
+        if (!job)
+            break; /* Stopping. */
+
+        ImageJob_execute(job);
+    }
+}
+
+static void ImageEncoder_enqueue(ImageEncoder *encoder, ImageJob *job)
+{
+    deMutex_lock(encoder->lock);
+
+    DE_ASSERT(!encoder->stop);
+
+    if (encoder->last)
+        encoder->last->next = job;
+    else
+        encoder->first = job;
+    encoder->last = job;
+
+    deMutex_unlock(encoder->lock);
+
+    deSemaphore_increment(encoder->numQueued);
+}
+
+static void ImageEncoder_destroy(ImageEncoder *encoder)
+{
+    int ndx;
+
+    if (encoder->numQueued)
+    {
+        deMutex_lock(encoder->lock);
+        encoder->stop = true;
+        deMutex_unlock(encoder->lock);
+
+        /* Threads exit once queue is empty. */
+        for (ndx = 0; ndx < encoder->numThreads; ndx++)
+            deSemaphore_increment(encoder->numQueued);
+
+        for (ndx = 0; ndx < encoder->numThreads; ndx++)
+        {
+            deThread_join(encoder->threads[ndx]);
+            deThread_destroy(encoder->threads[ndx]);
+        }
+
+        deSemaphore_destroy(encoder->numQueued);
+    }
+
+    if (encoder->lock)
+        deMutex_destroy(encoder->lock);
+
+    deFree(encoder);
+}
+
+static ImageEncoder *ImageEncoder_create(void)
+{
+    ImageEncoder *encoder = (ImageEncoder *)deCalloc(sizeof(ImageEncoder));
+    int numThreads        = (int)deGetNumAvailableLogicalCores();
+
+    if (!encoder)
+        return NULL;
+
+    numThreads = deClamp32(numThreads, 1, MAX_IMAGE_ENCODER_THREADS);
+
+    encoder->lock      = deMutex_create(NULL);
+    encoder->numQueued = deSemaphore_create(0, NULL);
+
+    if (!encoder->lock || !encoder->numQueued)
+    {
+        ImageEncoder_destroy(encoder);
+        return NULL;
+    }
+
+    for (; encoder->numThreads < numThreads; encoder->numThreads++)
+    {
+        encoder->threads[encoder->numThreads] = deThread_create(imageEncoderThread, encoder, NULL);
+
+        if (!encoder->threads[encoder->numThreads])
+            break;
+    }
+
+    if (encoder->numThreads == 0)
+    {
+        ImageEncoder_destroy(encoder);
+        return NULL;
+    }
+
+    return encoder;
+}
+
 /*--------------------------------------------------------------------*//*!
  * \brief Start image set
  * \param log            qpTestLog instance
@@ -886,10 +1738,6 @@ bool qpTestLog_writeImage(qpTestLog *log, const char *name, const char *descript
                           qpImageCompressionMode compressionMode, qpImageFormat imageFormat, int width, int height,
                           int stride, const void *data)
 {
-    char widthStr[32];
-    char heightStr[32];
-    qpXmlAttribute attribs[8];
-    int numAttribs = 0;
     Buffer compressedBuffer;
     const void *writeDataPtr = NULL;
     size_t writeDataBytes    = ~(size_t)0;
@@ -902,8 +1750,6 @@ bool qpTestLog_writeImage(qpTestLog *log, const char *name, const char *descript
     if (log->flags & QP_TEST_LOG_EXCLUDE_IMAGES)
         return true; /* Image not logged. */
 
-    Buffer_init(&compressedBuffer);
-
     /* BEST compression mode defaults to PNG. */
     if (compressionMode == QP_IMAGE_COMPRESSION_MODE_BEST)
     {
@@ -915,88 +1761,52 @@ bool qpTestLog_writeImage(qpTestLog *log, const char *name, const char *descript
     }
 
 #if defined(QP_SUPPORT_PNG)
-    /* Try storing with PNG compression. */
-    if (compressionMode == QP_IMAGE_COMPRESSION_MODE_PNG)
+    /* Encode PNG images on encoder threads. */
+    if (log->imageEncoder && compressionMode == QP_IMAGE_COMPRESSION_MODE_PNG)
     {
-        bool compressOk = compressImagePNG(&compressedBuffer, imageFormat, width, height, stride, data);
-        if (compressOk)
-        {
-            writeDataPtr   = compressedBuffer.data;
-            writeDataBytes = compressedBuffer.size;
-        }
-        else
-        {
-            /* Fall-back to default compression. */
-            qpPrintf("WARNING: PNG compression failed -- storing image uncompressed.\n");
-            compressionMode = QP_IMAGE_COMPRESSION_MODE_NONE;
-        }
-    }
-#endif
+        ImageJob *job = NULL;
 
-    /* Handle image compression. */
-    switch (compressionMode)
-    {
-    case QP_IMAGE_COMPRESSION_MODE_NONE:
-    {
-        int pixelSize    = imageFormat == QP_IMAGE_FORMAT_RGB888 ? 3 : 4;
-        int packedStride = pixelSize * width;
+        /* Wait until writer thread has written out enough pending images. */
+        deSemaphore_decrement(log->asyncWriter->numFreeImages);
 
-        if (packedStride == stride)
-            writeDataPtr = data;
-        else
+        deMutex_lock(log->lock);
+
+        /* Close pending start tag so that image element starts at a new line. */
+        qpXmlWriter_flush(log->writer);
+
+        job = ImageJob_create(log->writer, name, description, imageFormat, width, height, stride, data,
+                              log->pngCompressionLevel, log->pngFilter);
+
+        if (job && AsyncWriter_submitImage(log->asyncWriter, job))
         {
-            /* Need to re-pack pixels. */
-            if (Buffer_resize(&compressedBuffer, (size_t)(packedStride * height)))
-            {
-                int row;
-                for (row = 0; row < height; row++)
-                    memcpy(&compressedBuffer.data[packedStride * row], &((const uint8_t *)data)[row * stride],
-                           (size_t)(pixelSize * width));
-            }
-            else
-            {
-                qpPrintf("ERROR: Failed to pack pixels for writing.\n");
-                Buffer_deinit(&compressedBuffer);
-                return false;
-            }
+            ImageEncoder_enqueue(log->imageEncoder, job);
+            deMutex_unlock(log->lock);
+            return true;
         }
 
-        writeDataBytes = (size_t)(packedStride * height);
-        break;
-    }
+        /* Fall back to encoding on this thread. */
+        deMutex_unlock(log->lock);
+        deSemaphore_increment(log->asyncWriter->numFreeImages);
 
-#if defined(QP_SUPPORT_PNG)
-    case QP_IMAGE_COMPRESSION_MODE_PNG:
-        DE_ASSERT(writeDataPtr); /* Already handled. */
-        break;
+        if (job)
+            ImageJob_destroy(job);
+    }
 #endif
 
-    default:
-        qpPrintf("qpTestLog_writeImage(): Unknown compression mode: %s\n",
-                 QP_LOOKUP_STRING(s_qpImageCompressionModeMap, compressionMode));
+    Buffer_init(&compressedBuffer);
+
+    if (!encodeImage(&compressedBuffer, &compressionMode, imageFormat, width, height, stride, data,
+                     log->pngCompressionLevel, log->pngFilter, &writeDataPtr, &writeDataBytes))
+    {
         Buffer_deinit(&compressedBuffer);
         return false;
     }
 
-    /* Fill in attributes. */
-    int32ToString(width, widthStr);
-    int32ToString(height, heightStr);
-    attribs[numAttribs++] = qpSetStringAttrib("Name", name);
-    attribs[numAttribs++] = qpSetStringAttrib("Width", widthStr);
-    attribs[numAttribs++] = qpSetStringAttrib("Height", heightStr);
-    attribs[numAttribs++] = qpSetStringAttrib("Format", QP_LOOKUP_STRING(s_qpImageFormatMap, imageFormat));
-    attribs[numAttribs++] =
-        qpSetStringAttrib("CompressionMode", QP_LOOKUP_STRING(s_qpImageCompressionModeMap, compressionMode));
-    if (description)
-        attribs[numAttribs++] = qpSetStringAttrib("Description", description);
-
     /* \note Log lock is acquired after compression! */
     deMutex_lock(log->lock);
 
-    /* <Image ID="result" Name="Foobar" Width="640" Height="480" Format="RGB888" CompressionMode="None">base64 data</Image> */
-    if (!qpXmlWriter_startElement(log->writer, "Image", numAttribs, attribs) ||
-        !qpXmlWriter_writeBase64(log->writer, (const uint8_t *)writeDataPtr, writeDataBytes) ||
-        !qpXmlWriter_endElement(log->writer, "Image"))
+    if (!writeImageElement(log->writer, name, description, compressionMode, imageFormat, width, height, writeDataPtr,
+                           writeDataBytes))
     {
         qpPrintf("qpTestLog_writeImage(): Writing XML failed\n");
         deMutex_unlock(log->lock);
@@ -1012,6 +1822,26 @@ bool qpTestLog_writeImage(qpTestLog *log, const char *name, const char *descript
     return true;
 }
 
+/*--------------------------------------------------------------------*//*!
+ * \brief Set image compression options
+ *
+ * Options affect PNG compressed images.
+ * \param log                    qpTestLog instance
+ * \param pngCompressionLevel    zlib compression level (0-9), or -1 for default
+ * \param pngFilter              PNG row filter
+ *//*--------------------------------------------------------------------*/
+void qpTestLog_setImageCompressionOptions(qpTestLog *log, int pngCompressionLevel, qpPngFilter pngFilter)
+{
+    DE_ASSERT(log);
+    DE_ASSERT(deInRange32(pngCompressionLevel, -1, 9));
+    DE_ASSERT(deInBounds32(pngFilter, 0, QP_PNG_FILTER_LAST));
+
+    deMutex_lock(log->lock);
+    log->pngCompressionLevel = pngCompressionLevel;
+    log->pngFilter           = pngFilter;
+    deMutex_unlock(log->lock);
+}
+
 /*--------------------------------------------------------------------*//*!
  * \brief Writes infoLog into log. Might filter out empty infoLog.
  * \param log            qpTestLog instance
@@ -1542,8 +2372,9 @@ bool qpTestLog_writeRaw(qpTestLog *log, const char *rawContents)
 {
     DE_ASSERT(log);
 
-    fseek(log->outputFile, 0, SEEK_END);
-    fprintf(log->outputFile, "%s", rawContents);
+    if (!log->asyncWriter)
+        fseek(log->outputFile, 0, SEEK_END);
+    qpTestLog_writeOutput(log, rawContents);
     if (!(log->flags & QP_TEST_LOG_NO_FLUSH))
         qpTestLog_flushFile(log);
 
@@ -118,6 +118,20 @@ typedef enum qpImageCompressionMode_e
     QP_IMAGE_COMPRESSION_MODE_LAST
 } qpImageCompressionMode;
 
+/* PNG row filter used by image compression. */
+typedef enum qpPngFilter_e
+{
+    QP_PNG_FILTER_DEFAULT = 0, /*!< Let libpng choose the filter.            */
+    QP_PNG_FILTER_NONE,        /*!< No filtering.                            */
+    QP_PNG_FILTER_SUB,         /*!< Difference to left pixel.                */
+    QP_PNG_FILTER_UP,          /*!< Difference to pixel above.               */
+    QP_PNG_FILTER_AVG,         /*!< Difference to average of left and above. */
+    QP_PNG_FILTER_PAETH,       /*!< Paeth predictor.                         */
+    QP_PNG_FILTER_ALL,         /*!< Choose best filter for each row.         */
+
+    QP_PNG_FILTER_LAST
+} qpPngFilter;
+
 /*--------------------------------------------------------------------*//*!
  * \brief Image formats.
  *
@@ -147,6 +161,10 @@ typedef enum qpTestLogFlag_e
     QP_TEST_LOG_NO_INITIAL_OUTPUT = (1 << 4) /*!< Do not push data to cout when initializing log.                */
     ,
     QP_TEST_LOG_COMPACT = (1 << 5) /*!< Only write test case status.                                    */
+    ,
+    QP_TEST_LOG_ASYNC_WRITE = (1 << 6) /*!< Write log file on a separate thread.                            */
+    ,
+    QP_TEST_LOG_BINARY_FORMAT = (1 << 7) /*!< Write binary log instead of XML, see qpXmlWriter_setBinaryFormat(). */
 } qpTestLogFlag;
 
 /* Shader type. */
@@ -220,6 +238,8 @@ bool qpTestLog_startTestsCasesTime(qpTestLog *log);
 bool qpTestLog_endTestsCasesTime(qpTestLog *log);
 
 bool qpTestLog_terminateCase(qpTestLog *log, qpTestResult result);
+void qpTestLog_flush(qpTestLog *log);
+void qpTestLog_flushAfterCrash(qpTestLog *log);
 
 bool qpTestLog_startSection(qpTestLog *log, const char *name, const char *description);
 bool qpTestLog_endSection(qpTestLog *log);
@@ -235,6 +255,7 @@ bool qpTestLog_endImageSet(qpTestLog *log);
 bool qpTestLog_writeImage(qpTestLog *log, const char *name, const char *description,
                           qpImageCompressionMode compressionMode, qpImageFormat format, int width, int height,
                           int stride, const void *data);
+void qpTestLog_setImageCompressionOptions(qpTestLog *log, int pngCompressionLevel, qpPngFilter pngFilter);
 
 bool qpTestLog_startEglConfigSet(qpTestLog *log, const char *key, const char *description);
 bool qpTestLog_writeEglConfig(qpTestLog *log, const qpEglConfigInfo *config);
@@ -24,6 +24,7 @@
 #include "qpWatchDog.h"
 
 #include "deThread.h"
+#include "deMutex.h"
 #include "deClock.h"
 #include "deMemory.h"
 
@@ -56,8 +57,13 @@ struct qpWatchDog_s
     */
     int defaultIntervalTimeLimit;
 
-    volatile uint64_t resetTime;
-    volatile uint64_t lastTouchTime;
+    /*
+        qpWatchDog_touch() may be called from worker threads, for example by tcu::parallelFor() ranges.
+        64-bit stores are not atomic on all targets so times are accessed under timeLock.
+    */
+    deMutex timeLock;
+    uint64_t resetTime;
+    uint64_t lastTouchTime;
 
     deThread watchDogThread;
     volatile Status status;
@@ -72,11 +78,20 @@ static void watchDogThreadFunc(void *arg)
 
     while (dog->status == STATUS_THREAD_RUNNING)
     {
-        uint64_t curTime          = deGetMicroseconds();
-        int totalSecondsPassed    = (int)((curTime - dog->resetTime) / 1000000ull);
-        int secondsSinceLastTouch = (int)((curTime - dog->lastTouchTime) / 1000000ull);
-        bool overIntervalLimit    = secondsSinceLastTouch > dog->intervalTimeLimit;
-        bool overTotalLimit       = totalSecondsPassed > dog->totalTimeLimit;
+        uint64_t curTime;
+        int totalSecondsPassed;
+        int secondsSinceLastTouch;
+        bool overIntervalLimit;
+        bool overTotalLimit;
+
+        deMutex_lock(dog->timeLock);
+        curTime               = deGetMicroseconds();
+        totalSecondsPassed    = (int)((curTime - dog->resetTime) / 1000000ull);
+        secondsSinceLastTouch = (int)((curTime - dog->lastTouchTime) / 1000000ull);
+        deMutex_unlock(dog->timeLock);
+
+        overIntervalLimit = secondsSinceLastTouch > dog->intervalTimeLimit;
+        overTotalLimit    = totalSecondsPassed > dog->totalTimeLimit;
 
         if (overIntervalLimit || overTotalLimit)
         {
@@ -110,6 +125,13 @@ qpWatchDog *qpWatchDog_create(qpWatchDogFunc timeOutFunc, void *userPtr, int tot
     dog->totalTimeLimit           = totalTimeLimitSecs;
     dog->intervalTimeLimit        = intervalTimeLimitSecs;
     dog->defaultIntervalTimeLimit = intervalTimeLimitSecs;
+    dog->timeLock                 = deMutex_create(NULL);
+
+    if (!dog->timeLock)
+    {
+        deFree(dog);
+        return NULL;
+    }
 
     /* Reset (sets time values). */
     qpWatchDog_reset(dog);
@@ -119,6 +141,7 @@ qpWatchDog *qpWatchDog_create(qpWatchDogFunc timeOutFunc, void *userPtr, int tot
     dog->watchDogThread = deThread_create(watchDogThreadFunc, dog, NULL);
     if (!dog->watchDogThread)
     {
+        deMutex_destroy(dog->timeLock);
         deFree(dog);
         return NULL;
     }
@@ -133,8 +156,10 @@ void qpWatchDog_reset(qpWatchDog *dog)
     DE_ASSERT(dog);
     DBGPRINT(("qpWatchDog::reset()\n"));
 
+    deMutex_lock(dog->timeLock);
     dog->resetTime     = curTime;
     dog->lastTouchTime = curTime;
+    deMutex_unlock(dog->timeLock);
 }
 
 void qpWatchDog_destroy(qpWatchDog *dog)
@@ -146,6 +171,7 @@ void qpWatchDog_destroy(qpWatchDog *dog)
     dog->status = STATUS_STOP_THREAD;
     deThread_join(dog->watchDogThread);
     deThread_destroy(dog->watchDogThread);
+    deMutex_destroy(dog->timeLock);
 
     DBGPRINT(("qpWatchDog::destroy() finished\n"));
     deFree(dog);
@@ -153,9 +179,14 @@ void qpWatchDog_destroy(qpWatchDog *dog)
 
 void qpWatchDog_touch(qpWatchDog *dog)
 {
+    uint64_t curTime = deGetMicroseconds();
+
     DE_ASSERT(dog);
     DBGPRINT(("qpWatchDog::touch()\n"));
-    dog->lastTouchTime = deGetMicroseconds();
+
+    deMutex_lock(dog->timeLock);
+    dog->lastTouchTime = curTime;
+    deMutex_unlock(dog->timeLock);
 }
 
 /*
@@ -33,19 +33,98 @@
 #include "deMemPool.h"
 #include "dePoolArray.h"
 
+/* Binary format records. See qpXmlWriter_setBinaryFormat(). */
+typedef enum BinaryRecordType_e
+{
+    BINARY_RECORD_RAW = 1,        /*!< Container format text, written as-is.       */
+    BINARY_RECORD_START_DOCUMENT, /*!< uint8 writeXmlHeader.                       */
+    BINARY_RECORD_END_DOCUMENT,   /*!< No payload.                                 */
+    BINARY_RECORD_START_ELEMENT,  /*!< string name, uint32 numAttribs, attributes. */
+    BINARY_RECORD_END_ELEMENT,    /*!< string name.                                */
+    BINARY_RECORD_STRING,         /*!< Unescaped text.                             */
+    BINARY_RECORD_DATA,           /*!< Raw data, base64 encoded in XML.            */
+    BINARY_RECORD_FLUSH,          /*!< Closes pending start element.               */
+
+    BINARY_RECORD_LAST
+} BinaryRecordType;
+
+enum
+{
+    BINARY_FORMAT_VERSION = 1
+};
+
+static const uint8_t s_binaryMagic[8] = {0x89, 'Q', 'P', 'B', '\r', '\n', 0x1a, '\n'};
+
 struct qpXmlWriter_s
 {
     FILE *outputFile;
     bool flushAfterWrite;
 
+    qpXmlWriterWriteFunc writeFunc; /*!< Used instead of outputFile if set. */
+    void *writeFuncUserPtr;
+
+    bool isBinary; /*!< Write binary records instead of XML. */
+
     bool xmlPrevIsStartElement;
     bool xmlIsWriting;
     int xmlElementDepth;
 };
 
+static void writeBytes(qpXmlWriter *writer, const void *data, size_t numBytes)
+{
+    if (writer->writeFunc)
+        writer->writeFunc(writer->writeFuncUserPtr, (const char *)data, numBytes);
+    else
+        fwrite(data, 1, numBytes, writer->outputFile);
+}
+
+static void writeStr(qpXmlWriter *writer, const char *str)
+{
+    writeBytes(writer, str, strlen(str));
+}
+
+static void writeUint32(qpXmlWriter *writer, uint32_t value)
+{
+    const uint8_t bytes[4] = {(uint8_t)(value & 0xff), (uint8_t)((value >> 8) & 0xff),
+                              (uint8_t)((value >> 16) & 0xff), (uint8_t)(value >> 24)};
+    writeBytes(writer, bytes, sizeof(bytes));
+}
+
+static void writeRecordHeader(qpXmlWriter *writer, BinaryRecordType type, size_t payloadSize)
+{
+    const uint8_t typeByte = (uint8_t)type;
+
+    DE_ASSERT(payloadSize <= 0xffffffffu);
+
+    writeBytes(writer, &typeByte, 1);
+    writeUint32(writer, (uint32_t)payloadSize);
+}
+
+static void endRecord(qpXmlWriter *writer)
+{
+    if (writer->flushAfterWrite && !writer->writeFunc)
+        fflush(writer->outputFile);
+}
+
+/* Length-prefixed string, as used within record payloads. */
+static void writeBinaryString(qpXmlWriter *writer, const char *str)
+{
+    const size_t len = strlen(str);
+    writeUint32(writer, (uint32_t)len);
+    writeBytes(writer, str, len);
+}
+
+static void writeRecord(qpXmlWriter *writer, BinaryRecordType type, const void *payload, size_t payloadSize)
+{
+    writeRecordHeader(writer, type, payloadSize);
+    if (payloadSize > 0)
+        writeBytes(writer, payload, payloadSize);
+    endRecord(writer);
+}
+
 static bool writeEscaped(qpXmlWriter *writer, const char *str)
 {
-    char buf[256 + 10];
+    char buf[256 + 12]; /* Longest escape sequence is 11 characters. */
     char *d       = &buf[0];
     const char *s = str;
     bool isEOS    = false;
@@ -176,10 +255,10 @@ static bool writeEscaped(qpXmlWriter *writer, const char *str)
             *d++ = *s++;
 
         /* Write buffer if EOS or buffer full. */
-        if (isEOS || ((d - &buf[0]) >= 4))
+        if (isEOS || ((d - &buf[0]) >= 256))
         {
             *d = 0;
-            fputs(buf, writer->outputFile);
+            writeStr(writer, buf);
             d = &buf[0];
         }
     } while (!isEOS);
@@ -204,6 +283,47 @@ qpXmlWriter *qpXmlWriter_createFileWriter(FILE *outputFile, bool useCompression,
     return writer;
 }
 
+qpXmlWriter *qpXmlWriter_createCallbackWriter(qpXmlWriterWriteFunc writeFunc, void *userPtr)
+{
+    qpXmlWriter *writer = (qpXmlWriter *)deCalloc(sizeof(qpXmlWriter));
+    if (!writer)
+        return NULL;
+
+    DE_ASSERT(writeFunc);
+
+    writer->writeFunc        = writeFunc;
+    writer->writeFuncUserPtr = userPtr;
+
+    return writer;
+}
+
+qpXmlWriter *qpXmlWriter_createFragmentWriter(const qpXmlWriter *parent, qpXmlWriterWriteFunc writeFunc, void *userPtr)
+{
+    qpXmlWriter *writer = qpXmlWriter_createCallbackWriter(writeFunc, userPtr);
+    if (!writer)
+        return NULL;
+
+    DE_ASSERT(parent->xmlIsWriting && !parent->xmlPrevIsStartElement);
+
+    writer->isBinary              = parent->isBinary;
+    writer->xmlIsWriting          = true;
+    writer->xmlElementDepth       = parent->xmlElementDepth;
+    writer->xmlPrevIsStartElement = false;
+
+    return writer;
+}
+
+void qpXmlWriter_setBinaryFormat(qpXmlWriter *writer)
+{
+    DE_ASSERT(writer && !writer->isBinary && !writer->xmlIsWriting);
+
+    writer->isBinary = true;
+
+    writeBytes(writer, s_binaryMagic, sizeof(s_binaryMagic));
+    writeUint32(writer, BINARY_FORMAT_VERSION);
+    endRecord(writer);
+}
+
 void qpXmlWriter_destroy(qpXmlWriter *writer)
 {
     DE_ASSERT(writer);
@@ -215,7 +335,10 @@ static bool closePending(qpXmlWriter *writer)
 {
     if (writer->xmlPrevIsStartElement)
     {
-        fprintf(writer->outputFile, ">\n");
+        if (writer->isBinary)
+            writeRecord(writer, BINARY_RECORD_FLUSH, NULL, 0);
+        else
+            writeStr(writer, ">\n");
         writer->xmlPrevIsStartElement = false;
     }
 
@@ -233,9 +356,14 @@ bool qpXmlWriter_startDocument(qpXmlWriter *writer, bool writeXmlHeader)
     writer->xmlIsWriting          = true;
     writer->xmlElementDepth       = 0;
     writer->xmlPrevIsStartElement = false;
-    if (writeXmlHeader)
+    if (writer->isBinary)
+    {
+        const uint8_t payload = writeXmlHeader ? 1 : 0;
+        writeRecord(writer, BINARY_RECORD_START_DOCUMENT, &payload, 1);
+    }
+    else if (writeXmlHeader)
     {
-        fprintf(writer->outputFile, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+        writeStr(writer, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
     }
     return true;
 }
@@ -253,34 +381,122 @@ bool qpXmlWriter_endDocument(qpXmlWriter *writer)
     DE_ASSERT(writer->xmlIsWriting);
     DE_ASSERT(writer->xmlElementDepth == 0);
     closePending(writer);
+    if (writer->isBinary)
+        writeRecord(writer, BINARY_RECORD_END_DOCUMENT, NULL, 0);
     writer->xmlIsWriting = false;
     return true;
 }
 
 bool qpXmlWriter_writeString(qpXmlWriter *writer, const char *str)
 {
+    if (writer->isBinary)
+    {
+        writeRecord(writer, BINARY_RECORD_STRING, str, strlen(str));
+        writer->xmlPrevIsStartElement = false;
+        return true;
+    }
+
     if (writer->xmlPrevIsStartElement)
     {
-        fprintf(writer->outputFile, ">");
+        writeStr(writer, ">");
         writer->xmlPrevIsStartElement = false;
     }
 
     return writeEscaped(writer, str);
 }
 
+static bool writeBinaryStartElement(qpXmlWriter *writer, const char *elementName, int numAttribs,
+                                    const qpXmlAttribute *attribs)
+{
+    size_t payloadSize = 4 + strlen(elementName) + 4;
+    int ndx;
+
+    for (ndx = 0; ndx < numAttribs; ndx++)
+    {
+        const qpXmlAttribute *attrib = &attribs[ndx];
+
+        payloadSize += 4 + strlen(attrib->name) + 1;
+
+        switch (attrib->type)
+        {
+        case QP_XML_ATTRIBUTE_STRING:
+            payloadSize += 4 + strlen(attrib->stringValue);
+            break;
+
+        case QP_XML_ATTRIBUTE_INT:
+            payloadSize += 4;
+            break;
+
+        case QP_XML_ATTRIBUTE_BOOL:
+            payloadSize += 1;
+            break;
+
+        default:
+            DE_ASSERT(false);
+        }
+    }
+
+    writeRecordHeader(writer, BINARY_RECORD_START_ELEMENT, payloadSize);
+    writeBinaryString(writer, elementName);
+    writeUint32(writer, (uint32_t)numAttribs);
+
+    for (ndx = 0; ndx < numAttribs; ndx++)
+    {
+        const qpXmlAttribute *attrib = &attribs[ndx];
+        const uint8_t type           = (uint8_t)attrib->type;
+
+        writeBinaryString(writer, attrib->name);
+        writeBytes(writer, &type, 1);
+
+        switch (attrib->type)
+        {
+        case QP_XML_ATTRIBUTE_STRING:
+            writeBinaryString(writer, attrib->stringValue);
+            break;
+
+        case QP_XML_ATTRIBUTE_INT:
+            writeUint32(writer, (uint32_t)attrib->intValue);
+            break;
+
+        case QP_XML_ATTRIBUTE_BOOL:
+        {
+            const uint8_t value = attrib->boolValue ? 1 : 0;
+            writeBytes(writer, &value, 1);
+            break;
+        }
+
+        default:
+            DE_ASSERT(false);
+        }
+    }
+
+    endRecord(writer);
+
+    writer->xmlElementDepth++;
+    writer->xmlPrevIsStartElement = true;
+    return true;
+}
+
 bool qpXmlWriter_startElement(qpXmlWriter *writer, const char *elementName, int numAttribs,
                               const qpXmlAttribute *attribs)
 {
     int ndx;
 
+    if (writer->isBinary)
+        return writeBinaryStartElement(writer, elementName, numAttribs, attribs);
+
     closePending(writer);
 
-    fprintf(writer->outputFile, "%s<%s", getIndentStr(writer->xmlElementDepth), elementName);
+    writeStr(writer, getIndentStr(writer->xmlElementDepth));
+    writeStr(writer, "<");
+    writeStr(writer, elementName);
 
     for (ndx = 0; ndx < numAttribs; ndx++)
     {
         const qpXmlAttribute *attrib = &attribs[ndx];
-        fprintf(writer->outputFile, " %s=\"", attrib->name);
+        writeStr(writer, " ");
+        writeStr(writer, attrib->name);
+        writeStr(writer, "=\"");
         switch (attrib->type)
         {
         case QP_XML_ATTRIBUTE_STRING:
@@ -302,7 +518,7 @@ bool qpXmlWriter_startElement(qpXmlWriter *writer, const char *elementName, int
         default:
             DE_ASSERT(false);
         }
-        fprintf(writer->outputFile, "\"");
+        writeStr(writer, "\"");
     }
 
     writer->xmlElementDepth++;
@@ -315,13 +531,24 @@ bool qpXmlWriter_endElement(qpXmlWriter *writer, const char *elementName)
     DE_ASSERT(writer && writer->xmlElementDepth > 0);
     writer->xmlElementDepth--;
 
-    if (writer->xmlPrevIsStartElement) /* leave flag as-is */
+    if (writer->isBinary)
     {
-        fprintf(writer->outputFile, " />\n");
+        writeRecordHeader(writer, BINARY_RECORD_END_ELEMENT, 4 + strlen(elementName));
+        writeBinaryString(writer, elementName);
+        endRecord(writer);
+        writer->xmlPrevIsStartElement = false;
+    }
+    else if (writer->xmlPrevIsStartElement) /* leave flag as-is */
+    {
+        writeStr(writer, " />\n");
         writer->xmlPrevIsStartElement = false;
     }
     else
-        fprintf(writer->outputFile, "</%s>\n", /*getIndentStr(writer->xmlElementDepth),*/ elementName);
+    {
+        writeStr(writer, "</");
+        writeStr(writer, elementName);
+        writeStr(writer, ">\n");
+    }
 
     return true;
 }
@@ -333,12 +560,21 @@ bool qpXmlWriter_writeBase64(qpXmlWriter *writer, const uint8_t *data, size_t nu
         'W', 'X', 'Y', 'Z', 'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r',
         's', 't', 'u', 'v', 'w', 'x', 'y', 'z', '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', '+', '/'};
 
-    int numWritten        = 0;
-    size_t srcNdx         = 0;
-    bool writeIndent      = true;
-    const char *indentStr = getIndentStr(writer->xmlElementDepth);
+    size_t srcNdx          = 0;
+    const char *indentStr  = getIndentStr(writer->xmlElementDepth);
+    const size_t indentLen = strlen(indentStr);
+    char line[32 + 64 + 2]; /* Indent, 64 characters of data and EOL. */
+    size_t lineLen = 0;
 
     DE_ASSERT(writer && data && (numBytes > 0));
+    DE_ASSERT(indentLen <= 32);
+
+    if (writer->isBinary)
+    {
+        writeRecord(writer, BINARY_RECORD_DATA, data, numBytes);
+        writer->xmlPrevIsStartElement = false;
+        return true;
+    }
 
     /* Close and pending writes. */
     closePending(writer);
@@ -350,49 +586,65 @@ bool qpXmlWriter_writeBase64(qpXmlWriter *writer, const uint8_t *data, size_t nu
         uint8_t s0     = data[srcNdx];
         uint8_t s1     = (numRead >= 2) ? data[srcNdx + 1] : 0;
         uint8_t s2     = (numRead >= 3) ? data[srcNdx + 2] : 0;
-        char d[5];
+        char *d;
 
         srcNdx += numRead;
 
+        /* Write indent (if needed). */
+        if (lineLen == 0)
+        {
+            deMemcpy(&line[0], indentStr, indentLen);
+            lineLen = indentLen;
+        }
+
+        d = &line[lineLen];
+
         d[0] = s_base64Table[s0 >> 2];
         d[1] = s_base64Table[((s0 & 0x3) << 4) | (s1 >> 4)];
         d[2] = s_base64Table[((s1 & 0xF) << 2) | (s2 >> 6)];
         d[3] = s_base64Table[s2 & 0x3F];
-        d[4] = 0;
 
         if (numRead < 3)
             d[3] = '=';
         if (numRead < 2)
             d[2] = '=';
 
-        /* Write indent (if needed). */
-        if (writeIndent)
-        {
-            fprintf(writer->outputFile, "%s", indentStr);
-            writeIndent = false;
-        }
-
-        /* Write data. */
-        fprintf(writer->outputFile, "%s", &d[0]);
+        lineLen += 4;
 
         /* EOL every now and then. */
-        numWritten += 4;
-        if (numWritten >= 64)
+        if (lineLen - indentLen >= 64)
         {
-            fprintf(writer->outputFile, "\n");
-            numWritten  = 0;
-            writeIndent = true;
+            line[lineLen++] = '\n';
+            line[lineLen]   = 0;
+            writeStr(writer, line);
+            lineLen = 0;
         }
     }
 
     /* Last EOL. */
-    if (numWritten > 0)
-        fprintf(writer->outputFile, "\n");
+    if (lineLen > 0)
+    {
+        line[lineLen++] = '\n';
+        line[lineLen]   = 0;
+        writeStr(writer, line);
+    }
 
     DE_ASSERT(srcNdx == numBytes);
     return true;
 }
 
+bool qpXmlWriter_writeRaw(qpXmlWriter *writer, const char *str)
+{
+    DE_ASSERT(writer);
+
+    if (writer->isBinary)
+        writeRecord(writer, BINARY_RECORD_RAW, str, strlen(str));
+    else
+        writeStr(writer, str);
+
+    return true;
+}
+
 /* Common helper functions. */
 
 bool qpXmlWriter_writeStringElement(qpXmlWriter *writer, const char *elementName, const char *elementContent)
@@ -31,6 +31,8 @@ DE_BEGIN_EXTERN_C
 
 typedef struct qpXmlWriter_s qpXmlWriter;
 
+typedef void (*qpXmlWriterWriteFunc)(void *userPtr, const char *data, size_t numBytes);
+
 typedef enum qpXmlAttributeType_e
 {
     QP_XML_ATTRIBUTE_STRING = 0,
@@ -90,6 +92,41 @@ DE_INLINE qpXmlAttribute qpSetBoolAttrib(const char *name, bool value)
  *//*--------------------------------------------------------------------*/
 qpXmlWriter *qpXmlWriter_createFileWriter(FILE *outFile, bool useCompression, bool flushAfterWrite);
 
+/*--------------------------------------------------------------------*//*!
+ * \brief Create a XML Writer instance that passes output to a callback
+ * \param writeFunc Function called with each piece of output
+ * \param userPtr User pointer passed to writeFunc
+ * \return qpXmlWriter instance, or NULL on allocation failure
+ *//*--------------------------------------------------------------------*/
+qpXmlWriter *qpXmlWriter_createCallbackWriter(qpXmlWriterWriteFunc writeFunc, void *userPtr);
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Create a XML Writer for writing elements out of order
+ *
+ * Fragment writer starts at the current element depth of parent, and its
+ * output can be inserted at the current position of parent output. Pending
+ * start element of parent must be closed with qpXmlWriter_flush() first.
+ * \param parent Writer whose state is copied
+ * \param writeFunc Function called with each piece of output
+ * \param userPtr User pointer passed to writeFunc
+ * \return qpXmlWriter instance, or NULL on allocation failure
+ *//*--------------------------------------------------------------------*/
+qpXmlWriter *qpXmlWriter_createFragmentWriter(const qpXmlWriter *parent, qpXmlWriterWriteFunc writeFunc, void *userPtr);
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Switch XML Writer to binary log format
+ *
+ * Instead of XML text the writer outputs length-prefixed records, one for
+ * each write call. Attributes keep their type and data written with
+ * qpXmlWriter_writeBase64() is stored as-is. Record stream can be converted
+ * back to XML output identical to that of a text writer. See
+ * doc/qpa_file_format.txt for the format.
+ *
+ * Writes the stream header, must be called before any other output.
+ * \param writer qpXmlWriter instance
+ *//*--------------------------------------------------------------------*/
+void qpXmlWriter_setBinaryFormat(qpXmlWriter *writer);
+
 /*--------------------------------------------------------------------*//*!
  * \brief XML Writer instance
  * \param a    qpXmlWriter instance
@@ -151,6 +188,16 @@ bool qpXmlWriter_writeString(qpXmlWriter *writer, const char *content);
  *//*--------------------------------------------------------------------*/
 bool qpXmlWriter_writeBase64(qpXmlWriter *writer, const uint8_t *data, size_t numBytes);
 
+/*--------------------------------------------------------------------*//*!
+ * \brief Write string into output as-is
+ *
+ * Used for container format lines around XML documents.
+ * \param writer qpXmlWriter instance
+ * \param str String to be written
+ * \return true on success, false on error
+ *//*--------------------------------------------------------------------*/
+bool qpXmlWriter_writeRaw(qpXmlWriter *writer, const char *str);
+
 /*--------------------------------------------------------------------*//*!
  * \brief Convenience function for writing XML element
  * \param writer qpXmlWriter instance
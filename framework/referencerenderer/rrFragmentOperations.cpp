@@ -24,7 +24,9 @@
 #include "rrFragmentOperations.hpp"
 #include "tcuVectorUtil.hpp"
 #include "tcuTextureUtil.hpp"
+#include "deRandom.hpp"
 #include <limits>
+#include <vector>
 
 using de::clamp;
 using de::max;
@@ -995,10 +997,11 @@ void FragmentProcessor::executeUnsignedValueWrite(int fragNdxOffset, int numSamp
     }
 }
 
-void FragmentProcessor::render(const rr::MultisamplePixelBufferAccess &msColorBuffer,
-                               const rr::MultisamplePixelBufferAccess &msDepthBuffer,
-                               const rr::MultisamplePixelBufferAccess &msStencilBuffer, const Fragment *inputFragments,
-                               int numFragments, FaceType fragmentFacing, const FragmentOperationState &state)
+void FragmentProcessor::renderGeneric(const rr::MultisamplePixelBufferAccess &msColorBuffer,
+                                      const rr::MultisamplePixelBufferAccess &msDepthBuffer,
+                                      const rr::MultisamplePixelBufferAccess &msStencilBuffer,
+                                      const Fragment *inputFragments, int numFragments, FaceType fragmentFacing,
+                                      const FragmentOperationState &state)
 {
     DE_ASSERT(fragmentFacing < FACETYPE_LAST);
     DE_ASSERT(state.numStencilBits < 32); // code bitshifts numStencilBits, avoid undefined behavior
@@ -1286,4 +1289,615 @@ void FragmentProcessor::render(const rr::MultisamplePixelBufferAccess &msColorBu
     }
 }
 
+namespace
+{
+
+// Depth and stencil buffers of the specialized RGBA8 path, accessed directly through pixel pointers.
+// Conversions are the same ones PixelBufferAccess does for these formats, so the specialized path
+// gives results identical to renderGeneric().
+
+template <typename T>
+inline bool testCompare(TestFunc func, T a, T b)
+{
+    switch (func)
+    {
+    case TESTFUNC_NEVER:
+        return false;
+    case TESTFUNC_ALWAYS:
+        return true;
+    case TESTFUNC_LESS:
+        return a < b;
+    case TESTFUNC_LEQUAL:
+        return a <= b;
+    case TESTFUNC_GREATER:
+        return a > b;
+    case TESTFUNC_GEQUAL:
+        return a >= b;
+    case TESTFUNC_EQUAL:
+        return a == b;
+    case TESTFUNC_NOTEQUAL:
+        return a != b;
+    default:
+        DE_ASSERT(false);
+        return false;
+    }
+}
+
+inline int applyStencilOp(StencilOp op, int value, int clampedRef, int numStencilBits)
+{
+    switch (op)
+    {
+    case STENCILOP_KEEP:
+        return value;
+    case STENCILOP_ZERO:
+        return 0;
+    case STENCILOP_REPLACE:
+        return clampedRef;
+    case STENCILOP_INCR:
+        return de::clamp(value + 1, 0, (1 << numStencilBits) - 1);
+    case STENCILOP_DECR:
+        return de::clamp(value - 1, 0, (1 << numStencilBits) - 1);
+    case STENCILOP_INCR_WRAP:
+        return (value + 1) & ((1 << numStencilBits) - 1);
+    case STENCILOP_DECR_WRAP:
+        return (value - 1) & ((1 << numStencilBits) - 1);
+    case STENCILOP_INVERT:
+        return (~value) & ((1 << numStencilBits) - 1);
+    default:
+        DE_ASSERT(false);
+        return value;
+    }
+}
+
+class NoDepthBuffer
+{
+public:
+    enum
+    {
+        ENABLED = 0
+    };
+
+    bool test(TestFunc, float, int, int, int) const
+    {
+        DE_ASSERT(false);
+        return true;
+    }
+
+    void write(float, int, int, int) const
+    {
+        DE_ASSERT(false);
+    }
+};
+
+//! D FLOAT, the depth view of D32F_S8.
+class FloatDepthBuffer
+{
+public:
+    enum
+    {
+        ENABLED = 1
+    };
+
+    FloatDepthBuffer(const tcu::PixelBufferAccess &access) : m_access(access)
+    {
+    }
+
+    bool test(TestFunc func, float sampleDepth, int s, int x, int y) const
+    {
+        return testCompare(func, de::clamp(sampleDepth, 0.0f, 1.0f), *(const float *)m_access.getPixelPtr(s, x, y));
+    }
+
+    void write(float clampedDepth, int s, int x, int y) const
+    {
+        *(float *)m_access.getPixelPtr(s, x, y) = clampedDepth;
+    }
+
+private:
+    tcu::PixelBufferAccess m_access;
+};
+
+//! D UNORM_INT24, the depth view of D24S8.
+class Unorm24DepthBuffer
+{
+public:
+    enum
+    {
+        ENABLED = 1
+    };
+
+    Unorm24DepthBuffer(const tcu::PixelBufferAccess &access) : m_access(access)
+    {
+    }
+
+    bool test(TestFunc func, float sampleDepth, int s, int x, int y) const
+    {
+        // \note Conversion saturates, so clamping first doesn't change the result.
+        return testCompare(func, toUnorm24(de::clamp(sampleDepth, 0.0f, 1.0f)), read(m_access.getPixelPtr(s, x, y)));
+    }
+
+    void write(float clampedDepth, int s, int x, int y) const
+    {
+        uint8_t *const dst   = (uint8_t *)m_access.getPixelPtr(s, x, y);
+        const uint32_t value = toUnorm24(clampedDepth);
+
+#if (DE_ENDIANNESS == DE_LITTLE_ENDIAN)
+        dst[0] = (uint8_t)((value & 0x0000FFu) >> 0u);
+        dst[1] = (uint8_t)((value & 0x00FF00u) >> 8u);
+        dst[2] = (uint8_t)((value & 0xFF0000u) >> 16u);
+#else
+        dst[0] = (uint8_t)((value & 0xFF0000u) >> 16u);
+        dst[1] = (uint8_t)((value & 0x00FF00u) >> 8u);
+        dst[2] = (uint8_t)((value & 0x0000FFu) >> 0u);
+#endif
+    }
+
+private:
+    static uint32_t read(const void *ptr)
+    {
+        const uint8_t *const src = (const uint8_t *)ptr;
+
+#if (DE_ENDIANNESS == DE_LITTLE_ENDIAN)
+        return (((uint32_t)src[0]) << 0u) | (((uint32_t)src[1]) << 8u) | (((uint32_t)src[2]) << 16u);
+#else
+        return (((uint32_t)src[0]) << 16u) | (((uint32_t)src[1]) << 8u) | (((uint32_t)src[2]) << 0u);
+#endif
+    }
+
+    //! Depth in [0, 1] to UNORM_INT24, rounding to nearest even like setPixDepth() does.
+    static uint32_t toUnorm24(float depth)
+    {
+        const float f   = depth * 16777215.0f;
+        const float q   = deFloatFrac(f);
+        uint32_t intVal = (uint32_t)(f - q);
+
+        if (q > 0.5f || (q == 0.5f && (intVal % 2) != 0))
+            intVal++;
+
+        return de::min(intVal, 0xFFFFFFu);
+    }
+
+    tcu::PixelBufferAccess m_access;
+};
+
+class NoStencilBuffer
+{
+public:
+    enum
+    {
+        ENABLED = 0
+    };
+
+    int read(int, int, int) const
+    {
+        DE_ASSERT(false);
+        return 0;
+    }
+
+    void write(int, int, int, int) const
+    {
+        DE_ASSERT(false);
+    }
+};
+
+//! S UNSIGNED_INT8, the stencil view of D24S8 and D32F_S8.
+class Uint8StencilBuffer
+{
+public:
+    enum
+    {
+        ENABLED = 1
+    };
+
+    Uint8StencilBuffer(const tcu::PixelBufferAccess &access) : m_access(access)
+    {
+    }
+
+    int read(int s, int x, int y) const
+    {
+        return *(const uint8_t *)m_access.getPixelPtr(s, x, y);
+    }
+
+    void write(int value, int s, int x, int y) const
+    {
+        // \note Saturates like setPixStencil().
+        *(uint8_t *)m_access.getPixelPtr(s, x, y) = (uint8_t)de::min((uint32_t)value, 255u);
+    }
+
+private:
+    tcu::PixelBufferAccess m_access;
+};
+
+} // namespace
+
+template <class DepthBufferType, class StencilBufferType>
+void FragmentProcessor::renderRGBA8(const tcu::PixelBufferAccess &colorBuffer, const DepthBufferType &depthBuffer,
+                                    const StencilBufferType &stencilBuffer, const Fragment *inputFragments,
+                                    int numFragments, FaceType fragmentFacing, const FragmentOperationState &state)
+{
+    const int numSamplesPerFragment  = colorBuffer.getWidth();
+    const int totalNumSamples        = numFragments * numSamplesPerFragment;
+    const int numSampleGroups        = (totalNumSamples - 1) / SAMPLE_REGISTER_SIZE + 1;
+    const StencilState &stencilState = state.stencilStates[fragmentFacing];
+    const int clampedStencilRef      = de::clamp(stencilState.ref, 0, (1 << state.numStencilBits) - 1);
+    const int maskedStencilRef       = (int)stencilState.compMask & clampedStencilRef;
+
+    DE_ASSERT(SAMPLE_REGISTER_SIZE % numSamplesPerFragment == 0);
+
+    for (int sampleGroupNdx = 0; sampleGroupNdx < numSampleGroups; sampleGroupNdx++)
+    {
+        const int groupFirstFragNdx = (sampleGroupNdx * SAMPLE_REGISTER_SIZE) / numSamplesPerFragment;
+
+        for (int regSampleNdx = 0; regSampleNdx < SAMPLE_REGISTER_SIZE; regSampleNdx++)
+        {
+            const int fragNdx       = groupFirstFragNdx + regSampleNdx / numSamplesPerFragment;
+            const int fragSampleNdx = regSampleNdx % numSamplesPerFragment;
+
+            m_sampleRegister[regSampleNdx].isAlive =
+                fragNdx < numFragments && (inputFragments[fragNdx].coverage & (1u << fragSampleNdx)) != 0;
+        }
+
+        if (state.scissorTestEnabled)
+            executeScissorTest(groupFirstFragNdx, numSamplesPerFragment, inputFragments, state.scissorRectangle);
+
+        // Stencil and depth tests and writes in one pass. No two fragments share a pixel, so doing all
+        // operations for one sample before moving to the next gives the same result as doing them stage by
+        // stage like renderGeneric() does.
+
+        if (DepthBufferType::ENABLED || StencilBufferType::ENABLED)
+        {
+            for (int regSampleNdx = 0; regSampleNdx < SAMPLE_REGISTER_SIZE; regSampleNdx++)
+            {
+                SampleData &sample = m_sampleRegister[regSampleNdx];
+
+                if (!sample.isAlive)
+                    continue;
+
+                const int fragSampleNdx = regSampleNdx % numSamplesPerFragment;
+                const Fragment &frag    = inputFragments[groupFirstFragNdx + regSampleNdx / numSamplesPerFragment];
+                const int x             = frag.pixelCoord.x();
+                const int y             = frag.pixelCoord.y();
+                int stencilValue        = 0;
+                bool depthPassed        = true;
+
+                if (StencilBufferType::ENABLED)
+                {
+                    stencilValue = stencilBuffer.read(fragSampleNdx, x, y);
+
+                    if (!testCompare(stencilState.func, maskedStencilRef, (int)stencilState.compMask & stencilValue))
+                    {
+                        const int newValue =
+                            applyStencilOp(stencilState.sFail, stencilValue, clampedStencilRef, state.numStencilBits);
+
+                        stencilBuffer.write(maskedBitReplace(stencilValue, newValue, stencilState.writeMask),
+                                            fragSampleNdx, x, y);
+                        sample.isAlive = false;
+                        continue;
+                    }
+                }
+
+                if (DepthBufferType::ENABLED)
+                {
+                    const float sampleDepth = frag.sampleDepths[fragSampleNdx];
+
+                    depthPassed = depthBuffer.test(state.depthFunc, sampleDepth, fragSampleNdx, x, y);
+
+                    if (depthPassed && state.depthMask)
+                        depthBuffer.write(de::clamp(sampleDepth, 0.0f, 1.0f), fragSampleNdx, x, y);
+                }
+
+                if (StencilBufferType::ENABLED)
+                {
+                    const StencilOp op = depthPassed ? stencilState.dpPass : stencilState.dpFail;
+                    const int newValue = applyStencilOp(op, stencilValue, clampedStencilRef, state.numStencilBits);
+
+                    stencilBuffer.write(maskedBitReplace(stencilValue, newValue, stencilState.writeMask),
+                                        fragSampleNdx, x, y);
+                }
+
+                sample.isAlive = depthPassed;
+            }
+        }
+
+        // Blend, reading the destination directly.
+
+        if (state.blendMode == BLENDMODE_STANDARD)
+        {
+            for (int regSampleNdx = 0; regSampleNdx < SAMPLE_REGISTER_SIZE; regSampleNdx++)
+            {
+                SampleData &sample = m_sampleRegister[regSampleNdx];
+
+                if (sample.isAlive)
+                {
+                    const int fragSampleNdx = regSampleNdx % numSamplesPerFragment;
+                    const Fragment &frag = inputFragments[groupFirstFragNdx + regSampleNdx / numSamplesPerFragment];
+                    const uint8_t *const dstPtr = (const uint8_t *)colorBuffer.getPixelPtr(
+                        fragSampleNdx, frag.pixelCoord.x(), frag.pixelCoord.y());
+
+                    sample.clampedBlendSrcColor  = clamp(frag.value.get<float>(), Vec4(0.0f), Vec4(1.0f));
+                    sample.clampedBlendSrc1Color = clamp(frag.value1.get<float>(), Vec4(0.0f), Vec4(1.0f));
+                    sample.clampedBlendDstColor =
+                        Vec4(dstPtr[0] / 255.0f, dstPtr[1] / 255.0f, dstPtr[2] / 255.0f, dstPtr[3] / 255.0f);
+                }
+            }
+
+            executeBlendFactorComputeRGB(state.blendColor, state.blendRGBState);
+            executeBlendFactorComputeA(state.blendColor, state.blendAState);
+            executeBlend(state.blendRGBState, state.blendAState);
+        }
+        else
+        {
+            DE_ASSERT(state.blendMode == BLENDMODE_NONE);
+
+            for (int regSampleNdx = 0; regSampleNdx < SAMPLE_REGISTER_SIZE; regSampleNdx++)
+            {
+                SampleData &sample = m_sampleRegister[regSampleNdx];
+
+                if (sample.isAlive)
+                {
+                    const Fragment &frag = inputFragments[groupFirstFragNdx + regSampleNdx / numSamplesPerFragment];
+
+                    sample.blendedRGB = frag.value.get<float>().xyz();
+                    sample.blendedA   = frag.value.get<float>().w();
+                }
+            }
+        }
+
+        // Write, clamping to [0, 1] on the way.
+        // \note An SSE2 version (cvtps + packs) measured within noise of this and rounds 128 values in [0, 1]
+        //       differently from floatToU8(), so the write is kept scalar.
+
+        for (int regSampleNdx = 0; regSampleNdx < SAMPLE_REGISTER_SIZE; regSampleNdx++)
+        {
+            const SampleData &sample = m_sampleRegister[regSampleNdx];
+
+            if (sample.isAlive)
+            {
+                const int fragSampleNdx = regSampleNdx % numSamplesPerFragment;
+                const Fragment &frag    = inputFragments[groupFirstFragNdx + regSampleNdx / numSamplesPerFragment];
+                uint8_t *const dstPtr =
+                    (uint8_t *)colorBuffer.getPixelPtr(fragSampleNdx, frag.pixelCoord.x(), frag.pixelCoord.y());
+
+                dstPtr[0] = tcu::floatToU8(de::clamp(sample.blendedRGB.x(), 0.0f, 1.0f));
+                dstPtr[1] = tcu::floatToU8(de::clamp(sample.blendedRGB.y(), 0.0f, 1.0f));
+                dstPtr[2] = tcu::floatToU8(de::clamp(sample.blendedRGB.z(), 0.0f, 1.0f));
+                dstPtr[3] = tcu::floatToU8(de::clamp(sample.blendedA, 0.0f, 1.0f));
+            }
+        }
+    }
+}
+
+void FragmentProcessor::render(const rr::MultisamplePixelBufferAccess &msColorBuffer,
+                               const rr::MultisamplePixelBufferAccess &msDepthBuffer,
+                               const rr::MultisamplePixelBufferAccess &msStencilBuffer, const Fragment *inputFragments,
+                               int numFragments, FaceType fragmentFacing, const FragmentOperationState &state)
+{
+    DE_ASSERT(fragmentFacing < FACETYPE_LAST);
+    DE_ASSERT(state.numStencilBits < 32); // code bitshifts numStencilBits, avoid undefined behavior
+
+    // Resolve the buffer formats once per call. RGBA8 color with the depth and stencil views of D24S8 or
+    // D32F_S8 takes the specialized path, everything else goes through renderGeneric().
+
+    const tcu::PixelBufferAccess &colorBuffer   = msColorBuffer.raw();
+    const tcu::PixelBufferAccess &depthBuffer   = msDepthBuffer.raw();
+    const tcu::PixelBufferAccess &stencilBuffer = msStencilBuffer.raw();
+
+    const bool hasDepth = depthBuffer.getWidth() > 0 && depthBuffer.getHeight() > 0 && depthBuffer.getDepth() > 0;
+    const bool hasStencil =
+        stencilBuffer.getWidth() > 0 && stencilBuffer.getHeight() > 0 && stencilBuffer.getDepth() > 0;
+    const bool doDepthTest   = hasDepth && state.depthTestEnabled;
+    const bool doStencilTest = hasStencil && state.stencilTestEnabled;
+    const bool isFloatDepth =
+        doDepthTest && depthBuffer.getFormat() == tcu::TextureFormat(tcu::TextureFormat::D, tcu::TextureFormat::FLOAT);
+    const bool isUnorm24Depth =
+        doDepthTest &&
+        depthBuffer.getFormat() == tcu::TextureFormat(tcu::TextureFormat::D, tcu::TextureFormat::UNORM_INT24);
+    const bool isUint8Stencil =
+        doStencilTest &&
+        stencilBuffer.getFormat() == tcu::TextureFormat(tcu::TextureFormat::S, tcu::TextureFormat::UNSIGNED_INT8);
+    const bool useRGBA8Path =
+        colorBuffer.getFormat() == tcu::TextureFormat(tcu::TextureFormat::RGBA, tcu::TextureFormat::UNORM_INT8) &&
+        state.colorMask[0] && state.colorMask[1] && state.colorMask[2] && state.colorMask[3] &&
+        (state.blendMode == BLENDMODE_NONE || state.blendMode == BLENDMODE_STANDARD) &&
+        !(hasDepth && state.depthBoundsTestEnabled) && (!doDepthTest || isFloatDepth || isUnorm24Depth) &&
+        (!doStencilTest || isUint8Stencil);
+
+    if (!useRGBA8Path)
+    {
+        renderGeneric(msColorBuffer, msDepthBuffer, msStencilBuffer, inputFragments, numFragments, fragmentFacing,
+                      state);
+        return;
+    }
+
+    if (isUint8Stencil)
+    {
+        const Uint8StencilBuffer stencil(stencilBuffer);
+
+        if (isFloatDepth)
+            renderRGBA8(colorBuffer, FloatDepthBuffer(depthBuffer), stencil, inputFragments, numFragments,
+                        fragmentFacing, state);
+        else if (isUnorm24Depth)
+            renderRGBA8(colorBuffer, Unorm24DepthBuffer(depthBuffer), stencil, inputFragments, numFragments,
+                        fragmentFacing, state);
+        else
+            renderRGBA8(colorBuffer, NoDepthBuffer(), stencil, inputFragments, numFragments, fragmentFacing, state);
+    }
+    else
+    {
+        const NoStencilBuffer stencil;
+
+        if (isFloatDepth)
+            renderRGBA8(colorBuffer, FloatDepthBuffer(depthBuffer), stencil, inputFragments, numFragments,
+                        fragmentFacing, state);
+        else if (isUnorm24Depth)
+            renderRGBA8(colorBuffer, Unorm24DepthBuffer(depthBuffer), stencil, inputFragments, numFragments,
+                        fragmentFacing, state);
+        else
+            renderRGBA8(colorBuffer, NoDepthBuffer(), stencil, inputFragments, numFragments, fragmentFacing, state);
+    }
+}
+
+namespace
+{
+
+void randomizeStencilState(de::Random &rnd, StencilState &stencilState)
+{
+    stencilState.func      = (TestFunc)rnd.getInt(0, TESTFUNC_LAST - 1);
+    stencilState.ref       = rnd.getInt(-2, 260);
+    stencilState.compMask  = rnd.getBool() ? ~0u : rnd.getUint32();
+    stencilState.sFail     = (StencilOp)rnd.getInt(0, STENCILOP_LAST - 1);
+    stencilState.dpFail    = (StencilOp)rnd.getInt(0, STENCILOP_LAST - 1);
+    stencilState.dpPass    = (StencilOp)rnd.getInt(0, STENCILOP_LAST - 1);
+    stencilState.writeMask = rnd.getBool() ? ~0u : rnd.getUint32();
+}
+
+void randomizeBlendState(de::Random &rnd, BlendState &blendState)
+{
+    blendState.equation = (BlendEquation)rnd.getInt(0, BLENDEQUATION_LAST - 1);
+    blendState.srcFunc  = (BlendFunc)rnd.getInt(0, BLENDFUNC_LAST - 1);
+    blendState.dstFunc  = (BlendFunc)rnd.getInt(0, BLENDFUNC_LAST - 1);
+}
+
+//! Mostly depth values in steps of 1/16 so that EQUAL and NOTEQUAL tests hit both outcomes, some halfway
+//! between two 24-bit depth values to exercise rounding.
+float getRandomDepth(de::Random &rnd, int minSteps, int maxSteps)
+{
+    if (rnd.getInt(0, 3) == 0)
+        return ((float)rnd.getInt(0, 64) + 0.5f) / 16777215.0f;
+    else
+        return (float)rnd.getInt(minSteps, maxSteps) / 16.0f;
+}
+
+} // namespace
+
+void FragmentProcessor_selfTest(void)
+{
+    const int width        = 19;
+    const int height       = 13;
+    const int numIters     = 48;
+    const int numSamples[] = {1, 4};
+    const tcu::TextureFormat colorFormat(tcu::TextureFormat::RGBA, tcu::TextureFormat::UNORM_INT8);
+    const tcu::TextureFormat dsFormats[] = {
+        tcu::TextureFormat(tcu::TextureFormat::DS, tcu::TextureFormat::UNSIGNED_INT_24_8),
+        tcu::TextureFormat(tcu::TextureFormat::DS, tcu::TextureFormat::FLOAT_UNSIGNED_INT_24_8_REV)};
+    de::Random rnd(0x7a3c1d);
+
+    for (int samplesNdx = 0; samplesNdx < DE_LENGTH_OF_ARRAY(numSamples); samplesNdx++)
+    {
+        for (int dsNdx = 0; dsNdx < DE_LENGTH_OF_ARRAY(dsFormats); dsNdx++)
+        {
+            const int numSamplesPerFragment = numSamples[samplesNdx];
+            tcu::TextureLevel color[2];
+            tcu::TextureLevel depthStencil[2];
+            FragmentProcessor processor;
+            std::vector<IVec2> pixels;
+
+            for (int ndx = 0; ndx < 2; ndx++)
+            {
+                color[ndx].setStorage(colorFormat, numSamplesPerFragment, width, height);
+                depthStencil[ndx].setStorage(dsFormats[dsNdx], numSamplesPerFragment, width, height);
+            }
+
+            // Random initial contents, identical in both buffer sets.
+            {
+                const tcu::PixelBufferAccess depthAccess =
+                    tcu::getEffectiveDepthStencilAccess(depthStencil[0].getAccess(), tcu::Sampler::MODE_DEPTH);
+                const tcu::PixelBufferAccess stencilAccess =
+                    tcu::getEffectiveDepthStencilAccess(depthStencil[0].getAccess(), tcu::Sampler::MODE_STENCIL);
+                const int colorSize        = colorFormat.getPixelSize() * numSamplesPerFragment * width * height;
+                const int depthStencilSize = dsFormats[dsNdx].getPixelSize() * numSamplesPerFragment * width * height;
+
+                for (int byteNdx = 0; byteNdx < colorSize; byteNdx++)
+                    ((uint8_t *)color[0].getAccess().getDataPtr())[byteNdx] = rnd.getUint8();
+
+                deMemset(depthStencil[0].getAccess().getDataPtr(), 0, depthStencilSize);
+
+                for (int y = 0; y < height; y++)
+                    for (int x = 0; x < width; x++)
+                        for (int s = 0; s < numSamplesPerFragment; s++)
+                        {
+                            depthAccess.setPixDepth(getRandomDepth(rnd, 0, 16), s, x, y);
+                            stencilAccess.setPixStencil(rnd.getInt(0, 255), s, x, y);
+                        }
+
+                deMemcpy(color[1].getAccess().getDataPtr(), color[0].getAccess().getDataPtr(), colorSize);
+                deMemcpy(depthStencil[1].getAccess().getDataPtr(), depthStencil[0].getAccess().getDataPtr(),
+                         depthStencilSize);
+            }
+
+            for (int y = 0; y < height; y++)
+                for (int x = 0; x < width; x++)
+                    pixels.push_back(IVec2(x, y));
+
+            for (int iterNdx = 0; iterNdx < numIters; iterNdx++)
+            {
+                const FaceType facing = rnd.getBool() ? FACETYPE_FRONT : FACETYPE_BACK;
+                const int numFragments = rnd.getInt(1, (int)pixels.size());
+                std::vector<Fragment> fragments(numFragments);
+                std::vector<float> sampleDepths(numFragments * numSamplesPerFragment);
+                FragmentOperationState state;
+
+                state.scissorTestEnabled = rnd.getBool();
+                state.scissorRectangle =
+                    WindowRectangle(rnd.getInt(0, width / 2), rnd.getInt(0, height / 2), rnd.getInt(1, width),
+                                    rnd.getInt(1, height));
+                state.stencilTestEnabled = rnd.getBool();
+                randomizeStencilState(rnd, state.stencilStates[FACETYPE_FRONT]);
+                randomizeStencilState(rnd, state.stencilStates[FACETYPE_BACK]);
+                state.depthTestEnabled = rnd.getBool();
+                state.depthFunc        = (TestFunc)rnd.getInt(0, TESTFUNC_LAST - 1);
+                state.depthMask        = rnd.getBool();
+                state.blendMode        = rnd.getBool() ? BLENDMODE_STANDARD : BLENDMODE_NONE;
+                randomizeBlendState(rnd, state.blendRGBState);
+                randomizeBlendState(rnd, state.blendAState);
+                state.blendColor     = Vec4(rnd.getFloat(), rnd.getFloat(), rnd.getFloat(), rnd.getFloat());
+                state.numStencilBits = 8;
+
+                // No two fragments in one call may share a pixel.
+                rnd.shuffle(pixels.begin(), pixels.end());
+
+                for (int fragNdx = 0; fragNdx < numFragments; fragNdx++)
+                {
+                    const GenericVec4 value(Vec4(rnd.getFloat(-0.25f, 1.25f), rnd.getFloat(-0.25f, 1.25f),
+                                                 rnd.getFloat(-0.25f, 1.25f), rnd.getFloat(-0.25f, 1.25f)));
+                    const GenericVec4 value1(
+                        Vec4(rnd.getFloat(), rnd.getFloat(), rnd.getFloat(), rnd.getFloat(-0.25f, 1.25f)));
+                    const uint32_t coverage = rnd.getUint32() & ((1u << numSamplesPerFragment) - 1u);
+
+                    for (int s = 0; s < numSamplesPerFragment; s++)
+                        sampleDepths[fragNdx * numSamplesPerFragment + s] = getRandomDepth(rnd, -4, 20);
+
+                    fragments[fragNdx] = Fragment(pixels[fragNdx], value, value1, coverage,
+                                                  &sampleDepths[fragNdx * numSamplesPerFragment]);
+                }
+
+                for (int ndx = 0; ndx < 2; ndx++)
+                {
+                    const tcu::PixelBufferAccess depthAccess =
+                        tcu::getEffectiveDepthStencilAccess(depthStencil[ndx].getAccess(), tcu::Sampler::MODE_DEPTH);
+                    const tcu::PixelBufferAccess stencilAccess = tcu::getEffectiveDepthStencilAccess(
+                        depthStencil[ndx].getAccess(), tcu::Sampler::MODE_STENCIL);
+                    const MultisamplePixelBufferAccess msColor =
+                        MultisamplePixelBufferAccess::fromMultisampleAccess(color[ndx].getAccess());
+                    const MultisamplePixelBufferAccess msDepth =
+                        MultisamplePixelBufferAccess::fromMultisampleAccess(depthAccess);
+                    const MultisamplePixelBufferAccess msStencil =
+                        MultisamplePixelBufferAccess::fromMultisampleAccess(stencilAccess);
+
+                    if (ndx == 0)
+                        processor.renderGeneric(msColor, msDepth, msStencil, &fragments[0], numFragments, facing,
+                                                state);
+                    else
+                        processor.render(msColor, msDepth, msStencil, &fragments[0], numFragments, facing, state);
+                }
+
+                TCU_CHECK(deMemCmp(color[0].getAccess().getDataPtr(), color[1].getAccess().getDataPtr(),
+                                   colorFormat.getPixelSize() * numSamplesPerFragment * width * height) == 0);
+                TCU_CHECK(deMemCmp(depthStencil[0].getAccess().getDataPtr(),
+                                   depthStencil[1].getAccess().getDataPtr(),
+                                   dsFormats[dsNdx].getPixelSize() * numSamplesPerFragment * width * height) == 0);
+            }
+        }
+    }
+}
+
 } // namespace rr
@@ -104,6 +104,8 @@ public:
                 int numFragments, FaceType fragmentFacing, const FragmentOperationState &state);
 
 private:
+    friend void FragmentProcessor_selfTest(void);
+
     enum
     {
         SAMPLE_REGISTER_SIZE = 64
@@ -163,9 +165,23 @@ private:
     void executeUnsignedValueWrite(int fragNdxOffset, int numSamplesPerFragment, const Fragment *inputFragments,
                                    const tcu::BVec4 &colorMask, const tcu::PixelBufferAccess &colorBuffer);
 
+    //! Generic path, handles all buffer formats and state.
+    void renderGeneric(const rr::MultisamplePixelBufferAccess &colorMultisampleBuffer,
+                       const rr::MultisamplePixelBufferAccess &depthMultisampleBuffer,
+                       const rr::MultisamplePixelBufferAccess &stencilMultisampleBuffer, const Fragment *fragments,
+                       int numFragments, FaceType fragmentFacing, const FragmentOperationState &state);
+
+    //! Specialized path for RGBA8 color with a D32F or D24 depth and S8 stencil buffer, see render().
+    template <class DepthBufferType, class StencilBufferType>
+    void renderRGBA8(const tcu::PixelBufferAccess &colorBuffer, const DepthBufferType &depthBuffer,
+                     const StencilBufferType &stencilBuffer, const Fragment *fragments, int numFragments,
+                     FaceType fragmentFacing, const FragmentOperationState &state);
+
     SampleData m_sampleRegister[SAMPLE_REGISTER_SIZE];
 } DE_WARN_UNUSED_TYPE;
 
+void FragmentProcessor_selfTest(void);
+
 } // namespace rr
 
 #endif // _RRFRAGMENTOPERATIONS_HPP
@@ -23,8 +23,11 @@
 
 #include "rrRasterizer.hpp"
 #include "deMath.h"
+#include "deRandom.hpp"
 #include "tcuVectorUtil.hpp"
 
+#include <vector>
+
 namespace rr
 {
 
@@ -92,6 +95,31 @@ static inline bool isInsideCCW(const EdgeFunction &edge, const int64_t edgeVal)
     return edge.inclusive ? (edgeVal >= 0) : (edgeVal > 0);
 }
 
+//! Coverage of all samples of 2x2 block fragments that are inside the region.
+static inline uint64_t getRegionCoverage(int numSamples, bool outX0, bool outY0, bool outX1, bool outY1)
+{
+    uint64_t coverage = 0;
+
+    if (!outX0 && !outY0)
+        coverage |= getCoverageFragmentSampleBits(numSamples, 0, 0);
+    if (!outX1 && !outY0)
+        coverage |= getCoverageFragmentSampleBits(numSamples, 1, 0);
+    if (!outX0 && !outY1)
+        coverage |= getCoverageFragmentSampleBits(numSamples, 0, 1);
+    if (!outX1 && !outY1)
+        coverage |= getCoverageFragmentSampleBits(numSamples, 1, 1);
+
+    return coverage;
+}
+
+//! Range of edge function values over the rectangle [x0, x1] x [y0, y1].
+static inline void getEdgeRange(const EdgeFunction &edge, const int64_t x0, const int64_t y0, const int64_t x1,
+                                const int64_t y1, int64_t &minVal, int64_t &maxVal)
+{
+    minVal = (edge.a >= 0 ? edge.a * x0 : edge.a * x1) + (edge.b >= 0 ? edge.b * y0 : edge.b * y1) + edge.c;
+    maxVal = (edge.a >= 0 ? edge.a * x1 : edge.a * x0) + (edge.b >= 0 ? edge.b * y1 : edge.b * y0) + edge.c;
+}
+
 namespace LineRasterUtil
 {
 
@@ -449,6 +477,44 @@ bool doesLineSegmentExitDiamond(const SubpixelLineSegment &line, const tcu::Vect
 
 } // namespace LineRasterUtil
 
+enum
+{
+    COVERAGE_TILE_SIZE = 8 //!< Size of tiles classified before testing individual samples, must be even.
+};
+
+//! Initialize triangle edge functions so that inside tests use CCW rules. Returns true if area is positive.
+static bool initTriangleEdges(EdgeFunction &edge01, EdgeFunction &edge12, EdgeFunction &edge20, const Winding winding,
+                              const HorizontalFill horizontalFill, const VerticalFill verticalFill, const int64_t x0,
+                              const int64_t y0, const int64_t x1, const int64_t y1, const int64_t x2, const int64_t y2)
+{
+    if (winding == WINDING_CCW)
+    {
+        initEdgeCCW(edge01, horizontalFill, verticalFill, x0, y0, x1, y1);
+        initEdgeCCW(edge12, horizontalFill, verticalFill, x1, y1, x2, y2);
+        initEdgeCCW(edge20, horizontalFill, verticalFill, x2, y2, x0, y0);
+    }
+    else
+    {
+        // Reverse edges
+        initEdgeCCW(edge01, horizontalFill, verticalFill, x1, y1, x0, y0);
+        initEdgeCCW(edge12, horizontalFill, verticalFill, x2, y2, x1, y1);
+        initEdgeCCW(edge20, horizontalFill, verticalFill, x0, y0, x2, y2);
+    }
+
+    const int64_t s         = evaluateEdge(edge01, x2, y2);
+    const bool positiveArea = (winding == WINDING_CCW) ? (s > 0) : (s < 0);
+
+    if (!positiveArea)
+    {
+        // Reverse edges so that we can use CCW area tests & interpolation
+        reverseEdge(edge01);
+        reverseEdge(edge12);
+        reverseEdge(edge20);
+    }
+
+    return positiveArea;
+}
+
 TriangleRasterizer::TriangleRasterizer(const tcu::IVec4 &viewport, const int numSamples,
                                        const RasterizationState &state, const int subpixelBits)
     : m_viewport(viewport)
@@ -459,6 +525,8 @@ TriangleRasterizer::TriangleRasterizer(const tcu::IVec4 &viewport, const int num
     , m_subpixelBits(subpixelBits)
     , m_face(FACETYPE_LAST)
     , m_viewportOrientation(state.viewportOrientation)
+    , m_tileRowNdx(-1)
+    , m_firstTileNdx(0)
 {
 }
 
@@ -482,38 +550,15 @@ void TriangleRasterizer::init(const tcu::Vec4 &v0, const tcu::Vec4 &v1, const tc
     const int64_t x2 = toSubpixelCoord(v2.x(), m_subpixelBits);
     const int64_t y2 = toSubpixelCoord(v2.y(), m_subpixelBits);
 
-    // Initialize edge functions.
-    if (m_winding == WINDING_CCW)
-    {
-        initEdgeCCW(m_edge01, m_horizontalFill, m_verticalFill, x0, y0, x1, y1);
-        initEdgeCCW(m_edge12, m_horizontalFill, m_verticalFill, x1, y1, x2, y2);
-        initEdgeCCW(m_edge20, m_horizontalFill, m_verticalFill, x2, y2, x0, y0);
-    }
-    else
-    {
-        // Reverse edges
-        initEdgeCCW(m_edge01, m_horizontalFill, m_verticalFill, x1, y1, x0, y0);
-        initEdgeCCW(m_edge12, m_horizontalFill, m_verticalFill, x2, y2, x1, y1);
-        initEdgeCCW(m_edge20, m_horizontalFill, m_verticalFill, x0, y0, x2, y2);
-    }
-
-    // Determine face.
-    const int64_t s         = evaluateEdge(m_edge01, x2, y2);
-    const bool positiveArea = (m_winding == WINDING_CCW) ? (s > 0) : (s < 0);
+    // Initialize edge functions and determine face.
+    const bool positiveArea = initTriangleEdges(m_edge01, m_edge12, m_edge20, m_winding, m_horizontalFill,
+                                                m_verticalFill, x0, y0, x1, y1, x2, y2);
 
     if (m_viewportOrientation == VIEWPORTORIENTATION_UPPER_LEFT)
         m_face = positiveArea ? FACETYPE_BACK : FACETYPE_FRONT;
     else
         m_face = positiveArea ? FACETYPE_FRONT : FACETYPE_BACK;
 
-    if (!positiveArea)
-    {
-        // Reverse edges so that we can use CCW area tests & interpolation
-        reverseEdge(m_edge01);
-        reverseEdge(m_edge12);
-        reverseEdge(m_edge20);
-    }
-
     // Bounding box
     const int64_t xMin = de::min(de::min(x0, x1), x2);
     const int64_t xMax = de::max(de::max(x0, x1), x2);
@@ -536,7 +581,119 @@ void TriangleRasterizer::init(const tcu::Vec4 &v0, const tcu::Vec4 &v1, const tc
     m_bboxMax.x() = de::clamp(m_bboxMax.x(), wX0, wX1);
     m_bboxMax.y() = de::clamp(m_bboxMax.y(), wY0, wY1);
 
-    m_curPos = m_bboxMin;
+    m_regionMin  = tcu::IVec2(wX0, wY0);
+    m_regionMax  = tcu::IVec2(wX1, wY1);
+    m_scanMin    = m_bboxMin;
+    m_scanMax    = m_bboxMax;
+    m_curPos     = m_bboxMin;
+    m_tileRowNdx = -1;
+}
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Limit rasterization to a region
+ *
+ * Only fragments inside region (x, y, width, height) are generated. The 2x2
+ * block grid stays aligned to the bounding box, so the fragments generated
+ * for each pixel are identical to rasterizing the whole viewport. This
+ * allows rasterizing disjoint regions of the render target separately.
+ *
+ * Must be called after init() and before rasterize().
+ *//*--------------------------------------------------------------------*/
+void TriangleRasterizer::setRegion(const tcu::IVec4 &region)
+{
+    m_regionMin = tcu::max(m_regionMin, region.swizzle(0, 1));
+    m_regionMax = tcu::min(m_regionMax, region.swizzle(0, 1) + region.swizzle(2, 3) - tcu::IVec2(1));
+
+    for (int ndx = 0; ndx < 2; ndx++)
+    {
+        // Start from the first 2x2 block overlapping region
+        const int firstPixel = de::max(m_regionMin[ndx], m_bboxMin[ndx]);
+
+        m_scanMin[ndx] = m_bboxMin[ndx] + ((firstPixel - m_bboxMin[ndx]) & ~1);
+        m_scanMax[ndx] = de::min(m_bboxMax[ndx], m_regionMax[ndx]);
+    }
+
+    m_curPos     = m_scanMin;
+    m_tileRowNdx = -1;
+
+    // Nothing to rasterize
+    if (m_scanMin.x() > m_scanMax.x())
+        m_curPos.y() = m_scanMax.y() + 1;
+}
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Classify tiles of a tile row
+ *
+ * Up to MAX_TILE_SPAN tiles starting from firstTileNdx are classified.
+ * Tiles are COVERAGE_TILE_SIZE pixels square and aligned to the first
+ * rasterized 2x2 block, so each block belongs to exactly one tile. Edge
+ * functions are linear, so their range over a tile is given by the tile
+ * corners. A tile is not covered if any edge excludes all points in the
+ * tile, and fully covered if every edge includes all of them. The ranges
+ * are computed with the same fixed-point edge functions and fill rules as
+ * the per-sample tests, so classification never changes coverage.
+ *//*--------------------------------------------------------------------*/
+void TriangleRasterizer::classifyTiles(int tileRowNdx, int firstTileNdx)
+{
+    const int numRowTiles             = (m_scanMax.x() - m_scanMin.x()) / COVERAGE_TILE_SIZE + 1;
+    const int numTiles                = de::min<int>(numRowTiles - firstTileNdx, MAX_TILE_SPAN);
+    const int tileY0                  = m_scanMin.y() + tileRowNdx * COVERAGE_TILE_SIZE;
+    const EdgeFunction *const edges[] = {&m_edge01, &m_edge12, &m_edge20};
+
+    // All sample positions of pixels in the tile are inside [sx0, sx1] x [sy0, sy1]
+    const int64_t sy0 = toSubpixelCoord(tileY0, m_subpixelBits);
+    const int64_t sy1 = toSubpixelCoord(tileY0 + COVERAGE_TILE_SIZE, m_subpixelBits);
+
+    DE_ASSERT(de::inBounds(firstTileNdx, 0, numRowTiles));
+
+    for (int tileNdx = 0; tileNdx < numTiles; tileNdx++)
+    {
+        const int tileX0  = m_scanMin.x() + (firstTileNdx + tileNdx) * COVERAGE_TILE_SIZE;
+        const int64_t sx0 = toSubpixelCoord(tileX0, m_subpixelBits);
+        const int64_t sx1 = toSubpixelCoord(tileX0 + COVERAGE_TILE_SIZE, m_subpixelBits);
+        bool allInside    = true;
+        bool anyOutside   = false;
+
+        for (int edgeNdx = 0; edgeNdx < DE_LENGTH_OF_ARRAY(edges); edgeNdx++)
+        {
+            int64_t minVal;
+            int64_t maxVal;
+
+            getEdgeRange(*edges[edgeNdx], sx0, sy0, sx1, sy1, minVal, maxVal);
+
+            allInside  = allInside && isInsideCCW(*edges[edgeNdx], minVal);
+            anyOutside = anyOutside || !isInsideCCW(*edges[edgeNdx], maxVal);
+        }
+
+        m_tileCoverage[tileNdx] =
+            (uint8_t)(anyOutside ? TILECOVERAGE_NONE : (allInside ? TILECOVERAGE_FULL : TILECOVERAGE_PARTIAL));
+    }
+
+    m_tileRowNdx   = tileRowNdx;
+    m_firstTileNdx = firstTileNdx;
+}
+
+inline TriangleRasterizer::TileCoverage TriangleRasterizer::getTileCoverage(int x, int y)
+{
+    const int tileRowNdx = (y - m_scanMin.y()) / COVERAGE_TILE_SIZE;
+    const int tileNdx    = (x - m_scanMin.x()) / COVERAGE_TILE_SIZE;
+
+    if (tileRowNdx != m_tileRowNdx || !de::inBounds(tileNdx, m_firstTileNdx, m_firstTileNdx + (int)MAX_TILE_SPAN))
+        classifyTiles(tileRowNdx, tileNdx);
+
+    return (TileCoverage)m_tileCoverage[tileNdx - m_firstTileNdx];
+}
+
+//! Move to 2x2 block at x, or to the beginning of the next block row if x is past the scan area.
+inline void TriangleRasterizer::advanceTo(int x)
+{
+    m_curPos.x() = x;
+
+    if (m_curPos.x() > m_scanMax.x())
+    {
+        m_curPos.y() += 2;
+        m_curPos.x() = m_scanMin.x();
+    }
 }
 
 void TriangleRasterizer::rasterizeSingleSample(FragmentPacket *const fragmentPackets, float *const depthValues,
@@ -554,10 +711,19 @@ void TriangleRasterizer::rasterizeSingleSample(FragmentPacket *const fragmentPac
     const float zb = m_v1.z() - m_v2.z();
     const float zc = m_v2.z();
 
-    while (m_curPos.y() <= m_bboxMax.y() && packetNdx < maxFragmentPackets)
+    while (m_curPos.y() <= m_scanMax.y() && packetNdx < maxFragmentPackets)
     {
-        const int x0 = m_curPos.x();
-        const int y0 = m_curPos.y();
+        const int x0                    = m_curPos.x();
+        const int y0                    = m_curPos.y();
+        const TileCoverage tileCoverage = getTileCoverage(x0, y0);
+        const bool fullyCovered         = tileCoverage == TILECOVERAGE_FULL;
+
+        if (tileCoverage == TILECOVERAGE_NONE)
+        {
+            // Skip rest of the tile on this block row
+            advanceTo(x0 + COVERAGE_TILE_SIZE - (x0 - m_scanMin.x()) % COVERAGE_TILE_SIZE);
+            continue;
+        }
 
         // Subpixel coords
         const int64_t sx0 = toSubpixelCoord(x0, m_subpixelBits) + halfPixel;
@@ -568,9 +734,11 @@ void TriangleRasterizer::rasterizeSingleSample(FragmentPacket *const fragmentPac
         const int64_t sx[4] = {sx0, sx1, sx0, sx1};
         const int64_t sy[4] = {sy0, sy0, sy1, sy1};
 
-        // Viewport test
-        const bool outX1 = x0 + 1 == m_viewport.x() + m_viewport.z();
-        const bool outY1 = y0 + 1 == m_viewport.y() + m_viewport.w();
+        // Viewport and region test
+        const bool outX0 = x0 < m_regionMin.x();
+        const bool outY0 = y0 < m_regionMin.y();
+        const bool outX1 = x0 + 1 > m_regionMax.x();
+        const bool outY1 = y0 + 1 > m_regionMax.y();
 
         DE_ASSERT(x0 < m_viewport.x() + m_viewport.z());
         DE_ASSERT(y0 < m_viewport.y() + m_viewport.w());
@@ -591,28 +759,28 @@ void TriangleRasterizer::rasterizeSingleSample(FragmentPacket *const fragmentPac
             e20[i] = evaluateEdge(m_edge20, sx[i], sy[i]);
         }
 
-        // Compute coverage mask
-        coverage = setCoverageValue(coverage, 1, 0, 0, 0,
-                                    isInsideCCW(m_edge01, e01[0]) && isInsideCCW(m_edge12, e12[0]) &&
-                                        isInsideCCW(m_edge20, e20[0]));
-        coverage = setCoverageValue(coverage, 1, 1, 0, 0,
-                                    !outX1 && isInsideCCW(m_edge01, e01[1]) && isInsideCCW(m_edge12, e12[1]) &&
-                                        isInsideCCW(m_edge20, e20[1]));
-        coverage = setCoverageValue(coverage, 1, 0, 1, 0,
-                                    !outY1 && isInsideCCW(m_edge01, e01[2]) && isInsideCCW(m_edge12, e12[2]) &&
-                                        isInsideCCW(m_edge20, e20[2]));
-        coverage = setCoverageValue(coverage, 1, 1, 1, 0,
-                                    !outX1 && !outY1 && isInsideCCW(m_edge01, e01[3]) &&
-                                        isInsideCCW(m_edge12, e12[3]) && isInsideCCW(m_edge20, e20[3]));
-
-        // Advance to next location
-        m_curPos.x() += 2;
-        if (m_curPos.x() > m_bboxMax.x())
+        // Compute coverage mask, fully covered tiles only need the region test
+        if (fullyCovered)
+            coverage = getRegionCoverage(1, outX0, outY0, outX1, outY1);
+        else
         {
-            m_curPos.y() += 2;
-            m_curPos.x() = m_bboxMin.x();
+            coverage = setCoverageValue(coverage, 1, 0, 0, 0,
+                                        !outX0 && !outY0 && isInsideCCW(m_edge01, e01[0]) &&
+                                            isInsideCCW(m_edge12, e12[0]) && isInsideCCW(m_edge20, e20[0]));
+            coverage = setCoverageValue(coverage, 1, 1, 0, 0,
+                                        !outX1 && !outY0 && isInsideCCW(m_edge01, e01[1]) &&
+                                            isInsideCCW(m_edge12, e12[1]) && isInsideCCW(m_edge20, e20[1]));
+            coverage = setCoverageValue(coverage, 1, 0, 1, 0,
+                                        !outX0 && !outY1 && isInsideCCW(m_edge01, e01[2]) &&
+                                            isInsideCCW(m_edge12, e12[2]) && isInsideCCW(m_edge20, e20[2]));
+            coverage = setCoverageValue(coverage, 1, 1, 1, 0,
+                                        !outX1 && !outY1 && isInsideCCW(m_edge01, e01[3]) &&
+                                            isInsideCCW(m_edge12, e12[3]) && isInsideCCW(m_edge20, e20[3]));
         }
 
+        // Advance to next location
+        advanceTo(x0 + 2);
+
         if (coverage == 0)
             continue; // Discard.
 
@@ -710,10 +878,19 @@ void TriangleRasterizer::rasterizeMultiSample(FragmentPacket *const fragmentPack
     for (int c = 0; c < NumSamples * 2; ++c)
         samplePos[c] = toSubpixelCoord(samplePts[c], m_subpixelBits);
 
-    while (m_curPos.y() <= m_bboxMax.y() && packetNdx < maxFragmentPackets)
+    while (m_curPos.y() <= m_scanMax.y() && packetNdx < maxFragmentPackets)
     {
-        const int x0 = m_curPos.x();
-        const int y0 = m_curPos.y();
+        const int x0                    = m_curPos.x();
+        const int y0                    = m_curPos.y();
+        const TileCoverage tileCoverage = getTileCoverage(x0, y0);
+        const bool fullyCovered         = tileCoverage == TILECOVERAGE_FULL;
+
+        if (tileCoverage == TILECOVERAGE_NONE)
+        {
+            // Skip rest of the tile on this block row
+            advanceTo(x0 + COVERAGE_TILE_SIZE - (x0 - m_scanMin.x()) % COVERAGE_TILE_SIZE);
+            continue;
+        }
 
         // Base subpixel coords
         const int64_t sx0 = toSubpixelCoord(x0, m_subpixelBits);
@@ -724,9 +901,11 @@ void TriangleRasterizer::rasterizeMultiSample(FragmentPacket *const fragmentPack
         const int64_t sx[4] = {sx0, sx1, sx0, sx1};
         const int64_t sy[4] = {sy0, sy0, sy1, sy1};
 
-        // Viewport test
-        const bool outX1 = x0 + 1 == m_viewport.x() + m_viewport.z();
-        const bool outY1 = y0 + 1 == m_viewport.y() + m_viewport.w();
+        // Viewport and region test
+        const bool outX0 = x0 < m_regionMin.x();
+        const bool outY0 = y0 < m_regionMin.y();
+        const bool outX1 = x0 + 1 > m_regionMax.x();
+        const bool outY1 = y0 + 1 > m_regionMax.y();
 
         DE_ASSERT(x0 < m_viewport.x() + m_viewport.z());
         DE_ASSERT(y0 < m_viewport.y() + m_viewport.w());
@@ -753,34 +932,34 @@ void TriangleRasterizer::rasterizeMultiSample(FragmentPacket *const fragmentPack
             }
         }
 
-        // Compute coverage mask
-        for (int sampleNdx = 0; sampleNdx < NumSamples; sampleNdx++)
+        // Compute coverage mask, fully covered tiles only need the region test
+        if (fullyCovered)
+            coverage = getRegionCoverage(NumSamples, outX0, outY0, outX1, outY1);
+        else
         {
-            coverage =
-                setCoverageValue(coverage, NumSamples, 0, 0, sampleNdx,
-                                 isInsideCCW(m_edge01, e01[sampleNdx][0]) && isInsideCCW(m_edge12, e12[sampleNdx][0]) &&
-                                     isInsideCCW(m_edge20, e20[sampleNdx][0]));
-            coverage = setCoverageValue(coverage, NumSamples, 1, 0, sampleNdx,
-                                        !outX1 && isInsideCCW(m_edge01, e01[sampleNdx][1]) &&
-                                            isInsideCCW(m_edge12, e12[sampleNdx][1]) &&
-                                            isInsideCCW(m_edge20, e20[sampleNdx][1]));
-            coverage = setCoverageValue(coverage, NumSamples, 0, 1, sampleNdx,
-                                        !outY1 && isInsideCCW(m_edge01, e01[sampleNdx][2]) &&
-                                            isInsideCCW(m_edge12, e12[sampleNdx][2]) &&
-                                            isInsideCCW(m_edge20, e20[sampleNdx][2]));
-            coverage = setCoverageValue(coverage, NumSamples, 1, 1, sampleNdx,
-                                        !outX1 && !outY1 && isInsideCCW(m_edge01, e01[sampleNdx][3]) &&
-                                            isInsideCCW(m_edge12, e12[sampleNdx][3]) &&
-                                            isInsideCCW(m_edge20, e20[sampleNdx][3]));
+            for (int sampleNdx = 0; sampleNdx < NumSamples; sampleNdx++)
+            {
+                coverage = setCoverageValue(coverage, NumSamples, 0, 0, sampleNdx,
+                                            !outX0 && !outY0 && isInsideCCW(m_edge01, e01[sampleNdx][0]) &&
+                                                isInsideCCW(m_edge12, e12[sampleNdx][0]) &&
+                                                isInsideCCW(m_edge20, e20[sampleNdx][0]));
+                coverage = setCoverageValue(coverage, NumSamples, 1, 0, sampleNdx,
+                                            !outX1 && !outY0 && isInsideCCW(m_edge01, e01[sampleNdx][1]) &&
+                                                isInsideCCW(m_edge12, e12[sampleNdx][1]) &&
+                                                isInsideCCW(m_edge20, e20[sampleNdx][1]));
+                coverage = setCoverageValue(coverage, NumSamples, 0, 1, sampleNdx,
+                                            !outX0 && !outY1 && isInsideCCW(m_edge01, e01[sampleNdx][2]) &&
+                                                isInsideCCW(m_edge12, e12[sampleNdx][2]) &&
+                                                isInsideCCW(m_edge20, e20[sampleNdx][2]));
+                coverage = setCoverageValue(coverage, NumSamples, 1, 1, sampleNdx,
+                                            !outX1 && !outY1 && isInsideCCW(m_edge01, e01[sampleNdx][3]) &&
+                                                isInsideCCW(m_edge12, e12[sampleNdx][3]) &&
+                                                isInsideCCW(m_edge20, e20[sampleNdx][3]));
+            }
         }
 
         // Advance to next location
-        m_curPos.x() += 2;
-        if (m_curPos.x() > m_bboxMax.x())
-        {
-            m_curPos.y() += 2;
-            m_curPos.x() = m_bboxMin.x();
-        }
+        advanceTo(x0 + 2);
 
         if (coverage == 0)
             continue; // Discard.
@@ -1206,4 +1385,155 @@ void LineExitDiamondGenerator::rasterize(LineExitDiamond *const lineDiamonds, co
     numWritten = diamondNdx;
 }
 
+namespace
+{
+
+tcu::Vec4 getRandomVertex(de::Random &rnd, const tcu::IVec4 &viewport)
+{
+    // Snap some coordinates to pixel quarters to hit edges exactly.
+    const float x = rnd.getFloat((float)viewport.x() - 32.0f, (float)(viewport.x() + viewport.z()) + 32.0f);
+    const float y = rnd.getFloat((float)viewport.y() - 32.0f, (float)(viewport.y() + viewport.w()) + 32.0f);
+
+    if (rnd.getBool())
+        return tcu::Vec4(deFloatFloor(x * 4.0f) / 4.0f, deFloatFloor(y * 4.0f) / 4.0f, 0.0f, 1.0f);
+    else
+        return tcu::Vec4(x, y, 0.0f, 1.0f);
+}
+
+//! Sample coverage of each pixel in viewport computed by testing every sample against the edges.
+std::vector<uint32_t> getReferenceCoverage(const tcu::IVec4 &viewport, const tcu::IVec4 &region, int numSamples,
+                                           const RasterizationState &state, int subpixelBits, const tcu::Vec4 &v0,
+                                           const tcu::Vec4 &v1, const tcu::Vec4 &v2)
+{
+    const float *const samplePts = numSamples == 4 ? s_samplePts4 : s_samplePts16;
+    std::vector<uint32_t> coverage((size_t)(viewport.z() * viewport.w()), 0u);
+    EdgeFunction edges[3];
+
+    DE_ASSERT(numSamples == 1 || numSamples == 4 || numSamples == 16);
+
+    initTriangleEdges(edges[0], edges[1], edges[2], state.winding, state.horizontalFill, state.verticalFill,
+                      toSubpixelCoord(v0.x(), subpixelBits), toSubpixelCoord(v0.y(), subpixelBits),
+                      toSubpixelCoord(v1.x(), subpixelBits), toSubpixelCoord(v1.y(), subpixelBits),
+                      toSubpixelCoord(v2.x(), subpixelBits), toSubpixelCoord(v2.y(), subpixelBits));
+
+    for (int y = 0; y < viewport.w(); y++)
+        for (int x = 0; x < viewport.z(); x++)
+        {
+            const tcu::IVec2 pos = viewport.swizzle(0, 1) + tcu::IVec2(x, y);
+
+            if (!de::inBounds(pos.x(), region.x(), region.x() + region.z()) ||
+                !de::inBounds(pos.y(), region.y(), region.y() + region.w()))
+                continue;
+
+            for (int sampleNdx = 0; sampleNdx < numSamples; sampleNdx++)
+            {
+                const int64_t sx = toSubpixelCoord(pos.x(), subpixelBits) +
+                                   (numSamples == 1 ? (1ll << (subpixelBits - 1)) :
+                                                      toSubpixelCoord(samplePts[sampleNdx * 2 + 0], subpixelBits));
+                const int64_t sy = toSubpixelCoord(pos.y(), subpixelBits) +
+                                   (numSamples == 1 ? (1ll << (subpixelBits - 1)) :
+                                                      toSubpixelCoord(samplePts[sampleNdx * 2 + 1], subpixelBits));
+                bool inside      = true;
+
+                for (int edgeNdx = 0; edgeNdx < DE_LENGTH_OF_ARRAY(edges); edgeNdx++)
+                    inside = inside && isInsideCCW(edges[edgeNdx], evaluateEdge(edges[edgeNdx], sx, sy));
+
+                if (inside)
+                    coverage[y * viewport.z() + x] |= 1u << sampleNdx;
+            }
+        }
+
+    return coverage;
+}
+
+} // namespace
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Compare tiled rasterization to testing every sample
+ *
+ * Random triangles, including slivers and triangles crossing the viewport
+ * edges, are rasterized with random fill rules and regions. Viewports are
+ * wider than MAX_TILE_SPAN tiles and few packets are rasterized per call,
+ * so tile classification is resumed in the middle of tile rows.
+ *//*--------------------------------------------------------------------*/
+void TriangleRasterizer_selfTest(void)
+{
+    const int numSamplesCases[] = {1, 4, 16};
+    const int subpixelBits      = RenderState::DEFAULT_SUBPIXEL_BITS;
+    const int numIterations     = 300;
+    const int maxPacketsPerCall = 7;
+    de::Random rnd(0x7a3c19e5);
+
+    for (int iterNdx = 0; iterNdx < numIterations; iterNdx++)
+    {
+        const int numSamples = numSamplesCases[iterNdx % DE_LENGTH_OF_ARRAY(numSamplesCases)];
+        const tcu::IVec4 viewport(rnd.getInt(0, 16), rnd.getInt(0, 16), rnd.getInt(1, 600), rnd.getInt(1, 32));
+        const tcu::IVec4 region =
+            rnd.getBool() ? viewport :
+                            tcu::IVec4(rnd.getInt(0, 300), rnd.getInt(0, 24), rnd.getInt(1, 300), rnd.getInt(1, 24));
+        const tcu::Vec4 v0 = getRandomVertex(rnd, viewport);
+        const tcu::Vec4 v1 = getRandomVertex(rnd, viewport);
+        tcu::Vec4 v2       = getRandomVertex(rnd, viewport);
+        RasterizationState state;
+
+        // Sliver
+        if (iterNdx % 4 == 0)
+            v2 = v0 + (v1 - v0) * rnd.getFloat() +
+                 tcu::Vec4(rnd.getFloat(-1.0f, 1.0f), rnd.getFloat(-1.0f, 1.0f), 0.0f, 0.0f);
+
+        state.winding        = rnd.getBool() ? WINDING_CCW : WINDING_CW;
+        state.horizontalFill = rnd.getBool() ? FILL_LEFT : FILL_RIGHT;
+        state.verticalFill   = rnd.getBool() ? FILL_BOTTOM : FILL_TOP;
+
+        const std::vector<uint32_t> reference =
+            getReferenceCoverage(viewport, region, numSamples, state, subpixelBits, v0, v1, v2);
+        std::vector<uint32_t> result(reference.size(), 0u);
+        TriangleRasterizer rasterizer(viewport, numSamples, state, subpixelBits);
+        FragmentPacket packets[maxPacketsPerCall];
+
+        rasterizer.init(v0, v1, v2);
+
+        if (region != viewport)
+            rasterizer.setRegion(region);
+
+        for (;;)
+        {
+            int numPackets = 0;
+
+            rasterizer.rasterize(packets, DE_NULL, maxPacketsPerCall, numPackets);
+
+            if (numPackets == 0)
+                break;
+
+            for (int packetNdx = 0; packetNdx < numPackets; packetNdx++)
+            {
+                for (int fragNdx = 0; fragNdx < 4; fragNdx++)
+                {
+                    const int fragX          = fragNdx % 2;
+                    const int fragY          = fragNdx / 2;
+                    const tcu::IVec2 pos     = packets[packetNdx].position + tcu::IVec2(fragX, fragY);
+                    const uint32_t fragMask  = (uint32_t)((1ull << numSamples) - 1);
+                    const uint32_t fragCover = (uint32_t)(packets[packetNdx].coverage >>
+                                                          getCoverageOffset(numSamples, fragX, fragY)) &
+                                               fragMask;
+
+                    if (fragCover == 0)
+                        continue;
+
+                    TCU_CHECK(de::inBounds(pos.x(), viewport.x(), viewport.x() + viewport.z()) &&
+                              de::inBounds(pos.y(), viewport.y(), viewport.y() + viewport.w()));
+
+                    uint32_t &dst = result[(pos.y() - viewport.y()) * viewport.z() + (pos.x() - viewport.x())];
+
+                    // Each fragment is generated only once
+                    TCU_CHECK(dst == 0);
+                    dst = fragCover;
+                }
+            }
+        }
+
+        TCU_CHECK(result == reference);
+    }
+}
+
 } // namespace rr
@@ -114,6 +114,7 @@ struct EdgeFunction
  *  - Depth interpolation
  *  - Perspective-correct barycentric computation for interpolation
  *  - Visible face determination
+ *  - Hierarchical rejection and acceptance of 8x8 pixel tiles
  *
  * It does not (and will not) implement following:
  *  - Triangle setup
@@ -137,10 +138,23 @@ public:
     {
         return m_face;
     }
+    void setRegion(const tcu::IVec4 &region);
     void rasterize(FragmentPacket *const fragmentPackets, float *const depthValues, const int maxFragmentPackets,
                    int &numPacketsRasterized);
 
 private:
+    enum TileCoverage
+    {
+        TILECOVERAGE_NONE = 0, //!< No sample in tile is covered.
+        TILECOVERAGE_PARTIAL,  //!< Samples must be tested individually.
+        TILECOVERAGE_FULL,     //!< All samples in tile are covered.
+    };
+
+    enum
+    {
+        MAX_TILE_SPAN = 64 //!< Tiles classified at once, wider tile rows are classified in pieces.
+    };
+
     void rasterizeSingleSample(FragmentPacket *const fragmentPackets, float *const depthValues,
                                const int maxFragmentPackets, int &numPacketsRasterized);
 
@@ -148,6 +162,10 @@ private:
     void rasterizeMultiSample(FragmentPacket *const fragmentPackets, float *const depthValues,
                               const int maxFragmentPackets, int &numPacketsRasterized);
 
+    TileCoverage getTileCoverage(int x, int y);
+    void classifyTiles(int tileRowNdx, int firstTileNdx);
+    void advanceTo(int x);
+
     // Constant rasterization state.
     const tcu::IVec4 m_viewport;
     const int m_numSamples;
@@ -166,8 +184,15 @@ private:
     FaceType m_face;                           //!< Triangle orientation, eg. visible face.
     tcu::IVec2 m_bboxMin;                      //!< Bounding box min (inclusive).
     tcu::IVec2 m_bboxMax;                      //!< Bounding box max (inclusive).
+    tcu::IVec2 m_regionMin;                    //!< Region min (inclusive), fragments outside region are not generated.
+    tcu::IVec2 m_regionMax;                    //!< Region max (inclusive).
+    tcu::IVec2 m_scanMin;                      //!< First rasterized 2x2 block (inclusive).
+    tcu::IVec2 m_scanMax;                      //!< Last rasterized 2x2 block (inclusive).
     tcu::IVec2 m_curPos;                       //!< Current rasterization position.
     ViewportOrientation m_viewportOrientation; //!< Direction of +x+y axis
+    uint8_t m_tileCoverage[MAX_TILE_SPAN];     //!< Coverage class of tiles starting from m_firstTileNdx.
+    int m_tileRowNdx;                          //!< Tile row m_tileCoverage was computed for, -1 if none.
+    int m_firstTileNdx;                        //!< First tile in m_tileCoverage.
 } DE_WARN_UNUSED_TYPE;
 
 /*--------------------------------------------------------------------*//*!
@@ -302,6 +327,8 @@ private:
     tcu::IVec2 m_curPos;  //!< Current rasterization position.
 };
 
+void TriangleRasterizer_selfTest(void);
+
 } // namespace rr
 
 #endif // _RRRASTERIZER_HPP
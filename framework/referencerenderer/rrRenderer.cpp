@@ -28,9 +28,12 @@
 #include "rrPrimitiveAssembler.hpp"
 #include "rrFragmentOperations.hpp"
 #include "rrRasterizer.hpp"
+#include "tcuParallelFor.hpp"
 #include "deMemory.h"
+#include "deRandom.hpp"
 
-#include <set>
+#include <algorithm>
+#include <functional>
 #include <limits>
 
 namespace rr
@@ -42,6 +45,13 @@ typedef double ClipFloat; // floating point type used in clipping
 
 typedef tcu::Vector<ClipFloat, 4> ClipVec4;
 
+enum
+{
+    RASTER_TILE_SIZE           = 64,    //!< Tile size in pixels for multi-threaded rasterization.
+    RASTER_MIN_PARALLEL_PIXELS = 16384, //!< Draws covering fewer pixels are rasterized on the calling thread.
+    VERTEX_SHADING_CHUNK_SIZE  = 256    //!< Vertices per range in multi-threaded vertex shading.
+};
+
 struct RasterizationInternalBuffers
 {
     std::vector<FragmentPacket> fragmentPackets;
@@ -93,8 +103,9 @@ bool isEmpty(const rr::MultisampleConstPixelBufferAccess &access)
 struct DrawContext
 {
     int primitiveID;
+    const int numThreads;
 
-    DrawContext(void) : primitiveID(0)
+    DrawContext(int numThreads_) : primitiveID(0), numThreads(numThreads_)
     {
     }
 };
@@ -867,59 +878,96 @@ void transformClipCoordsToWindowCoords(const RenderState &state, ContainerType &
         transformPrimitiveClipCoordsToWindowCoords(state, *it);
 }
 
-void makeSharedVerticeDistinct(VertexPacket *&packet, std::set<VertexPacket *, std::less<void *>> &vertices,
-                               VertexPacketAllocator &vpalloc)
+void copyVertexPacketOutputs(VertexPacket &dst, const VertexPacket &src, size_t numOutputs)
 {
-    // distinct
-    if (vertices.find(packet) == vertices.end())
-    {
-        vertices.insert(packet);
-    }
-    else
-    {
-        VertexPacket *newPacket = vpalloc.alloc();
+    dst.position    = src.position;
+    dst.pointSize   = src.pointSize;
+    dst.primitiveID = src.primitiveID;
 
-        // copy packet output values
-        newPacket->position    = packet->position;
-        newPacket->pointSize   = packet->pointSize;
-        newPacket->primitiveID = packet->primitiveID;
-
-        for (size_t outputNdx = 0; outputNdx < vpalloc.getNumVertexOutputs(); ++outputNdx)
-            newPacket->outputs[outputNdx] = packet->outputs[outputNdx];
-
-        // no need to insert new packet to "vertices" as newPacket is unique
-        packet = newPacket;
-    }
+    for (size_t outputNdx = 0; outputNdx < numOutputs; ++outputNdx)
+        dst.outputs[outputNdx] = src.outputs[outputNdx];
 }
 
-void makeSharedVerticesDistinct(pa::Triangle &target, std::set<VertexPacket *, std::less<void *>> &vertices,
-                                VertexPacketAllocator &vpalloc)
+void getVertexReferences(std::vector<VertexPacket **> &dst, pa::Triangle &target)
 {
-    makeSharedVerticeDistinct(target.v0, vertices, vpalloc);
-    makeSharedVerticeDistinct(target.v1, vertices, vpalloc);
-    makeSharedVerticeDistinct(target.v2, vertices, vpalloc);
+    dst.push_back(&target.v0);
+    dst.push_back(&target.v1);
+    dst.push_back(&target.v2);
 }
 
-void makeSharedVerticesDistinct(pa::Line &target, std::set<VertexPacket *, std::less<void *>> &vertices,
-                                VertexPacketAllocator &vpalloc)
+void getVertexReferences(std::vector<VertexPacket **> &dst, pa::Line &target)
 {
-    makeSharedVerticeDistinct(target.v0, vertices, vpalloc);
-    makeSharedVerticeDistinct(target.v1, vertices, vpalloc);
+    dst.push_back(&target.v0);
+    dst.push_back(&target.v1);
 }
 
-void makeSharedVerticesDistinct(pa::Point &target, std::set<VertexPacket *, std::less<void *>> &vertices,
-                                VertexPacketAllocator &vpalloc)
+void getVertexReferences(std::vector<VertexPacket **> &dst, pa::Point &target)
 {
-    makeSharedVerticeDistinct(target.v0, vertices, vpalloc);
+    dst.push_back(&target.v0);
 }
 
+/*--------------------------------------------------------------------*//*!
+ * \brief Give each primitive its own copy of shared vertices
+ *
+ * First reference to a packet keeps the packet, later references get a
+ * copy. References are grouped by sorting a flat array, copies are
+ * allocated in a single block.
+ *//*--------------------------------------------------------------------*/
 template <typename ContainerType>
 void makeSharedVerticesDistinct(ContainerType &list, VertexPacketAllocator &vpalloc)
 {
-    std::set<VertexPacket *, std::less<void *>> vertices;
+    std::vector<VertexPacket **> references;
+    std::vector<int> order;
+    int numCopies = 0;
+
+    references.reserve(list.size() * 3);
 
     for (typename ContainerType::iterator it = list.begin(); it != list.end(); ++it)
-        makeSharedVerticesDistinct(*it, vertices, vpalloc);
+        getVertexReferences(references, *it);
+
+    // Sort references by packet, keeping reference order within each packet
+    order.resize(references.size());
+    for (int ndx = 0; ndx < (int)order.size(); ++ndx)
+        order[ndx] = ndx;
+
+    std::sort(order.begin(), order.end(),
+              [&](int a, int b)
+              {
+                  if (*references[a] != *references[b])
+                      return std::less<VertexPacket *>()(*references[a], *references[b]);
+                  return a < b;
+              });
+
+    for (size_t ndx = 1; ndx < order.size(); ++ndx)
+    {
+        if (*references[order[ndx]] == *references[order[ndx - 1]])
+            ++numCopies;
+    }
+
+    if (numCopies == 0)
+        return;
+
+    // Replace all but first reference with copies
+    {
+        const std::vector<VertexPacket *> copies = vpalloc.allocArray((size_t)numCopies);
+        const VertexPacket *prevPacket           = DE_NULL;
+        int copyNdx                              = 0;
+
+        for (size_t ndx = 0; ndx < order.size(); ++ndx)
+        {
+            VertexPacket *&reference = *references[order[ndx]];
+
+            if (reference == prevPacket)
+            {
+                copyVertexPacketOutputs(*copies[copyNdx], *reference, vpalloc.getNumVertexOutputs());
+                reference = copies[copyNdx++];
+            }
+            else
+                prevPacket = reference;
+        }
+
+        DE_ASSERT(copyNdx == numCopies);
+    }
 }
 
 void generatePrimitiveIDs(pa::Triangle &target, int id)
@@ -1115,7 +1163,7 @@ void writeFragmentPackets(const RenderState &state, const RenderTarget &renderTa
 }
 
 void rasterizePrimitive(const RenderState &state, const RenderTarget &renderTarget, const Program &program,
-                        const pa::Triangle &triangle, const tcu::IVec4 &renderTargetRect,
+                        const pa::Triangle &triangle, const tcu::IVec4 &renderTargetRect, const tcu::IVec4 &region,
                         RasterizationInternalBuffers &buffers)
 {
     const int numSamples      = renderTarget.getNumSamples();
@@ -1132,6 +1180,8 @@ void rasterizePrimitive(const RenderState &state, const RenderTarget &renderTarg
         (state.cullMode == CULLMODE_BACK && visibleFace == FACETYPE_BACK))
         return;
 
+    rasterizer.setRegion(region);
+
     // Shading context
     FragmentShadingContext shadingContext(
         triangle.v0->outputs, triangle.v1->outputs, triangle.v2->outputs, &buffers.shaderOutputs[0],
@@ -1190,8 +1240,13 @@ void rasterizePrimitive(const RenderState &state, const RenderTarget &renderTarg
 }
 
 void rasterizePrimitive(const RenderState &state, const RenderTarget &renderTarget, const Program &program,
-                        const pa::Line &line, const tcu::IVec4 &renderTargetRect, RasterizationInternalBuffers &buffers)
+                        const pa::Line &line, const tcu::IVec4 &renderTargetRect, const tcu::IVec4 &region,
+                        RasterizationInternalBuffers &buffers)
 {
+    // Line rasterizers don't support limiting rasterization to a region
+    DE_ASSERT(region == renderTargetRect);
+    DE_UNREF(region);
+
     const int numSamples      = renderTarget.getNumSamples();
     const float depthClampMin = de::min(state.viewport.zn, state.viewport.zf);
     const float depthClampMax = de::max(state.viewport.zn, state.viewport.zf);
@@ -1247,7 +1302,7 @@ void rasterizePrimitive(const RenderState &state, const RenderTarget &renderTarg
 }
 
 void rasterizePrimitive(const RenderState &state, const RenderTarget &renderTarget, const Program &program,
-                        const pa::Point &point, const tcu::IVec4 &renderTargetRect,
+                        const pa::Point &point, const tcu::IVec4 &renderTargetRect, const tcu::IVec4 &region,
                         RasterizationInternalBuffers &buffers)
 {
     const int numSamples      = renderTarget.getNumSamples();
@@ -1269,6 +1324,8 @@ void rasterizePrimitive(const RenderState &state, const RenderTarget &renderTarg
 
     rasterizer1.init(w0, w1, w2);
     rasterizer2.init(w0, w2, w3);
+    rasterizer1.setRegion(region);
+    rasterizer2.setRegion(region);
 
     // Shading context
     FragmentShadingContext shadingContext(point.v0->outputs, DE_NULL, DE_NULL, &buffers.shaderOutputs[0],
@@ -1322,46 +1379,181 @@ void rasterizePrimitive(const RenderState &state, const RenderTarget &renderTarg
     }
 }
 
-template <typename ContainerType>
-void rasterize(const RenderState &state, const RenderTarget &renderTarget, const Program &program,
-               const ContainerType &list)
+void initRasterizationBuffers(RasterizationInternalBuffers &buffers, std::vector<float> &depthValues,
+                               const RenderTarget &renderTarget, const Program &program)
 {
     const int numSamples            = renderTarget.getNumSamples();
     const int numFragmentOutputs    = (int)program.fragmentShader->getOutputs().size();
     const size_t maxFragmentPackets = 128;
 
-    const tcu::IVec4 viewportRect     = tcu::IVec4(state.viewport.rect.left, state.viewport.rect.bottom,
-                                                   state.viewport.rect.width, state.viewport.rect.height);
-    const tcu::IVec4 bufferRect       = getBufferSize(renderTarget.getColorBuffer(0));
-    const tcu::IVec4 renderTargetRect = rectIntersection(viewportRect, bufferRect);
-
-    // shared buffers for all primitives
-    std::vector<FragmentPacket> fragmentPackets(maxFragmentPackets);
-    std::vector<GenericVec4> shaderOutputs(maxFragmentPackets * 4 * numFragmentOutputs);
-    std::vector<GenericVec4> shaderOutputsSrc1(maxFragmentPackets * 4 * numFragmentOutputs);
-    std::vector<Fragment> shadedFragments(maxFragmentPackets * 4);
-    std::vector<float> depthValues(0);
-    float *depthBufferPointer = DE_NULL;
-
-    RasterizationInternalBuffers buffers;
+    buffers.fragmentPackets.resize(maxFragmentPackets);
+    buffers.shaderOutputs.resize(maxFragmentPackets * 4 * numFragmentOutputs);
+    buffers.shaderOutputsSrc1.resize(maxFragmentPackets * 4 * numFragmentOutputs);
+    buffers.shadedFragments.resize(maxFragmentPackets * 4);
+    buffers.fragmentDepthBuffer = DE_NULL;
 
     // calculate depth only if we have a depth buffer
     if (!isEmpty(renderTarget.getDepthBuffer()))
     {
         depthValues.resize(maxFragmentPackets * 4 * numSamples);
-        depthBufferPointer = &depthValues[0];
+        buffers.fragmentDepthBuffer = &depthValues[0];
     }
+}
 
-    // set buffers
-    buffers.fragmentPackets.swap(fragmentPackets);
-    buffers.shaderOutputs.swap(shaderOutputs);
-    buffers.shaderOutputsSrc1.swap(shaderOutputsSrc1);
-    buffers.shadedFragments.swap(shadedFragments);
-    buffers.fragmentDepthBuffer = depthBufferPointer;
+//! Window-space bounding box (xMin, yMin, xMax, yMax) of primitive
+tcu::Vec4 getPrimitiveWindowBounds(const pa::Triangle &triangle)
+{
+    const tcu::Vec4 &p0 = triangle.v0->position;
+    const tcu::Vec4 &p1 = triangle.v1->position;
+    const tcu::Vec4 &p2 = triangle.v2->position;
+
+    return tcu::Vec4(de::min(de::min(p0.x(), p1.x()), p2.x()), de::min(de::min(p0.y(), p1.y()), p2.y()),
+                     de::max(de::max(p0.x(), p1.x()), p2.x()), de::max(de::max(p0.y(), p1.y()), p2.y()));
+}
+
+tcu::Vec4 getPrimitiveWindowBounds(const pa::Point &point)
+{
+    const tcu::Vec4 &p  = point.v0->position;
+    const float offset = point.v0->pointSize / 2.0f;
+
+    return tcu::Vec4(p.x() - offset, p.y() - offset, p.x() + offset, p.y() + offset);
+}
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Conservative range of pixels (x0, y0, x1, y1) primitive may cover
+ *
+ * Bounds are expanded by a pixel to account for subpixel snapping and
+ * fill rules, and clamped to rect. Returned range is inclusive.
+ *//*--------------------------------------------------------------------*/
+tcu::IVec4 getPrimitivePixelRange(const tcu::Vec4 &bounds, const tcu::IVec4 &rect)
+{
+    const float xMin = (float)rect.x();
+    const float yMin = (float)rect.y();
+    const float xMax = (float)(rect.x() + rect.z() - 1);
+    const float yMax = (float)(rect.y() + rect.w() - 1);
+
+    // NaN bounds, assume primitive covers everything
+    if (!(bounds.x() <= bounds.z()) || !(bounds.y() <= bounds.w()))
+        return tcu::IVec4(rect.x(), rect.y(), rect.x() + rect.z() - 1, rect.y() + rect.w() - 1);
+
+    return tcu::IVec4((int)de::clamp(deFloatFloor(bounds.x()) - 1.0f, xMin, xMax),
+                      (int)de::clamp(deFloatFloor(bounds.y()) - 1.0f, yMin, yMax),
+                      (int)de::clamp(deFloatCeil(bounds.z()) + 1.0f, xMin, xMax),
+                      (int)de::clamp(deFloatCeil(bounds.w()) + 1.0f, yMin, yMax));
+}
+
+template <typename ContainerType>
+void rasterizeSerial(const RenderState &state, const RenderTarget &renderTarget, const Program &program,
+                     const ContainerType &list, const tcu::IVec4 &renderTargetRect)
+{
+    // shared buffers for all primitives
+    RasterizationInternalBuffers buffers;
+    std::vector<float> depthValues;
+
+    initRasterizationBuffers(buffers, depthValues, renderTarget, program);
 
     // rasterize
     for (typename ContainerType::const_iterator it = list.begin(); it != list.end(); ++it)
-        rasterizePrimitive(state, renderTarget, program, *it, renderTargetRect, buffers);
+        rasterizePrimitive(state, renderTarget, program, *it, renderTargetRect, renderTargetRect, buffers);
+}
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Rasterize triangles or points on multiple threads
+ *
+ * Primitives are binned to tiles in API order and each tile is rasterized,
+ * shaded and written by a single thread. Fragments are generated only
+ * inside the tile, so each pixel sees exactly the same sequence of
+ * fragments as in serial rasterization.
+ *//*--------------------------------------------------------------------*/
+template <typename ContainerType>
+void rasterizeTiled(const RenderState &state, const RenderTarget &renderTarget, const Program &program,
+                    const ContainerType &list, const tcu::IVec4 &renderTargetRect, int numThreads)
+{
+    const int numTilesX = deDivRoundUp32(renderTargetRect.z(), RASTER_TILE_SIZE);
+    const int numTilesY = deDivRoundUp32(renderTargetRect.w(), RASTER_TILE_SIZE);
+    std::vector<std::vector<int>> tilePrimitives((size_t)(numTilesX * numTilesY));
+    std::vector<int> nonEmptyTiles;
+    int64_t numCoveredPixels = 0;
+
+    // Bin primitives
+    for (int primNdx = 0; primNdx < (int)list.size(); ++primNdx)
+    {
+        const tcu::IVec4 pixels = getPrimitivePixelRange(getPrimitiveWindowBounds(list[primNdx]), renderTargetRect);
+        const int tileX0        = (pixels.x() - renderTargetRect.x()) / RASTER_TILE_SIZE;
+        const int tileY0        = (pixels.y() - renderTargetRect.y()) / RASTER_TILE_SIZE;
+        const int tileX1        = (pixels.z() - renderTargetRect.x()) / RASTER_TILE_SIZE;
+        const int tileY1        = (pixels.w() - renderTargetRect.y()) / RASTER_TILE_SIZE;
+
+        for (int tileY = tileY0; tileY <= tileY1; ++tileY)
+            for (int tileX = tileX0; tileX <= tileX1; ++tileX)
+                tilePrimitives[tileY * numTilesX + tileX].push_back(primNdx);
+
+        numCoveredPixels += (int64_t)(pixels.z() - pixels.x() + 1) * (int64_t)(pixels.w() - pixels.y() + 1);
+    }
+
+    for (int tileNdx = 0; tileNdx < (int)tilePrimitives.size(); ++tileNdx)
+    {
+        if (!tilePrimitives[tileNdx].empty())
+            nonEmptyTiles.push_back(tileNdx);
+    }
+
+    // Rasterize tiles
+    {
+        const auto rasterizeTiles = [&](int begin, int end)
+        {
+            RasterizationInternalBuffers buffers;
+            std::vector<float> depthValues;
+
+            initRasterizationBuffers(buffers, depthValues, renderTarget, program);
+
+            for (int ndx = begin; ndx < end; ++ndx)
+            {
+                const int tileNdx             = nonEmptyTiles[ndx];
+                const int tileX               = renderTargetRect.x() + (tileNdx % numTilesX) * RASTER_TILE_SIZE;
+                const int tileY               = renderTargetRect.y() + (tileNdx / numTilesX) * RASTER_TILE_SIZE;
+                const tcu::IVec4 tileRect     = tcu::IVec4(tileX, tileY, RASTER_TILE_SIZE, RASTER_TILE_SIZE);
+                const std::vector<int> &prims = tilePrimitives[tileNdx];
+
+                for (size_t primNdx = 0; primNdx < prims.size(); ++primNdx)
+                    rasterizePrimitive(state, renderTarget, program, list[prims[primNdx]], renderTargetRect,
+                                       tileRect, buffers);
+            }
+        };
+
+        if (numCoveredPixels < RASTER_MIN_PARALLEL_PIXELS)
+            numThreads = 1;
+
+        tcu::parallelFor((int)nonEmptyTiles.size(), 1, rasterizeTiles, numThreads);
+    }
+}
+
+template <typename ContainerType>
+void rasterize(const RenderState &state, const RenderTarget &renderTarget, const Program &program,
+               const ContainerType &list, int numThreads)
+{
+    const tcu::IVec4 viewportRect     = tcu::IVec4(state.viewport.rect.left, state.viewport.rect.bottom,
+                                                   state.viewport.rect.width, state.viewport.rect.height);
+    const tcu::IVec4 bufferRect       = getBufferSize(renderTarget.getColorBuffer(0));
+    const tcu::IVec4 renderTargetRect = rectIntersection(viewportRect, bufferRect);
+
+    if (numThreads != 1 && renderTargetRect.z() * renderTargetRect.w() >= RASTER_MIN_PARALLEL_PIXELS)
+        rasterizeTiled(state, renderTarget, program, list, renderTargetRect, numThreads);
+    else
+        rasterizeSerial(state, renderTarget, program, list, renderTargetRect);
+}
+
+//! Lines are always rasterized on a single thread, line rasterizers can't be limited to a tile.
+void rasterize(const RenderState &state, const RenderTarget &renderTarget, const Program &program,
+               const std::vector<pa::Line> &list, int numThreads)
+{
+    const tcu::IVec4 viewportRect     = tcu::IVec4(state.viewport.rect.left, state.viewport.rect.bottom,
+                                                   state.viewport.rect.width, state.viewport.rect.height);
+    const tcu::IVec4 bufferRect       = getBufferSize(renderTarget.getColorBuffer(0));
+    const tcu::IVec4 renderTargetRect = rectIntersection(viewportRect, bufferRect);
+
+    DE_UNREF(numThreads);
+
+    rasterizeSerial(state, renderTarget, program, list, renderTargetRect);
 }
 
 /*--------------------------------------------------------------------*//*!
@@ -1369,7 +1561,7 @@ void rasterize(const RenderState &state, const RenderTarget &renderTarget, const
  *//*--------------------------------------------------------------------*/
 template <typename ContainerType>
 void drawBasicPrimitives(const RenderState &state, const RenderTarget &renderTarget, const Program &program,
-                         ContainerType &primList, VertexPacketAllocator &vpalloc)
+                         ContainerType &primList, const DrawContext &drawContext, VertexPacketAllocator &vpalloc)
 {
     const bool clipZ = !state.fragOps.depthClampEnabled;
 
@@ -1386,7 +1578,7 @@ void drawBasicPrimitives(const RenderState &state, const RenderTarget &renderTar
     transformClipCoordsToWindowCoords(state, primList);
 
     // Rasterize and paint
-    rasterize(state, renderTarget, program, primList);
+    rasterize(state, renderTarget, program, primList, drawContext.numThreads);
 }
 
 void copyVertexPacketPointers(const VertexPacket **dst, const pa::Point &in)
@@ -1428,7 +1620,7 @@ void copyVertexPacketPointers(const VertexPacket **dst, const pa::TriangleAdjace
 template <PrimitiveType DrawPrimitiveType> // \note DrawPrimitiveType  can only be Points, line_strip, or triangle_strip
 void drawGeometryShaderOutputAsPrimitives(const RenderState &state, const RenderTarget &renderTarget,
                                           const Program &program, VertexPacket *const *vertices, size_t numVertices,
-                                          VertexPacketAllocator &vpalloc)
+                                          const DrawContext &drawContext, VertexPacketAllocator &vpalloc)
 {
     // Run primitive assembly for generated stream
 
@@ -1447,7 +1639,7 @@ void drawGeometryShaderOutputAsPrimitives(const RenderState &state, const Render
 
     // Draw assembled primitives
 
-    drawBasicPrimitives(state, renderTarget, program, inputPrimitives, vpalloc);
+    drawBasicPrimitives(state, renderTarget, program, inputPrimitives, drawContext, vpalloc);
 }
 
 template <PrimitiveType DrawPrimitiveType>
@@ -1508,15 +1700,18 @@ void drawWithGeometryShader(const RenderState &state, const RenderTarget &render
             {
             case rr::GEOMETRYSHADEROUTPUTTYPE_POINTS:
                 drawGeometryShaderOutputAsPrimitives<PRIMITIVETYPE_POINTS>(
-                    state, renderTarget, program, &emitted[primitiveBegin], primitiveEnd - primitiveBegin, vpalloc);
+                    state, renderTarget, program, &emitted[primitiveBegin], primitiveEnd - primitiveBegin, drawContext,
+                    vpalloc);
                 break;
             case rr::GEOMETRYSHADEROUTPUTTYPE_LINE_STRIP:
                 drawGeometryShaderOutputAsPrimitives<PRIMITIVETYPE_LINE_STRIP>(
-                    state, renderTarget, program, &emitted[primitiveBegin], primitiveEnd - primitiveBegin, vpalloc);
+                    state, renderTarget, program, &emitted[primitiveBegin], primitiveEnd - primitiveBegin, drawContext,
+                    vpalloc);
                 break;
             case rr::GEOMETRYSHADEROUTPUTTYPE_TRIANGLE_STRIP:
                 drawGeometryShaderOutputAsPrimitives<PRIMITIVETYPE_TRIANGLE_STRIP>(
-                    state, renderTarget, program, &emitted[primitiveBegin], primitiveEnd - primitiveBegin, vpalloc);
+                    state, renderTarget, program, &emitted[primitiveBegin], primitiveEnd - primitiveBegin, drawContext,
+                    vpalloc);
                 break;
             default:
                 DE_ASSERT(false);
@@ -1568,7 +1763,40 @@ void drawAsPrimitives(const RenderState &state, const RenderTarget &renderTarget
         generatePrimitiveIDs(basePrimitives, drawContext);
 
         // Draw as a basic type
-        drawBasicPrimitives(state, renderTarget, program, basePrimitives, vpalloc);
+        drawBasicPrimitives(state, renderTarget, program, basePrimitives, drawContext, vpalloc);
+    }
+}
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Post-transform vertex cache
+ *
+ * Finds distinct vertex indices referenced by elements so that each vertex
+ * is shaded only once per instance. elementVertices gives the position of
+ * each element's vertex in vertexIndices. Primitives sharing a vertex get
+ * their own copies later in makeSharedVerticesDistinct().
+ *
+ * Non-indexed draws never reference a vertex twice and skip the lookup.
+ *//*--------------------------------------------------------------------*/
+void findDistinctVertices(const std::vector<int> &elementIndices, bool indexed, std::vector<int> &vertexIndices,
+                          std::vector<int> &elementVertices)
+{
+    vertexIndices = elementIndices;
+    elementVertices.resize(elementIndices.size());
+
+    if (indexed)
+    {
+        std::sort(vertexIndices.begin(), vertexIndices.end());
+        vertexIndices.erase(std::unique(vertexIndices.begin(), vertexIndices.end()), vertexIndices.end());
+
+        for (size_t ndx = 0; ndx < elementIndices.size(); ++ndx)
+            elementVertices[ndx] =
+                (int)(std::lower_bound(vertexIndices.begin(), vertexIndices.end(), elementIndices[ndx]) -
+                      vertexIndices.begin());
+    }
+    else
+    {
+        for (size_t ndx = 0; ndx < elementIndices.size(); ++ndx)
+            elementVertices[ndx] = (int)ndx;
     }
 }
 
@@ -1806,7 +2034,12 @@ bool PrimitiveList::isRestartIndex(size_t elementNdx, uint32_t restartIndex) con
         return elementNdx == (size_t)restartIndex;
 }
 
-Renderer::Renderer(void)
+Renderer::Renderer(void) : m_numThreads(1)
+{
+}
+
+Renderer::Renderer(int numThreads)
+    : m_numThreads(numThreads > 0 ? numThreads : tcu::getDefaultParallelForNumThreads())
 {
 }
 
@@ -1839,10 +2072,15 @@ void Renderer::drawInstanced(const DrawCommand &command, int numInstances) const
 
     // Prepare transformation
 
-    const size_t numVaryings = command.program.vertexShader->getOutputs().size();
+    const size_t numVaryings   = command.program.vertexShader->getOutputs().size();
+    const bool useVertexCache = command.primitives.getIndexType() != INDEXTYPE_LAST;
     VertexPacketAllocator vpalloc(numVaryings);
     std::vector<VertexPacket *> vertexPackets = vpalloc.allocArray(command.primitives.getNumElements());
-    DrawContext drawContext;
+    std::vector<VertexPacket *> elementPackets(command.primitives.getNumElements());
+    std::vector<int> elementIndices;
+    std::vector<int> vertexIndices;
+    std::vector<int> elementVertices;
+    DrawContext drawContext(m_numThreads);
 
     for (int instanceID = 0; instanceID < numInstances; ++instanceID)
     {
@@ -1851,36 +2089,53 @@ void Renderer::drawInstanced(const DrawCommand &command, int numInstances) const
 
         for (size_t elementNdx = 0; elementNdx < command.primitives.getNumElements(); ++elementNdx)
         {
-            int numVertexPackets = 0;
+            // collect primitive vertex indices until restart
 
-            // collect primitive vertices until restart
+            elementIndices.clear();
 
             while (elementNdx < command.primitives.getNumElements() &&
                    !(command.state.restart.enabled &&
                      command.primitives.isRestartIndex(elementNdx, command.state.restart.restartIndex)))
             {
-                // input
-                vertexPackets[numVertexPackets]->instanceNdx = instanceID;
-                vertexPackets[numVertexPackets]->vertexNdx   = (int)command.primitives.getIndex(elementNdx);
-
-                // output
-                vertexPackets[numVertexPackets]->pointSize =
-                    command.state.point.pointSize; // default value from the current state
-                vertexPackets[numVertexPackets]->position = tcu::Vec4(0, 0, 0, 0); // no undefined values
-
-                ++numVertexPackets;
+                elementIndices.push_back((int)command.primitives.getIndex(elementNdx));
                 ++elementNdx;
             }
 
             // Duplicated restart shade
-            if (numVertexPackets == 0)
+            if (elementIndices.empty())
                 continue;
 
-            // \todo Vertex cache?
+            // Post-transform vertex cache
+            findDistinctVertices(elementIndices, useVertexCache, vertexIndices, elementVertices);
+
+            const int numElements = (int)elementIndices.size();
+            const int numVertices = (int)vertexIndices.size();
+
+            for (int vertexNdx = 0; vertexNdx < numVertices; ++vertexNdx)
+            {
+                // input
+                vertexPackets[vertexNdx]->instanceNdx = instanceID;
+                vertexPackets[vertexNdx]->vertexNdx   = vertexIndices[vertexNdx];
+
+                // output
+                vertexPackets[vertexNdx]->pointSize =
+                    command.state.point.pointSize; // default value from the current state
+                vertexPackets[vertexNdx]->position = tcu::Vec4(0, 0, 0, 0); // no undefined values
+            }
 
             // Transform vertices
+            {
+                const auto shadeVertices = [&](int begin, int end)
+                {
+                    command.program.vertexShader->shadeVertices(command.vertexAttribs, &vertexPackets[begin],
+                                                                end - begin);
+                };
+
+                tcu::parallelFor(numVertices, VERTEX_SHADING_CHUNK_SIZE, shadeVertices, m_numThreads);
+            }
 
-            command.program.vertexShader->shadeVertices(command.vertexAttribs, &vertexPackets[0], numVertexPackets);
+            for (int ndx = 0; ndx < numElements; ++ndx)
+                elementPackets[ndx] = vertexPackets[elementVertices[ndx]];
 
             // Draw primitives
 
@@ -1889,72 +2144,72 @@ void Renderer::drawInstanced(const DrawCommand &command, int numInstances) const
             case PRIMITIVETYPE_TRIANGLES:
             {
                 drawAsPrimitives<PRIMITIVETYPE_TRIANGLES>(command.state, command.renderTarget, command.program,
-                                                          &vertexPackets[0], numVertexPackets, drawContext, vpalloc);
+                                                          &elementPackets[0], numElements, drawContext, vpalloc);
                 break;
             }
             case PRIMITIVETYPE_TRIANGLE_STRIP:
             {
                 drawAsPrimitives<PRIMITIVETYPE_TRIANGLE_STRIP>(command.state, command.renderTarget, command.program,
-                                                               &vertexPackets[0], numVertexPackets, drawContext,
+                                                               &elementPackets[0], numElements, drawContext,
                                                                vpalloc);
                 break;
             }
             case PRIMITIVETYPE_TRIANGLE_FAN:
             {
                 drawAsPrimitives<PRIMITIVETYPE_TRIANGLE_FAN>(command.state, command.renderTarget, command.program,
-                                                             &vertexPackets[0], numVertexPackets, drawContext, vpalloc);
+                                                             &elementPackets[0], numElements, drawContext, vpalloc);
                 break;
             }
             case PRIMITIVETYPE_LINES:
             {
                 drawAsPrimitives<PRIMITIVETYPE_LINES>(command.state, command.renderTarget, command.program,
-                                                      &vertexPackets[0], numVertexPackets, drawContext, vpalloc);
+                                                      &elementPackets[0], numElements, drawContext, vpalloc);
                 break;
             }
             case PRIMITIVETYPE_LINE_STRIP:
             {
                 drawAsPrimitives<PRIMITIVETYPE_LINE_STRIP>(command.state, command.renderTarget, command.program,
-                                                           &vertexPackets[0], numVertexPackets, drawContext, vpalloc);
+                                                           &elementPackets[0], numElements, drawContext, vpalloc);
                 break;
             }
             case PRIMITIVETYPE_LINE_LOOP:
             {
                 drawAsPrimitives<PRIMITIVETYPE_LINE_LOOP>(command.state, command.renderTarget, command.program,
-                                                          &vertexPackets[0], numVertexPackets, drawContext, vpalloc);
+                                                          &elementPackets[0], numElements, drawContext, vpalloc);
                 break;
             }
             case PRIMITIVETYPE_POINTS:
             {
                 drawAsPrimitives<PRIMITIVETYPE_POINTS>(command.state, command.renderTarget, command.program,
-                                                       &vertexPackets[0], numVertexPackets, drawContext, vpalloc);
+                                                       &elementPackets[0], numElements, drawContext, vpalloc);
                 break;
             }
             case PRIMITIVETYPE_LINES_ADJACENCY:
             {
                 drawAsPrimitives<PRIMITIVETYPE_LINES_ADJACENCY>(command.state, command.renderTarget, command.program,
-                                                                &vertexPackets[0], numVertexPackets, drawContext,
+                                                                &elementPackets[0], numElements, drawContext,
                                                                 vpalloc);
                 break;
             }
             case PRIMITIVETYPE_LINE_STRIP_ADJACENCY:
             {
                 drawAsPrimitives<PRIMITIVETYPE_LINE_STRIP_ADJACENCY>(command.state, command.renderTarget,
-                                                                     command.program, &vertexPackets[0],
-                                                                     numVertexPackets, drawContext, vpalloc);
+                                                                     command.program, &elementPackets[0], numElements,
+                                                                     drawContext, vpalloc);
                 break;
             }
             case PRIMITIVETYPE_TRIANGLES_ADJACENCY:
             {
                 drawAsPrimitives<PRIMITIVETYPE_TRIANGLES_ADJACENCY>(command.state, command.renderTarget,
-                                                                    command.program, &vertexPackets[0],
-                                                                    numVertexPackets, drawContext, vpalloc);
+                                                                    command.program, &elementPackets[0], numElements,
+                                                                    drawContext, vpalloc);
                 break;
             }
             case PRIMITIVETYPE_TRIANGLE_STRIP_ADJACENCY:
             {
                 drawAsPrimitives<PRIMITIVETYPE_TRIANGLE_STRIP_ADJACENCY>(command.state, command.renderTarget,
-                                                                         command.program, &vertexPackets[0],
-                                                                         numVertexPackets, drawContext, vpalloc);
+                                                                         command.program, &elementPackets[0],
+                                                                         numElements, drawContext, vpalloc);
                 break;
             }
             default:
@@ -1964,4 +2219,171 @@ void Renderer::drawInstanced(const DrawCommand &command, int numInstances) const
     }
 }
 
+namespace
+{
+
+class SelfTestVertexShader : public VertexShader
+{
+public:
+    SelfTestVertexShader(void) : VertexShader(2, 1)
+    {
+        m_inputs[0].type  = GENERICVECTYPE_FLOAT;
+        m_inputs[1].type  = GENERICVECTYPE_FLOAT;
+        m_outputs[0].type = GENERICVECTYPE_FLOAT;
+    }
+
+    void shadeVertices(const VertexAttrib *inputs, VertexPacket *const *packets, const int numPackets) const
+    {
+        for (int packetNdx = 0; packetNdx < numPackets; packetNdx++)
+        {
+            VertexPacket &packet = *packets[packetNdx];
+
+            readVertexAttrib(packet.position, inputs[0], packet.instanceNdx, packet.vertexNdx);
+            packet.outputs[0] = readVertexAttribFloat(inputs[1], packet.instanceNdx, packet.vertexNdx);
+            packet.pointSize  = 9.0f;
+        }
+    }
+};
+
+class SelfTestFragmentShader : public FragmentShader
+{
+public:
+    SelfTestFragmentShader(void) : FragmentShader(1, 1)
+    {
+        m_inputs[0].type  = GENERICVECTYPE_FLOAT;
+        m_outputs[0].type = GENERICVECTYPE_FLOAT;
+    }
+
+    void shadeFragments(FragmentPacket *packets, const int numPackets, const FragmentShadingContext &context) const
+    {
+        for (int packetNdx = 0; packetNdx < numPackets; packetNdx++)
+        {
+            for (int fragNdx = 0; fragNdx < NUM_FRAGMENTS_PER_PACKET; fragNdx++)
+                writeFragmentOutput(context, packetNdx, fragNdx, 0,
+                                    readVarying<float>(packets[packetNdx], context, 0, fragNdx));
+        }
+    }
+};
+
+size_t getDataSize(const tcu::ConstPixelBufferAccess &access)
+{
+    return (size_t)access.getWidth() * access.getHeight() * access.getDepth() * access.getFormat().getPixelSize();
+}
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Draw a fixed pseudo-random scene on numThreads threads
+ *
+ * Triangles and points overlap each other and tile edges, and depth,
+ * stencil and blend state make the result depend on primitive order.
+ *//*--------------------------------------------------------------------*/
+void renderSelfTestScene(int numThreads, const tcu::PixelBufferAccess &color, const tcu::PixelBufferAccess &depthStencil)
+{
+    const int numTriangles = 96;
+    const int width        = color.getHeight();
+    const int height       = color.getDepth();
+    de::Random rnd(0x5e1f7e57);
+    std::vector<tcu::Vec4> positions;
+    std::vector<tcu::Vec4> colors;
+
+    for (int triNdx = 0; triNdx < numTriangles; triNdx++)
+    {
+        const tcu::Vec2 center(rnd.getFloat(-1.1f, 1.1f), rnd.getFloat(-1.1f, 1.1f));
+
+        for (int vtxNdx = 0; vtxNdx < 3; vtxNdx++)
+        {
+            positions.push_back(tcu::Vec4(center.x() + rnd.getFloat(-0.5f, 0.5f),
+                                          center.y() + rnd.getFloat(-0.5f, 0.5f), rnd.getFloat(-1.0f, 1.0f), 1.0f));
+            colors.push_back(tcu::Vec4(rnd.getFloat(), rnd.getFloat(), rnd.getFloat(), rnd.getFloat()));
+        }
+    }
+
+    // Clears leave the padding of FLOAT_UNSIGNED_INT_24_8_REV untouched, zero it for bytewise comparison.
+    deMemset(depthStencil.getDataPtr(), 0, getDataSize(depthStencil));
+
+    tcu::clear(color, tcu::Vec4(0.0f, 0.0f, 0.0f, 1.0f));
+    tcu::clearDepth(depthStencil, 1.0f);
+    tcu::clearStencil(depthStencil, 0);
+
+    {
+        const SelfTestVertexShader vertexShader;
+        const SelfTestFragmentShader fragmentShader;
+        const Program program(&vertexShader, &fragmentShader);
+        const MultisamplePixelBufferAccess colorAccess = MultisamplePixelBufferAccess::fromMultisampleAccess(color);
+        const MultisamplePixelBufferAccess dsAccess =
+            MultisamplePixelBufferAccess::fromMultisampleAccess(depthStencil);
+        const RenderTarget renderTarget(colorAccess, dsAccess, dsAccess);
+        const VertexAttrib vertexAttribs[] = {VertexAttrib(VERTEXATTRIBTYPE_FLOAT, 4, 0, 0, &positions[0]),
+                                              VertexAttrib(VERTEXATTRIBTYPE_FLOAT, 4, 0, 0, &colors[0])};
+        const Renderer renderer(numThreads);
+        RenderState state((ViewportState(colorAccess)), RenderState::DEFAULT_SUBPIXEL_BITS);
+
+        state.fragOps.depthTestEnabled                     = true;
+        state.fragOps.depthFunc                            = TESTFUNC_LEQUAL;
+        state.fragOps.stencilTestEnabled                   = true;
+        state.fragOps.stencilStates[FACETYPE_BACK].func    = TESTFUNC_ALWAYS;
+        state.fragOps.stencilStates[FACETYPE_BACK].dpFail  = STENCILOP_DECR_WRAP;
+        state.fragOps.stencilStates[FACETYPE_BACK].dpPass  = STENCILOP_INCR_WRAP;
+        state.fragOps.stencilStates[FACETYPE_FRONT]        = state.fragOps.stencilStates[FACETYPE_BACK];
+        state.fragOps.stencilStates[FACETYPE_FRONT].dpPass = STENCILOP_INVERT;
+        state.fragOps.blendMode                            = BLENDMODE_STANDARD;
+        state.fragOps.blendRGBState.srcFunc                = BLENDFUNC_SRC_ALPHA;
+        state.fragOps.blendRGBState.dstFunc                = BLENDFUNC_ONE_MINUS_SRC_ALPHA;
+        state.fragOps.blendAState.srcFunc                  = BLENDFUNC_ONE;
+        state.fragOps.blendAState.dstFunc                  = BLENDFUNC_ONE;
+
+        // Full render target, then a viewport not aligned to tiles.
+        renderer.draw(DrawCommand(state, renderTarget, program, DE_LENGTH_OF_ARRAY(vertexAttribs), vertexAttribs,
+                                  PrimitiveList(PRIMITIVETYPE_TRIANGLES, (int)positions.size(), 0)));
+
+        state.viewport.rect = WindowRectangle(13, 9, width - 20, height - 15);
+
+        renderer.draw(DrawCommand(state, renderTarget, program, DE_LENGTH_OF_ARRAY(vertexAttribs), vertexAttribs,
+                                  PrimitiveList(PRIMITIVETYPE_POINTS, (int)positions.size(), 0)));
+        renderer.draw(DrawCommand(state, renderTarget, program, DE_LENGTH_OF_ARRAY(vertexAttribs), vertexAttribs,
+                                  PrimitiveList(PRIMITIVETYPE_TRIANGLE_STRIP, (int)positions.size(), 0)));
+    }
+}
+
+bool isBitwiseEqual(const tcu::ConstPixelBufferAccess &a, const tcu::ConstPixelBufferAccess &b)
+{
+    return deMemCmp(a.getDataPtr(), b.getDataPtr(), getDataSize(a)) == 0;
+}
+
+} // namespace
+
+void Renderer_selfTest(void)
+{
+    // 200x150 is not a multiple of RASTER_TILE_SIZE and exceeds RASTER_MIN_PARALLEL_PIXELS.
+    const int width        = 200;
+    const int height       = 150;
+    const int threads[]    = {2, 5};
+    const int numSamples[] = {1, 4};
+    const tcu::TextureFormat colorFormat(tcu::TextureFormat::RGBA, tcu::TextureFormat::UNORM_INT8);
+    const tcu::TextureFormat dsFormats[] = {
+        tcu::TextureFormat(tcu::TextureFormat::DS, tcu::TextureFormat::UNSIGNED_INT_24_8),
+        tcu::TextureFormat(tcu::TextureFormat::DS, tcu::TextureFormat::FLOAT_UNSIGNED_INT_24_8_REV)};
+
+    for (int samplesNdx = 0; samplesNdx < DE_LENGTH_OF_ARRAY(numSamples); samplesNdx++)
+    {
+        for (int dsNdx = 0; dsNdx < DE_LENGTH_OF_ARRAY(dsFormats); dsNdx++)
+        {
+            tcu::TextureLevel refColor(colorFormat, numSamples[samplesNdx], width, height);
+            tcu::TextureLevel refDepthStencil(dsFormats[dsNdx], numSamples[samplesNdx], width, height);
+
+            renderSelfTestScene(1, refColor.getAccess(), refDepthStencil.getAccess());
+
+            for (int threadsNdx = 0; threadsNdx < DE_LENGTH_OF_ARRAY(threads); threadsNdx++)
+            {
+                tcu::TextureLevel color(colorFormat, numSamples[samplesNdx], width, height);
+                tcu::TextureLevel depthStencil(dsFormats[dsNdx], numSamples[samplesNdx], width, height);
+
+                renderSelfTestScene(threads[threadsNdx], color.getAccess(), depthStencil.getAccess());
+
+                TCU_CHECK(isBitwiseEqual(color.getAccess(), refColor.getAccess()));
+                TCU_CHECK(isBitwiseEqual(depthStencil.getAccess(), refDepthStencil.getAccess()));
+            }
+        }
+    }
+}
+
 } // namespace rr
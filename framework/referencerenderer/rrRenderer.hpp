@@ -156,16 +156,32 @@ public:
     const PrimitiveList &primitives;
 } DE_WARN_UNUSED_TYPE;
 
+/*--------------------------------------------------------------------*//*!
+ * \brief Reference renderer
+ *
+ * By default draws are executed on the calling thread. If numThreads is
+ * not 1, vertex shading is split into chunks and triangles and points are
+ * binned to screen tiles that are rasterized and shaded on numThreads
+ * threads (0 selects the number of available cores). Tiles preserve
+ * primitive order, so the result is identical to single-threaded
+ * rendering. Shaders must then be safe to call concurrently.
+ *//*--------------------------------------------------------------------*/
 class Renderer
 {
 public:
     Renderer(void);
+    explicit Renderer(int numThreads);
     ~Renderer(void);
 
     void draw(const DrawCommand &command) const;
     void drawInstanced(const DrawCommand &command, int numInstances) const;
+
+private:
+    const int m_numThreads;
 } DE_WARN_UNUSED_TYPE;
 
+void Renderer_selfTest(void);
+
 } // namespace rr
 
 #endif // _RRRENDERER_HPP
@@ -108,8 +108,13 @@ FboTestCase::IterateResult FboTestCase::iterate(void)
         sglr::ReferenceContextBuffers buffers(
             tcu::PixelFormat(8, 8, 8, renderTarget.getPixelFormat().alphaBits ? 8 : 0), renderTarget.getDepthBits(),
             renderTarget.getStencilBits(), width, height);
-        sglr::ReferenceContext context(sglr::ReferenceContextLimits(renderCtx), buffers.getColorbuffer(),
-                                       buffers.getDepthbuffer(), buffers.getStencilbuffer());
+        sglr::ReferenceContextLimits limits(renderCtx);
+
+        // FBO test shaders only read their uniforms and textures, so the reference can be rendered on all cores.
+        limits.numRendererThreads = 0;
+
+        sglr::ReferenceContext context(limits, buffers.getColorbuffer(), buffers.getDepthbuffer(),
+                                       buffers.getStencilbuffer());
 
         setContext(&context);
         render(reference);
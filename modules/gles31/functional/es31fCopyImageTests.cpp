@@ -1345,7 +1345,9 @@ void decompressTextureLevel(const tcu::TexDecompressionParams &params, ArrayBuff
     levelAccess = tcu::PixelBufferAccess(decompressedFormat, levelPixelSize.x(), levelPixelSize.y(), levelPixelSize.z(),
                                          levelData.getPtr());
 
-    tcu::decompress(levelAccess, compressedFormat, (const uint8_t *)data, params);
+    // Decoded texels don't depend on the thread count, decode on all cores.
+    tcu::decompress(levelAccess, compressedFormat, (const uint8_t *)data,
+                    tcu::TexDecompressionParams(params.astcMode, 0));
 }
 
 void decompressTexture(vector<ArrayBuffer<uint8_t>> &levelDatas, vector<tcu::PixelBufferAccess> &levelAccesses,
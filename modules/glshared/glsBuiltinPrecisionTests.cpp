@@ -25,6 +25,7 @@
 #include "glsBuiltinPrecisionTests.hpp"
 
 #include "deMath.h"
+#include "deInt32.h"
 #include "deMemory.h"
 #include "deDefs.hpp"
 #include "deRandom.hpp"
@@ -50,11 +51,13 @@
 
 #include "glsShaderExecUtil.hpp"
 
+#include <cstddef>
 #include <cmath>
 #include <string>
 #include <sstream>
 #include <iostream>
 #include <map>
+#include <new>
 #include <utility>
 #include <limits>
 
@@ -637,11 +640,128 @@ template <typename T>
 VariableP<T> variable(const string &name);
 StatementP compoundStatement(const vector<StatementP> &statements);
 
+/*--------------------------------------------------------------------*//*!
+ * \brief Type-independent part of a variable.
+ *
+ * Each variable has a slot in the environment frame of the scope it is used
+ * in. Slots are assigned by assignFrameSlots() after the statements of the
+ * scope have been built, so evaluation doesn't need to look up variables by
+ * name.
+ *
+ *//*--------------------------------------------------------------------*/
+class VariableBase
+{
+public:
+    VariableBase(const string &name, size_t valueSize) : m_name(name), m_valueSize(valueSize), m_offset(NO_SLOT)
+    {
+    }
+
+    string getName(void) const
+    {
+        return m_name;
+    }
+    size_t getValueSize(void) const
+    {
+        return m_valueSize;
+    }
+    size_t getOffset(void) const
+    {
+        DE_ASSERT(m_offset != NO_SLOT);
+        return m_offset;
+    }
+    void setOffset(size_t offset) const
+    {
+        // Variables must not be shared between scopes with different layouts.
+        DE_ASSERT(m_offset == NO_SLOT || m_offset == offset);
+        m_offset = offset;
+    }
+
+private:
+    static constexpr size_t NO_SLOT = ~(size_t)0;
+
+    const string m_name;
+    const size_t m_valueSize;
+    mutable size_t m_offset;
+};
+
+typedef vector<const VariableBase *> VariableList;
+
+//! Assign frame slots to variables. Variables with the same name share a slot. Returns the frame size in bytes.
+size_t assignFrameSlots(const VariableList &variables)
+{
+    map<string, size_t> slotSizes;
+    map<string, size_t> slotOffsets;
+    size_t frameSize = 0;
+
+    for (size_t ndx = 0; ndx < variables.size(); ++ndx)
+    {
+        size_t &slotSize = slotSizes[variables[ndx]->getName()];
+
+        slotSize = de::max(slotSize, variables[ndx]->getValueSize());
+    }
+
+    for (map<string, size_t>::const_iterator it = slotSizes.begin(); it != slotSizes.end(); ++it)
+    {
+        slotOffsets[it->first] = frameSize;
+        frameSize += deAlignSize(it->second, alignof(std::max_align_t));
+    }
+
+    for (size_t ndx = 0; ndx < variables.size(); ++ndx)
+        variables[ndx]->setOffset(slotOffsets[variables[ndx]->getName()]);
+
+    return frameSize;
+}
+
+/*--------------------------------------------------------------------*//*!
+ * \brief Storage for the frames of nested environments.
+ *
+ * Frames are allocated in LIFO order, one per function call depth. Storage
+ * is kept when a frame is released, so once the deepest call has been
+ * evaluated no more memory is allocated.
+ *
+ *//*--------------------------------------------------------------------*/
+class EnvironmentArena
+{
+public:
+    EnvironmentArena(void) : m_depth(0)
+    {
+    }
+
+    uint8_t *pushFrame(size_t frameSize)
+    {
+        if (m_frames.size() <= m_depth)
+            m_frames.resize(m_depth + 1);
+
+        vector<std::max_align_t> &frame = m_frames[m_depth++];
+        const size_t numUnits           = (frameSize + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t);
+
+        if (frame.size() < numUnits)
+            frame.resize(numUnits);
+
+        return reinterpret_cast<uint8_t *>(frame.data());
+    }
+
+    void popFrame(void)
+    {
+        DE_ASSERT(m_depth > 0);
+        --m_depth;
+    }
+
+private:
+    EnvironmentArena(const EnvironmentArena &);
+    EnvironmentArena &operator=(const EnvironmentArena &);
+
+    vector<vector<std::max_align_t>> m_frames;
+    size_t m_depth;
+};
+
 /*--------------------------------------------------------------------*//*!
  * \brief A variable environment.
  *
  * An Environment object maintains the mapping between variables of the
- * abstract syntax tree and their values.
+ * abstract syntax tree and their values. Values are stored in a frame
+ * allocated from an EnvironmentArena, at the slots assigned to the variables
+ * by assignFrameSlots().
  *
  * \todo [2014-03-28 lauri] At least run-time type safety.
  *
@@ -649,25 +769,48 @@ StatementP compoundStatement(const vector<StatementP> &statements);
 class Environment
 {
 public:
+    Environment(EnvironmentArena &arena, size_t frameSize)
+        : m_arena(arena)
+        , m_frameSize(frameSize)
+        , m_frame(arena.pushFrame(frameSize))
+    {
+    }
+
+    ~Environment(void)
+    {
+        m_arena.popFrame();
+    }
+
+    EnvironmentArena &getArena(void) const
+    {
+        return m_arena;
+    }
+
     template <typename T>
     void bind(const Variable<T> &variable, const typename Traits<T>::IVal &value)
     {
-        uint8_t *const data = new uint8_t[sizeof(value)];
-
-        deMemcpy(data, &value, sizeof(value));
-        de::insert(m_map, variable.getName(), SharedPtr<uint8_t>(data, de::ArrayDeleter<uint8_t>()));
+        new (getSlot(variable)) typename Traits<T>::IVal(value);
     }
 
     template <typename T>
     typename Traits<T>::IVal &lookup(const Variable<T> &variable) const
     {
-        uint8_t *const data = de::lookup(m_map, variable.getName()).get();
-
-        return *reinterpret_cast<typename Traits<T>::IVal *>(data);
+        return *reinterpret_cast<typename Traits<T>::IVal *>(getSlot(variable));
     }
 
 private:
-    map<string, SharedPtr<uint8_t>> m_map;
+    Environment(const Environment &);
+    Environment &operator=(const Environment &);
+
+    uint8_t *getSlot(const VariableBase &variable) const
+    {
+        DE_ASSERT(variable.getOffset() + variable.getValueSize() <= m_frameSize);
+        return m_frame + variable.getOffset();
+    }
+
+    EnvironmentArena &m_arena;
+    const size_t m_frameSize;
+    uint8_t *const m_frame;
 };
 
 /*--------------------------------------------------------------------*//*!
@@ -748,11 +891,17 @@ public:
     {
         this->doGetUsedFuncs(dst);
     }
+    //! Add the variables used in this statement to `dst`.
+    void getUsedVars(VariableList &dst) const
+    {
+        this->doGetUsedVars(dst);
+    }
 
 protected:
-    virtual void doPrint(ostream &os) const         = 0;
-    virtual void doExecute(EvalContext &ctx) const  = 0;
-    virtual void doGetUsedFuncs(FuncSet &dst) const = 0;
+    virtual void doPrint(ostream &os) const             = 0;
+    virtual void doExecute(EvalContext &ctx) const      = 0;
+    virtual void doGetUsedFuncs(FuncSet &dst) const     = 0;
+    virtual void doGetUsedVars(VariableList &dst) const = 0;
 };
 
 ostream &operator<<(ostream &os, const Statement &stmt)
@@ -853,6 +1002,12 @@ protected:
         m_value->getUsedFuncs(dst);
     }
 
+    void doGetUsedVars(VariableList &dst) const
+    {
+        dst.push_back(m_variable.get());
+        m_value->getUsedVars(dst);
+    }
+
     VariableP<T> m_variable;
     ExprP<T> m_value;
     bool m_isDeclaration;
@@ -913,6 +1068,12 @@ protected:
             m_statements[ndx]->getUsedFuncs(dst);
     }
 
+    void doGetUsedVars(VariableList &dst) const
+    {
+        for (size_t ndx = 0; ndx < m_statements.size(); ++ndx)
+            m_statements[ndx]->getUsedVars(dst);
+    }
+
     vector<StatementP> m_statements;
 };
 
@@ -939,6 +1100,12 @@ public:
         this->doGetUsedFuncs(dst);
     }
 
+    //! Output the variables that this expression refers to. Variables inside called functions are not included.
+    void getUsedVars(VariableList &dst) const
+    {
+        this->doGetUsedVars(dst);
+    }
+
 protected:
     virtual void doPrintExpr(ostream &) const
     {
@@ -946,6 +1113,9 @@ protected:
     virtual void doGetUsedFuncs(FuncSet &) const
     {
     }
+    virtual void doGetUsedVars(VariableList &) const
+    {
+    }
 };
 
 //! Type-specific operations for an expression representing type T.
@@ -1129,31 +1299,28 @@ ExprP<Matrix<float, Rows, Cols>> operator-(const ExprP<Matrix<float, Rows, Cols>
  * environment.
  *//*--------------------------------------------------------------------*/
 template <typename T>
-class Variable : public Expr<T>
+class Variable : public Expr<T>, public VariableBase
 {
 public:
     typedef typename Expr<T>::IVal IVal;
 
-    Variable(const string &name) : m_name(name)
-    {
-    }
-    string getName(void) const
+    Variable(const string &name) : VariableBase(name, sizeof(IVal))
     {
-        return m_name;
     }
 
 protected:
     void doPrintExpr(ostream &os) const
     {
-        os << m_name;
+        os << getName();
+    }
+    void doGetUsedVars(VariableList &dst) const
+    {
+        dst.push_back(this);
     }
     IVal doEvaluate(const EvalContext &ctx) const
     {
         return ctx.env.lookup<T>(*this);
     }
-
-private:
-    string m_name;
 };
 
 template <typename T>
@@ -1438,6 +1605,14 @@ protected:
         m_args.d->getUsedFuncs(dst);
     }
 
+    void doGetUsedVars(VariableList &dst) const
+    {
+        m_args.a->getUsedVars(dst);
+        m_args.b->getUsedVars(dst);
+        m_args.c->getUsedVars(dst);
+        m_args.d->getUsedVars(dst);
+    }
+
     const ApplyFunc &m_func;
     ArgExprs m_args;
 };
@@ -1602,12 +1777,12 @@ protected:
 
     IRet doApply(const EvalContext &ctx, const IArgs &args) const
     {
-        Environment funEnv;
+        initialize();
+
+        Environment funEnv(ctx.env.getArena(), m_frameSize);
         IArgs &mutArgs = const_cast<IArgs &>(args);
         IRet ret;
 
-        initialize();
-
         funEnv.bind(*m_var0, args.a);
         funEnv.bind(*m_var1, args.b);
         funEnv.bind(*m_var2, args.c);
@@ -1654,6 +1829,7 @@ protected:
     mutable VariableP<Arg3> m_var3;
     mutable vector<StatementP> m_body;
     mutable ExprP<Ret> m_ret;
+    mutable size_t m_frameSize;
 
 private:
     void initialize(void) const
@@ -1664,6 +1840,7 @@ private:
             Counter symCounter;
             ExpandContext ctx(symCounter);
             ArgExprs args;
+            VariableList usedVars;
 
             args.a = m_var0 = variable<Arg0>(paramNames.a);
             args.b = m_var1 = variable<Arg1>(paramNames.b);
@@ -1672,6 +1849,17 @@ private:
 
             m_ret  = this->doExpand(ctx, args);
             m_body = ctx.getStatements();
+
+            usedVars.push_back(m_var0.get());
+            usedVars.push_back(m_var1.get());
+            usedVars.push_back(m_var2.get());
+            usedVars.push_back(m_var3.get());
+
+            for (size_t ndx = 0; ndx < m_body.size(); ++ndx)
+                m_body[ndx]->getUsedVars(usedVars);
+            m_ret->getUsedVars(usedVars);
+
+            m_frameSize = assignFrameSlots(usedVars);
         }
     }
 };
@@ -4867,7 +5055,6 @@ void PrecisionCase::testStatement(const Variables<In, Out> &variables, const Inp
     const FloatFormat highpFmt = m_ctx.highpFormat;
     const int maxMsgs          = 100;
     int numErrors              = 0;
-    Environment env; // Hoisted out of the inner loop for optimization.
 
     switch (inCount)
     {
@@ -4970,6 +5157,20 @@ void PrecisionCase::testStatement(const Variables<In, Out> &variables, const Inp
         executor->execute(int(numValues), inputArr, outputArr);
     }
 
+    // Assign frame slots to the variables of the statement.
+    VariableList usedVars;
+
+    stmt.getUsedVars(usedVars);
+    usedVars.push_back(variables.in0.get());
+    usedVars.push_back(variables.in1.get());
+    usedVars.push_back(variables.in2.get());
+    usedVars.push_back(variables.in3.get());
+    usedVars.push_back(variables.out0.get());
+    usedVars.push_back(variables.out1.get());
+
+    EnvironmentArena envArena;
+    Environment env(envArena, assignFrameSlots(usedVars)); // Hoisted out of the inner loop for optimization.
+
     // Initialize environment with unused values so we don't need to bind in inner loop.
     {
         const typename Traits<In0>::IVal in0;
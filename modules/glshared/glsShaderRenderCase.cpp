@@ -321,7 +321,8 @@ ShaderEvalContext::ShaderEvalContext(const QuadGrid &quadGrid_)
         switch (binding.getType())
         {
         case TextureBinding::TYPE_2D:
-            textures[ndx].tex2D = &binding.get2D()->getRefTexture();
+            textures[ndx].tex2D      = &binding.get2D()->getRefTexture();
+            textures[ndx].prepared2D = tcu::PreparedSampler2D(textures[ndx].tex2D->getView(), textures[ndx].sampler);
             break;
         case TextureBinding::TYPE_CUBE_MAP:
             textures[ndx].texCube = &binding.getCube()->getRefTexture();
@@ -362,7 +363,7 @@ void ShaderEvalContext::reset(float sx, float sy)
 tcu::Vec4 ShaderEvalContext::texture2D(int unitNdx, const tcu::Vec2 &texCoords)
 {
     if (textures[unitNdx].tex2D)
-        return textures[unitNdx].tex2D->sample(textures[unitNdx].sampler, texCoords.x(), texCoords.y(), 0.0f);
+        return textures[unitNdx].prepared2D.sample(texCoords.x(), texCoords.y(), 0.0f);
     else
         return tcu::Vec4(0.0f, 0.0f, 0.0f, 1.0f);
 }
@@ -174,6 +174,7 @@ public:
         const tcu::TextureCube *texCube;
         const tcu::Texture2DArray *tex2DArray;
         const tcu::Texture3D *tex3D;
+        tcu::PreparedSampler2D prepared2D; //!< tex2D with sampler, used by texture2D()
 
         inline ShaderSampler(void) : tex2D(DE_NULL), texCube(DE_NULL), tex2DArray(DE_NULL), tex3D(DE_NULL)
         {
@@ -30,14 +30,20 @@
 #include "tcuEither.hpp"
 #include "tcuTestLog.hpp"
 #include "tcuCommandLine.hpp"
+#include "tcuParallelFor.hpp"
+#include "tcuInterval.hpp"
+#include "tcuCompressedTexture.hpp"
 
 #include "rrRenderer.hpp"
+#include "rrRasterizer.hpp"
+#include "rrFragmentOperations.hpp"
 #include "tcuTextureUtil.hpp"
 #include "tcuVectorUtil.hpp"
 #include "tcuFloat.hpp"
 
 #include "deRandom.hpp"
 #include "deArrayUtil.hpp"
+#include "deStringUtil.hpp"
 
 #include <stdexcept>
 #include <cmath>
@@ -806,6 +812,93 @@ protected:
     vector<SubCase>::const_iterator m_caseIter;
 };
 
+// Benchmarks directed rounding with FPU rounding mode switches against the rounding-mode free implementation
+// used by tcu::Interval when TCU_INTERVAL_ROUNDING_MODE_FREE is set.
+class IntervalRoundingCase : public tcu::TestCase
+{
+public:
+    IntervalRoundingCase(tcu::TestContext &testCtx, const char *name) : tcu::TestCase(testCtx, name, "")
+    {
+    }
+
+    IterateResult iterate(void)
+    {
+        const int numValues     = 1 << 16;
+        const int numIterations = 16;
+        const double numOps     = double(3 * numValues * numIterations);
+        vector<double> lhs(numValues);
+        vector<double> rhs(numValues);
+        de::Random rnd(0x7e57);
+        uint64_t fenvTime      = 0;
+        uint64_t errorFreeTime = 0;
+        double fenvSum         = 0.0;
+        double errorFreeSum    = 0.0;
+
+        for (int ndx = 0; ndx < numValues; ndx++)
+        {
+            lhs[ndx] = rnd.getDouble(-1e3, 1e3);
+            rhs[ndx] = rnd.getDouble(1e-3, 1e3);
+        }
+
+        fenvTime      = measureMicroseconds(
+            [&]()
+            {
+                fenvSum = sumDirected(lhs, rhs, numIterations, tcu::addDirectedFenv, tcu::mulDirectedFenv,
+                                      tcu::divDirectedFenv);
+            });
+        errorFreeTime = measureMicroseconds(
+            [&]()
+            {
+                errorFreeSum = sumDirected(lhs, rhs, numIterations, tcu::addDirectedErrorFree,
+                                           tcu::mulDirectedErrorFree, tcu::divDirectedErrorFree);
+            });
+
+        {
+            const float fenvRate      = getMegaRate(numOps, fenvTime);
+            const float errorFreeRate = getMegaRate(numOps, errorFreeTime);
+
+            m_testCtx.getLog() << TestLog::Message << "Interval arithmetic uses the "
+                               << (TCU_INTERVAL_ROUNDING_MODE_FREE ? "rounding-mode free" : "rounding mode")
+                               << " implementation" << TestLog::EndMessage
+                               << TestLog::Float("RoundingModeThroughput", "Throughput with rounding mode switches",
+                                                 "Mops/s", QP_KEY_TAG_PERFORMANCE, fenvRate)
+                               << TestLog::Float("RoundingModeFreeThroughput",
+                                                 "Throughput without rounding mode switches", "Mops/s",
+                                                 QP_KEY_TAG_PERFORMANCE, errorFreeRate);
+
+            // Both implementations give the same bounds for operands away from underflow.
+            if (fenvSum != errorFreeSum)
+                m_testCtx.setTestResult(QP_TEST_RESULT_FAIL, "Rounding-mode free results differ");
+            else
+                m_testCtx.setTestResult(QP_TEST_RESULT_PASS, de::floatToString(errorFreeRate / fenvRate, 2).c_str());
+        }
+
+        return STOP;
+    }
+
+private:
+    typedef double (*DirectedOp)(double, double, bool);
+
+    static double sumDirected(const vector<double> &lhs, const vector<double> &rhs, int numIterations, DirectedOp add,
+                              DirectedOp mul, DirectedOp div)
+    {
+        double sum = 0.0;
+
+        for (int iterNdx = 0; iterNdx < numIterations; iterNdx++)
+        {
+            for (size_t ndx = 0; ndx < lhs.size(); ndx++)
+            {
+                const bool upward = (ndx % 2) != 0;
+
+                sum += add(lhs[ndx], rhs[ndx], upward) + mul(lhs[ndx], rhs[ndx], upward) +
+                       div(lhs[ndx], rhs[ndx], upward);
+            }
+        }
+
+        return sum;
+    }
+};
+
 class CommonFrameworkTests : public tcu::TestCaseGroup
 {
 public:
@@ -819,6 +912,14 @@ public:
         addChild(
             new SelfCheckCase(m_testCtx, "float_format", "tcu::FloatFormat_selfTest()", tcu::FloatFormat_selfTest));
         addChild(new SelfCheckCase(m_testCtx, "either", "tcu::Either_selfTest()", tcu::Either_selfTest));
+        addChild(new SelfCheckCase(m_testCtx, "parallel_for", "tcu::ParallelFor_selfTest()",
+                                   tcu::ParallelFor_selfTest));
+        addChild(new SelfCheckCase(m_testCtx, "interval", "tcu::Interval_selfTest()", tcu::Interval_selfTest));
+        addChild(new SelfCheckCase(m_testCtx, "compressed_texture", "tcu::CompressedTexture_selfTest()",
+                                   tcu::CompressedTexture_selfTest));
+        addChild(new SelfCheckCase(m_testCtx, "prepared_sampler_2d", "tcu::PreparedSampler2D_selfTest()",
+                                   tcu::PreparedSampler2D_selfTest));
+        addChild(new IntervalRoundingCase(m_testCtx, "interval_rounding"));
     }
 };
 
@@ -833,6 +934,11 @@ public:
     void init(void)
     {
         addChild(new ConstantInterpolationTest(m_testCtx));
+        addChild(new SelfCheckCase(m_testCtx, "triangle_rasterizer", "rr::TriangleRasterizer_selfTest()",
+                                   rr::TriangleRasterizer_selfTest));
+        addChild(new SelfCheckCase(m_testCtx, "renderer", "rr::Renderer_selfTest()", rr::Renderer_selfTest));
+        addChild(new SelfCheckCase(m_testCtx, "fragment_operations", "rr::FragmentProcessor_selfTest()",
+                                   rr::FragmentProcessor_selfTest));
     }
 };
 
@@ -22,16 +22,23 @@
  *//*--------------------------------------------------------------------*/
 
 #include "ditImageCompareTests.hpp"
+#include "ditTestCase.hpp"
 #include "tcuResource.hpp"
 #include "tcuImageCompare.hpp"
 #include "tcuFuzzyImageCompare.hpp"
+#include "tcuBilinearImageCompare.hpp"
 #include "tcuImageIO.hpp"
 #include "tcuTexture.hpp"
 #include "tcuTestLog.hpp"
 #include "tcuTextureUtil.hpp"
 #include "tcuRGBA.hpp"
+#include "tcuVectorUtil.hpp"
 #include "deFilePath.hpp"
 #include "deClock.h"
+#include "deMemory.h"
+#include "deRandom.hpp"
+#include "deString.h"
+#include "deStringUtil.hpp"
 
 namespace dit
 {
@@ -158,6 +165,331 @@ private:
     const bool m_expectedResult;
 };
 
+enum ThresholdCompareType
+{
+    THRESHOLDCOMPARE_INT = 0,
+    THRESHOLDCOMPARE_FLOAT,
+    THRESHOLDCOMPARE_FLOAT_ULP,
+    THRESHOLDCOMPARE_BITWISE,
+
+    THRESHOLDCOMPARE_LAST
+};
+
+// Benchmarks threshold compares on images the row kernels handle against the per-pixel path. The
+// per-pixel path is timed by comparing the same data through accesses with a padded pixel pitch,
+// which the row kernels don't accept.
+class ThresholdCompareCase : public tcu::TestCase
+{
+public:
+    ThresholdCompareCase(tcu::TestContext &testCtx, const char *name, ThresholdCompareType compareType,
+                         const tcu::TextureFormat &format)
+        : tcu::TestCase(testCtx, name, "")
+        , m_compareType(compareType)
+        , m_format(format)
+    {
+    }
+
+    IterateResult iterate(void)
+    {
+        const int benchmarkSize = 1024;
+        const int failSize      = 32;
+        de::Random rnd(deStringHash(getName()));
+        bool allOk = true;
+
+        // Passing images, timed.
+        {
+            tcu::TextureLevel reference;
+            tcu::TextureLevel result;
+            uint64_t compareTime   = 0;
+            uint64_t perPixelTime  = 0;
+            bool compareOk         = false;
+            bool perPixelCompareOk = false;
+
+            generateImages(rnd, benchmarkSize, false, reference, result);
+
+            {
+                std::vector<uint8_t> paddedRefData;
+                std::vector<uint8_t> paddedResData;
+                const tcu::ConstPixelBufferAccess paddedRef = getPaddedCopy(reference, paddedRefData);
+                const tcu::ConstPixelBufferAccess paddedRes = getPaddedCopy(result, paddedResData);
+
+                compareTime  = measureMicroseconds([&]() { compareOk = compare(reference, result); });
+                perPixelTime = measureMicroseconds([&]() { perPixelCompareOk = compare(paddedRef, paddedRes); });
+            }
+
+            m_testCtx.getLog() << TestLog::Integer("CompareTime", "Comparison time", "us", QP_KEY_TAG_TIME,
+                                                   compareTime)
+                               << TestLog::Integer("PerPixelCompareTime", "Per-pixel comparison time", "us",
+                                                   QP_KEY_TAG_TIME, perPixelTime);
+
+            if (!compareOk || !perPixelCompareOk)
+            {
+                m_testCtx.getLog() << TestLog::Message << "ERROR: Comparison of images within threshold failed"
+                                   << TestLog::EndMessage;
+                allOk = false;
+            }
+        }
+
+        // One pixel over threshold must fail with both paths.
+        {
+            tcu::TextureLevel reference;
+            tcu::TextureLevel result;
+            std::vector<uint8_t> paddedRefData;
+            std::vector<uint8_t> paddedResData;
+
+            generateImages(rnd, failSize, true, reference, result);
+
+            if (compare(reference, result) ||
+                compare(getPaddedCopy(reference, paddedRefData), getPaddedCopy(result, paddedResData)))
+            {
+                m_testCtx.getLog() << TestLog::Message << "ERROR: Comparison of images with failing pixel passed"
+                                   << TestLog::EndMessage;
+                allOk = false;
+            }
+        }
+
+        m_testCtx.setTestResult(allOk ? QP_TEST_RESULT_PASS : QP_TEST_RESULT_FAIL,
+                                allOk ? "Pass" : "Wrong comparison result");
+
+        return STOP;
+    }
+
+private:
+    bool compare(const tcu::ConstPixelBufferAccess &reference, const tcu::ConstPixelBufferAccess &result)
+    {
+        TestLog &log = m_testCtx.getLog();
+
+        switch (m_compareType)
+        {
+        case THRESHOLDCOMPARE_INT:
+            return tcu::intThresholdCompare(log, "Compare", "Image comparison", reference, result,
+                                            tcu::UVec4(3u, 3u, 3u, 3u), tcu::COMPARE_LOG_ON_ERROR);
+        case THRESHOLDCOMPARE_FLOAT:
+            return tcu::floatThresholdCompare(log, "Compare", "Image comparison", reference, result,
+                                              tcu::Vec4(1.0f / 64.0f), tcu::COMPARE_LOG_ON_ERROR);
+        case THRESHOLDCOMPARE_FLOAT_ULP:
+            return tcu::floatUlpThresholdCompare(log, "Compare", "Image comparison", reference, result,
+                                                 tcu::UVec4(1u << 14u), tcu::COMPARE_LOG_ON_ERROR);
+        case THRESHOLDCOMPARE_BITWISE:
+            return tcu::bitwiseCompare(log, "Compare", "Image comparison", reference, result,
+                                       tcu::COMPARE_LOG_ON_ERROR);
+        default:
+            DE_FATAL("Unknown compare type");
+            return false;
+        }
+    }
+
+    //! Generates reference and result within thresholds of all compare types, or with one pixel far off.
+    void generateImages(de::Random &rnd, int size, bool addFailingPixel, tcu::TextureLevel &reference,
+                        tcu::TextureLevel &result) const
+    {
+        const int numValues = size * size * tcu::getNumUsedChannels(m_format.order);
+
+        reference.setStorage(m_format, size, size);
+        result.setStorage(m_format, size, size);
+
+        for (int y = 0; y < size; y++)
+        {
+            for (int x = 0; x < size; x++)
+            {
+                if (m_format.type == tcu::TextureFormat::UNSIGNED_INT32)
+                    reference.getAccess().setPixel(tcu::UVec4((rnd.getUint32() >> 2u) + 16u, 0u, 0u, 0u), x, y);
+                else if (m_format.type == tcu::TextureFormat::UNORM_INT8)
+                    reference.getAccess().setPixel(tcu::IVec4(rnd.getInt(0, 255), rnd.getInt(0, 255),
+                                                              rnd.getInt(0, 255), rnd.getInt(0, 255)),
+                                                   x, y);
+                else
+                    reference.getAccess().setPixel(tcu::Vec4(rnd.getFloat(0.25f, 1.0f), rnd.getFloat(0.25f, 1.0f),
+                                                             rnd.getFloat(0.25f, 1.0f), rnd.getFloat(0.25f, 1.0f)),
+                                                   x, y);
+            }
+        }
+
+        tcu::copy(result.getAccess(), reference.getAccess());
+
+        // Perturb values by a few units of the storage type.
+        if (m_compareType != THRESHOLDCOMPARE_BITWISE)
+        {
+            void *const data = result.getAccess().getDataPtr();
+
+            for (int ndx = 0; ndx < numValues; ndx++)
+            {
+                switch (m_format.type)
+                {
+                case tcu::TextureFormat::UNORM_INT8:
+                    ((uint8_t *)data)[ndx] = (uint8_t)de::clamp(((uint8_t *)data)[ndx] + rnd.getInt(-2, 2), 0, 255);
+                    break;
+                case tcu::TextureFormat::HALF_FLOAT:
+                    ((uint16_t *)data)[ndx] = (uint16_t)(((uint16_t *)data)[ndx] + rnd.getInt(-1, 1));
+                    break;
+                case tcu::TextureFormat::FLOAT:
+                    ((uint32_t *)data)[ndx] = (uint32_t)(((uint32_t *)data)[ndx] + rnd.getInt(-4, 4));
+                    break;
+                case tcu::TextureFormat::UNSIGNED_INT32:
+                    ((uint32_t *)data)[ndx] = (uint32_t)(((uint32_t *)data)[ndx] + rnd.getInt(-3, 3));
+                    break;
+                default:
+                    DE_FATAL("Unsupported format");
+                }
+            }
+        }
+
+        if (addFailingPixel)
+        {
+            const int x = rnd.getInt(0, size - 1);
+            const int y = rnd.getInt(0, size - 1);
+
+            if (m_format.type == tcu::TextureFormat::UNORM_INT8 || m_format.type == tcu::TextureFormat::UNSIGNED_INT32)
+            {
+                tcu::UVec4 value = reference.getAccess().getPixelUint(x, y);
+                value[0]         = (value[0] + 128u) % 256u;
+                result.getAccess().setPixel(value, x, y);
+            }
+            else
+                result.getAccess().setPixel(reference.getAccess().getPixel(x, y) + tcu::Vec4(0.5f, 0.0f, 0.0f, 0.0f),
+                                            x, y);
+        }
+    }
+
+    //! Copies image to storage with a padded pixel pitch.
+    static tcu::ConstPixelBufferAccess getPaddedCopy(const tcu::TextureLevel &src, std::vector<uint8_t> &storage)
+    {
+        const int pixelPitch = src.getFormat().getPixelSize() * 2;
+        const tcu::IVec3 pitch(pixelPitch, pixelPitch * src.getWidth(), pixelPitch * src.getWidth() * src.getHeight());
+
+        storage.resize(pitch.z() * src.getDepth());
+
+        const tcu::PixelBufferAccess dst(src.getFormat(), src.getSize(), pitch, &storage[0]);
+        tcu::copy(dst, src.getAccess());
+
+        return dst;
+    }
+
+    const ThresholdCompareType m_compareType;
+    const tcu::TextureFormat m_format;
+};
+
+enum ParallelCompareType
+{
+    PARALLELCOMPARE_FUZZY = 0,
+    PARALLELCOMPARE_BILINEAR,
+
+    PARALLELCOMPARE_LAST
+};
+
+// Benchmarks fuzzy and bilinear compares on one thread and on a fixed number of threads, and checks that the result
+// and error mask don't depend on the number of threads.
+class ParallelCompareCase : public tcu::TestCase
+{
+public:
+    ParallelCompareCase(tcu::TestContext &testCtx, const char *name, ParallelCompareType compareType)
+        : tcu::TestCase(testCtx, name, "")
+        , m_compareType(compareType)
+    {
+    }
+
+    IterateResult iterate(void)
+    {
+        const int benchmarkSize = 1024;
+        const int numThreads    = 4;
+        const double numPixels  = double(benchmarkSize * benchmarkSize);
+        const tcu::TextureFormat format(tcu::TextureFormat::RGBA, tcu::TextureFormat::UNORM_INT8);
+        tcu::TextureLevel reference(format, benchmarkSize, benchmarkSize);
+        tcu::TextureLevel result(format, benchmarkSize, benchmarkSize);
+        tcu::TextureLevel singleThreadMask(format, benchmarkSize, benchmarkSize);
+        tcu::TextureLevel multiThreadMask(format, benchmarkSize, benchmarkSize);
+        uint64_t singleThreadTime = 0;
+        uint64_t multiThreadTime  = 0;
+        float singleThreadResult  = 0.0f;
+        float multiThreadResult   = 0.0f;
+
+        generateImages(reference, result);
+
+        singleThreadTime =
+            measureMicroseconds([&]() { singleThreadResult = compare(reference, result, singleThreadMask, 1); });
+        multiThreadTime =
+            measureMicroseconds([&]() { multiThreadResult = compare(reference, result, multiThreadMask, numThreads); });
+
+        {
+            const float singleThreadRate = getMegaRate(numPixels, singleThreadTime);
+            const float multiThreadRate  = getMegaRate(numPixels, multiThreadTime);
+            const size_t maskSize        = (size_t)(benchmarkSize * benchmarkSize * format.getPixelSize());
+            const bool isOk              = singleThreadResult == multiThreadResult &&
+                              deMemCmp(singleThreadMask.getAccess().getDataPtr(),
+                                       multiThreadMask.getAccess().getDataPtr(), maskSize) == 0;
+
+            m_testCtx.getLog() << TestLog::Integer("NumThreads", "Threads used for the multi-threaded run", "",
+                                                   QP_KEY_TAG_NONE, numThreads)
+                               << TestLog::Float("SingleThreadResult", "Result on one thread", "", QP_KEY_TAG_NONE,
+                                                 singleThreadResult)
+                               << TestLog::Float("MultiThreadResult", "Result on multiple threads", "",
+                                                 QP_KEY_TAG_NONE, multiThreadResult)
+                               << TestLog::Float("SingleThreadThroughput", "Throughput on one thread", "Mpix/s",
+                                                 QP_KEY_TAG_PERFORMANCE, singleThreadRate)
+                               << TestLog::Float("MultiThreadThroughput", "Throughput on multiple threads", "Mpix/s",
+                                                 QP_KEY_TAG_PERFORMANCE, multiThreadRate);
+
+            if (!isOk)
+                m_testCtx.setTestResult(QP_TEST_RESULT_FAIL, "Result depends on number of threads");
+            else
+                m_testCtx.setTestResult(QP_TEST_RESULT_PASS, de::floatToString(multiThreadRate, 2).c_str());
+        }
+
+        return STOP;
+    }
+
+private:
+    float compare(const tcu::ConstPixelBufferAccess &reference, const tcu::ConstPixelBufferAccess &result,
+                  const tcu::PixelBufferAccess &errorMask, int numThreads) const
+    {
+        switch (m_compareType)
+        {
+        case PARALLELCOMPARE_FUZZY:
+        {
+            tcu::FuzzyCompareParams params;
+            params.numThreads = numThreads;
+            return tcu::fuzzyCompare(params, reference, result, errorMask);
+        }
+        case PARALLELCOMPARE_BILINEAR:
+        {
+            const bool isOk = tcu::bilinearCompare(reference, result, errorMask, tcu::RGBA(7, 7, 7, 2), numThreads);
+            return isOk ? 1.0f : 0.0f;
+        }
+        default:
+            DE_FATAL("Unknown compare type");
+            return 0.0f;
+        }
+    }
+
+    //! Generates a smooth reference and a result that is slightly off, shifted by one pixel in a few areas.
+    void generateImages(tcu::TextureLevel &reference, tcu::TextureLevel &result) const
+    {
+        const tcu::PixelBufferAccess ref = reference.getAccess();
+        const tcu::PixelBufferAccess res = result.getAccess();
+        de::Random rnd(deStringHash(getName()));
+
+        for (int y = 0; y < ref.getHeight(); y++)
+        {
+            for (int x = 0; x < ref.getWidth(); x++)
+                ref.setPixel(tcu::IVec4((x * 3 + y) % 256, (y * 5) % 256, ((x ^ y) & 0x40) ? 255 : 0, 255), x, y);
+        }
+
+        for (int y = 0; y < res.getHeight(); y++)
+        {
+            for (int x = 0; x < res.getWidth(); x++)
+            {
+                const bool shifted        = ((x / 64) + (y / 64)) % 7 == 0;
+                const tcu::IVec4 refPixel = ref.getPixelInt(shifted ? de::min(x + 1, ref.getWidth() - 1) : x, y);
+                const tcu::IVec4 noise(rnd.getInt(-2, 2), rnd.getInt(-2, 2), rnd.getInt(-2, 2), 0);
+
+                res.setPixel(tcu::clamp(refPixel + noise, tcu::IVec4(0), tcu::IVec4(255)), x, y);
+            }
+        }
+    }
+
+    const ParallelCompareType m_compareType;
+};
+
 class FuzzyComparisonMetricTests : public tcu::TestCaseGroup
 {
 public:
@@ -257,6 +589,50 @@ public:
     }
 };
 
+class ThresholdCompareTests : public tcu::TestCaseGroup
+{
+public:
+    ThresholdCompareTests(tcu::TestContext &testCtx)
+        : tcu::TestCaseGroup(testCtx, "threshold_compare", "Threshold comparison row kernel benchmarks")
+    {
+    }
+
+    void init(void)
+    {
+        const tcu::TextureFormat rgba8(tcu::TextureFormat::RGBA, tcu::TextureFormat::UNORM_INT8);
+        const tcu::TextureFormat rgba16f(tcu::TextureFormat::RGBA, tcu::TextureFormat::HALF_FLOAT);
+        const tcu::TextureFormat rgba32f(tcu::TextureFormat::RGBA, tcu::TextureFormat::FLOAT);
+        const tcu::TextureFormat r32ui(tcu::TextureFormat::R, tcu::TextureFormat::UNSIGNED_INT32);
+
+        addChild(new ThresholdCompareCase(m_testCtx, "int_rgba8", THRESHOLDCOMPARE_INT, rgba8));
+        addChild(new ThresholdCompareCase(m_testCtx, "int_r32ui", THRESHOLDCOMPARE_INT, r32ui));
+        addChild(new ThresholdCompareCase(m_testCtx, "float_rgba8", THRESHOLDCOMPARE_FLOAT, rgba8));
+        addChild(new ThresholdCompareCase(m_testCtx, "float_rgba16f", THRESHOLDCOMPARE_FLOAT, rgba16f));
+        addChild(new ThresholdCompareCase(m_testCtx, "float_rgba32f", THRESHOLDCOMPARE_FLOAT, rgba32f));
+        addChild(new ThresholdCompareCase(m_testCtx, "float_ulp_rgba16f", THRESHOLDCOMPARE_FLOAT_ULP, rgba16f));
+        addChild(new ThresholdCompareCase(m_testCtx, "float_ulp_rgba32f", THRESHOLDCOMPARE_FLOAT_ULP, rgba32f));
+        addChild(new ThresholdCompareCase(m_testCtx, "bitwise_rgba8", THRESHOLDCOMPARE_BITWISE, rgba8));
+        addChild(new ThresholdCompareCase(m_testCtx, "bitwise_rgba16f", THRESHOLDCOMPARE_BITWISE, rgba16f));
+        addChild(new ThresholdCompareCase(m_testCtx, "bitwise_rgba32f", THRESHOLDCOMPARE_BITWISE, rgba32f));
+        addChild(new ThresholdCompareCase(m_testCtx, "bitwise_r32ui", THRESHOLDCOMPARE_BITWISE, r32ui));
+    }
+};
+
+class ParallelCompareTests : public tcu::TestCaseGroup
+{
+public:
+    ParallelCompareTests(tcu::TestContext &testCtx)
+        : tcu::TestCaseGroup(testCtx, "parallel_compare", "Multi-threaded fuzzy and bilinear comparison benchmarks")
+    {
+    }
+
+    void init(void)
+    {
+        addChild(new ParallelCompareCase(m_testCtx, "fuzzy", PARALLELCOMPARE_FUZZY));
+        addChild(new ParallelCompareCase(m_testCtx, "bilinear", PARALLELCOMPARE_BILINEAR));
+    }
+};
+
 ImageCompareTests::ImageCompareTests(tcu::TestContext &testCtx)
     : tcu::TestCaseGroup(testCtx, "image_compare", "Image comparison tests")
 {
@@ -270,6 +646,8 @@ void ImageCompareTests::init(void)
 {
     addChild(new FuzzyComparisonMetricTests(m_testCtx));
     addChild(new BilinearCompareTests(m_testCtx));
+    addChild(new ThresholdCompareTests(m_testCtx));
+    addChild(new ParallelCompareTests(m_testCtx));
 }
 
 } // namespace dit
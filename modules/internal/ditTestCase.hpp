@@ -25,6 +25,7 @@
 
 #include "tcuDefs.hpp"
 #include "tcuTestCase.hpp"
+#include "deClock.h"
 
 namespace dit
 {
@@ -51,6 +52,21 @@ private:
     Function m_function;
 };
 
+//! Runs func once and returns its wall-clock time in microseconds, at least one so that rates stay finite.
+template <typename Func>
+uint64_t measureMicroseconds(Func func)
+{
+    const uint64_t startTime = deGetMicroseconds();
+    func();
+    return de::max<uint64_t>(deGetMicroseconds() - startTime, 1u);
+}
+
+//! Returns throughput in millions of units per second.
+inline float getMegaRate(double numUnits, uint64_t timeUs)
+{
+    return float(numUnits / double(timeUs));
+}
+
 } // namespace dit
 
 #endif // _DITTESTCASE_HPP
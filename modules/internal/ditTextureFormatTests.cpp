@@ -1249,6 +1249,137 @@ public:
     }
 };
 
+class ColorCopyCase : public tcu::TestCase
+{
+public:
+    ColorCopyCase(tcu::TestContext &testCtx, TextureFormat srcFormat)
+        : tcu::TestCase(testCtx, getCaseName(srcFormat).c_str(), "")
+        , m_srcFormat(srcFormat)
+    {
+        DE_ASSERT(isColorFormat(srcFormat));
+    }
+
+    static bool isColorFormat(TextureFormat format)
+    {
+        return isValid(format) && format.order != TextureFormat::D && format.order != TextureFormat::S &&
+               format.order != TextureFormat::DS && format.type != TextureFormat::SIGNED_INT64 &&
+               format.type != TextureFormat::UNSIGNED_INT64 && format.type != TextureFormat::FLOAT64;
+    }
+
+    IterateResult iterate(void)
+    {
+        // Wider than one conversion chunk, and source rows are padded to test row addressing.
+        const int width       = 100;
+        const int height      = 3;
+        const int srcRowPitch = width * m_srcFormat.getPixelSize() + 12;
+        vector<uint8_t> srcMem(srcRowPitch * height);
+        const PixelBufferAccess src(m_srcFormat, width, height, 1, srcRowPitch, srcRowPitch * height, &srcMem[0]);
+        const bool srcIsInt = isIntegerFormat(m_srcFormat);
+        de::Random rnd(deStringHash(getName()));
+        int numFailed = 0;
+
+        // Float sources are filled through setPixel() to avoid NaNs and values out of integer range.
+        if (srcIsInt)
+        {
+            for (size_t ndx = 0; ndx < srcMem.size(); ndx++)
+                srcMem[ndx] = rnd.getUint8();
+        }
+        else
+        {
+            for (int y = 0; y < height; y++)
+                for (int x = 0; x < width; x++)
+                    src.setPixel(getRandomValue(rnd), x, y);
+        }
+
+        m_testCtx.getLog() << TestLog::Message
+                           << "Comparing tcu::copy() against getPixel() -> setPixel() to all color formats"
+                           << TestLog::EndMessage;
+
+        for (int channelType = 0; channelType < TextureFormat::CHANNELTYPE_LAST; channelType++)
+        {
+            for (int channelOrder = 0; channelOrder < TextureFormat::CHANNELORDER_LAST; channelOrder++)
+            {
+                const TextureFormat dstFormat((TextureFormat::ChannelOrder)channelOrder,
+                                              (TextureFormat::ChannelType)channelType);
+
+                if (!isColorFormat(dstFormat) || dstFormat == m_srcFormat)
+                    continue;
+
+                const int dstSize = width * height * dstFormat.getPixelSize();
+                vector<uint8_t> refMem(dstSize, 0);
+                vector<uint8_t> resMem(dstSize, 0);
+                const PixelBufferAccess ref(dstFormat, width, height, 1, &refMem[0]);
+                const PixelBufferAccess res(dstFormat, width, height, 1, &resMem[0]);
+
+                for (int y = 0; y < height; y++)
+                {
+                    for (int x = 0; x < width; x++)
+                    {
+                        if (srcIsInt && isIntegerFormat(dstFormat))
+                            ref.setPixel(src.getPixelInt(x, y), x, y);
+                        else
+                            ref.setPixel(src.getPixel(x, y), x, y);
+                    }
+                }
+
+                tcu::copy(res, src);
+
+                if (refMem != resMem)
+                {
+                    if (numFailed < 10)
+                        m_testCtx.getLog() << TestLog::Message << "ERROR: result differs from reference with "
+                                           << dstFormat << TestLog::EndMessage;
+                    numFailed += 1;
+                }
+            }
+        }
+
+        if (numFailed == 0)
+            m_testCtx.setTestResult(QP_TEST_RESULT_PASS, "Pass");
+        else
+            m_testCtx.setTestResult(QP_TEST_RESULT_FAIL, (de::toString(numFailed) + " formats failed").c_str());
+
+        return STOP;
+    }
+
+private:
+    static bool isIntegerFormat(TextureFormat format)
+    {
+        const TextureChannelClass channelClass = tcu::getTextureChannelClass(format.type);
+        return channelClass == tcu::TEXTURECHANNELCLASS_SIGNED_INTEGER ||
+               channelClass == tcu::TEXTURECHANNELCLASS_UNSIGNED_INTEGER;
+    }
+
+    static tcu::Vec4 getRandomValue(de::Random &rnd)
+    {
+        tcu::Vec4 value;
+
+        // Mix of normalized values, rounding ties and values that saturate integer channels.
+        for (int c = 0; c < 4; c++)
+        {
+            switch (rnd.getInt(0, 3))
+            {
+            case 0:
+                value[c] = rnd.getFloat(-1.5f, 1.5f);
+                break;
+            case 1:
+                value[c] = (float)rnd.getInt(-300, 300) / 255.0f;
+                break;
+            case 2:
+                value[c] = (float)rnd.getInt(-600, 600) + 0.5f;
+                break;
+            default:
+                value[c] = (float)rnd.getInt(-70000, 70000);
+                break;
+            }
+        }
+
+        return value;
+    }
+
+    const TextureFormat m_srcFormat;
+};
+
 } // namespace
 
 tcu::TestCaseGroup *createTextureFormatTests(tcu::TestContext &testCtx)
@@ -1283,6 +1414,25 @@ tcu::TestCaseGroup *createTextureFormatTests(tcu::TestContext &testCtx)
         }
     }
 
+    {
+        de::MovePtr<tcu::TestCaseGroup> copyGroup(
+            new tcu::TestCaseGroup(testCtx, "copy", "Color format conversion with tcu::copy()"));
+
+        for (int channelType = 0; channelType < TextureFormat::CHANNELTYPE_LAST; channelType++)
+        {
+            for (int channelOrder = 0; channelOrder < TextureFormat::CHANNELORDER_LAST; channelOrder++)
+            {
+                const TextureFormat format((TextureFormat::ChannelOrder)channelOrder,
+                                           (TextureFormat::ChannelType)channelType);
+
+                if (ColorCopyCase::isColorFormat(format))
+                    copyGroup->addChild(new ColorCopyCase(testCtx, format));
+            }
+        }
+
+        group->addChild(copyGroup.release());
+    }
+
     return group.release();
 }
 
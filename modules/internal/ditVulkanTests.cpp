@@ -25,6 +25,7 @@
 #include "ditTestCase.hpp"
 
 #include "vkImageUtil.hpp"
+#include "vkShaderCache.hpp"
 
 #include "deUniquePtr.hpp"
 
@@ -36,6 +37,8 @@ tcu::TestCaseGroup *createVulkanTests(tcu::TestContext &testCtx)
     de::MovePtr<tcu::TestCaseGroup> group(new tcu::TestCaseGroup(testCtx, "vulkan", "Vulkan Framework Tests"));
 
     group->addChild(new SelfCheckCase(testCtx, "image_util", "ImageUtil self-check tests", vk::imageUtilSelfTest));
+    group->addChild(
+        new SelfCheckCase(testCtx, "shader_cache", "ShaderCache self-check tests", vk::shaderCacheSelfTest));
 
     return group.release();
 }